@@ -0,0 +1,110 @@
+#include "Adafruit_ADS1X15.h"
+#include "sim/sim_ads1115.h"
+
+// Bytes por transação: endereço + ponteiro de registrador + dados
+#define ADS_WRITE_CONFIG_BYTES 4
+#define ADS_READ_REGISTER_BYTES 5
+
+bool Adafruit_ADS1X15::begin(uint8_t i2c_addr, TwoWire* wire) {
+    _address = i2c_addr;
+    _wire = wire;
+    i2c_transaction(ADS_READ_REGISTER_BYTES);
+    return sim_ads1115_responds(_address);
+}
+
+void Adafruit_ADS1X15::i2c_transaction(size_t bytes) {
+    sim_sleep_us((_wire != nullptr ? _wire : &Wire)->transfer_time_us(bytes));
+}
+
+uint32_t Adafruit_ADS1X15::conversion_time_us() const {
+    static const uint16_t SPS[] = {8, 16, 32, 64, 128, 250, 475, 860};
+    uint16_t sps = SPS[(_data_rate >> 5) & 0x07];
+    // O oscilador interno tem tolerância de ±10%; o datasheet garante o período nominal + 10%
+    return (uint32_t)(1100000UL / sps);
+}
+
+double Adafruit_ADS1X15::full_scale_volts() const {
+    switch (_gain) {
+        case GAIN_TWOTHIRDS: return 6.144;
+        case GAIN_ONE: return 4.096;
+        case GAIN_TWO: return 2.048;
+        case GAIN_FOUR: return 1.024;
+        case GAIN_EIGHT: return 0.512;
+        case GAIN_SIXTEEN: return 0.256;
+    }
+    return 6.144;
+}
+
+void Adafruit_ADS1X15::startADCReading(uint16_t mux, bool continuous) {
+    _mux = mux;
+    _continuous = continuous;
+    // Como a biblioteca original: configuração e, em seguida, os limiares
+    // Hi_thresh = 0x8000 / Lo_thresh = 0x0000 (ALERT/RDY no modo "conversão pronta")
+    i2c_transaction(ADS_WRITE_CONFIG_BYTES);
+    i2c_transaction(ADS_WRITE_CONFIG_BYTES);
+    i2c_transaction(ADS_WRITE_CONFIG_BYTES);
+    _conversion_start_us = sim_now_us();
+    sim_ads1115_conversion_started(conversion_time_us(), continuous);
+}
+
+bool Adafruit_ADS1X15::conversionComplete() {
+    i2c_transaction(ADS_READ_REGISTER_BYTES);
+    return sim_now_us() - _conversion_start_us >= conversion_time_us();
+}
+
+int16_t Adafruit_ADS1X15::getLastConversionResults() {
+    i2c_transaction(ADS_READ_REGISTER_BYTES);
+    if (!sim_ads1115_responds(_address)) {
+        return 0;
+    }
+
+    double volts;
+    if (_mux >= ADS1X15_REG_CONFIG_MUX_SINGLE_0) {
+        volts = sim_ads1115_input_volts((uint8_t)((_mux - ADS1X15_REG_CONFIG_MUX_SINGLE_0) >> 12));
+    } else if (_mux == ADS1X15_REG_CONFIG_MUX_DIFF_0_1) {
+        volts = sim_ads1115_input_volts(0) - sim_ads1115_input_volts(1);
+    } else if (_mux == ADS1X15_REG_CONFIG_MUX_DIFF_2_3) {
+        volts = sim_ads1115_input_volts(2) - sim_ads1115_input_volts(3);
+    } else {
+        volts = sim_ads1115_input_volts(_mux == ADS1X15_REG_CONFIG_MUX_DIFF_0_3 ? 0 : 1) - sim_ads1115_input_volts(3);
+    }
+
+    double counts = volts / full_scale_volts() * 32768.0;
+    if (counts > 32767.0) {
+        counts = 32767.0;
+    } else if (counts < -32768.0) {
+        counts = -32768.0;
+    }
+    if (_continuous) {
+        _conversion_start_us = sim_now_us();
+    }
+    return (int16_t)lround(counts);
+}
+
+int16_t Adafruit_ADS1X15::readADC_SingleEnded(uint8_t channel) {
+    if (channel > 3) {
+        return 0;
+    }
+    startADCReading(MUX_BY_CHANNEL[channel], false);
+    while (!conversionComplete()) {
+    }
+    return getLastConversionResults();
+}
+
+int16_t Adafruit_ADS1X15::readADC_Differential_0_1() {
+    startADCReading(ADS1X15_REG_CONFIG_MUX_DIFF_0_1, false);
+    while (!conversionComplete()) {
+    }
+    return getLastConversionResults();
+}
+
+int16_t Adafruit_ADS1X15::readADC_Differential_2_3() {
+    startADCReading(ADS1X15_REG_CONFIG_MUX_DIFF_2_3, false);
+    while (!conversionComplete()) {
+    }
+    return getLastConversionResults();
+}
+
+float Adafruit_ADS1X15::computeVolts(int16_t counts) {
+    return (float)(counts * full_scale_volts() / 32768.0);
+}
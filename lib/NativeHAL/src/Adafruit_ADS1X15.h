@@ -0,0 +1,80 @@
+#ifndef NATIVE_HAL_ADAFRUIT_ADS1X15_H
+#define NATIVE_HAL_ADAFRUIT_ADS1X15_H
+
+/**
+ * Substituto da biblioteca Adafruit ADS1X15 para o build nativo: mesma API
+ * pública, servida pelo ADS1115 simulado (sim/sim_ads1115.h). Os tempos de
+ * conversão e das transações I2C avançam o relógio simulado.
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define ADS1X15_ADDRESS (0x48)
+
+#define ADS1X15_REG_CONFIG_MUX_DIFF_0_1 (0x0000)
+#define ADS1X15_REG_CONFIG_MUX_DIFF_0_3 (0x1000)
+#define ADS1X15_REG_CONFIG_MUX_DIFF_1_3 (0x2000)
+#define ADS1X15_REG_CONFIG_MUX_DIFF_2_3 (0x3000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_0 (0x4000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_1 (0x5000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_2 (0x6000)
+#define ADS1X15_REG_CONFIG_MUX_SINGLE_3 (0x7000)
+
+constexpr uint16_t MUX_BY_CHANNEL[] = {
+    ADS1X15_REG_CONFIG_MUX_SINGLE_0,
+    ADS1X15_REG_CONFIG_MUX_SINGLE_1,
+    ADS1X15_REG_CONFIG_MUX_SINGLE_2,
+    ADS1X15_REG_CONFIG_MUX_SINGLE_3,
+};
+
+typedef enum {
+    GAIN_TWOTHIRDS = 0x0000,
+    GAIN_ONE = 0x0200,
+    GAIN_TWO = 0x0400,
+    GAIN_FOUR = 0x0600,
+    GAIN_EIGHT = 0x0800,
+    GAIN_SIXTEEN = 0x0A00
+} adsGain_t;
+
+#define RATE_ADS1115_8SPS (0x0000)
+#define RATE_ADS1115_16SPS (0x0020)
+#define RATE_ADS1115_32SPS (0x0040)
+#define RATE_ADS1115_64SPS (0x0060)
+#define RATE_ADS1115_128SPS (0x0080)
+#define RATE_ADS1115_250SPS (0x00A0)
+#define RATE_ADS1115_475SPS (0x00C0)
+#define RATE_ADS1115_860SPS (0x00E0)
+
+class Adafruit_ADS1X15 {
+public:
+    bool begin(uint8_t i2c_addr = ADS1X15_ADDRESS, TwoWire* wire = &Wire);
+    int16_t readADC_SingleEnded(uint8_t channel);
+    int16_t readADC_Differential_0_1();
+    int16_t readADC_Differential_2_3();
+    void startADCReading(uint16_t mux, bool continuous);
+    bool conversionComplete();
+    int16_t getLastConversionResults();
+    float computeVolts(int16_t counts);
+    void setGain(adsGain_t gain) { _gain = gain; }
+    adsGain_t getGain() { return _gain; }
+    void setDataRate(uint16_t rate) { _data_rate = rate; }
+    uint16_t getDataRate() { return _data_rate; }
+
+protected:
+    uint32_t conversion_time_us() const;
+    double full_scale_volts() const;
+    void i2c_transaction(size_t bytes);
+
+    uint8_t _address = ADS1X15_ADDRESS;
+    TwoWire* _wire = nullptr;
+    adsGain_t _gain = GAIN_TWOTHIRDS;
+    uint16_t _data_rate = RATE_ADS1115_128SPS;
+    uint16_t _mux = ADS1X15_REG_CONFIG_MUX_SINGLE_0;
+    bool _continuous = false;
+    uint64_t _conversion_start_us = 0;
+};
+
+class Adafruit_ADS1115 : public Adafruit_ADS1X15 {};
+
+#endif // NATIVE_HAL_ADAFRUIT_ADS1X15_H
@@ -0,0 +1,73 @@
+#include "Arduino.h"
+#include "sim/sim_gpio.h"
+#include "sim/sim_system.h"
+
+unsigned long millis() {
+    return (unsigned long)((sim_now_us() - sim_system_boot_us()) / 1000ULL);
+}
+
+unsigned long micros() {
+    return (unsigned long)(sim_now_us() - sim_system_boot_us());
+}
+
+void delay(uint32_t ms) {
+    sim_sleep_us((uint64_t)ms * 1000ULL);
+}
+
+void delayMicroseconds(uint32_t us) {
+    sim_sleep_us(us);
+}
+
+void yield() {
+    // Passa a vez às tarefas prontas sem avançar o relógio
+    sim_sleep_us(0);
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    sim_gpio_write(pin, value);
+}
+
+int digitalRead(uint8_t pin) {
+    return sim_gpio_read(pin);
+}
+
+uint16_t analogRead(uint8_t pin) {
+    return sim_gpio_read(pin) ? 4095 : 0;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+    sim_gpio_attach_isr(pin, isr, mode);
+}
+
+void detachInterrupt(uint8_t pin) {
+    sim_gpio_detach_isr(pin);
+}
+
+void interrupts() {
+}
+
+void noInterrupts() {
+}
+
+long random(long max_value) {
+    return max_value > 0 ? (long)(lrand48() % max_value) : 0;
+}
+
+long random(long min_value, long max_value) {
+    return max_value > min_value ? min_value + random(max_value - min_value) : min_value;
+}
+
+void randomSeed(unsigned long seed) {
+    srand48((long)seed);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+EspClass ESP;
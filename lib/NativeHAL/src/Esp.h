@@ -0,0 +1,23 @@
+#ifndef NATIVE_HAL_ESP_H
+#define NATIVE_HAL_ESP_H
+
+#include <stdint.h>
+#include "sim/sim_system.h"
+
+/**
+ * @brief Objeto ESP do núcleo Arduino (heap e reset).
+ */
+class EspClass {
+public:
+    uint32_t getHeapSize() { return sim_system_heap_size(); }
+    uint32_t getFreeHeap() { return sim_system_free_heap(); }
+    uint32_t getMinFreeHeap() { return sim_system_min_free_heap(); }
+    uint32_t getMaxAllocHeap() { return sim_system_free_heap(); }
+    uint32_t getCpuFreqMHz() { return 240; }
+    const char* getChipModel() { return "ESP32-D0WD (native)"; }
+    [[noreturn]] void restart() { sim_system_restart(); }
+};
+
+extern EspClass ESP;
+
+#endif // NATIVE_HAL_ESP_H
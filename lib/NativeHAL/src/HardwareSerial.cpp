@@ -0,0 +1,41 @@
+#include "HardwareSerial.h"
+#include <stdio.h>
+
+HardwareSerial Serial(0);
+HardwareSerial Serial1(1);
+HardwareSerial Serial2(2);
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rx_pin, int8_t tx_pin,
+                           bool invert, unsigned long timeout_ms, uint8_t rxfifo_full_thrhd) {
+    (void)config;
+    (void)rx_pin;
+    (void)tx_pin;
+    (void)invert;
+    (void)timeout_ms;
+    (void)rxfifo_full_thrhd;
+    _baud = baud;
+}
+
+int HardwareSerial::read() {
+    if (_rx.empty()) {
+        return -1;
+    }
+    int c = _rx.front();
+    _rx.pop_front();
+    return c;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (_device) {
+        _device(buffer, size);
+    } else if (_uart_nr == 0) {
+        fwrite(buffer, 1, size, stdout);
+    }
+    return size;
+}
+
+void HardwareSerial::flush() {
+    if (_uart_nr == 0) {
+        fflush(stdout);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef NATIVE_HAL_HARDWARESERIAL_H
+#define NATIVE_HAL_HARDWARESERIAL_H
+
+#include <deque>
+#include <functional>
+#include "Stream.h"
+
+#define SERIAL_8N1 0x800001c
+
+/**
+ * @brief UART do ESP32.
+ *
+ * Serial (UART0) escreve no stdout do host. As demais UARTs podem ser ligadas
+ * a um periférico simulado (ex: Serial1 -> SIM7000), que recebe os bytes
+ * transmitidos e injeta as respostas no buffer de recepção.
+ */
+class HardwareSerial : public Stream {
+public:
+    explicit HardwareSerial(int uart_nr) : _uart_nr(uart_nr) {}
+
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rx_pin = -1, int8_t tx_pin = -1,
+               bool invert = false, unsigned long timeout_ms = 20000UL, uint8_t rxfifo_full_thrhd = 112);
+    void end() { _baud = 0; }
+    unsigned long baudRate() const { return _baud; }
+
+    int available() override { return (int)_rx.size(); }
+    int read() override;
+    int peek() override { return _rx.empty() ? -1 : _rx.front(); }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int availableForWrite() override { return 128; }
+    void flush() override;
+    operator bool() const { return true; }
+
+    // --- Lado do periférico simulado ---
+    void sim_attach_device(std::function<void(const uint8_t*, size_t)> on_tx) { _device = std::move(on_tx); }
+    void sim_inject(const uint8_t* data, size_t length) { _rx.insert(_rx.end(), data, data + length); }
+    void sim_inject(const char* text) { sim_inject((const uint8_t*)text, strlen(text)); }
+
+private:
+    int _uart_nr;
+    unsigned long _baud = 0;
+    std::deque<uint8_t> _rx;
+    std::function<void(const uint8_t*, size_t)> _device;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+#endif // NATIVE_HAL_HARDWARESERIAL_H
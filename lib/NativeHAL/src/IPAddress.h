@@ -0,0 +1,52 @@
+#ifndef NATIVE_HAL_IPADDRESS_H
+#define NATIVE_HAL_IPADDRESS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "WString.h"
+
+/**
+ * @brief Endereço IPv4 (subconjunto da classe IPAddress do Arduino).
+ */
+class IPAddress {
+public:
+    IPAddress() : IPAddress(0, 0, 0, 0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+        _octets[0] = a;
+        _octets[1] = b;
+        _octets[2] = c;
+        _octets[3] = d;
+    }
+    IPAddress(uint32_t address) {
+        for (int i = 0; i < 4; i++) {
+            _octets[i] = (uint8_t)(address >> (8 * i));
+        }
+    }
+
+    bool fromString(const char* address) {
+        unsigned a, b, c, d;
+        if (sscanf(address, "%u.%u.%u.%u", &a, &b, &c, &d) != 4 || a > 255 || b > 255 || c > 255 || d > 255) {
+            return false;
+        }
+        *this = IPAddress((uint8_t)a, (uint8_t)b, (uint8_t)c, (uint8_t)d);
+        return true;
+    }
+    bool fromString(const String& address) { return fromString(address.c_str()); }
+
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _octets[0], _octets[1], _octets[2], _octets[3]);
+        return String(buf);
+    }
+
+    operator uint32_t() const {
+        return (uint32_t)_octets[0] | ((uint32_t)_octets[1] << 8) | ((uint32_t)_octets[2] << 16) | ((uint32_t)_octets[3] << 24);
+    }
+    uint8_t operator[](int index) const { return _octets[index]; }
+    uint8_t& operator[](int index) { return _octets[index]; }
+
+private:
+    uint8_t _octets[4];
+};
+
+#endif // NATIVE_HAL_IPADDRESS_H
@@ -0,0 +1,165 @@
+#include "Preferences.h"
+#include "sim/sim_kernel.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define NVS_KEY_MAX 16      // 15 caracteres + terminador
+#define NVS_VALUE_MAX 64
+#define NVS_NAMESPACES 4
+#define NVS_ENTRIES 32
+
+// Escrever na flash leva alguns milissegundos (apagamento de página amortizado)
+#define NVS_WRITE_US 2000
+
+struct NvsEntry {
+    int8_t ns;               // Índice do namespace (-1 = livre)
+    char key[NVS_KEY_MAX];
+    uint16_t length;
+    uint8_t value[NVS_VALUE_MAX];
+};
+
+SIM_PERSIST static char g_namespaces[NVS_NAMESPACES][NVS_KEY_MAX] = {};
+SIM_PERSIST static NvsEntry g_entries[NVS_ENTRIES] = {};
+SIM_PERSIST static bool g_formatted = false;
+
+/**
+ * @brief (Função Privada) Partição vazia no primeiro boot da simulação.
+ */
+static void format_if_needed() {
+    if (g_formatted) {
+        return;
+    }
+    for (NvsEntry& entry : g_entries) {
+        entry.ns = -1;
+    }
+    g_formatted = true;
+}
+
+static NvsEntry* find(int ns, const char* key) {
+    for (NvsEntry& entry : g_entries) {
+        if (entry.ns == ns && strncmp(entry.key, key, NVS_KEY_MAX) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partition_label) {
+    (void)partition_label;
+    format_if_needed();
+    if (name == nullptr || strlen(name) >= NVS_KEY_MAX) {
+        return false;
+    }
+    _read_only = readOnly;
+    for (int i = 0; i < NVS_NAMESPACES; i++) {
+        if (strcmp(g_namespaces[i], name) == 0) {
+            _namespace = i;
+            return true;
+        }
+    }
+    if (readOnly) {
+        return false; // Como no NVS: namespace inexistente não abre só para leitura
+    }
+    for (int i = 0; i < NVS_NAMESPACES; i++) {
+        if (g_namespaces[i][0] == '\0') {
+            strncpy(g_namespaces[i], name, NVS_KEY_MAX - 1);
+            _namespace = i;
+            return true;
+        }
+    }
+    fprintf(stderr, "NativeSim: AVISO - NVS sem espaço para o namespace '%s'.\n", name);
+    return false;
+}
+
+void Preferences::end() {
+    _namespace = -1;
+}
+
+bool Preferences::clear() {
+    if (_namespace < 0 || _read_only) {
+        return false;
+    }
+    for (NvsEntry& entry : g_entries) {
+        if (entry.ns == _namespace) {
+            entry.ns = -1;
+        }
+    }
+    sim_sleep_us(NVS_WRITE_US);
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (_namespace < 0 || _read_only) {
+        return false;
+    }
+    NvsEntry* entry = find(_namespace, key);
+    if (entry == nullptr) {
+        return false;
+    }
+    entry->ns = -1;
+    sim_sleep_us(NVS_WRITE_US);
+    return true;
+}
+
+bool Preferences::isKey(const char* key) {
+    return _namespace >= 0 && find(_namespace, key) != nullptr;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    if (_namespace < 0 || _read_only || key == nullptr || strlen(key) >= NVS_KEY_MAX || len > NVS_VALUE_MAX) {
+        return 0;
+    }
+    NvsEntry* entry = find(_namespace, key);
+    if (entry == nullptr) {
+        for (NvsEntry& candidate : g_entries) {
+            if (candidate.ns < 0) {
+                entry = &candidate;
+                break;
+            }
+        }
+        if (entry == nullptr) {
+            fprintf(stderr, "NativeSim: AVISO - NVS cheio ao gravar '%s'.\n", key);
+            return 0;
+        }
+        entry->ns = (int8_t)_namespace;
+        memset(entry->key, 0, sizeof(entry->key));
+        strncpy(entry->key, key, NVS_KEY_MAX - 1);
+    }
+    entry->length = (uint16_t)len;
+    memcpy(entry->value, value, len);
+    sim_sleep_us(NVS_WRITE_US);
+    return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    NvsEntry* entry = _namespace >= 0 ? find(_namespace, key) : nullptr;
+    if (entry == nullptr || entry->length > maxLen) {
+        return 0;
+    }
+    memcpy(buf, entry->value, entry->length);
+    return entry->length;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    NvsEntry* entry = _namespace >= 0 ? find(_namespace, key) : nullptr;
+    return entry != nullptr ? entry->length : 0;
+}
+
+size_t Preferences::putShort(const char* key, int16_t value) {
+    return putBytes(key, &value, sizeof(value));
+}
+
+int16_t Preferences::getShort(const char* key, int16_t defaultValue) {
+    int16_t value;
+    return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : defaultValue;
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value) {
+    return putBytes(key, &value, sizeof(value));
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    uint32_t value;
+    return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : defaultValue;
+}
@@ -0,0 +1,36 @@
+#ifndef NATIVE_HAL_PREFERENCES_H
+#define NATIVE_HAL_PREFERENCES_H
+
+/**
+ * Substituto da biblioteca Preferences (NVS) do Arduino-ESP32. As chaves
+ * ficam numa tabela fixa na seção persistente da simulação, então
+ * sobrevivem ao deep sleep como a flash real. Mesmos limites do NVS:
+ * namespace e chave com até 15 caracteres.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partition_label = nullptr);
+    void end();
+
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putShort(const char* key, int16_t value);
+    int16_t getShort(const char* key, int16_t defaultValue = 0);
+    size_t putUInt(const char* key, uint32_t value);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    size_t putBytes(const char* key, const void* value, size_t len);
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+    size_t getBytesLength(const char* key);
+
+private:
+    int _namespace = -1;
+    bool _read_only = false;
+};
+
+#endif // NATIVE_HAL_PREFERENCES_H
@@ -0,0 +1,97 @@
+#include "SensirionI2cScd4x.h"
+#include "sim/sim_scd40.h"
+
+void SensirionI2cScd4x::begin(TwoWire& i2c_bus, uint8_t i2c_address) {
+    _wire = &i2c_bus;
+    _address = i2c_address;
+}
+
+/**
+ * @brief (Função Privada) Transação I2C + tempo de execução do comando.
+ */
+int16_t SensirionI2cScd4x::command(uint32_t execution_ms, size_t bytes) {
+    sim_sleep_us((_wire != nullptr ? _wire : &Wire)->transfer_time_us(bytes));
+    if (!sim_scd40_responds() || _address != SCD40_I2C_ADDR_62) {
+        return SIM_SCD4X_ERROR_NACK;
+    }
+    delay(execution_ms);
+    return 0;
+}
+
+int16_t SensirionI2cScd4x::startPeriodicMeasurement() {
+    int16_t error = command(0, 3);
+    if (!error) {
+        sim_scd40_set_mode(SIM_SCD40_PERIODIC);
+    }
+    return error;
+}
+
+int16_t SensirionI2cScd4x::startLowPowerPeriodicMeasurement() {
+    int16_t error = command(0, 3);
+    if (!error) {
+        sim_scd40_set_mode(SIM_SCD40_LOW_POWER_PERIODIC);
+    }
+    return error;
+}
+
+int16_t SensirionI2cScd4x::stopPeriodicMeasurement() {
+    int16_t error = command(500, 3);
+    if (!error) {
+        sim_scd40_set_mode(SIM_SCD40_IDLE);
+    }
+    return error;
+}
+
+int16_t SensirionI2cScd4x::getDataReadyStatus(bool& data_ready) {
+    int16_t error = command(1, 6);
+    data_ready = !error && sim_scd40_data_ready();
+    return error;
+}
+
+int16_t SensirionI2cScd4x::readMeasurement(uint16_t& co2_concentration, float& temperature,
+                                           float& relative_humidity) {
+    int16_t error = command(1, 12);
+    if (error) {
+        return error;
+    }
+    sim_scd40_take_measurement(co2_concentration, temperature, relative_humidity);
+    return 0;
+}
+
+int16_t SensirionI2cScd4x::measureSingleShot() {
+    int16_t error = command(5000, 3);
+    if (!error) {
+        sim_scd40_single_shot_done();
+    }
+    return error;
+}
+
+int16_t SensirionI2cScd4x::wakeUp() {
+    // O sensor não confirma (ACK) o wake_up
+    sim_sleep_us((_wire != nullptr ? _wire : &Wire)->transfer_time_us(3));
+    delay(30);
+    if (sim_scd40_responds()) {
+        sim_scd40_set_mode(SIM_SCD40_IDLE);
+    }
+    return 0;
+}
+
+int16_t SensirionI2cScd4x::powerDown() {
+    int16_t error = command(1, 3);
+    if (!error) {
+        sim_scd40_set_mode(SIM_SCD40_SLEEP);
+    }
+    return error;
+}
+
+int16_t SensirionI2cScd4x::reinit() {
+    return command(30, 3);
+}
+
+void errorToString(uint16_t error, char error_message[], size_t error_message_size) {
+    if (error == SIM_SCD4X_ERROR_NACK) {
+        snprintf(error_message, error_message_size, "I2C NACK: sensor não respondeu (simulação)");
+    } else {
+        snprintf(error_message, error_message_size, "Erro 0x%04X (simulação)", error);
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef NATIVE_HAL_SENSIRION_I2C_SCD4X_H
+#define NATIVE_HAL_SENSIRION_I2C_SCD4X_H
+
+/**
+ * Substituto da biblioteca Sensirion I2C SCD4x para o build nativo: mesma
+ * API, servida pelo SCD40 simulado. Os tempos de execução dos comandos do
+ * datasheet avançam o relógio simulado.
+ */
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#define SCD40_I2C_ADDR_62 0x62
+#define SCD41_I2C_ADDR_62 0x62
+
+// Código de erro devolvido quando o sensor não responde (trilho desligado)
+#define SIM_SCD4X_ERROR_NACK 0x0310
+
+class SensirionI2cScd4x {
+public:
+    void begin(TwoWire& i2c_bus, uint8_t i2c_address);
+
+    int16_t startPeriodicMeasurement();
+    int16_t startLowPowerPeriodicMeasurement();
+    int16_t stopPeriodicMeasurement();
+    int16_t getDataReadyStatus(bool& data_ready);
+    int16_t readMeasurement(uint16_t& co2_concentration, float& temperature, float& relative_humidity);
+    int16_t measureSingleShot();
+    int16_t wakeUp();
+    int16_t powerDown();
+    int16_t reinit();
+
+private:
+    int16_t command(uint32_t execution_ms, size_t bytes);
+
+    TwoWire* _wire = nullptr;
+    uint8_t _address = SCD40_I2C_ADDR_62;
+};
+
+void errorToString(uint16_t error, char error_message[], size_t error_message_size);
+
+#endif // NATIVE_HAL_SENSIRION_I2C_SCD4X_H
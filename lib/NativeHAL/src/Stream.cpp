@@ -0,0 +1,145 @@
+#include "Stream.h"
+#include "Arduino.h"
+
+int Stream::timedRead() {
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) {
+            return c;
+        }
+        delay(1);
+    } while (millis() - start < _timeout);
+    return -1;
+}
+
+int Stream::timedPeek() {
+    unsigned long start = millis();
+    do {
+        int c = peek();
+        if (c >= 0) {
+            return c;
+        }
+        delay(1);
+    } while (millis() - start < _timeout);
+    return -1;
+}
+
+int Stream::peekNextDigit(bool allow_decimal) {
+    for (;;) {
+        int c = timedPeek();
+        if (c < 0 || c == '-' || (c >= '0' && c <= '9') || (allow_decimal && c == '.')) {
+            return c;
+        }
+        read(); // Descarta caracteres que não fazem parte do número
+    }
+}
+
+bool Stream::find(const char* target) {
+    size_t len = strlen(target);
+    size_t matched = 0;
+    if (len == 0) {
+        return true;
+    }
+    for (;;) {
+        int c = timedRead();
+        if (c < 0) {
+            return false;
+        }
+        if (c == target[matched]) {
+            if (++matched == len) {
+                return true;
+            }
+        } else {
+            matched = (c == target[0]) ? 1 : 0;
+        }
+    }
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0) {
+            break;
+        }
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0 || c == terminator) {
+            break;
+        }
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+String Stream::readString() {
+    String result;
+    int c;
+    while ((c = timedRead()) >= 0) {
+        result += (char)c;
+    }
+    return result;
+}
+
+String Stream::readStringUntil(char terminator) {
+    String result;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator) {
+        result += (char)c;
+    }
+    return result;
+}
+
+long Stream::parseInt() {
+    bool negative = false;
+    long value = 0;
+    int c = peekNextDigit(false);
+    if (c < 0) {
+        return 0;
+    }
+    do {
+        if (c == '-') {
+            negative = true;
+        } else if (c >= '0' && c <= '9') {
+            value = value * 10 + (c - '0');
+        }
+        read();
+        c = timedPeek();
+    } while (c >= '0' && c <= '9');
+    return negative ? -value : value;
+}
+
+float Stream::parseFloat() {
+    bool negative = false;
+    bool fraction = false;
+    double value = 0.0;
+    double scale = 1.0;
+    int c = peekNextDigit(true);
+    if (c < 0) {
+        return 0.0f;
+    }
+    do {
+        if (c == '-') {
+            negative = true;
+        } else if (c == '.') {
+            fraction = true;
+        } else if (c >= '0' && c <= '9') {
+            value = value * 10.0 + (c - '0');
+            if (fraction) {
+                scale *= 0.1;
+            }
+        }
+        read();
+        c = timedPeek();
+    } while ((c >= '0' && c <= '9') || (c == '.' && !fraction));
+    value *= scale;
+    return (float)(negative ? -value : value);
+}
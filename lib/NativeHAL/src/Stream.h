@@ -0,0 +1,38 @@
+#ifndef NATIVE_HAL_STREAM_H
+#define NATIVE_HAL_STREAM_H
+
+#include "Print.h"
+
+/**
+ * @brief Classe base de fluxos de entrada do Arduino.
+ *
+ * As leituras com timeout avançam o relógio simulado enquanto esperam
+ * (ver sim/sim_kernel.h), como o loop ocupado do núcleo real faria.
+ */
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout_ms) { _timeout = timeout_ms; }
+    unsigned long getTimeout() const { return _timeout; }
+
+    bool find(const char* target);
+    size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+    size_t readBytesUntil(char terminator, char* buffer, size_t length);
+    String readString();
+    String readStringUntil(char terminator);
+    long parseInt();
+    float parseFloat();
+
+protected:
+    int timedRead();
+    int timedPeek();
+    int peekNextDigit(bool allow_decimal);
+
+    unsigned long _timeout = 1000;
+};
+
+#endif // NATIVE_HAL_STREAM_H
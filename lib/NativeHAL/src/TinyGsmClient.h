@@ -0,0 +1,15 @@
+#ifndef NATIVE_HAL_TINYGSMCLIENT_H
+#define NATIVE_HAL_TINYGSMCLIENT_H
+
+/**
+ * Seleção do modem, como no TinyGSM real. O build nativo só simula o SIM7000.
+ */
+#if defined(TINY_GSM_MODEM_SIM7000)
+#include "TinyGsmClientSIM7000.h"
+typedef TinyGsmSim7000 TinyGsm;
+typedef TinyGsmSim7000::GsmClientSim7000 TinyGsmClient;
+#else
+#error "NativeHAL: apenas TINY_GSM_MODEM_SIM7000 é simulado."
+#endif
+
+#endif // NATIVE_HAL_TINYGSMCLIENT_H
@@ -0,0 +1,390 @@
+#include "TinyGsmClient.h"
+#include "sim/sim_sim7000.h"
+
+#include <stdlib.h>
+
+// ===================================================================
+// --- AT ---
+// ===================================================================
+
+int8_t TinyGsmSim7000::waitResponse(uint32_t timeout_ms, String& data, GsmConstStr r1, GsmConstStr r2,
+                                    GsmConstStr r3, GsmConstStr r4, GsmConstStr r5) {
+    GsmConstStr responses[] = {r1, r2, r3, r4, r5};
+    data.reserve(64);
+    int8_t index = 0;
+    unsigned long start = millis();
+
+    do {
+        while (stream.available() > 0) {
+            int c = stream.read();
+            if (c <= 0) {
+                continue;
+            }
+            data += (char)c;
+            for (int i = 0; i < 5; i++) {
+                if (responses[i] != nullptr && data.endsWith(String(responses[i]))) {
+                    index = (int8_t)(i + 1);
+                    break;
+                }
+            }
+            if (index != 0) {
+                if (index == 3 || index == 4) {
+                    // Consome o código do erro (+CME ERROR: <n>)
+                    stream_skip_until('\n');
+                }
+                return index;
+            }
+        }
+        // Sem TINY_GSM_YIELD: a espera precisa avançar o relógio simulado
+        delay(1);
+    } while (millis() - start < timeout_ms);
+
+    data.trim();
+    data = "";
+    return index;
+}
+
+bool TinyGsmSim7000::stream_skip_until(char terminator, uint32_t timeout_ms) {
+    unsigned long start = millis();
+    while (millis() - start < timeout_ms) {
+        while (stream.available() > 0) {
+            if (stream.read() == terminator) {
+                return true;
+            }
+        }
+        delay(1);
+    }
+    return false;
+}
+
+int TinyGsmSim7000::stream_get_int_before(char terminator) {
+    char buffer[16];
+    size_t n = stream.readBytesUntil(terminator, buffer, sizeof(buffer) - 1);
+    buffer[n] = '\0';
+    return n > 0 ? atoi(buffer) : -9999;
+}
+
+float TinyGsmSim7000::stream_get_float_before(char terminator) {
+    char buffer[24];
+    size_t n = stream.readBytesUntil(terminator, buffer, sizeof(buffer) - 1);
+    buffer[n] = '\0';
+    return n > 0 ? (float)atof(buffer) : -9999.0f;
+}
+
+// ===================================================================
+// --- Ciclo de vida ---
+// ===================================================================
+
+bool TinyGsmSim7000::testAT(uint32_t timeout_ms) {
+    for (unsigned long start = millis(); millis() - start < timeout_ms;) {
+        sendAT(GF(""));
+        if (waitResponse(200) == 1) {
+            return true;
+        }
+        delay(100);
+    }
+    return false;
+}
+
+bool TinyGsmSim7000::init(const char* pin) {
+    (void)pin;
+    if (!testAT()) {
+        return false;
+    }
+    sendAT(GF("E0")); // Sem eco
+    if (waitResponse() != 1) {
+        return false;
+    }
+    sendAT(GF("+CMEE=2")); // Erros detalhados
+    waitResponse();
+
+    sendAT(GF("+CPIN?"));
+    return waitResponse(10000L, GF("+CPIN: READY")) == 1 && waitResponse() == 1;
+}
+
+bool TinyGsmSim7000::restart(const char* pin) {
+    if (!testAT()) {
+        return false;
+    }
+    sendAT(GF("+CFUN=0"));
+    waitResponse(10000L);
+    sendAT(GF("+CFUN=1,1"));
+    waitResponse(10000L);
+    delay(5000L);
+    return init(pin);
+}
+
+bool TinyGsmSim7000::poweroff() {
+    sendAT(GF("+CPOWD=1"));
+    return waitResponse(GF("NORMAL POWER DOWN")) == 1;
+}
+
+String TinyGsmSim7000::getModemInfo() {
+    sendAT(GF("I"));
+    String response;
+    if (waitResponse(1000L, response) != 1) {
+        return "";
+    }
+    response.replace("\r\nOK\r\n", "");
+    response.replace("\r\n", " ");
+    response.trim();
+    return response;
+}
+
+// ===================================================================
+// --- Rede ---
+// ===================================================================
+
+int TinyGsmSim7000::registration_status_xreg(const char* command) {
+    sendAT('+', command, '?');
+    String prefix = String(GSM_NL "+") + command + ":";
+    if (waitResponse(GFP(prefix.c_str())) != 1) {
+        return REG_NO_RESULT;
+    }
+    stream_skip_until(',');
+    int status = stream_get_int_before('\n');
+    waitResponse();
+    return status;
+}
+
+RegStatus TinyGsmSim7000::getRegistrationStatus() {
+    RegStatus eps = (RegStatus)registration_status_xreg("CEREG");
+    if (eps == REG_OK_HOME || eps == REG_OK_ROAMING) {
+        return eps;
+    }
+    return (RegStatus)registration_status_xreg("CGREG");
+}
+
+bool TinyGsmSim7000::isNetworkConnected() {
+    RegStatus status = getRegistrationStatus();
+    return status == REG_OK_HOME || status == REG_OK_ROAMING;
+}
+
+bool TinyGsmSim7000::waitForNetwork(uint32_t timeout_ms, bool check_signal) {
+    for (unsigned long start = millis(); millis() - start < timeout_ms;) {
+        if (check_signal) {
+            getSignalQuality();
+        }
+        if (isNetworkConnected()) {
+            return true;
+        }
+        delay(250);
+    }
+    return false;
+}
+
+int16_t TinyGsmSim7000::getSignalQuality() {
+    sendAT(GF("+CSQ"));
+    if (waitResponse(GF(GSM_NL "+CSQ:")) != 1) {
+        return 99;
+    }
+    int csq = stream_get_int_before(',');
+    waitResponse();
+    return (int16_t)csq;
+}
+
+bool TinyGsmSim7000::gprsConnect(const char* apn, const char* user, const char* pwd) {
+    (void)user;
+    (void)pwd;
+    gprsDisconnect();
+
+    sendAT(GF("+CGDCONT=1,\"IP\",\""), apn, '"');
+    waitResponse();
+
+    sendAT(GF("+CGATT=1"));
+    if (waitResponse(60000L) != 1) {
+        return false;
+    }
+
+    sendAT(GF("+CNCFG=1,\""), apn, '"');
+    waitResponse();
+
+    sendAT(GF("+CNACT=1,\""), apn, '"');
+    return waitResponse(60000L, GF(GSM_NL "+APP PDP: ACTIVE"), GF(GSM_NL "+APP PDP: DEACTIVE")) == 1;
+}
+
+bool TinyGsmSim7000::gprsDisconnect() {
+    sendAT(GF("+CNACT=0"));
+    return waitResponse(60000L) == 1;
+}
+
+bool TinyGsmSim7000::isGprsConnected() {
+    sendAT(GF("+CNACT?"));
+    if (waitResponse(GF(GSM_NL "+CNACT:")) != 1) {
+        return false;
+    }
+    int status = stream_get_int_before(',');
+    waitResponse();
+    return status == 1;
+}
+
+String TinyGsmSim7000::getLocalIP() {
+    sendAT(GF("+CNACT?"));
+    if (waitResponse(GF(GSM_NL "+CNACT:")) != 1) {
+        return "";
+    }
+    stream_skip_until('"');
+    String ip = stream.readStringUntil('"');
+    waitResponse();
+    return ip;
+}
+
+// ===================================================================
+// --- Hora ---
+// ===================================================================
+
+byte TinyGsmSim7000::NTPServerSync(String server, byte TimeZone) {
+    sendAT(GF("+CNTPCID=1"));
+    waitResponse(10000L);
+
+    sendAT(GF("+CNTP=\""), server, "\",", String(TimeZone));
+    if (waitResponse(10000L) != 1) {
+        return -1;
+    }
+
+    sendAT(GF("+CNTP"));
+    if (waitResponse(10000L, GF("+CNTP:")) == 1) {
+        String result = stream.readStringUntil('\n');
+        result.trim();
+        return (byte)result.toInt();
+    }
+    return -1;
+}
+
+bool TinyGsmSim7000::getNetworkTime(int* year, int* month, int* day, int* hour, int* minute, int* second,
+                                    float* timezone) {
+    sendAT(GF("+CCLK?"));
+    if (waitResponse(2000L, GF("+CCLK: \"")) != 1) {
+        return false;
+    }
+    int iyear = stream_get_int_before('/');
+    int imonth = stream_get_int_before('/');
+    int iday = stream_get_int_before(',');
+    int ihour = stream_get_int_before(':');
+    int imin = stream_get_int_before(':');
+    char sec_text[3] = {0, 0, 0};
+    stream.readBytes(sec_text, 2);
+    int isec = atoi(sec_text);
+    int sign = stream.read();
+    int itz = stream_get_int_before('"');
+    if (sign == '-') {
+        itz = -itz;
+    }
+    stream_skip_until('\n');
+    if (iyear < 2000) {
+        iyear += 2000;
+    }
+
+    if (year != nullptr) *year = iyear;
+    if (month != nullptr) *month = imonth;
+    if (day != nullptr) *day = iday;
+    if (hour != nullptr) *hour = ihour;
+    if (minute != nullptr) *minute = imin;
+    if (second != nullptr) *second = isec;
+    if (timezone != nullptr) *timezone = (float)itz / 4.0f;
+
+    waitResponse();
+    return true;
+}
+
+// ===================================================================
+// --- GNSS ---
+// ===================================================================
+
+bool TinyGsmSim7000::enableGPS() {
+    sendAT(GF("+CGNSPWR=1"));
+    return waitResponse() == 1;
+}
+
+bool TinyGsmSim7000::disableGPS() {
+    sendAT(GF("+CGNSPWR=0"));
+    return waitResponse() == 1;
+}
+
+bool TinyGsmSim7000::getGPS(float* lat, float* lon, float* speed, float* alt, int* vsat, int* usat,
+                            float* accuracy, int* year, int* month, int* day, int* hour, int* minute,
+                            int* second) {
+    sendAT(GF("+CGNSINF"));
+    if (waitResponse(10000L, GF(GSM_NL "+CGNSINF:")) != 1) {
+        return false;
+    }
+
+    stream_skip_until(',');              // GNSS run status
+    if (stream_get_int_before(',') != 1) {
+        stream_skip_until('\n');         // Linha de vírgulas (sem fix)
+        waitResponse();
+        return false;
+    }
+
+    char utc[20] = {0};
+    stream.readBytesUntil(',', utc, sizeof(utc) - 1);
+    float ilat = stream_get_float_before(',');
+    float ilon = stream_get_float_before(',');
+    float ialt = stream_get_float_before(',');
+    float ispeed = stream_get_float_before(',');
+    stream_skip_until(',');              // Course over ground
+    stream_skip_until(',');              // Fix mode
+    stream_skip_until(',');              // Reservado
+    float ihdop = stream_get_float_before(',');
+    stream_skip_until(',');              // PDOP
+    stream_skip_until(',');              // VDOP
+    stream_skip_until(',');              // Reservado
+    int ivsat = stream_get_int_before(',');
+    int iusat = stream_get_int_before(',');
+    stream_skip_until('\n');
+
+    if (lat != nullptr) *lat = ilat;
+    if (lon != nullptr) *lon = ilon;
+    if (speed != nullptr) *speed = ispeed;
+    if (alt != nullptr) *alt = ialt;
+    if (vsat != nullptr) *vsat = ivsat;
+    if (usat != nullptr) *usat = iusat;
+    if (accuracy != nullptr) *accuracy = ihdop;
+
+    int fields[6] = {0};
+    sscanf(utc, "%4d%2d%2d%2d%2d%2d", &fields[0], &fields[1], &fields[2], &fields[3], &fields[4], &fields[5]);
+    if (year != nullptr) *year = fields[0];
+    if (month != nullptr) *month = fields[1];
+    if (day != nullptr) *day = fields[2];
+    if (hour != nullptr) *hour = fields[3];
+    if (minute != nullptr) *minute = fields[4];
+    if (second != nullptr) *second = fields[5];
+
+    waitResponse();
+    return true;
+}
+
+// ===================================================================
+// --- Cliente TCP ---
+// ===================================================================
+
+int TinyGsmSim7000::GsmClientSim7000::connect(const char* host, uint16_t port, int timeout_s) {
+    (void)timeout_s;
+    stop();
+    return sim_sim7000_socket_open(_mux, host, port) ? 1 : 0;
+}
+
+size_t TinyGsmSim7000::GsmClientSim7000::write(const uint8_t* buf, size_t size) {
+    return sim_sim7000_socket_send(_mux, buf, size);
+}
+
+int TinyGsmSim7000::GsmClientSim7000::available() {
+    return (int)sim_sim7000_socket_available(_mux);
+}
+
+int TinyGsmSim7000::GsmClientSim7000::read(uint8_t* buf, size_t size) {
+    return sim_sim7000_socket_read(_mux, buf, size);
+}
+
+int TinyGsmSim7000::GsmClientSim7000::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+void TinyGsmSim7000::GsmClientSim7000::stop() {
+    sim_sim7000_socket_close(_mux);
+}
+
+uint8_t TinyGsmSim7000::GsmClientSim7000::connected() {
+    return sim_sim7000_socket_connected(_mux) ? 1 : 0;
+}
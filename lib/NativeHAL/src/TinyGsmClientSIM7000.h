@@ -0,0 +1,145 @@
+#ifndef NATIVE_HAL_TINYGSMCLIENTSIM7000_H
+#define NATIVE_HAL_TINYGSMCLIENTSIM7000_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+/**
+ * Substituto do TinyGSM (SIM7000) para o build nativo.
+ *
+ * Mantém a API usada pelo firmware e conversa com o modem simulado pelos
+ * mesmos comandos AT da biblioteca real (sendAT/waitResponse na Serial1),
+ * então timeouts, URCs e respostas roteirizadas se comportam como no
+ * hardware. O plano de dados dos sockets é servido diretamente pelo modem
+ * simulado (sim/sim_sim7000.h), com o custo do AT+CASEND/AT+CARECV.
+ */
+
+#define GSM_NL "\r\n"
+#define GF(x) F(x)
+#define GFP(x) (reinterpret_cast<GsmConstStr>(x))
+
+typedef const __FlashStringHelper* GsmConstStr;
+
+static const char GSM_OK[] = "OK" GSM_NL;
+static const char GSM_ERROR[] = "ERROR" GSM_NL;
+static const char GSM_CME_ERROR[] = GSM_NL "+CME ERROR:";
+static const char GSM_CMS_ERROR[] = GSM_NL "+CMS ERROR:";
+
+enum RegStatus {
+    REG_NO_RESULT = -1,
+    REG_UNREGISTERED = 0,
+    REG_SEARCHING = 2,
+    REG_DENIED = 3,
+    REG_OK_HOME = 1,
+    REG_OK_ROAMING = 5,
+    REG_UNKNOWN = 4,
+};
+
+class TinyGsmSim7000 {
+public:
+    class GsmClientSim7000 : public Client {
+    public:
+        GsmClientSim7000() {}
+        explicit GsmClientSim7000(TinyGsmSim7000& modem, uint8_t mux = 0) { init(&modem, mux); }
+
+        bool init(TinyGsmSim7000* modem, uint8_t mux = 0) {
+            _at = modem;
+            _mux = mux;
+            return true;
+        }
+
+        int connect(const char* host, uint16_t port, int timeout_s);
+        int connect(const char* host, uint16_t port) override { return connect(host, port, 75); }
+        int connect(IPAddress ip, uint16_t port) override { return connect(ip.toString().c_str(), port); }
+        size_t write(const uint8_t* buf, size_t size) override;
+        size_t write(uint8_t c) override { return write(&c, 1); }
+        using Print::write;
+        int available() override;
+        int read(uint8_t* buf, size_t size) override;
+        int read() override;
+        int peek() override { return -1; }
+        void flush() override {}
+        void stop() override;
+        void stop(uint32_t maxWaitMs) { (void)maxWaitMs; stop(); }
+        uint8_t connected() override;
+        operator bool() override { return connected(); }
+
+    private:
+        TinyGsmSim7000* _at = nullptr;
+        uint8_t _mux = 0;
+    };
+
+    explicit TinyGsmSim7000(Stream& stream) : stream(stream) {}
+
+    // --- Ciclo de vida ---
+    bool begin(const char* pin = nullptr) { return init(pin); }
+    bool init(const char* pin = nullptr);
+    bool restart(const char* pin = nullptr);
+    bool poweroff();
+    bool testAT(uint32_t timeout_ms = 10000L);
+    String getModemInfo();
+
+    // --- Rede ---
+    RegStatus getRegistrationStatus();
+    bool isNetworkConnected();
+    bool waitForNetwork(uint32_t timeout_ms = 60000L, bool check_signal = false);
+    int16_t getSignalQuality();
+    bool gprsConnect(const char* apn, const char* user = nullptr, const char* pwd = nullptr);
+    bool gprsDisconnect();
+    bool isGprsConnected();
+    String getLocalIP();
+    IPAddress localIP() { IPAddress ip; ip.fromString(getLocalIP()); return ip; }
+
+    // --- Hora ---
+    byte NTPServerSync(String server = "pool.ntp.org", byte TimeZone = 0);
+    bool getNetworkTime(int* year, int* month, int* day, int* hour, int* minute, int* second, float* timezone);
+
+    // --- GNSS ---
+    bool enableGPS();
+    bool disableGPS();
+    bool getGPS(float* lat, float* lon, float* speed = 0, float* alt = 0, int* vsat = 0, int* usat = 0,
+                float* accuracy = 0, int* year = 0, int* month = 0, int* day = 0, int* hour = 0,
+                int* minute = 0, int* second = 0);
+
+    // --- AT ---
+    template <typename... Args>
+    void sendAT(Args... cmd) {
+        stream_write("AT", cmd..., GSM_NL);
+        stream.flush();
+    }
+
+    int8_t waitResponse(uint32_t timeout_ms, String& data, GsmConstStr r1 = GFP(GSM_OK),
+                        GsmConstStr r2 = GFP(GSM_ERROR), GsmConstStr r3 = GFP(GSM_CME_ERROR),
+                        GsmConstStr r4 = GFP(GSM_CMS_ERROR), GsmConstStr r5 = nullptr);
+    int8_t waitResponse(uint32_t timeout_ms, GsmConstStr r1 = GFP(GSM_OK), GsmConstStr r2 = GFP(GSM_ERROR),
+                        GsmConstStr r3 = GFP(GSM_CME_ERROR), GsmConstStr r4 = GFP(GSM_CMS_ERROR),
+                        GsmConstStr r5 = nullptr) {
+        String data;
+        return waitResponse(timeout_ms, data, r1, r2, r3, r4, r5);
+    }
+    int8_t waitResponse(GsmConstStr r1 = GFP(GSM_OK), GsmConstStr r2 = GFP(GSM_ERROR),
+                        GsmConstStr r3 = GFP(GSM_CME_ERROR), GsmConstStr r4 = GFP(GSM_CMS_ERROR),
+                        GsmConstStr r5 = nullptr) {
+        return waitResponse(1000, r1, r2, r3, r4, r5);
+    }
+
+    Stream& stream;
+
+private:
+    template <typename T>
+    void stream_write(T last) {
+        stream.print(last);
+    }
+    template <typename T, typename... Args>
+    void stream_write(T head, Args... tail) {
+        stream.print(head);
+        stream_write(tail...);
+    }
+
+    int stream_get_int_before(char terminator);
+    float stream_get_float_before(char terminator);
+    bool stream_skip_until(char terminator, uint32_t timeout_ms = 1000L);
+    int registration_status_xreg(const char* command);
+};
+
+#endif // NATIVE_HAL_TINYGSMCLIENTSIM7000_H
@@ -0,0 +1,168 @@
+#include "WString.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief (Função Privada) Converte um inteiro sem sinal para a base pedida.
+ */
+static std::string to_base(unsigned long long value, unsigned char base) {
+    if (base < 2 || base > 36) {
+        base = 10;
+    }
+    char buf[66];
+    int pos = sizeof(buf) - 1;
+    buf[pos] = '\0';
+    do {
+        unsigned digit = (unsigned)(value % base);
+        buf[--pos] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= base;
+    } while (value != 0);
+    return std::string(&buf[pos]);
+}
+
+static std::string signed_to_base(long long value, unsigned char base) {
+    if (value < 0 && base == 10) {
+        return "-" + to_base((unsigned long long)(-(value + 1)) + 1, base);
+    }
+    return to_base((unsigned long long)value, base);
+}
+
+static std::string float_to_string(double value, unsigned int decimal_places) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimal_places, value);
+    return std::string(buf);
+}
+
+String::String(unsigned char value, unsigned char base) : _s(to_base(value, base)) {}
+String::String(int value, unsigned char base) : _s(signed_to_base(value, base)) {}
+String::String(unsigned int value, unsigned char base) : _s(to_base(value, base)) {}
+String::String(long value, unsigned char base) : _s(signed_to_base(value, base)) {}
+String::String(unsigned long value, unsigned char base) : _s(to_base(value, base)) {}
+String::String(long long value, unsigned char base) : _s(signed_to_base(value, base)) {}
+String::String(unsigned long long value, unsigned char base) : _s(to_base(value, base)) {}
+String::String(float value, unsigned int decimal_places) : _s(float_to_string(value, decimal_places)) {}
+String::String(double value, unsigned int decimal_places) : _s(float_to_string(value, decimal_places)) {}
+
+bool String::equalsIgnoreCase(const String& str) const {
+    if (_s.size() != str._s.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < _s.size(); i++) {
+        if (tolower((unsigned char)_s[i]) != tolower((unsigned char)str._s[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool String::endsWith(const String& suffix) const {
+    return _s.size() >= suffix._s.size() &&
+           _s.compare(_s.size() - suffix._s.size(), suffix._s.size(), suffix._s) == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t pos = _s.find(c, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& str, unsigned int from) const {
+    size_t pos = _s.find(str._s, from);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const {
+    size_t pos = _s.rfind(c);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String& str) const {
+    size_t pos = _s.rfind(str._s);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int begin) const {
+    return substring(begin, length());
+}
+
+String String::substring(unsigned int begin, unsigned int end) const {
+    if (begin > end) {
+        unsigned int tmp = begin;
+        begin = end;
+        end = tmp;
+    }
+    if (begin >= _s.size()) {
+        return String();
+    }
+    if (end > _s.size()) {
+        end = (unsigned int)_s.size();
+    }
+    return String(_s.substr(begin, end - begin));
+}
+
+void String::replace(char find, char replace) {
+    for (char& c : _s) {
+        if (c == find) {
+            c = replace;
+        }
+    }
+}
+
+void String::replace(const String& find, const String& replace) {
+    if (find._s.empty()) {
+        return;
+    }
+    size_t pos = 0;
+    while ((pos = _s.find(find._s, pos)) != std::string::npos) {
+        _s.replace(pos, find._s.size(), replace._s);
+        pos += replace._s.size();
+    }
+}
+
+void String::remove(unsigned int index) {
+    if (index < _s.size()) {
+        _s.erase(index);
+    }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+    if (index < _s.size()) {
+        _s.erase(index, count);
+    }
+}
+
+void String::toLowerCase() {
+    for (char& c : _s) {
+        c = (char)tolower((unsigned char)c);
+    }
+}
+
+void String::toUpperCase() {
+    for (char& c : _s) {
+        c = (char)toupper((unsigned char)c);
+    }
+}
+
+void String::trim() {
+    size_t begin = 0;
+    while (begin < _s.size() && isspace((unsigned char)_s[begin])) {
+        begin++;
+    }
+    size_t end = _s.size();
+    while (end > begin && isspace((unsigned char)_s[end - 1])) {
+        end--;
+    }
+    _s = _s.substr(begin, end - begin);
+}
+
+long String::toInt() const {
+    return strtol(_s.c_str(), NULL, 10);
+}
+
+float String::toFloat() const {
+    return (float)strtod(_s.c_str(), NULL);
+}
+
+double String::toDouble() const {
+    return strtod(_s.c_str(), NULL);
+}
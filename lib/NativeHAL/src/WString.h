@@ -0,0 +1,100 @@
+#ifndef NATIVE_HAL_WSTRING_H
+#define NATIVE_HAL_WSTRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+// Equivalente da macro F() do núcleo Arduino: no host não há PROGMEM,
+// então a "string em flash" é um ponteiro comum reinterpretado.
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+#define FPSTR(pstr_pointer) (reinterpret_cast<const __FlashStringHelper*>(pstr_pointer))
+
+/**
+ * @brief Subconjunto da classe String do Arduino, sobre std::string.
+ *
+ * Cobre a API usada pelo firmware e pelas bibliotecas (PubSubClient,
+ * ArduinoJson): construtores numéricos, busca, recorte e concatenação.
+ */
+class String {
+public:
+    String() {}
+    String(const char* cstr) : _s(cstr ? cstr : "") {}
+    String(const char* cstr, size_t length) : _s(cstr ? std::string(cstr, length) : std::string()) {}
+    String(const __FlashStringHelper* str) : _s(str ? reinterpret_cast<const char*>(str) : "") {}
+    String(const std::string& str) : _s(str) {}
+    explicit String(char c) : _s(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(long long value, unsigned char base = 10);
+    explicit String(unsigned long long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimal_places = 2);
+    explicit String(double value, unsigned int decimal_places = 2);
+
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    bool isEmpty() const { return _s.empty(); }
+    const char* c_str() const { return _s.c_str(); }
+    void reserve(unsigned int size) { _s.reserve(size); }
+
+    bool concat(const String& str) { _s += str._s; return true; }
+    bool concat(const char* cstr) { if (cstr) _s += cstr; return true; }
+    bool concat(const char* cstr, unsigned int length) { if (cstr) _s.append(cstr, length); return true; }
+    bool concat(char c) { _s += c; return true; }
+    template <typename T> bool concat(T value) { return concat(String(value)); }
+
+    String& operator=(const char* cstr) { _s = cstr ? cstr : ""; return *this; }
+    String& operator+=(const String& str) { concat(str); return *this; }
+    String& operator+=(const char* cstr) { concat(cstr); return *this; }
+    String& operator+=(char c) { concat(c); return *this; }
+    template <typename T> String& operator+=(T value) { concat(value); return *this; }
+
+    friend String operator+(const String& lhs, const String& rhs) { return String(lhs._s + rhs._s); }
+    friend String operator+(const String& lhs, const char* rhs) { return String(lhs._s + (rhs ? rhs : "")); }
+    friend String operator+(const char* lhs, const String& rhs) { return String((lhs ? lhs : "") + rhs._s); }
+    friend String operator+(const String& lhs, char rhs) { return String(lhs._s + rhs); }
+
+    bool equals(const String& str) const { return _s == str._s; }
+    bool equals(const char* cstr) const { return _s == (cstr ? cstr : ""); }
+    bool equalsIgnoreCase(const String& str) const;
+    bool operator==(const String& rhs) const { return equals(rhs); }
+    bool operator==(const char* rhs) const { return equals(rhs); }
+    bool operator!=(const String& rhs) const { return !equals(rhs); }
+    bool operator!=(const char* rhs) const { return !equals(rhs); }
+    bool operator<(const String& rhs) const { return _s < rhs._s; }
+    int compareTo(const String& str) const { return _s.compare(str._s); }
+    bool startsWith(const String& prefix) const { return _s.compare(0, prefix._s.size(), prefix._s) == 0; }
+    bool endsWith(const String& suffix) const;
+
+    char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+    void setCharAt(unsigned int index, char c) { if (index < _s.size()) _s[index] = c; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char& operator[](unsigned int index) { return _s[index]; }
+
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const String& str, unsigned int from = 0) const;
+    int lastIndexOf(char c) const;
+    int lastIndexOf(const String& str) const;
+    String substring(unsigned int begin) const;
+    String substring(unsigned int begin, unsigned int end) const;
+
+    void replace(char find, char replace);
+    void replace(const String& find, const String& replace);
+    void remove(unsigned int index);
+    void remove(unsigned int index, unsigned int count);
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const;
+    float toFloat() const;
+    double toDouble() const;
+
+private:
+    std::string _s;
+};
+
+#endif // NATIVE_HAL_WSTRING_H
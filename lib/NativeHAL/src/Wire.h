@@ -0,0 +1,41 @@
+#ifndef NATIVE_HAL_WIRE_H
+#define NATIVE_HAL_WIRE_H
+
+#include "Arduino.h"
+
+/**
+ * @brief Barramento I2C. Os dispositivos simulados (ADS1115, SCD40) são
+ * servidos diretamente pelas bibliotecas substitutas, então aqui só fica a
+ * configuração do barramento (usada no custo de tempo das transações).
+ */
+class TwoWire {
+public:
+    explicit TwoWire(uint8_t bus_num) : _bus_num(bus_num) {}
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+        (void)sda;
+        (void)scl;
+        _frequency = frequency ? frequency : 100000;
+        _started = true;
+        return true;
+    }
+    bool end() { _started = false; return true; }
+    bool setClock(uint32_t frequency) { _frequency = frequency; return true; }
+    uint32_t getClock() const { return _frequency; }
+    bool started() const { return _started; }
+
+    /**
+     * @brief Duração (µs) de uma transação de 'bytes' bytes no barramento.
+     */
+    uint32_t transfer_time_us(size_t bytes) const { return (uint32_t)((bytes + 1) * 9ULL * 1000000ULL / _frequency); }
+
+private:
+    uint8_t _bus_num;
+    uint32_t _frequency = 100000;
+    bool _started = false;
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif // NATIVE_HAL_WIRE_H
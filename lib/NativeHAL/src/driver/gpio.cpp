@@ -0,0 +1,13 @@
+#include "gpio.h"
+#include "sim/sim_gpio.h"
+
+esp_err_t gpio_hold_en(gpio_num_t gpio_num) {
+    return (gpio_num >= 0 && gpio_num < SIM_GPIO_COUNT) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t gpio_hold_dis(gpio_num_t gpio_num) {
+    return (gpio_num >= 0 && gpio_num < SIM_GPIO_COUNT) ? ESP_OK : ESP_FAIL;
+}
+
+void gpio_deep_sleep_hold_en(void) {
+}
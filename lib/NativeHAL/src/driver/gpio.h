@@ -0,0 +1,17 @@
+#ifndef NATIVE_HAL_DRIVER_GPIO_H
+#define NATIVE_HAL_DRIVER_GPIO_H
+
+#include "esp_sleep.h" // esp_err_t
+
+typedef int gpio_num_t;
+
+/*
+ * Retenção do nível de saída (gpio_hold_en) durante o deep sleep. No build
+ * nativo o pino já mantém o último nível escrito enquanto o ESP32 dorme, e
+ * todo boot do simulador começa com os pinos zerados: as funções só validam.
+ */
+esp_err_t gpio_hold_en(gpio_num_t gpio_num);
+esp_err_t gpio_hold_dis(gpio_num_t gpio_num);
+void gpio_deep_sleep_hold_en(void);
+
+#endif // NATIVE_HAL_DRIVER_GPIO_H
@@ -0,0 +1,106 @@
+#include "mcpwm.h"
+#include "hal/mcpwm_ll.h"
+#include "Arduino.h"
+#include "sim/sim_gpio.h"
+#include "sim/sim_kernel.h"
+
+#define CAPTURE_CHANNELS 3
+
+struct CaptureChannel {
+    int gpio = -1;
+    bool enabled = false;
+    mcpwm_capture_config_t config = {};
+    uint32_t value = 0; // Última captura
+};
+
+static CaptureChannel g_channels[MCPWM_UNIT_MAX][CAPTURE_CHANNELS];
+
+// Só o endereço importa: identifica a unidade
+struct mcpwm_dev_t {
+    mcpwm_unit_t unit;
+};
+
+mcpwm_dev_t MCPWM0 = {MCPWM_UNIT_0};
+mcpwm_dev_t MCPWM1 = {MCPWM_UNIT_1};
+
+/**
+ * @brief (Função Privada) Contador livre de 32 bits no clock APB (volta a cada ~53,7 s).
+ */
+static uint32_t capture_counter() {
+    return (uint32_t)(sim_now_us() * (MCPWM_CAPTURE_CLK_HZ / 1000000UL));
+}
+
+/**
+ * @brief (Função Privada) Borda no pino roteado para um canal de captura.
+ */
+static void on_edge(mcpwm_unit_t unit, int channel, int level) {
+    CaptureChannel& ch = g_channels[unit][channel];
+    if (!ch.enabled || ch.config.capture_cb == nullptr) {
+        return;
+    }
+    mcpwm_capture_on_edge_t edge = (level == HIGH) ? MCPWM_POS_EDGE : MCPWM_NEG_EDGE;
+    if ((ch.config.cap_edge & edge) == 0) {
+        return;
+    }
+    // cap_prescale (divisor de bordas da entrada) não é simulado: só 1.
+    ch.value = capture_counter();
+    cap_event_data_t event = {edge, ch.value};
+    ch.config.capture_cb(unit, (mcpwm_capture_channel_id_t)channel, &event, ch.config.user_data);
+}
+
+esp_err_t mcpwm_gpio_init(mcpwm_unit_t mcpwm_num, mcpwm_io_signals_t io_signal, int gpio_num) {
+    if (mcpwm_num >= MCPWM_UNIT_MAX || io_signal < MCPWM_CAP_0 || io_signal > MCPWM_CAP_2 ||
+        gpio_num < 0 || gpio_num >= SIM_GPIO_COUNT) {
+        return ESP_FAIL;
+    }
+    int channel = io_signal - MCPWM_CAP_0;
+    CaptureChannel& ch = g_channels[mcpwm_num][channel];
+    if (ch.gpio != gpio_num) {
+        ch.gpio = gpio_num;
+        sim_gpio_watch_input((uint8_t)gpio_num, [mcpwm_num, channel, gpio_num](int level) {
+            // Ignora o observador se o canal foi roteado para outro pino depois
+            if (g_channels[mcpwm_num][channel].gpio == gpio_num) {
+                on_edge(mcpwm_num, channel, level);
+            }
+        });
+    }
+    return ESP_OK;
+}
+
+esp_err_t mcpwm_capture_enable_channel(mcpwm_unit_t mcpwm_num, mcpwm_capture_channel_id_t cap_channel,
+                                       const mcpwm_capture_config_t* cap_conf) {
+    if (mcpwm_num >= MCPWM_UNIT_MAX || cap_channel > MCPWM_SELECT_CAP2 || cap_conf == nullptr) {
+        return ESP_FAIL;
+    }
+    CaptureChannel& ch = g_channels[mcpwm_num][cap_channel];
+    ch.config = *cap_conf;
+    ch.enabled = true;
+    return ESP_OK;
+}
+
+esp_err_t mcpwm_capture_disable_channel(mcpwm_unit_t mcpwm_num, mcpwm_capture_channel_id_t cap_channel) {
+    if (mcpwm_num >= MCPWM_UNIT_MAX || cap_channel > MCPWM_SELECT_CAP2) {
+        return ESP_FAIL;
+    }
+    g_channels[mcpwm_num][cap_channel].enabled = false;
+    return ESP_OK;
+}
+
+uint32_t mcpwm_capture_signal_get_value(mcpwm_unit_t mcpwm_num, mcpwm_capture_channel_id_t cap_channel) {
+    if (mcpwm_num >= MCPWM_UNIT_MAX || cap_channel > MCPWM_SELECT_CAP2) {
+        return 0;
+    }
+    return g_channels[mcpwm_num][cap_channel].value;
+}
+
+void mcpwm_ll_trigger_soft_capture(mcpwm_dev_t* mcpwm, int channel) {
+    if (mcpwm == nullptr || channel < 0 || channel >= CAPTURE_CHANNELS) {
+        return;
+    }
+    // Só trava se o canal estiver habilitado. O callback não é simulado aqui:
+    // o único uso é o CAP2, que não tem callback.
+    CaptureChannel& ch = g_channels[mcpwm->unit][channel];
+    if (ch.enabled) {
+        ch.value = capture_counter();
+    }
+}
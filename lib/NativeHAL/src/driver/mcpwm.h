@@ -0,0 +1,60 @@
+#ifndef NATIVE_HAL_DRIVER_MCPWM_H
+#define NATIVE_HAL_DRIVER_MCPWM_H
+
+#include <stdint.h>
+#include "esp_sleep.h" // esp_err_t
+
+/*
+ * Subconjunto da API legada de captura do MCPWM (ESP-IDF 4.4, driver/mcpwm.h).
+ * No build nativo a captura observa o pino simulado e entrega o instante
+ * exato da borda no relógio de 80 MHz (APB), como o latch do hardware.
+ */
+
+#define MCPWM_CAPTURE_CLK_HZ 80000000UL
+
+typedef enum {
+    MCPWM_UNIT_0 = 0,
+    MCPWM_UNIT_1,
+    MCPWM_UNIT_MAX,
+} mcpwm_unit_t;
+
+typedef enum {
+    MCPWM_CAP_0 = 0,
+    MCPWM_CAP_1,
+    MCPWM_CAP_2,
+} mcpwm_io_signals_t;
+
+typedef enum {
+    MCPWM_SELECT_CAP0 = 0,
+    MCPWM_SELECT_CAP1,
+    MCPWM_SELECT_CAP2,
+} mcpwm_capture_channel_id_t;
+
+typedef enum {
+    MCPWM_NEG_EDGE = 1 << 0,
+    MCPWM_POS_EDGE = 1 << 1,
+    MCPWM_BOTH_EDGE = MCPWM_NEG_EDGE | MCPWM_POS_EDGE,
+} mcpwm_capture_on_edge_t;
+
+typedef struct {
+    mcpwm_capture_on_edge_t cap_edge; // Borda que gerou esta captura
+    uint32_t cap_value;               // Contador de captura (APB) no instante da borda
+} cap_event_data_t;
+
+typedef bool (*cap_isr_cb_t)(mcpwm_unit_t mcpwm, mcpwm_capture_channel_id_t cap_channel,
+                             const cap_event_data_t* edata, void* user_data);
+
+typedef struct {
+    mcpwm_capture_on_edge_t cap_edge;
+    uint32_t cap_prescale;
+    cap_isr_cb_t capture_cb;
+    void* user_data;
+} mcpwm_capture_config_t;
+
+esp_err_t mcpwm_gpio_init(mcpwm_unit_t mcpwm_num, mcpwm_io_signals_t io_signal, int gpio_num);
+esp_err_t mcpwm_capture_enable_channel(mcpwm_unit_t mcpwm_num, mcpwm_capture_channel_id_t cap_channel,
+                                       const mcpwm_capture_config_t* cap_conf);
+esp_err_t mcpwm_capture_disable_channel(mcpwm_unit_t mcpwm_num, mcpwm_capture_channel_id_t cap_channel);
+uint32_t mcpwm_capture_signal_get_value(mcpwm_unit_t mcpwm_num, mcpwm_capture_channel_id_t cap_channel);
+
+#endif // NATIVE_HAL_DRIVER_MCPWM_H
@@ -0,0 +1,32 @@
+#include "rtc_io.h"
+
+// RTC_GPIOn -> GPIO do ESP32 (datasheet, tabela "RTC_MUX Pin Summary")
+static const int RTC_IO_TO_GPIO[] = {36, 37, 38, 39, 34, 35, 25, 26, 33, 32, 4, 0, 2, 15, 13, 12, 14, 27};
+
+#define RTC_IO_COUNT (int)(sizeof(RTC_IO_TO_GPIO) / sizeof(RTC_IO_TO_GPIO[0]))
+
+int rtc_io_number_get(gpio_num_t gpio_num) {
+    for (int i = 0; i < RTC_IO_COUNT; i++) {
+        if (RTC_IO_TO_GPIO[i] == gpio_num) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool rtc_gpio_is_valid_gpio(gpio_num_t gpio_num) {
+    return rtc_io_number_get(gpio_num) >= 0;
+}
+
+esp_err_t rtc_gpio_init(gpio_num_t gpio_num) {
+    return rtc_gpio_is_valid_gpio(gpio_num) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t rtc_gpio_deinit(gpio_num_t gpio_num) {
+    return rtc_gpio_is_valid_gpio(gpio_num) ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t rtc_gpio_set_direction(gpio_num_t gpio_num, rtc_gpio_mode_t mode) {
+    (void)mode;
+    return rtc_gpio_is_valid_gpio(gpio_num) ? ESP_OK : ESP_FAIL;
+}
@@ -0,0 +1,24 @@
+#ifndef NATIVE_HAL_DRIVER_RTC_IO_H
+#define NATIVE_HAL_DRIVER_RTC_IO_H
+
+#include "driver/gpio.h"
+
+typedef enum {
+    RTC_GPIO_MODE_INPUT_ONLY = 0,
+    RTC_GPIO_MODE_OUTPUT_ONLY,
+    RTC_GPIO_MODE_INPUT_OUTPUT,
+    RTC_GPIO_MODE_DISABLED,
+} rtc_gpio_mode_t;
+
+bool rtc_gpio_is_valid_gpio(gpio_num_t gpio_num);
+
+/**
+ * @brief Número do RTC GPIO (RTC_GPIOn) do pino, ou -1 se ele não tem função RTC.
+ */
+int rtc_io_number_get(gpio_num_t gpio_num);
+
+esp_err_t rtc_gpio_init(gpio_num_t gpio_num);
+esp_err_t rtc_gpio_deinit(gpio_num_t gpio_num);
+esp_err_t rtc_gpio_set_direction(gpio_num_t gpio_num, rtc_gpio_mode_t mode);
+
+#endif // NATIVE_HAL_DRIVER_RTC_IO_H
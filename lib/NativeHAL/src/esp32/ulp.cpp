@@ -0,0 +1,208 @@
+#include "ulp.h"
+#include "Arduino.h"
+#include "driver/rtc_io.h"
+#include "sim/sim_gpio.h"
+#include "sim/sim_kernel.h"
+#include "sim/sim_ulp.h"
+#include "soc/rtc_io_reg.h"
+
+#include <stdio.h>
+
+#define PROGRAM_MAX_INSNS 256
+#define MAX_STEPS_PER_RUN 100000
+
+SIM_PERSIST uint32_t sim_rtc_slow_mem[SIM_RTC_SLOW_MEM_WORDS];
+
+// Programa carregado, com os rótulos já resolvidos para índices. Fica na
+// seção persistente como se ocupasse a RTC slow memory.
+SIM_PERSIST static ulp_insn_t g_program[PROGRAM_MAX_INSNS];
+SIM_PERSIST static uint32_t g_program_addr = 0;
+SIM_PERSIST static uint32_t g_program_size = 0;
+SIM_PERSIST static uint32_t g_entry = 0;
+SIM_PERSIST static uint32_t g_period_us = 0;
+SIM_PERSIST static bool g_running = false;
+
+// Invalida a cadeia de ticks anterior quando ulp_run() é chamado de novo
+static uint32_t g_generation = 0;
+
+/**
+ * @brief (Função Privada) Leitura de um registrador de periférico pelo ULP.
+ */
+static uint32_t read_register(uint32_t reg) {
+    if (reg != RTC_GPIO_IN_REG) {
+        fprintf(stderr, "NativeSim: AVISO - ULP leu registrador não simulado 0x%08x.\n", (unsigned)reg);
+        return 0;
+    }
+    uint32_t value = 0;
+    for (int gpio = 0; gpio < SIM_GPIO_COUNT; gpio++) {
+        int rtc_io = rtc_io_number_get(gpio);
+        if (rtc_io >= 0 && sim_gpio_read((uint8_t)gpio) == HIGH) {
+            value |= 1UL << (RTC_GPIO_IN_NEXT_S + rtc_io);
+        }
+    }
+    return value;
+}
+
+/**
+ * @brief (Função Privada) Executa o programa a partir do ponto de entrada até I_HALT.
+ */
+static void run_program() {
+    uint16_t r[4] = {};
+    bool zero = false;
+    bool overflow = false;
+    uint32_t pc = g_entry - g_program_addr;
+
+    for (int steps = 0; steps < MAX_STEPS_PER_RUN; steps++) {
+        if (pc >= g_program_size) {
+            fprintf(stderr, "NativeSim: ERRO - ULP saiu do programa (pc = %u). Timer parado.\n", (unsigned)pc);
+            g_running = false;
+            return;
+        }
+        const ulp_insn_t& insn = g_program[pc];
+        uint32_t insn_addr = g_program_addr + pc;
+        pc++;
+        if (insn.op == SIM_ULP_OP_HALT) {
+            return;
+        }
+
+        bool is_alu = true;
+        int32_t alu = 0; // Resultado (sem truncar) das operações de ALU
+        switch (insn.op) {
+            case SIM_ULP_OP_MOVI: alu = (uint16_t)insn.imm; break;
+            case SIM_ULP_OP_MOVR: alu = r[insn.rs]; break;
+            case SIM_ULP_OP_ADDI: alu = (int32_t)r[insn.rs] + (uint16_t)insn.imm; break;
+            case SIM_ULP_OP_SUBI: alu = (int32_t)r[insn.rs] - (uint16_t)insn.imm; break;
+            case SIM_ULP_OP_ADDR: alu = (int32_t)r[insn.rs] + r[insn.rt]; break;
+            case SIM_ULP_OP_ANDI: alu = r[insn.rs] & (uint16_t)insn.imm; break;
+            default: is_alu = false; break;
+        }
+        if (is_alu) {
+            overflow = alu < 0 || alu > 0xffff;
+            r[insn.rd] = (uint16_t)alu;
+            zero = r[insn.rd] == 0;
+            continue;
+        }
+
+        switch (insn.op) {
+            case SIM_ULP_OP_LD: {
+                uint32_t addr = r[insn.rs] + insn.imm;
+                r[insn.rd] = addr < SIM_RTC_SLOW_MEM_WORDS ? (uint16_t)(sim_rtc_slow_mem[addr] & 0xffff) : 0;
+                break;
+            }
+            case SIM_ULP_OP_ST: {
+                // Como no ESP32: dado nos 16 bits baixos, endereço do ST nos bits 31:21
+                uint32_t addr = r[insn.rt] + insn.imm;
+                if (addr < SIM_RTC_SLOW_MEM_WORDS) {
+                    sim_rtc_slow_mem[addr] = ((insn_addr & 0x7ff) << 21) | r[insn.rs];
+                }
+                break;
+            }
+            case SIM_ULP_OP_RD_REG: {
+                uint32_t width = insn.high - insn.low + 1;
+                uint32_t mask = width >= 16 ? 0xffff : (1UL << width) - 1;
+                r[R0] = (uint16_t)((read_register(insn.reg) >> insn.low) & mask);
+                break;
+            }
+            case SIM_ULP_OP_BL:  if (r[R0] < (uint16_t)insn.imm) pc = insn.label; break;
+            case SIM_ULP_OP_BGE: if (r[R0] >= (uint16_t)insn.imm) pc = insn.label; break;
+            case SIM_ULP_OP_BX:  pc = insn.label; break;
+            case SIM_ULP_OP_BXZ: if (zero) pc = insn.label; break;
+            case SIM_ULP_OP_BXF: if (overflow) pc = insn.label; break;
+            default: break;
+        }
+    }
+    fprintf(stderr, "NativeSim: ERRO - ULP sem I_HALT após %d instruções. Timer parado.\n", MAX_STEPS_PER_RUN);
+    g_running = false;
+}
+
+/**
+ * @brief (Função Privada) Agenda a próxima execução do programa pelo timer do ULP.
+ */
+static void schedule_tick(uint64_t at_us, uint32_t generation) {
+    sim_schedule_us(at_us, [generation]() {
+        if (!g_running || generation != g_generation) {
+            return;
+        }
+        run_program();
+        schedule_tick(sim_now_us() + g_period_us, generation);
+    });
+}
+
+esp_err_t ulp_process_macros_and_load(uint32_t load_addr, const ulp_insn_t* program, size_t* psize) {
+    if (program == nullptr || psize == nullptr) {
+        return ESP_FAIL;
+    }
+    // 1ª passada: posição (em instruções reais) de cada rótulo
+    static const uint32_t MAX_LABELS = 64;
+    int32_t label_pos[MAX_LABELS];
+    for (uint32_t i = 0; i < MAX_LABELS; i++) {
+        label_pos[i] = -1;
+    }
+    uint32_t count = 0;
+    for (size_t i = 0; i < *psize; i++) {
+        if (program[i].op == SIM_ULP_OP_LABEL) {
+            if (program[i].label >= MAX_LABELS) {
+                return ESP_FAIL;
+            }
+            label_pos[program[i].label] = (int32_t)count;
+        } else {
+            count++;
+        }
+    }
+    if (count > PROGRAM_MAX_INSNS || load_addr + count > SIM_RTC_SLOW_MEM_WORDS) {
+        return ESP_FAIL;
+    }
+
+    // 2ª passada: copia sem os rótulos, trocando o número do rótulo pelo índice
+    uint32_t n = 0;
+    for (size_t i = 0; i < *psize; i++) {
+        ulp_insn_t insn = program[i];
+        if (insn.op == SIM_ULP_OP_LABEL) {
+            continue;
+        }
+        if (insn.op >= SIM_ULP_OP_BL) {
+            if (insn.label >= MAX_LABELS || label_pos[insn.label] < 0) {
+                fprintf(stderr, "NativeSim: ERRO - ULP: rótulo %u não definido.\n", (unsigned)insn.label);
+                return ESP_FAIL;
+            }
+            insn.label = (uint32_t)label_pos[insn.label];
+        }
+        g_program[n++] = insn;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        sim_rtc_slow_mem[load_addr + i] = 0; // Palavras ocupadas pelo código
+    }
+    g_program_addr = load_addr;
+    g_program_size = count;
+    *psize = count;
+    return ESP_OK;
+}
+
+esp_err_t ulp_set_wakeup_period(size_t period_index, uint32_t period_us) {
+    if (period_index != 0 || period_us == 0) {
+        return ESP_FAIL; // Só o período 0 é simulado
+    }
+    g_period_us = period_us;
+    return ESP_OK;
+}
+
+esp_err_t ulp_run(uint32_t entry_point) {
+    if (g_program_size == 0 || entry_point < g_program_addr || entry_point >= g_program_addr + g_program_size ||
+        g_period_us == 0) {
+        return ESP_FAIL;
+    }
+    g_entry = entry_point;
+    g_running = true;
+    schedule_tick(sim_now_us(), ++g_generation);
+    return ESP_OK;
+}
+
+void sim_ulp_boot() {
+    if (g_running) {
+        schedule_tick(sim_now_us() + g_period_us, ++g_generation);
+    }
+}
+
+bool sim_ulp_running() {
+    return g_running;
+}
@@ -0,0 +1,95 @@
+#ifndef NATIVE_HAL_ESP32_ULP_H
+#define NATIVE_HAL_ESP32_ULP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_sleep.h" // esp_err_t
+
+/*
+ * Subconjunto do montador por macros do coprocessador ULP (ESP-IDF 4.4,
+ * esp32/ulp.h). No build nativo cada macro gera uma instrução "simbólica"
+ * (não a codificação binária do ESP32) que sim_ulp interpreta com a mesma
+ * semântica: registradores R0-R3 de 16 bits, memória em palavras de 32 bits
+ * da RTC slow memory (I_ST grava nos 16 bits baixos) e flags de zero/overflow
+ * atualizadas só pelas operações de ALU.
+ *
+ * O programa roda a cada período do timer do ULP até I_HALT, inclusive com o
+ * ESP32 em deep sleep (os eventos dos periféricos simulados continuam).
+ */
+
+// RTC slow memory (8 KB), persistente entre despertares
+#define SIM_RTC_SLOW_MEM_WORDS 2048
+extern uint32_t sim_rtc_slow_mem[SIM_RTC_SLOW_MEM_WORDS];
+#define RTC_SLOW_MEM sim_rtc_slow_mem
+
+#define R0 0
+#define R1 1
+#define R2 2
+#define R3 3
+
+typedef enum {
+    SIM_ULP_OP_LABEL = 0,
+    SIM_ULP_OP_HALT,
+    SIM_ULP_OP_MOVI,   // rd = imm
+    SIM_ULP_OP_MOVR,   // rd = rs
+    SIM_ULP_OP_ADDI,   // rd = rs + imm
+    SIM_ULP_OP_SUBI,   // rd = rs - imm
+    SIM_ULP_OP_ADDR,   // rd = rs + rt
+    SIM_ULP_OP_ANDI,   // rd = rs & imm
+    SIM_ULP_OP_LD,     // rd = MEM[rs + imm] & 0xffff
+    SIM_ULP_OP_ST,     // MEM[rt + imm] = rs (16 bits baixos)
+    SIM_ULP_OP_RD_REG, // R0 = bits [low, high] do registrador 'reg'
+    SIM_ULP_OP_BL,     // salta para o rótulo se R0 < imm
+    SIM_ULP_OP_BGE,    // salta para o rótulo se R0 >= imm
+    SIM_ULP_OP_BX,     // salto incondicional
+    SIM_ULP_OP_BXZ,    // salta se a última operação de ALU deu zero
+    SIM_ULP_OP_BXF,    // salta se a última operação de ALU transbordou
+} sim_ulp_op_t;
+
+typedef struct {
+    uint8_t op;
+    uint8_t rd;
+    uint8_t rs;
+    uint8_t rt;
+    int32_t imm;
+    uint32_t label;
+    uint32_t reg;
+    uint8_t low;
+    uint8_t high;
+} ulp_insn_t;
+
+#define SIM_ULP_INSN(op_, rd_, rs_, rt_, imm_, label_, reg_, low_, high_) \
+    { (uint8_t)(op_), (uint8_t)(rd_), (uint8_t)(rs_), (uint8_t)(rt_), (int32_t)(imm_), (uint32_t)(label_), (uint32_t)(reg_), (uint8_t)(low_), (uint8_t)(high_) }
+
+#define M_LABEL(label_num)          SIM_ULP_INSN(SIM_ULP_OP_LABEL, 0, 0, 0, 0, label_num, 0, 0, 0)
+#define I_HALT()                    SIM_ULP_INSN(SIM_ULP_OP_HALT, 0, 0, 0, 0, 0, 0, 0, 0)
+#define I_MOVI(reg_dest, imm_)      SIM_ULP_INSN(SIM_ULP_OP_MOVI, reg_dest, 0, 0, imm_, 0, 0, 0, 0)
+#define I_MOVR(reg_dest, reg_src)   SIM_ULP_INSN(SIM_ULP_OP_MOVR, reg_dest, reg_src, 0, 0, 0, 0, 0, 0)
+#define I_ADDI(reg_dest, reg_src, imm_) SIM_ULP_INSN(SIM_ULP_OP_ADDI, reg_dest, reg_src, 0, imm_, 0, 0, 0, 0)
+#define I_SUBI(reg_dest, reg_src, imm_) SIM_ULP_INSN(SIM_ULP_OP_SUBI, reg_dest, reg_src, 0, imm_, 0, 0, 0, 0)
+#define I_ADDR(reg_dest, reg_src1, reg_src2) SIM_ULP_INSN(SIM_ULP_OP_ADDR, reg_dest, reg_src1, reg_src2, 0, 0, 0, 0, 0)
+#define I_ANDI(reg_dest, reg_src, imm_) SIM_ULP_INSN(SIM_ULP_OP_ANDI, reg_dest, reg_src, 0, imm_, 0, 0, 0, 0)
+#define I_LD(reg_dest, reg_addr, offset_) SIM_ULP_INSN(SIM_ULP_OP_LD, reg_dest, reg_addr, 0, offset_, 0, 0, 0, 0)
+#define I_ST(reg_val, reg_addr, offset_) SIM_ULP_INSN(SIM_ULP_OP_ST, 0, reg_val, reg_addr, offset_, 0, 0, 0, 0)
+#define I_RD_REG(reg, low_bit, high_bit) SIM_ULP_INSN(SIM_ULP_OP_RD_REG, 0, 0, 0, 0, 0, reg, low_bit, high_bit)
+#define M_BL(label_num, imm_value)  SIM_ULP_INSN(SIM_ULP_OP_BL, 0, 0, 0, imm_value, label_num, 0, 0, 0)
+#define M_BGE(label_num, imm_value) SIM_ULP_INSN(SIM_ULP_OP_BGE, 0, 0, 0, imm_value, label_num, 0, 0, 0)
+#define M_BX(label_num)             SIM_ULP_INSN(SIM_ULP_OP_BX, 0, 0, 0, 0, label_num, 0, 0, 0)
+#define M_BXZ(label_num)            SIM_ULP_INSN(SIM_ULP_OP_BXZ, 0, 0, 0, 0, label_num, 0, 0, 0)
+#define M_BXF(label_num)            SIM_ULP_INSN(SIM_ULP_OP_BXF, 0, 0, 0, 0, label_num, 0, 0, 0)
+
+/**
+ * @brief Resolve os rótulos e carrega o programa na RTC slow memory.
+ * @param load_addr Endereço (em palavras) do início do programa.
+ * @param psize Entrada: instruções em 'program'; saída: palavras ocupadas.
+ */
+esp_err_t ulp_process_macros_and_load(uint32_t load_addr, const ulp_insn_t* program, size_t* psize);
+
+/**
+ * @brief Arma o timer do ULP; o programa começa em 'entry_point' (palavras).
+ */
+esp_err_t ulp_run(uint32_t entry_point);
+
+esp_err_t ulp_set_wakeup_period(size_t period_index, uint32_t period_us);
+
+#endif // NATIVE_HAL_ESP32_ULP_H
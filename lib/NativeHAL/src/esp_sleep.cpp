@@ -0,0 +1,31 @@
+#include "esp_sleep.h"
+#include "sim/sim_system.h"
+
+static uint64_t g_timer_wakeup_us = 0;
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us) {
+    g_timer_wakeup_us = time_in_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_pd_config(esp_sleep_pd_domain_t domain, esp_sleep_pd_option_t option) {
+    (void)domain;
+    (void)option;
+    return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void) {
+    return sim_system_boot_reason() == SIM_BOOT_DEEP_SLEEP ? ESP_SLEEP_WAKEUP_TIMER : ESP_SLEEP_WAKEUP_UNDEFINED;
+}
+
+void esp_default_wake_deep_sleep(void) {
+}
+
+__attribute__((weak)) void esp_wake_deep_sleep(void) {
+    esp_default_wake_deep_sleep();
+}
+
+void esp_deep_sleep_start(void) {
+    // Sem fonte de despertar o ESP32 dormiria para sempre; aqui, um dia
+    sim_system_deep_sleep(g_timer_wakeup_us != 0 ? g_timer_wakeup_us : 86400ULL * 1000000ULL);
+}
@@ -0,0 +1,59 @@
+#ifndef NATIVE_HAL_ESP_SLEEP_H
+#define NATIVE_HAL_ESP_SLEEP_H
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+typedef enum {
+    ESP_PD_DOMAIN_RTC_PERIPH,
+    ESP_PD_DOMAIN_RTC_SLOW_MEM,
+    ESP_PD_DOMAIN_RTC_FAST_MEM,
+    ESP_PD_DOMAIN_XTAL,
+    ESP_PD_DOMAIN_MAX
+} esp_sleep_pd_domain_t;
+
+typedef enum {
+    ESP_PD_OPTION_OFF,
+    ESP_PD_OPTION_ON,
+    ESP_PD_OPTION_AUTO
+} esp_sleep_pd_option_t;
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_TOUCHPAD,
+    ESP_SLEEP_WAKEUP_ULP,
+    ESP_SLEEP_WAKEUP_GPIO,
+    ESP_SLEEP_WAKEUP_UART,
+} esp_sleep_wakeup_cause_t;
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+esp_err_t esp_sleep_pd_config(esp_sleep_pd_domain_t domain, esp_sleep_pd_option_t option);
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void);
+
+/**
+ * @brief Stub de despertar padrão da ROM. No build nativo não faz nada.
+ */
+void esp_default_wake_deep_sleep(void);
+
+/**
+ * @brief Stub de despertar: roda antes do bootloader ao sair do deep sleep.
+ * Definição fraca (chama esp_default_wake_deep_sleep()); o firmware pode
+ * substituí-la. No build nativo é chamada antes do setup() em todo despertar
+ * de deep sleep (ver sim/sim_system.cpp).
+ */
+void esp_wake_deep_sleep(void);
+
+/**
+ * @brief Entra em deep sleep: no build nativo encerra o despertar atual
+ * (ver sim/sim_system.h). Não retorna.
+ */
+[[noreturn]] void esp_deep_sleep_start(void);
+
+#endif // NATIVE_HAL_ESP_SLEEP_H
@@ -0,0 +1,31 @@
+#ifndef NATIVE_HAL_ESP_SYSTEM_H
+#define NATIVE_HAL_ESP_SYSTEM_H
+
+#include "sim/sim_system.h"
+
+typedef enum {
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC,
+    ESP_RST_INT_WDT,
+    ESP_RST_TASK_WDT,
+    ESP_RST_WDT,
+    ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT,
+    ESP_RST_SDIO,
+} esp_reset_reason_t;
+
+/**
+ * @brief Motivo do último reset, derivado do motivo de boot da simulação.
+ */
+static inline esp_reset_reason_t esp_reset_reason(void) {
+    switch (sim_system_boot_reason()) {
+        case SIM_BOOT_DEEP_SLEEP:     return ESP_RST_DEEPSLEEP;
+        case SIM_BOOT_SOFTWARE_RESET: return ESP_RST_SW;
+        default:                      return ESP_RST_POWERON;
+    }
+}
+
+#endif // NATIVE_HAL_ESP_SYSTEM_H
@@ -0,0 +1,140 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "event_groups.h"
+#include "semphr.h"
+#include "Arduino.h"
+
+// Passo de espera das primitivas bloqueantes: as tarefas são cooperativas,
+// então "bloquear" é dormir em passos de um tick até a condição valer.
+#define SIM_RTOS_POLL_US 1000ULL
+
+// Semáforos costumam ser liberados por ISRs com prazo curto (ex: conversão
+// pronta do ADC): a espera usa um passo menor para não somar um tick inteiro
+// de latência, que no ESP32 não existe (a ISR acorda a tarefa na hora).
+#define SIM_RTOS_SEMAPHORE_POLL_US 20ULL
+
+struct SimEventGroup {
+    EventBits_t bits;
+};
+
+struct SimSemaphore {
+    bool available;
+};
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task_code, const char* name, uint32_t stack_depth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* created_task,
+                                   BaseType_t core_id) {
+    (void)stack_depth;
+    (void)priority;
+    (void)core_id;
+    if (created_task != NULL) {
+        *created_task = NULL;
+    }
+    return sim_spawn_task(name, [task_code, parameters]() { task_code(parameters); }) ? pdPASS
+                                                                                    : errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task_code, const char* name, uint32_t stack_depth,
+                       void* parameters, UBaseType_t priority, TaskHandle_t* created_task) {
+    return xTaskCreatePinnedToCore(task_code, name, stack_depth, parameters, priority, created_task, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if (task == NULL) {
+        sim_exit_current_task();
+    }
+}
+
+void vTaskDelay(TickType_t ticks) {
+    sim_sleep_us((uint64_t)ticks * 1000ULL);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)millis();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    (void)task;
+    return 0;
+}
+
+EventGroupHandle_t xEventGroupCreate(void) {
+    return new SimEventGroup{0};
+}
+
+void vEventGroupDelete(EventGroupHandle_t group) {
+    delete group;
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    group->bits |= bits;
+    return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    EventBits_t previous = group->bits;
+    group->bits &= ~bits;
+    return previous;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits_to_wait, BaseType_t clear_on_exit,
+                                BaseType_t wait_for_all, TickType_t ticks_to_wait) {
+    uint64_t deadline = ticks_to_wait == portMAX_DELAY ? UINT64_MAX
+                                                       : sim_now_us() + (uint64_t)ticks_to_wait * 1000ULL;
+    for (;;) {
+        EventBits_t bits = group->bits;
+        bool satisfied = wait_for_all ? (bits & bits_to_wait) == bits_to_wait : (bits & bits_to_wait) != 0;
+        if (satisfied) {
+            if (clear_on_exit) {
+                group->bits &= ~bits_to_wait;
+            }
+            return bits;
+        }
+        if (sim_now_us() >= deadline) {
+            return bits;
+        }
+        sim_sleep_us(SIM_RTOS_POLL_US);
+    }
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return new SimSemaphore{false};
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+    delete semaphore;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    if (semaphore->available) {
+        return pdFALSE;
+    }
+    semaphore->available = true;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higher_priority_task_woken) {
+    if (higher_priority_task_woken != NULL) {
+        *higher_priority_task_woken = pdFALSE;
+    }
+    return xSemaphoreGive(semaphore);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait) {
+    uint64_t deadline = ticks_to_wait == portMAX_DELAY ? UINT64_MAX
+                                                       : sim_now_us() + (uint64_t)ticks_to_wait * 1000ULL;
+    for (;;) {
+        if (semaphore->available) {
+            semaphore->available = false;
+            return pdTRUE;
+        }
+        if (sim_now_us() >= deadline) {
+            return pdFALSE;
+        }
+        sim_sleep_us(SIM_RTOS_SEMAPHORE_POLL_US);
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef NATIVE_HAL_FREERTOS_SEMPHR_H
+#define NATIVE_HAL_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+typedef struct SimSemaphore* SemaphoreHandle_t;
+
+// Na simulação a "ISR" roda no contexto da tarefa que avança o relógio e não
+// há preempção: pedir a troca de contexto não tem efeito.
+#define portYIELD_FROM_ISR(...) ((void)0)
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* higher_priority_task_woken);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks_to_wait);
+
+#endif // NATIVE_HAL_FREERTOS_SEMPHR_H
@@ -0,0 +1,21 @@
+#ifndef NATIVE_HAL_HAL_MCPWM_LL_H
+#define NATIVE_HAL_HAL_MCPWM_LL_H
+
+#include <stdint.h>
+
+/*
+ * Subconjunto da camada LL do MCPWM (ESP-IDF 4.4, hal/mcpwm_ll.h).
+ * Só a captura por software, que o driver legado não expõe.
+ */
+
+typedef struct mcpwm_dev_t mcpwm_dev_t;
+
+extern mcpwm_dev_t MCPWM0;
+extern mcpwm_dev_t MCPWM1;
+
+#define MCPWM_LL_GET_HW(ID) (((ID) == 0) ? &MCPWM0 : &MCPWM1)
+
+// Trava o contador de captura no canal (lido depois com mcpwm_capture_signal_get_value())
+void mcpwm_ll_trigger_soft_capture(mcpwm_dev_t* mcpwm, int channel);
+
+#endif // NATIVE_HAL_HAL_MCPWM_LL_H
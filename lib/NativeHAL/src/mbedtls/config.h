@@ -0,0 +1,14 @@
+#ifndef NATIVE_HAL_MBEDTLS_CONFIG_H
+#define NATIVE_HAL_MBEDTLS_CONFIG_H
+
+/**
+ * Opções do mbedTLS simulado: as mesmas do ESP-IDF 4.4 relevantes ao firmware.
+ */
+#define MBEDTLS_PLATFORM_MEMORY
+#define MBEDTLS_SSL_SESSION_TICKETS
+#define MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+#define MBEDTLS_SSL_KEEP_PEER_CERTIFICATE
+#define MBEDTLS_SSL_IN_CONTENT_LEN 16384
+#define MBEDTLS_SSL_OUT_CONTENT_LEN 4096
+
+#endif // NATIVE_HAL_MBEDTLS_CONFIG_H
@@ -0,0 +1,16 @@
+#ifndef NATIVE_HAL_MBEDTLS_ERROR_H
+#define NATIVE_HAL_MBEDTLS_ERROR_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void mbedtls_strerror(int errnum, char* buffer, size_t buflen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_MBEDTLS_ERROR_H
@@ -0,0 +1,27 @@
+#ifndef NATIVE_HAL_MBEDTLS_PK_H
+#define NATIVE_HAL_MBEDTLS_PK_H
+
+#include <stddef.h>
+
+#define MBEDTLS_ERR_PK_ALLOC_FAILED -0x3F80
+#define MBEDTLS_ERR_PK_KEY_INVALID_FORMAT -0x3D00
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mbedtls_pk_context {
+    unsigned char* key;
+    size_t key_len;
+} mbedtls_pk_context;
+
+void mbedtls_pk_init(mbedtls_pk_context* ctx);
+void mbedtls_pk_free(mbedtls_pk_context* ctx);
+int mbedtls_pk_parse_key(mbedtls_pk_context* ctx, const unsigned char* key, size_t keylen,
+                         const unsigned char* pwd, size_t pwdlen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_MBEDTLS_PK_H
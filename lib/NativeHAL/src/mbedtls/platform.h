@@ -0,0 +1,24 @@
+#ifndef NATIVE_HAL_MBEDTLS_PLATFORM_H
+#define NATIVE_HAL_MBEDTLS_PLATFORM_H
+
+/**
+ * mbedTLS simulado: alocação configurável (MBEDTLS_PLATFORM_MEMORY). Todas as
+ * alocações do mbedTLS simulado passam por mbedtls_calloc()/mbedtls_free().
+ */
+
+#include <stddef.h>
+#include "mbedtls/config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void* mbedtls_calloc(size_t n, size_t size);
+void mbedtls_free(void* ptr);
+int mbedtls_platform_set_calloc_free(void* (*calloc_func)(size_t, size_t), void (*free_func)(void*));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_MBEDTLS_PLATFORM_H
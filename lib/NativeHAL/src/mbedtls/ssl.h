@@ -0,0 +1,135 @@
+#ifndef NATIVE_HAL_MBEDTLS_SSL_H
+#define NATIVE_HAL_MBEDTLS_SSL_H
+
+/**
+ * mbedTLS simulado (API do 2.28): mesmas funções, estruturas e códigos de
+ * erro usados pelo TlsClient, sobre o protocolo de sim/sim_tls_wire.h.
+ *
+ * O handshake não faz criptografia, mas respeita o fluxo real: chamadas não
+ * bloqueantes que devolvem WANT_READ, callback de verificação apenas no
+ * handshake completo, sessão serializável (retomada por session ID), buffers
+ * de entrada/saída alocados em mbedtls_ssl_setup() (via mbedtls_calloc, ver
+ * mbedtls/platform.h), a memória de trabalho e o custo de CPU do handshake
+ * (tls.client_full_scratch_bytes, tls.client_full_cpu_ms, tls.client_resume_cpu_ms).
+ * O Max Fragment Length é aceito e guardado, mas os buffers continuam com o
+ * tamanho fixo (como no mbedTLS sem MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mbedtls/config.h"
+#include "mbedtls/version.h"
+#include "mbedtls/x509_crt.h"
+#include "mbedtls/pk.h"
+
+#define MBEDTLS_ERR_SSL_BAD_INPUT_DATA -0x7100
+#define MBEDTLS_ERR_SSL_INVALID_RECORD -0x7200
+#define MBEDTLS_ERR_SSL_CONN_EOF -0x7280
+#define MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE -0x7780
+#define MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY -0x7880
+#define MBEDTLS_ERR_SSL_BAD_HS_SERVER_HELLO -0x7980
+#define MBEDTLS_ERR_SSL_ALLOC_FAILED -0x7F00
+#define MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL -0x6A00
+#define MBEDTLS_ERR_SSL_WANT_READ -0x6900
+#define MBEDTLS_ERR_SSL_WANT_WRITE -0x6880
+#define MBEDTLS_ERR_SSL_TIMEOUT -0x6800
+
+#define MBEDTLS_SSL_IS_CLIENT 0
+#define MBEDTLS_SSL_IS_SERVER 1
+#define MBEDTLS_SSL_TRANSPORT_STREAM 0
+#define MBEDTLS_SSL_PRESET_DEFAULT 0
+
+#define MBEDTLS_SSL_VERIFY_NONE 0
+#define MBEDTLS_SSL_VERIFY_OPTIONAL 1
+#define MBEDTLS_SSL_VERIFY_REQUIRED 2
+
+#define MBEDTLS_SSL_MAX_FRAG_LEN_NONE 0
+#define MBEDTLS_SSL_MAX_FRAG_LEN_512 1
+#define MBEDTLS_SSL_MAX_FRAG_LEN_1024 2
+#define MBEDTLS_SSL_MAX_FRAG_LEN_2048 3
+#define MBEDTLS_SSL_MAX_FRAG_LEN_4096 4
+
+#define MBEDTLS_SSL_SESSION_TICKETS_DISABLED 0
+#define MBEDTLS_SSL_SESSION_TICKETS_ENABLED 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int mbedtls_ssl_send_t(void* ctx, const unsigned char* buf, size_t len);
+typedef int mbedtls_ssl_recv_t(void* ctx, unsigned char* buf, size_t len);
+typedef int mbedtls_ssl_recv_timeout_t(void* ctx, unsigned char* buf, size_t len, uint32_t timeout);
+
+typedef struct mbedtls_ssl_session {
+    unsigned char id[32];
+    size_t id_len;
+    int valid;
+} mbedtls_ssl_session;
+
+typedef struct mbedtls_ssl_config {
+    int endpoint;
+    int authmode;
+    int session_tickets;
+    unsigned char mfl_code;      // MBEDTLS_SSL_MAX_FRAG_LEN_*
+    mbedtls_x509_crt* ca_chain;
+    mbedtls_x509_crt* own_cert;
+    mbedtls_pk_context* own_key;
+    int (*f_vrfy)(void*, mbedtls_x509_crt*, int, uint32_t*);
+    void* p_vrfy;
+    int (*f_rng)(void*, unsigned char*, size_t);
+    void* p_rng;
+} mbedtls_ssl_config;
+
+typedef struct mbedtls_ssl_context {
+    const mbedtls_ssl_config* conf;
+    int state;
+    void* p_bio;
+    mbedtls_ssl_send_t* f_send;
+    mbedtls_ssl_recv_t* f_recv;
+    unsigned char* in_buf;       // Registros recebidos (MBEDTLS_SSL_IN_CONTENT_LEN)
+    size_t in_len;
+    size_t app_offset;           // Dados de aplicação ainda não lidos no registro atual
+    size_t app_len;
+    unsigned char* out_buf;      // Registro em montagem (MBEDTLS_SSL_OUT_CONTENT_LEN)
+    char* hostname;
+    mbedtls_ssl_session session;
+    int session_offered;
+} mbedtls_ssl_context;
+
+void mbedtls_ssl_init(mbedtls_ssl_context* ssl);
+void mbedtls_ssl_free(mbedtls_ssl_context* ssl);
+int mbedtls_ssl_setup(mbedtls_ssl_context* ssl, const mbedtls_ssl_config* conf);
+int mbedtls_ssl_set_hostname(mbedtls_ssl_context* ssl, const char* hostname);
+void mbedtls_ssl_set_bio(mbedtls_ssl_context* ssl, void* p_bio, mbedtls_ssl_send_t* f_send,
+                         mbedtls_ssl_recv_t* f_recv, mbedtls_ssl_recv_timeout_t* f_recv_timeout);
+
+void mbedtls_ssl_config_init(mbedtls_ssl_config* conf);
+void mbedtls_ssl_config_free(mbedtls_ssl_config* conf);
+int mbedtls_ssl_config_defaults(mbedtls_ssl_config* conf, int endpoint, int transport, int preset);
+void mbedtls_ssl_conf_authmode(mbedtls_ssl_config* conf, int authmode);
+void mbedtls_ssl_conf_ca_chain(mbedtls_ssl_config* conf, mbedtls_x509_crt* ca_chain, void* ca_crl);
+void mbedtls_ssl_conf_verify(mbedtls_ssl_config* conf, int (*f_vrfy)(void*, mbedtls_x509_crt*, int, uint32_t*),
+                             void* p_vrfy);
+void mbedtls_ssl_conf_rng(mbedtls_ssl_config* conf, int (*f_rng)(void*, unsigned char*, size_t), void* p_rng);
+void mbedtls_ssl_conf_session_tickets(mbedtls_ssl_config* conf, int use_tickets);
+int mbedtls_ssl_conf_max_frag_len(mbedtls_ssl_config* conf, unsigned char mfl_code);
+int mbedtls_ssl_conf_own_cert(mbedtls_ssl_config* conf, mbedtls_x509_crt* own_cert, mbedtls_pk_context* pk_key);
+
+int mbedtls_ssl_handshake(mbedtls_ssl_context* ssl);
+int mbedtls_ssl_read(mbedtls_ssl_context* ssl, unsigned char* buf, size_t len);
+int mbedtls_ssl_write(mbedtls_ssl_context* ssl, const unsigned char* buf, size_t len);
+size_t mbedtls_ssl_get_bytes_avail(const mbedtls_ssl_context* ssl);
+int mbedtls_ssl_close_notify(mbedtls_ssl_context* ssl);
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session* session);
+void mbedtls_ssl_session_free(mbedtls_ssl_session* session);
+int mbedtls_ssl_session_save(const mbedtls_ssl_session* session, unsigned char* buf, size_t buf_len, size_t* olen);
+int mbedtls_ssl_session_load(mbedtls_ssl_session* session, const unsigned char* buf, size_t len);
+int mbedtls_ssl_set_session(mbedtls_ssl_context* ssl, const mbedtls_ssl_session* session);
+int mbedtls_ssl_get_session(const mbedtls_ssl_context* ssl, mbedtls_ssl_session* session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_MBEDTLS_SSL_H
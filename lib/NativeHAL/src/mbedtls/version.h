@@ -0,0 +1,10 @@
+#ifndef NATIVE_HAL_MBEDTLS_VERSION_H
+#define NATIVE_HAL_MBEDTLS_VERSION_H
+
+// Mesma API do mbedTLS 2.28 do ESP-IDF 4.4
+#define MBEDTLS_VERSION_MAJOR 2
+#define MBEDTLS_VERSION_MINOR 28
+#define MBEDTLS_VERSION_PATCH 0
+#define MBEDTLS_VERSION_STRING "2.28.0 (NativeHAL)"
+
+#endif // NATIVE_HAL_MBEDTLS_VERSION_H
@@ -0,0 +1,30 @@
+#ifndef NATIVE_HAL_MBEDTLS_X509_CRT_H
+#define NATIVE_HAL_MBEDTLS_X509_CRT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MBEDTLS_ERR_X509_INVALID_FORMAT -0x2180
+#define MBEDTLS_ERR_X509_CERT_VERIFY_FAILED -0x2700
+#define MBEDTLS_ERR_X509_ALLOC_FAILED -0x2880
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Só guarda o PEM (a alocação imita o uso de heap do certificado analisado)
+typedef struct mbedtls_x509_crt {
+    unsigned char* raw;
+    size_t raw_len;
+    int count;
+} mbedtls_x509_crt;
+
+void mbedtls_x509_crt_init(mbedtls_x509_crt* crt);
+void mbedtls_x509_crt_free(mbedtls_x509_crt* crt);
+int mbedtls_x509_crt_parse(mbedtls_x509_crt* chain, const unsigned char* buf, size_t buflen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NATIVE_HAL_MBEDTLS_X509_CRT_H
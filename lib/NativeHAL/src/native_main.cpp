@@ -0,0 +1,65 @@
+/**
+ * Ponto de entrada do build nativo.
+ *
+ * Uso:
+ *     .pio/build/native/program [--scenario arquivo] [--set chave=valor]... [--cycles N] [--days D]
+ *
+ * Em "pio test -e native" o main() é o do Unity (PIO_UNIT_TESTING).
+ *
+ * Cada ciclo é um despertar completo do firmware (setup() até o deep sleep),
+ * com o relógio simulado avançando durante o sono. Ao final é impresso o
+ * consumo estimado (mAh por dia) pelo modelo de energia (sim/sim_energy.h).
+ */
+
+#ifndef PIO_UNIT_TESTING
+
+#include "sim/sim_params.h"
+#include "sim/sim_system.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Uso: %s [--scenario arquivo] [--set chave=valor]... [--cycles N] [--days D]\n"
+            "  --scenario  carrega parâmetros de simulação de um arquivo\n"
+            "  --set       define um parâmetro (mesmo formato das linhas do cenário)\n"
+            "  --cycles    número máximo de despertares (padrão: 1, ou ilimitado com --days)\n"
+            "  --days      simula até D dias de tempo simulado\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    uint32_t cycles = 0;
+    uint64_t until_us = UINT64_MAX;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (strcmp(arg, "--scenario") == 0 && has_value) {
+            if (!sim_params_load_file(argv[++i])) {
+                return 2;
+            }
+        } else if (strcmp(arg, "--set") == 0 && has_value) {
+            if (!sim_param_parse_line(argv[++i])) {
+                fprintf(stderr, "NativeSim: ERRO - parâmetro inválido '%s'.\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(arg, "--cycles") == 0 && has_value) {
+            cycles = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(arg, "--days") == 0 && has_value) {
+            until_us = (uint64_t)(strtod(argv[++i], nullptr) * 86400.0 * 1e6);
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (cycles == 0) {
+        cycles = until_us == UINT64_MAX ? 1 : UINT32_MAX;
+    }
+    return sim_system_run_cycles(cycles, until_us);
+}
+
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,105 @@
+#include "sim_ads1115.h"
+#include "sim_devices.h"
+#include "sim_gpio.h"
+#include "sim_kernel.h"
+#include "sim_params.h"
+#include "Arduino.h"
+#include "config.h"
+
+#include <math.h>
+#include <stdio.h>
+
+// Tensões em ar limpo e regime (V). Os padrões correspondem aos R0 do main.cpp,
+// de modo que a razão Rs/R0 fique perto de 1.
+static const double DEFAULT_VOLTS[4] = {1.896, 2.315, 1.273, 0.0};
+
+// GPIO ligado ao ALERT/RDY (open-drain com pull-up). Por padrão segue a
+// ligação do firmware; ads.alert_pin = -1 deixa o pino desconectado.
+#ifdef ADS1115_ALERT_PIN
+#define SIM_ADS_ALERT_PIN ADS1115_ALERT_PIN
+#else
+#define SIM_ADS_ALERT_PIN -1
+#endif
+
+#define RDY_PULSE_US 8
+
+// Incrementado a cada nova configuração ou troca do trilho: conversões antigas morrem
+static uint32_t g_generation = 0;
+
+static int alert_pin() {
+    return (int)sim_param("ads.alert_pin", SIM_ADS_ALERT_PIN);
+}
+
+/**
+ * @brief (Função Privada) Fim de uma conversão: sinaliza no ALERT/RDY.
+ */
+static void conversion_done(uint32_t generation, uint32_t period_us, bool continuous) {
+    int pin = alert_pin();
+    if (generation != g_generation || pin < 0 || !sim_ads1115_responds((uint8_t)sim_param("ads.address", 0x48))) {
+        return;
+    }
+    sim_gpio_drive((uint8_t)pin, LOW);
+    if (!continuous) {
+        return;
+    }
+    uint64_t now = sim_now_us();
+    sim_schedule_us(now + RDY_PULSE_US, [pin, generation]() {
+        if (generation == g_generation) {
+            sim_gpio_drive((uint8_t)pin, HIGH);
+        }
+    });
+    sim_schedule_us(now + period_us, [generation, period_us]() { conversion_done(generation, period_us, true); });
+}
+
+void sim_ads1115_boot() {
+    g_generation++;
+    int pin = alert_pin();
+    if (pin >= 0) {
+        sim_gpio_drive((uint8_t)pin, HIGH);
+        sim_gpio_watch(SENSOR_POWER_CTRL_PIN, [pin](int level) {
+            (void)level;
+            g_generation++;
+            sim_gpio_drive((uint8_t)pin, HIGH);
+        });
+    }
+}
+
+void sim_ads1115_conversion_started(uint32_t period_us, bool continuous) {
+    uint32_t generation = ++g_generation;
+    int pin = alert_pin();
+    if (pin < 0) {
+        return;
+    }
+    sim_gpio_drive((uint8_t)pin, HIGH);
+    sim_schedule_us(sim_now_us() + period_us,
+                    [generation, period_us, continuous]() { conversion_done(generation, period_us, continuous); });
+}
+
+bool sim_ads1115_responds(uint8_t address) {
+    return sim_sensor_rail_on() && address == (uint8_t)sim_param("ads.address", 0x48) &&
+           sim_param("ads.present", 1) != 0;
+}
+
+double sim_ads1115_input_volts(uint8_t channel) {
+    if (channel > 3 || !sim_sensor_rail_on()) {
+        return 0.0;
+    }
+    char key[16];
+    snprintf(key, sizeof(key), "ads.ch%u_v", channel);
+    double steady = sim_param(key, DEFAULT_VOLTS[channel]);
+
+    // Aquecedor do MICS6814: a saída parte abaixo do regime e converge
+    // exponencialmente a partir do instante em que o trilho foi ligado.
+    double since_on_s = (sim_now_us() - sim_sensor_rail_on_us()) / 1e6;
+    double drop = sim_param("ads.warmup_drop", 0.30);
+    double tau_s = sim_param("ads.warmup_tau_s", 25.0);
+    double volts = steady * (1.0 - drop * exp(-since_on_s / tau_s));
+
+    volts += sim_gaussian() * sim_param("ads.noise_mv", 2.0) / 1000.0;
+
+    // Picos impulsivos (chaveamento do aquecedor): fração ads.spike_rate das leituras
+    if (sim_uniform() < sim_param("ads.spike_rate", 0.0)) {
+        volts += sim_param("ads.spike_mv", 400.0) / 1000.0;
+    }
+    return volts;
+}
@@ -0,0 +1,29 @@
+#ifndef SIM_ADS1115_H
+#define SIM_ADS1115_H
+
+#include <stdint.h>
+
+/**
+ * @brief Indica se o ADS1115 responde no endereço (trilho ligado e ADDR certo).
+ */
+bool sim_ads1115_responds(uint8_t address);
+
+/**
+ * @brief Tensão na entrada AINx no instante atual (saídas do MICS6814 com
+ * aquecimento e ruído).
+ */
+double sim_ads1115_input_volts(uint8_t channel);
+
+/**
+ * @brief Início de uma conversão (escrita do registrador de configuração).
+ *
+ * Com o ALERT/RDY ligado a um GPIO (ads.alert_pin), o pino vai a nível baixo
+ * ao fim da conversão: em single-shot fica baixo até a próxima conversão; em
+ * modo contínuo pulsa baixo por 8 µs ao fim de cada uma (datasheet, 8.3.8).
+ *
+ * @param period_us Duração de uma conversão na taxa configurada.
+ * @param continuous true no modo de conversão contínua.
+ */
+void sim_ads1115_conversion_started(uint32_t period_us, bool continuous);
+
+#endif // SIM_ADS1115_H
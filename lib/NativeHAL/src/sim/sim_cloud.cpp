@@ -0,0 +1,381 @@
+#include "sim_cloud.h"
+#include "sim_kernel.h"
+#include "sim_params.h"
+#include "sim_sim7000.h"
+#include "sim_system.h"
+#include "sim_tls_wire.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// --- Estado persistente do servidor ---
+// ===================================================================
+
+#define SIM_CLOUD_SESSION_SLOTS 8
+
+struct ServerSession {
+    bool valid;
+    uint8_t id[SIM_TLS_SESSION_ID_LEN];
+    double created_utc;
+};
+
+SIM_PERSIST static ServerSession g_sessions[SIM_CLOUD_SESSION_SLOTS] = {};
+SIM_PERSIST static uint32_t g_next_session_slot = 0;
+SIM_PERSIST static uint32_t g_publish_count = 0;
+
+// ===================================================================
+// --- Conexões (por socket do modem) ---
+// ===================================================================
+
+typedef enum {
+    TLS_WAIT_CLIENT_HELLO = 0,
+    TLS_WAIT_CLIENT_FLIGHT,
+    TLS_WAIT_CLIENT_FINISHED,
+    TLS_ESTABLISHED,
+    TLS_CLOSED,
+} server_tls_state_t;
+
+struct Connection {
+    bool open;
+    server_tls_state_t state;
+    std::vector<uint8_t> records;  // Bytes TLS ainda não processados
+    std::vector<uint8_t> mqtt;     // Fluxo MQTT decifrado
+    bool mqtt_connected;
+};
+
+static Connection g_connections[SIM_SIM7000_MUX_COUNT];
+
+static uint64_t latency_us(const char* key, double default_ms) {
+    return (uint64_t)(sim_param(key, default_ms) * 1000.0);
+}
+
+/**
+ * @brief (Função Privada) Envia um registro TLS ao cliente.
+ */
+static void send_record(uint8_t mux, uint8_t type, const uint8_t* body, size_t length, uint64_t delay_us) {
+    std::vector<uint8_t> record(SIM_TLS_RECORD_HEADER + length);
+    sim_tls_write_header(record.data(), type, length);
+    if (length > 0) {
+        memcpy(record.data() + SIM_TLS_RECORD_HEADER, body, length);
+    }
+    sim_sim7000_socket_deliver(mux, record.data(), record.size(), delay_us);
+}
+
+/**
+ * @brief (Função Privada) Envia dados MQTT como registro de aplicação.
+ */
+static void send_app_data(uint8_t mux, const uint8_t* data, size_t length) {
+    std::vector<uint8_t> body(length + SIM_TLS_APP_OVERHEAD, 0);
+    memcpy(body.data(), data, length);
+    send_record(mux, SIM_TLS_APPLICATION_DATA, body.data(), body.size(), latency_us("broker.latency_ms", 20));
+}
+
+// ===================================================================
+// --- TLS (lado servidor) ---
+// ===================================================================
+
+static ServerSession* find_session(const uint8_t* id) {
+    double lifetime_s = sim_param("tls.session_lifetime_s", 86400);
+    for (ServerSession& session : g_sessions) {
+        if (session.valid && memcmp(session.id, id, SIM_TLS_SESSION_ID_LEN) == 0) {
+            if (sim_true_utc() - session.created_utc > lifetime_s) {
+                session.valid = false;
+                return nullptr;
+            }
+            return &session;
+        }
+    }
+    return nullptr;
+}
+
+static ServerSession* new_session() {
+    ServerSession& session = g_sessions[g_next_session_slot++ % SIM_CLOUD_SESSION_SLOTS];
+    session.valid = true;
+    session.created_utc = sim_true_utc();
+    for (uint8_t& b : session.id) {
+        b = (uint8_t)(lrand48() & 0xFF);
+    }
+    return &session;
+}
+
+static void handle_client_hello(uint8_t mux, const uint8_t* body, size_t length) {
+    Connection& conn = g_connections[mux];
+    ServerSession* session = nullptr;
+    if (length >= 2 + SIM_TLS_SESSION_ID_LEN && body[1] == SIM_TLS_SESSION_ID_LEN &&
+        sim_param("tls.resumption", 1) != 0) {
+        session = find_session(body + 2);
+    }
+    bool resumed = session != nullptr;
+    if (!resumed) {
+        session = new_session();
+    }
+
+    uint8_t hello[2 + SIM_TLS_SESSION_ID_LEN + 60] = {};
+    hello[0] = SIM_TLS_SERVER_HELLO;
+    hello[1] = resumed ? 1 : 0;
+    memcpy(hello + 2, session->id, SIM_TLS_SESSION_ID_LEN);
+    uint64_t crypto_us = latency_us("tls.server_crypto_ms", 15);
+    send_record(mux, SIM_TLS_HANDSHAKE, hello, sizeof(hello), crypto_us);
+
+    if (resumed) {
+        uint8_t finished[SIM_TLS_FINISHED_BYTES] = {SIM_TLS_FINISHED};
+        send_record(mux, SIM_TLS_HANDSHAKE, finished, sizeof(finished), crypto_us);
+        conn.state = TLS_WAIT_CLIENT_FINISHED;
+    } else {
+        // Certificate (cadeia da AWS) + ServerKeyExchange + CertificateRequest + ServerHelloDone
+        std::vector<uint8_t> flight((size_t)sim_param("tls.server_flight_bytes", 4100), 0);
+        flight[0] = SIM_TLS_SERVER_CERTIFICATE_FLIGHT;
+        send_record(mux, SIM_TLS_HANDSHAKE, flight.data(), flight.size(), crypto_us);
+        conn.state = TLS_WAIT_CLIENT_FLIGHT;
+    }
+    printf("NativeSim: TLS - ClientHello (%s).\n", resumed ? "sessão retomada" : "handshake completo");
+}
+
+static void handle_mqtt(uint8_t mux);
+
+static void handle_record(uint8_t mux, uint8_t type, const uint8_t* body, size_t length) {
+    Connection& conn = g_connections[mux];
+    if (type == SIM_TLS_ALERT) {
+        conn.state = TLS_CLOSED;
+        return;
+    }
+    if (type == SIM_TLS_APPLICATION_DATA) {
+        if (conn.state == TLS_ESTABLISHED && length >= SIM_TLS_APP_OVERHEAD) {
+            conn.mqtt.insert(conn.mqtt.end(), body, body + length - SIM_TLS_APP_OVERHEAD);
+            handle_mqtt(mux);
+        }
+        return;
+    }
+    if (type != SIM_TLS_HANDSHAKE || length == 0) {
+        return;
+    }
+
+    switch (conn.state) {
+        case TLS_WAIT_CLIENT_HELLO:
+            if (body[0] == SIM_TLS_CLIENT_HELLO) {
+                handle_client_hello(mux, body, length);
+            }
+            break;
+        case TLS_WAIT_CLIENT_FLIGHT:
+            if (body[0] == SIM_TLS_CLIENT_KEY_FLIGHT) {
+                uint8_t finished[SIM_TLS_FINISHED_BYTES] = {SIM_TLS_FINISHED};
+                send_record(mux, SIM_TLS_HANDSHAKE, finished, sizeof(finished),
+                            latency_us("tls.server_crypto_ms", 15));
+                conn.state = TLS_ESTABLISHED;
+            }
+            break;
+        case TLS_WAIT_CLIENT_FINISHED:
+            if (body[0] == SIM_TLS_FINISHED) {
+                conn.state = TLS_ESTABLISHED;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// ===================================================================
+// --- Broker MQTT ---
+// ===================================================================
+
+/**
+ * @brief (Função Privada) Grava o payload de um PUBLISH para análise offline.
+ */
+static void dump_payload(const uint8_t* payload, size_t length) {
+    const char* dir = sim_param_str("broker.dump_dir", nullptr);
+    if (dir == nullptr || dir[0] == '\0') {
+        return;
+    }
+    char path[512];
+    snprintf(path, sizeof(path), "%s/publish_%04u.bin", dir, (unsigned)g_publish_count);
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        fprintf(stderr, "NativeSim: AVISO - não foi possível gravar '%s'.\n", path);
+        return;
+    }
+    fwrite(payload, 1, length, file);
+    fclose(file);
+}
+
+static void handle_publish(uint8_t mux, uint8_t flags, const uint8_t* body, size_t length) {
+    if (length < 2) {
+        return;
+    }
+    size_t topic_len = ((size_t)body[0] << 8) | body[1];
+    size_t pos = 2 + topic_len;
+    uint8_t qos = (flags >> 1) & 0x03;
+    uint16_t packet_id = 0;
+    if (qos > 0) {
+        if (pos + 2 > length) {
+            return;
+        }
+        packet_id = (uint16_t)((body[pos] << 8) | body[pos + 1]);
+        pos += 2;
+    }
+    if (pos > length) {
+        return;
+    }
+
+    std::string topic((const char*)body + 2, topic_len);
+    g_publish_count++;
+    printf("NativeSim: broker - PUBLISH #%u em '%s' (%u bytes de payload, QoS %u).\n",
+           (unsigned)g_publish_count, topic.c_str(), (unsigned)(length - pos), qos);
+    dump_payload(body + pos, length - pos);
+
+    if (qos > 0) {
+        uint8_t puback[4] = {0x40, 0x02, (uint8_t)(packet_id >> 8), (uint8_t)(packet_id & 0xFF)};
+        send_app_data(mux, puback, sizeof(puback));
+    }
+}
+
+/**
+ * @brief (Função Privada) Entrega a mensagem retida do cenário (broker.retained)
+ * a um novo assinante, como o AWS IoT faz com mensagens "retained".
+ */
+static void send_retained(uint8_t mux, const std::string& topic) {
+    const char* payload = sim_param_str("broker.retained", nullptr);
+    if (payload == nullptr || payload[0] == '\0') {
+        return;
+    }
+    size_t payload_len = strlen(payload);
+    std::vector<uint8_t> packet;
+    size_t remaining = 2 + topic.size() + payload_len;
+    packet.push_back(0x31); // PUBLISH, QoS 0, RETAIN
+    do {
+        uint8_t digit = remaining % 128;
+        remaining /= 128;
+        packet.push_back(remaining ? (uint8_t)(digit | 0x80) : digit);
+    } while (remaining);
+    packet.push_back((uint8_t)(topic.size() >> 8));
+    packet.push_back((uint8_t)(topic.size() & 0xFF));
+    packet.insert(packet.end(), topic.begin(), topic.end());
+    packet.insert(packet.end(), payload, payload + payload_len);
+    printf("NativeSim: broker - mensagem retida em '%s' (%u bytes).\n", topic.c_str(), (unsigned)payload_len);
+    send_app_data(mux, packet.data(), packet.size());
+}
+
+static void handle_mqtt(uint8_t mux) {
+    Connection& conn = g_connections[mux];
+    std::vector<uint8_t>& in = conn.mqtt;
+
+    for (;;) {
+        // Cabeçalho fixo: tipo/flags + "remaining length" (até 4 bytes)
+        if (in.size() < 2) {
+            return;
+        }
+        size_t remaining = 0;
+        size_t header = 1;
+        uint32_t multiplier = 1;
+        uint8_t byte;
+        do {
+            if (header >= in.size() || header > 4) {
+                return;
+            }
+            byte = in[header++];
+            remaining += (byte & 0x7F) * multiplier;
+            multiplier *= 128;
+        } while (byte & 0x80);
+        if (in.size() < header + remaining) {
+            return;
+        }
+
+        uint8_t type = in[0] >> 4;
+        uint8_t flags = in[0] & 0x0F;
+        const uint8_t* body = in.data() + header;
+
+        switch (type) {
+            case 1: { // CONNECT
+                uint8_t rc = (uint8_t)sim_param("broker.connack_rc", 0);
+                uint8_t connack[4] = {0x20, 0x02, 0x00, rc};
+                send_app_data(mux, connack, sizeof(connack));
+                conn.mqtt_connected = rc == 0;
+                printf("NativeSim: broker - CONNECT (rc=%u).\n", rc);
+                break;
+            }
+            case 3: // PUBLISH
+                if (conn.mqtt_connected) {
+                    handle_publish(mux, flags, body, remaining);
+                }
+                break;
+            case 8: { // SUBSCRIBE
+                std::vector<std::string> filters;
+                size_t pos = 2;
+                while (pos + 2 <= remaining) {
+                    size_t topic_len = ((size_t)body[pos] << 8) | body[pos + 1];
+                    filters.emplace_back((const char*)body + pos + 2, std::min(topic_len, remaining - pos - 2));
+                    pos += 2 + topic_len + 1;
+                }
+                std::vector<uint8_t> suback = {0x90, (uint8_t)(2 + filters.size()), body[0], body[1]};
+                suback.insert(suback.end(), filters.size(), 0x00);
+                send_app_data(mux, suback.data(), suback.size());
+                for (const std::string& filter : filters) {
+                    send_retained(mux, filter);
+                }
+                break;
+            }
+            case 12: { // PINGREQ
+                uint8_t pingresp[2] = {0xD0, 0x00};
+                send_app_data(mux, pingresp, sizeof(pingresp));
+                break;
+            }
+            case 14: // DISCONNECT
+                conn.mqtt_connected = false;
+                printf("NativeSim: broker - DISCONNECT.\n");
+                break;
+            default:
+                break;
+        }
+        in.erase(in.begin(), in.begin() + header + remaining);
+    }
+}
+
+// ===================================================================
+// --- Interface com o modem ---
+// ===================================================================
+
+bool sim_cloud_open(uint8_t mux, const char* host, uint16_t port) {
+    if (mux >= SIM_SIM7000_MUX_COUNT || sim_param("broker.available", 1) == 0) {
+        printf("NativeSim: nuvem - conexão a %s:%u recusada.\n", host, port);
+        return false;
+    }
+    Connection& conn = g_connections[mux];
+    conn = Connection();
+    conn.open = true;
+    conn.state = TLS_WAIT_CLIENT_HELLO;
+    return true;
+}
+
+void sim_cloud_receive(uint8_t mux, const uint8_t* data, size_t length) {
+    if (mux >= SIM_SIM7000_MUX_COUNT || !g_connections[mux].open) {
+        return;
+    }
+    Connection& conn = g_connections[mux];
+    conn.records.insert(conn.records.end(), data, data + length);
+
+    size_t size;
+    while ((size = sim_tls_record_size(conn.records.data(), conn.records.size())) != 0) {
+        std::vector<uint8_t> record(conn.records.begin(), conn.records.begin() + size);
+        conn.records.erase(conn.records.begin(), conn.records.begin() + size);
+        handle_record(mux, record[0], record.data() + SIM_TLS_RECORD_HEADER, size - SIM_TLS_RECORD_HEADER);
+        if (conn.state == TLS_CLOSED) {
+            sim_sim7000_socket_remote_close(mux);
+            conn.open = false;
+            return;
+        }
+    }
+}
+
+void sim_cloud_close(uint8_t mux) {
+    if (mux < SIM_SIM7000_MUX_COUNT) {
+        g_connections[mux] = Connection();
+    }
+}
+
+uint32_t sim_cloud_publish_count() {
+    return g_publish_count;
+}
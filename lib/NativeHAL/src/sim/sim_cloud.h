@@ -0,0 +1,44 @@
+#ifndef SIM_CLOUD_H
+#define SIM_CLOUD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Nuvem simulada: a outra ponta dos sockets do SIM7000.
+ *
+ * Implementa o lado servidor do TLS simulado (ver sim_tls_wire.h), com cache
+ * de sessões para retomada, e um broker MQTT mínimo (CONNECT, PUBLISH,
+ * SUBSCRIBE, PINGREQ, DISCONNECT). Cada PUBLISH é registrado no log e, com
+ * "broker.dump_dir" definido, o payload é gravado em
+ * <dir>/publish_<n>.bin (legível por tools/decode_payload.py). Com
+ * "broker.retained" definido, cada SUBSCRIBE recebe esse texto como
+ * mensagem retida no tópico assinado.
+ *
+ * Parâmetros: tls.resumption, tls.session_lifetime_s, tls.server_flight_bytes,
+ * tls.server_crypto_ms, broker.available, broker.connack_rc,
+ * broker.latency_ms, broker.dump_dir, broker.retained.
+ */
+
+/**
+ * @brief Uma conexão TCP chegou ao servidor.
+ * @return false se o servidor recusar a conexão.
+ */
+bool sim_cloud_open(uint8_t mux, const char* host, uint16_t port);
+
+/**
+ * @brief Bytes do cliente chegaram ao servidor.
+ */
+void sim_cloud_receive(uint8_t mux, const uint8_t* data, size_t length);
+
+/**
+ * @brief O cliente (ou o modem) fechou a conexão.
+ */
+void sim_cloud_close(uint8_t mux);
+
+/**
+ * @brief Total de mensagens PUBLISH recebidas pelo broker desde a energização.
+ */
+uint32_t sim_cloud_publish_count();
+
+#endif // SIM_CLOUD_H
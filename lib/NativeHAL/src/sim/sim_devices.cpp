@@ -0,0 +1,55 @@
+#include "sim_devices.h"
+#include "sim_energy.h"
+#include "sim_gpio.h"
+#include "sim_kernel.h"
+#include "Arduino.h"
+#include "config.h"
+
+static bool g_rail_on = false;
+static uint64_t g_rail_on_us = 0;
+
+void sim_devices_boot() {
+    g_rail_on = false;
+    g_rail_on_us = 0;
+
+    // MOSFET low-side dos sensores: nível alto liga o trilho
+    sim_gpio_watch(SENSOR_POWER_CTRL_PIN, [](int level) {
+        g_rail_on = level == HIGH;
+        if (g_rail_on) {
+            g_rail_on_us = sim_now_us();
+        }
+    });
+
+    sim_ads1115_boot();
+    sim_scd40_boot();
+    sim_dsm501a_boot();
+    sim_sim7000_boot();
+}
+
+bool sim_sensor_rail_on() {
+    return g_rail_on;
+}
+
+uint64_t sim_sensor_rail_on_us() {
+    return g_rail_on_us;
+}
+
+const char* sim_sensors_energy_state(uint64_t t_us, uint64_t* until_us) {
+    (void)t_us;
+    (void)until_us; // Só muda com escrita no GPIO, no instante atual
+    return g_rail_on ? "on" : "off";
+}
+
+double sim_uniform() {
+    return drand48();
+}
+
+double sim_gaussian() {
+    // Box-Muller
+    double u1 = drand48();
+    double u2 = drand48();
+    if (u1 < 1e-12) {
+        u1 = 1e-12;
+    }
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * PI * u2);
+}
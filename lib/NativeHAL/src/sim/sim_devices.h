@@ -0,0 +1,50 @@
+#ifndef SIM_DEVICES_H
+#define SIM_DEVICES_H
+
+#include <stdint.h>
+
+/**
+ * Periféricos simulados da placa. Cada um tem estado "elétrico" (zerado a
+ * cada boot do ESP32, pois depende dos pinos) e, quando faz sentido, estado
+ * persistente (ex: o modem tem alimentação própria e continua registrado).
+ *
+ * Parâmetros roteirizáveis (ver sim_params.h), por prefixo:
+ *   ads.*    ADS1115 e as saídas do MICS6814       (sim_ads1115.cpp)
+ *   scd40.*  SCD40                                 (sim_scd40.cpp)
+ *   dsm.*    trens de pulsos do DSM501A            (sim_dsm501a.cpp)
+ *   modem.*, net.*, gnss.*, at.*  SIM7000 e rede   (sim_sim7000.cpp)
+ *   tls.*, broker.*  servidor TLS e broker MQTT    (sim_cloud.cpp)
+ *   energy.*  correntes por componente/estado      (sim_energy.cpp)
+ */
+
+/**
+ * @brief Conecta os periféricos aos pinos no início de cada despertar.
+ */
+void sim_devices_boot();
+
+void sim_ads1115_boot();
+void sim_scd40_boot();
+void sim_dsm501a_boot();
+void sim_sim7000_boot();
+
+/**
+ * @brief Indica se o trilho de alimentação dos sensores está ligado.
+ */
+bool sim_sensor_rail_on();
+
+/**
+ * @brief Instante (µs) em que o trilho dos sensores foi ligado pela última vez.
+ */
+uint64_t sim_sensor_rail_on_us();
+
+/**
+ * @brief Número gaussiano (média 0, desvio 1) com semente do cenário.
+ */
+double sim_gaussian();
+
+/**
+ * @brief Número uniforme em [0, 1).
+ */
+double sim_uniform();
+
+#endif // SIM_DEVICES_H
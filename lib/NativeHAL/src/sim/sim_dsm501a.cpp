@@ -0,0 +1,87 @@
+#include "sim_devices.h"
+#include "sim_gpio.h"
+#include "sim_kernel.h"
+#include "sim_params.h"
+#include "Arduino.h"
+#include "config.h"
+
+/**
+ * DSM501A simulado: cada saída (PM2.5 e PM10) gera pulsos em nível baixo de
+ * 10-90 ms (faixa do datasheet), espaçados para que a fração do tempo em
+ * nível baixo siga a LOP ratio do cenário (dsm.pm25_lop / dsm.pm10_lop, em %).
+ * Em repouso a saída fica em nível alto (divisor resistivo = pull-up).
+ */
+
+struct DsmOutput {
+    uint8_t pin;
+    const char* lop_key;
+    double default_lop;
+};
+
+static const DsmOutput OUTPUTS[] = {
+    {DSM501A_PM25_PIN, "dsm.pm25_lop", 2.0},
+    {DSM501A_PM10_PIN, "dsm.pm10_lop", 3.5},
+};
+
+// Incrementado a cada troca do trilho: eventos de uma "sessão" antiga morrem
+static uint32_t g_generation = 0;
+
+static void schedule_next_pulse(const DsmOutput* output, uint32_t generation, uint64_t at_us);
+
+/**
+ * @brief (Função Privada) Começa um pulso baixo e agenda o seu fim.
+ */
+static void pulse_start(const DsmOutput* output, uint32_t generation) {
+    if (generation != g_generation) {
+        return;
+    }
+    double lop = sim_param(output->lop_key, output->default_lop) / 100.0;
+    double warmup_s = sim_param("dsm.warmup_s", 0.0);
+    bool warm = (sim_now_us() - sim_sensor_rail_on_us()) / 1e6 >= warmup_s;
+    if (lop <= 0.0 || !warm) {
+        // Sem partículas (ou aquecendo): reavalia em 1 s
+        schedule_next_pulse(output, generation, sim_now_us() + 1000000ULL);
+        return;
+    }
+    if (lop > 0.95) {
+        lop = 0.95;
+    }
+
+    double min_ms = sim_param("dsm.pulse_min_ms", 10.0);
+    double max_ms = sim_param("dsm.pulse_max_ms", 90.0);
+    double width_ms = min_ms + (max_ms - min_ms) * sim_uniform();
+    // Intervalo em nível alto com distribuição exponencial e média que fecha a LOP
+    double mean_gap_ms = width_ms * (1.0 - lop) / lop;
+    double gap_ms = -mean_gap_ms * log(1.0 - sim_uniform());
+
+    uint64_t end_us = sim_now_us() + (uint64_t)(width_ms * 1000.0);
+    sim_gpio_drive(output->pin, LOW);
+    sim_schedule_us(end_us, [output, generation]() {
+        if (generation == g_generation) {
+            sim_gpio_drive(output->pin, HIGH);
+        }
+    });
+    schedule_next_pulse(output, generation, end_us + (uint64_t)(gap_ms * 1000.0));
+}
+
+static void schedule_next_pulse(const DsmOutput* output, uint32_t generation, uint64_t at_us) {
+    sim_schedule_us(at_us, [output, generation]() { pulse_start(output, generation); });
+}
+
+void sim_dsm501a_boot() {
+    g_generation++;
+    for (const DsmOutput& output : OUTPUTS) {
+        sim_gpio_drive(output.pin, HIGH);
+    }
+
+    sim_gpio_watch(SENSOR_POWER_CTRL_PIN, [](int level) {
+        g_generation++;
+        for (const DsmOutput& output : OUTPUTS) {
+            sim_gpio_drive(output.pin, HIGH);
+            if (level == HIGH) {
+                // Fase aleatória para as duas saídas não pulsarem juntas
+                schedule_next_pulse(&output, g_generation, sim_now_us() + (uint64_t)(sim_uniform() * 200000.0));
+            }
+        }
+    });
+}
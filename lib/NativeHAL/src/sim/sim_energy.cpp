@@ -0,0 +1,191 @@
+#include "sim_energy.h"
+#include "sim_kernel.h"
+#include "sim_params.h"
+#include "sim_system.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct EnergyState {
+    sim_energy_component_t component;
+    const char* name;
+    double default_ma;
+};
+
+static const char* const COMPONENT_NAMES[SIM_ENERGY_COMPONENT_COUNT] = {
+    "board", "mcu", "modem", "gnss", "sensors",
+};
+
+static const sim_energy_state_fn STATE_FNS[SIM_ENERGY_COMPONENT_COUNT] = {
+    nullptr, // Placa: sempre "on"
+    sim_system_mcu_energy_state,
+    sim_sim7000_energy_state,
+    sim_sim7000_gnss_energy_state,
+    sim_sensors_energy_state,
+};
+
+// Correntes padrão (mA): ESP32 a 240 MHz sem rádio, SIM7000G em LTE-M/NB-IoT,
+// trilho dos sensores com os aquecedores do MICS6814 e do DSM501A ligados.
+static const EnergyState STATES[] = {
+    {SIM_ENERGY_BOARD, "on", 0.05},
+    {SIM_ENERGY_MCU, "active", 45.0},
+    {SIM_ENERGY_MCU, "deep_sleep", 0.012},
+    {SIM_ENERGY_MCU, "deep_sleep_ulp", 0.15},  // Timer do ULP + domínio RTC_PERIPH ligado
+    {SIM_ENERGY_MODEM, "off", 0.008},
+    {SIM_ENERGY_MODEM, "boot", 50.0},
+    {SIM_ENERGY_MODEM, "min_func", 6.0},     // AT+CFUN=0
+    {SIM_ENERGY_MODEM, "search", 45.0},      // Procurando célula / registrando
+    {SIM_ENERGY_MODEM, "tx", 180.0},
+    {SIM_ENERGY_MODEM, "rx", 60.0},
+    {SIM_ENERGY_MODEM, "connected", 30.0},   // RRC conectado após tráfego (até o inactivity timer)
+    {SIM_ENERGY_MODEM, "idle", 9.0},         // Registrado, paging DRX, UART ativa
+    {SIM_ENERGY_MODEM, "edrx", 1.5},
+    {SIM_ENERGY_MODEM, "psm", 0.009},
+    {SIM_ENERGY_GNSS, "off", 0.0},
+    {SIM_ENERGY_GNSS, "acquire", 32.0},
+    {SIM_ENERGY_GNSS, "track", 26.0},
+    {SIM_ENERGY_SENSORS, "off", 0.0},
+    {SIM_ENERGY_SENSORS, "on", 195.0},
+};
+
+#define STATE_COUNT (sizeof(STATES) / sizeof(STATES[0]))
+
+// Acumuladores: sobrevivem ao deep sleep (o relatório cobre todos os despertares)
+SIM_PERSIST static uint64_t g_accounted_us = 0;
+SIM_PERSIST static double g_charge_mas[STATE_COUNT] = {};
+SIM_PERSIST static uint64_t g_time_us[STATE_COUNT] = {};
+SIM_PERSIST static uint64_t g_wake_start_us = 0;
+SIM_PERSIST static uint64_t g_cycle_start_us = 0;
+SIM_PERSIST static double g_cycle_start_mas[SIM_ENERGY_COMPONENT_COUNT] = {};
+SIM_PERSIST static uint32_t g_wakes = 0;
+
+/**
+ * @brief (Função Privada) Índice do estado na tabela (aborta se não existir).
+ */
+static size_t state_index(sim_energy_component_t component, const char* name) {
+    for (size_t i = 0; i < STATE_COUNT; i++) {
+        if (STATES[i].component == component && strcmp(STATES[i].name, name) == 0) {
+            return i;
+        }
+    }
+    fprintf(stderr, "NativeSim: ERRO - estado de energia desconhecido '%s.%s'.\n", COMPONENT_NAMES[component], name);
+    abort();
+}
+
+static double state_current_ma(size_t index) {
+    char key[64];
+    snprintf(key, sizeof(key), "energy.%s.%s_ma", COMPONENT_NAMES[STATES[index].component], STATES[index].name);
+    return sim_param(key, STATES[index].default_ma);
+}
+
+static double component_mas(sim_energy_component_t component) {
+    double total = 0.0;
+    for (size_t i = 0; i < STATE_COUNT; i++) {
+        if (STATES[i].component == component) {
+            total += g_charge_mas[i];
+        }
+    }
+    return total;
+}
+
+void sim_energy_advance(uint64_t t_us) {
+    uint64_t t = g_accounted_us;
+    while (t < t_us) {
+        // Trecho em que nenhum componente muda de estado sozinho
+        uint64_t until = t_us;
+        size_t current[SIM_ENERGY_COMPONENT_COUNT];
+        for (int c = 0; c < SIM_ENERGY_COMPONENT_COUNT; c++) {
+            const char* name = STATE_FNS[c] != nullptr ? STATE_FNS[c](t, &until) : "on";
+            current[c] = state_index((sim_energy_component_t)c, name);
+        }
+        if (until <= t) {
+            until = t_us;
+        }
+        uint64_t span = until - t;
+        for (int c = 0; c < SIM_ENERGY_COMPONENT_COUNT; c++) {
+            g_charge_mas[current[c]] += state_current_ma(current[c]) * span / 1e6;
+            g_time_us[current[c]] += span;
+        }
+        t = until;
+    }
+    g_accounted_us = t_us > g_accounted_us ? t_us : g_accounted_us;
+}
+
+double sim_energy_total_mah() {
+    double total = 0.0;
+    for (size_t i = 0; i < STATE_COUNT; i++) {
+        total += g_charge_mas[i];
+    }
+    return total / 3600.0;
+}
+
+void sim_energy_wake_begin() {
+    sim_energy_advance(sim_now_us());
+    g_wake_start_us = sim_now_us();
+    g_wakes++;
+}
+
+void sim_energy_wake_end() {
+    sim_energy_advance(sim_now_us());
+    uint64_t now = sim_now_us();
+    double cycle_mah[SIM_ENERGY_COMPONENT_COUNT];
+    double cycle_total = 0.0;
+    for (int c = 0; c < SIM_ENERGY_COMPONENT_COUNT; c++) {
+        double mas = component_mas((sim_energy_component_t)c);
+        cycle_mah[c] = (mas - g_cycle_start_mas[c]) / 3600.0;
+        cycle_total += cycle_mah[c];
+        g_cycle_start_mas[c] = mas;
+    }
+    double awake_s = (now - g_wake_start_us) / 1e6;
+    double sleep_s = (g_wake_start_us - g_cycle_start_us) / 1e6;
+
+    printf("NativeSim: energia - ativo %.1f s, ciclo %.3f mAh (MCU %.3f, modem %.3f, GNSS %.3f, sensores %.3f), "
+           "acumulado %.2f mAh.\n",
+           awake_s, cycle_total, cycle_mah[SIM_ENERGY_MCU], cycle_mah[SIM_ENERGY_MODEM], cycle_mah[SIM_ENERGY_GNSS],
+           cycle_mah[SIM_ENERGY_SENSORS], sim_energy_total_mah());
+
+    const char* csv_path = sim_param_str("energy.csv", nullptr);
+    if (csv_path != nullptr && csv_path[0] != '\0') {
+        FILE* csv = fopen(csv_path, g_wakes == 1 ? "w" : "a");
+        if (csv != nullptr) {
+            if (g_wakes == 1) {
+                fprintf(csv, "wake,start_s,sleep_before_s,awake_s,board_mah,mcu_mah,modem_mah,gnss_mah,sensors_mah,"
+                             "total_mah\n");
+            }
+            fprintf(csv, "%u,%.3f,%.3f,%.3f,%.5f,%.5f,%.5f,%.5f,%.5f,%.5f\n", g_wakes, g_wake_start_us / 1e6, sleep_s,
+                    awake_s, cycle_mah[SIM_ENERGY_BOARD], cycle_mah[SIM_ENERGY_MCU], cycle_mah[SIM_ENERGY_MODEM],
+                    cycle_mah[SIM_ENERGY_GNSS], cycle_mah[SIM_ENERGY_SENSORS], cycle_total);
+            fclose(csv);
+        }
+    }
+    g_cycle_start_us = now;
+}
+
+void sim_energy_report() {
+    double elapsed_s = g_accounted_us / 1e6;
+    if (elapsed_s <= 0.0) {
+        return;
+    }
+
+    printf("\n===== NativeSim: energia (%.2f dias simulados, %u despertares) =====\n", elapsed_s / 86400.0, g_wakes);
+    printf("  %-9s %-11s %12s %9s %11s\n", "comp.", "estado", "tempo (s)", "mA", "carga (mAh)");
+    for (size_t i = 0; i < STATE_COUNT; i++) {
+        if (g_time_us[i] == 0) {
+            continue;
+        }
+        printf("  %-9s %-11s %12.1f %9.3f %11.4f\n", COMPONENT_NAMES[STATES[i].component], STATES[i].name,
+               g_time_us[i] / 1e6, state_current_ma(i), g_charge_mas[i] / 3600.0);
+    }
+
+    double total_mah = sim_energy_total_mah();
+    double average_ma = total_mah * 3600.0 / elapsed_s;
+    double per_day_mah = average_ma * 24.0;
+    double battery_mah = sim_param("energy.battery_mah", 3000);
+    printf("  Por componente (mAh/dia):");
+    for (int c = 0; c < SIM_ENERGY_COMPONENT_COUNT; c++) {
+        printf(" %s %.2f", COMPONENT_NAMES[c], component_mas((sim_energy_component_t)c) / 3600.0 / elapsed_s * 86400.0);
+    }
+    printf("\n  Total: %.3f mAh | média %.3f mA | %.2f mAh/dia | autonomia estimada %.0f dias (%.0f mAh)\n", total_mah,
+           average_ma, per_day_mah, per_day_mah > 0.0 ? battery_mah / per_day_mah : 0.0, battery_mah);
+}
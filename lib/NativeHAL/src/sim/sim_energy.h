@@ -0,0 +1,69 @@
+#ifndef SIM_ENERGY_H
+#define SIM_ENERGY_H
+
+#include <stdint.h>
+
+/**
+ * Modelo de consumo da placa simulada.
+ *
+ * Cada componente está sempre em um estado de consumo (ex: modem "search",
+ * "tx", "psm") derivado do estado do periférico simulado. O núcleo chama
+ * sim_energy_advance() sempre que o relógio avança (inclusive no deep sleep),
+ * e a carga de cada trecho é integrada com a corrente do estado vigente.
+ *
+ * As correntes (mA) vêm do cenário, "energy.<componente>.<estado>_ma"; os
+ * padrões são valores típicos de datasheet e devem ser substituídos por
+ * medições da placa real. Outros parâmetros:
+ *   energy.battery_mah  capacidade usada na estimativa de autonomia (padrão 3000)
+ *   energy.csv          arquivo CSV com uma linha por despertar (opcional)
+ */
+
+typedef enum {
+    SIM_ENERGY_BOARD = 0,   // Reguladores e divisores (sempre ligado)
+    SIM_ENERGY_MCU,
+    SIM_ENERGY_MODEM,
+    SIM_ENERGY_GNSS,
+    SIM_ENERGY_SENSORS,
+    SIM_ENERGY_COMPONENT_COUNT
+} sim_energy_component_t;
+
+/**
+ * @brief Estado de consumo de um componente no instante 't_us'.
+ * @param until_us Reduzido para o instante em que o estado muda sozinho
+ *                 (ex: fim do T3324), se for antes do valor recebido.
+ * @return Nome do estado (deve existir na tabela de sim_energy.cpp).
+ */
+typedef const char* (*sim_energy_state_fn)(uint64_t t_us, uint64_t* until_us);
+
+/**
+ * @brief Integra o consumo até 't_us'. Chamada pelo núcleo antes de avançar o relógio.
+ */
+void sim_energy_advance(uint64_t t_us);
+
+/**
+ * @brief Marca o início de um despertar (base do resumo por despertar).
+ */
+void sim_energy_wake_begin();
+
+/**
+ * @brief Registra o fim do despertar (antes do deep sleep): resumo e linha do CSV.
+ */
+void sim_energy_wake_end();
+
+/**
+ * @brief Imprime o relatório acumulado (carga por componente/estado e mAh por dia).
+ */
+void sim_energy_report();
+
+/**
+ * @brief Carga total acumulada desde a energização (mAh).
+ */
+double sim_energy_total_mah();
+
+// Estados de cada periférico (implementados junto do respectivo simulador)
+const char* sim_system_mcu_energy_state(uint64_t t_us, uint64_t* until_us);
+const char* sim_sim7000_energy_state(uint64_t t_us, uint64_t* until_us);
+const char* sim_sim7000_gnss_energy_state(uint64_t t_us, uint64_t* until_us);
+const char* sim_sensors_energy_state(uint64_t t_us, uint64_t* until_us);
+
+#endif // SIM_ENERGY_H
@@ -0,0 +1,86 @@
+#include "sim_gpio.h"
+#include "Arduino.h"
+
+#include <vector>
+
+struct SimPin {
+    int level = LOW;
+    void (*isr)(void) = nullptr;
+    int isr_mode = 0;
+    std::vector<std::function<void(int)>> watchers;
+    std::vector<std::function<void(int)>> input_watchers;
+};
+
+static SimPin g_pins[SIM_GPIO_COUNT];
+
+void sim_gpio_reset() {
+    for (SimPin& pin : g_pins) {
+        pin = SimPin();
+    }
+}
+
+void sim_gpio_write(uint8_t pin, int level) {
+    if (pin >= SIM_GPIO_COUNT) {
+        return;
+    }
+    level = level ? HIGH : LOW;
+    bool changed = g_pins[pin].level != level;
+    g_pins[pin].level = level;
+    if (changed) {
+        for (auto& watcher : g_pins[pin].watchers) {
+            watcher(level);
+        }
+    }
+}
+
+int sim_gpio_read(uint8_t pin) {
+    return pin < SIM_GPIO_COUNT ? g_pins[pin].level : LOW;
+}
+
+void sim_gpio_drive(uint8_t pin, int level) {
+    if (pin >= SIM_GPIO_COUNT) {
+        return;
+    }
+    SimPin& p = g_pins[pin];
+    level = level ? HIGH : LOW;
+    int previous = p.level;
+    p.level = level;
+    if (previous == level) {
+        return;
+    }
+    for (auto& watcher : p.input_watchers) {
+        watcher(level);
+    }
+    if (p.isr == nullptr) {
+        return;
+    }
+    bool rising = level == HIGH;
+    if (p.isr_mode == CHANGE || (p.isr_mode == RISING && rising) || (p.isr_mode == FALLING && !rising)) {
+        p.isr();
+    }
+}
+
+void sim_gpio_watch(uint8_t pin, std::function<void(int level)> watcher) {
+    if (pin < SIM_GPIO_COUNT) {
+        g_pins[pin].watchers.push_back(std::move(watcher));
+    }
+}
+
+void sim_gpio_watch_input(uint8_t pin, std::function<void(int level)> watcher) {
+    if (pin < SIM_GPIO_COUNT) {
+        g_pins[pin].input_watchers.push_back(std::move(watcher));
+    }
+}
+
+void sim_gpio_attach_isr(uint8_t pin, void (*isr)(void), int mode) {
+    if (pin < SIM_GPIO_COUNT) {
+        g_pins[pin].isr = isr;
+        g_pins[pin].isr_mode = mode;
+    }
+}
+
+void sim_gpio_detach_isr(uint8_t pin) {
+    if (pin < SIM_GPIO_COUNT) {
+        g_pins[pin].isr = nullptr;
+    }
+}
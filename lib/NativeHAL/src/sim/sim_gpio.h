@@ -0,0 +1,46 @@
+#ifndef SIM_GPIO_H
+#define SIM_GPIO_H
+
+#include <stdint.h>
+#include <functional>
+
+#define SIM_GPIO_COUNT 40
+
+/**
+ * @brief Volta todos os pinos ao estado de reset (nível baixo, sem ISRs).
+ */
+void sim_gpio_reset();
+
+/**
+ * @brief Escrita do firmware num pino de saída (digitalWrite).
+ * Notifica os periféricos que observam o pino.
+ */
+void sim_gpio_write(uint8_t pin, int level);
+
+/**
+ * @brief Nível atual do pino (digitalRead).
+ */
+int sim_gpio_read(uint8_t pin);
+
+/**
+ * @brief Um periférico simulado dirige o nível de um pino de entrada.
+ * Dispara a ISR anexada quando a borda corresponde ao modo.
+ */
+void sim_gpio_drive(uint8_t pin, int level);
+
+/**
+ * @brief Registra um observador das escritas do firmware num pino.
+ */
+void sim_gpio_watch(uint8_t pin, std::function<void(int level)> watcher);
+
+/**
+ * @brief Registra um observador das mudanças de nível de um pino de entrada
+ * (sim_gpio_drive). Usado por periféricos do ESP32 que amostram o pino sem
+ * ISR de GPIO (ex: captura do MCPWM).
+ */
+void sim_gpio_watch_input(uint8_t pin, std::function<void(int level)> watcher);
+
+void sim_gpio_attach_isr(uint8_t pin, void (*isr)(void), int mode);
+void sim_gpio_detach_isr(uint8_t pin);
+
+#endif // SIM_GPIO_H
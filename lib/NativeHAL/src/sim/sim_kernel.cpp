@@ -0,0 +1,220 @@
+#include "sim_kernel.h"
+#include "sim_energy.h"
+#include "sim_params.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Relógio simulado: persiste entre despertares (o tempo não volta a zero)
+SIM_PERSIST static uint64_t g_now_us = 0;
+
+struct SimTask {
+    std::string name;
+    uint64_t wake_us = 0;
+    uint64_t order = 0;  // Desempate FIFO entre tarefas com o mesmo prazo
+    bool done = false;
+    std::condition_variable cv;
+};
+
+struct SimEvent {
+    uint64_t at_us;
+    uint64_t order;
+    std::function<void()> callback;
+};
+
+struct SimEventLater {
+    bool operator()(const SimEvent& a, const SimEvent& b) const {
+        return a.at_us > b.at_us || (a.at_us == b.at_us && a.order > b.order);
+    }
+};
+
+// Lançada por sim_exit_current_task() e capturada na entrada da tarefa
+struct SimTaskExit {};
+
+static std::mutex g_mutex;
+static std::vector<SimTask*> g_tasks;
+static SimTask* g_current = nullptr;
+static std::priority_queue<SimEvent, std::vector<SimEvent>, SimEventLater> g_events;
+static uint64_t g_order = 0;
+static thread_local SimTask* t_self = nullptr;
+
+// Cadência em tempo real
+static std::chrono::steady_clock::time_point g_real_base;
+static uint64_t g_sim_base_us = 0;
+
+static double g_speed = 0.0;
+
+/**
+ * @brief (Função Privada) Move o relógio simulado, cadenciando pelo tempo real
+ * quando sim.speed > 0.
+ */
+static void advance_clock(uint64_t t_us) {
+    if (t_us <= g_now_us) {
+        return;
+    }
+    if (g_speed > 0.0) {
+        std::this_thread::sleep_until(g_real_base +
+                                      std::chrono::microseconds((int64_t)((t_us - g_sim_base_us) / g_speed)));
+    }
+    sim_energy_advance(t_us);
+    g_now_us = t_us;
+}
+
+/**
+ * @brief (Função Privada) Tarefa viva com o menor prazo de despertar.
+ */
+static SimTask* earliest_task() {
+    SimTask* best = nullptr;
+    for (SimTask* task : g_tasks) {
+        if (task->done) {
+            continue;
+        }
+        if (best == nullptr || task->wake_us < best->wake_us ||
+            (task->wake_us == best->wake_us && task->order < best->order)) {
+            best = task;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief (Função Privada) Executa eventos e passa a vez até chegar a vez de 'self'.
+ * Chamada com g_mutex travado; retorna com ele travado.
+ */
+static void run_until_turn(std::unique_lock<std::mutex>& lock, SimTask* self) {
+    for (;;) {
+        SimTask* next = earliest_task();
+        if (!g_events.empty() && (next == nullptr || g_events.top().at_us <= next->wake_us)) {
+            SimEvent event = g_events.top();
+            g_events.pop();
+            advance_clock(event.at_us);
+            lock.unlock();
+            event.callback();
+            lock.lock();
+            continue;
+        }
+        if (next == nullptr) {
+            fprintf(stderr, "NativeSim: ERRO - nenhuma tarefa viva para executar.\n");
+            abort();
+        }
+
+        advance_clock(next->wake_us);
+        if (next == self) {
+            return;
+        }
+        g_current = next;
+        next->cv.notify_one();
+        if (self->done) {
+            return;
+        }
+        self->cv.wait(lock, [self] { return g_current == self; });
+        return;
+    }
+}
+
+uint64_t sim_now_us() {
+    return g_now_us;
+}
+
+void sim_sleep_until_us(uint64_t t_us) {
+    std::unique_lock<std::mutex> lock(g_mutex);
+    SimTask* self = t_self;
+    self->wake_us = t_us > g_now_us ? t_us : g_now_us;
+    self->order = ++g_order;
+    run_until_turn(lock, self);
+}
+
+void sim_sleep_us(uint64_t duration_us) {
+    sim_sleep_until_us(g_now_us + duration_us);
+}
+
+void sim_schedule_us(uint64_t at_us, std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_events.push(SimEvent{at_us > g_now_us ? at_us : g_now_us, ++g_order, std::move(callback)});
+}
+
+bool sim_spawn_task(const char* name, std::function<void()> entry) {
+    SimTask* task = new SimTask();
+    task->name = name ? name : "task";
+    {
+        std::lock_guard<std::mutex> lock(g_mutex);
+        task->wake_us = g_now_us;
+        task->order = ++g_order;
+        g_tasks.push_back(task);
+    }
+
+    std::thread([task, entry]() {
+        t_self = task;
+        {
+            std::unique_lock<std::mutex> lock(g_mutex);
+            task->cv.wait(lock, [task] { return g_current == task; });
+        }
+        try {
+            entry();
+        } catch (const SimTaskExit&) {
+            // vTaskDelete(NULL)
+        }
+        std::unique_lock<std::mutex> lock(g_mutex);
+        task->done = true;
+        run_until_turn(lock, task);
+    }).detach();
+    return true;
+}
+
+void sim_exit_current_task() {
+    if (t_self == g_tasks.front()) {
+        fprintf(stderr, "NativeSim: ERRO - vTaskDelete(NULL) chamado pela tarefa principal.\n");
+        abort();
+    }
+    throw SimTaskExit();
+}
+
+int sim_live_tasks() {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    int live = 0;
+    for (size_t i = 1; i < g_tasks.size(); i++) {
+        if (!g_tasks[i]->done) {
+            live++;
+        }
+    }
+    return live;
+}
+
+void sim_kernel_boot() {
+    SimTask* main_task = new SimTask();
+    main_task->name = "loopTask";
+    main_task->wake_us = g_now_us;
+    g_tasks.push_back(main_task);
+    g_current = main_task;
+    t_self = main_task;
+
+    g_real_base = std::chrono::steady_clock::now();
+    g_sim_base_us = g_now_us;
+    g_speed = sim_param("sim.speed", 0.0);
+}
+
+void sim_kernel_deep_sleep(uint64_t duration_us, bool run_events) {
+    std::unique_lock<std::mutex> lock(g_mutex);
+    // Sem 'run_events', eventos pendentes (ex: URCs do modem) se perdem com o
+    // ESP32 dormindo. O sono nunca é cadenciado: nada do firmware executa nesse
+    // intervalo (só periféricos e o ULP).
+    uint64_t end_us = g_now_us + duration_us;
+    while (run_events && !g_events.empty() && g_events.top().at_us <= end_us) {
+        SimEvent event = g_events.top();
+        g_events.pop();
+        sim_energy_advance(event.at_us);
+        g_now_us = event.at_us;
+        lock.unlock();
+        event.callback();
+        lock.lock();
+    }
+    sim_energy_advance(end_us);
+    g_now_us = end_us;
+}
@@ -0,0 +1,77 @@
+#ifndef SIM_KERNEL_H
+#define SIM_KERNEL_H
+
+#include <stdint.h>
+#include <functional>
+
+/**
+ * Núcleo da simulação nativa: relógio, tarefas cooperativas e eventos.
+ *
+ * O relógio simulado (em microssegundos) só avança quando a tarefa em
+ * execução dorme (delay(), espera de evento do FreeRTOS, timeout de leitura).
+ * Nesse momento o núcleo executa, em ordem de tempo, os eventos agendados
+ * pelos periféricos simulados (bordas de GPIO, bytes chegando na UART) e
+ * acorda a tarefa com o menor prazo. Só uma tarefa roda por vez, então o
+ * código do firmware e as "ISRs" nunca executam simultaneamente.
+ *
+ * Por padrão o relógio avança o mais rápido possível. Com sim.speed = N, os
+ * despertares são cadenciados pelo tempo real (N s simulados por segundo); o
+ * deep sleep nunca é cadenciado.
+ */
+
+// Estado que sobrevive ao deep sleep: variáveis RTC_DATA_ATTR do firmware e o
+// estado dos periféricos externos ao ESP32 (modem, nuvem). Cada despertar roda
+// num processo filho; só esta seção volta para o processo pai ao dormir.
+#define SIM_PERSIST_SECTION "native_rtc"
+#define SIM_PERSIST __attribute__((section(SIM_PERSIST_SECTION), used))
+
+/**
+ * @brief Tempo simulado desde o primeiro boot (µs). Não é zerado no deep sleep.
+ */
+uint64_t sim_now_us();
+
+/**
+ * @brief Bloqueia a tarefa atual até o instante simulado indicado.
+ */
+void sim_sleep_until_us(uint64_t t_us);
+
+/**
+ * @brief Bloqueia a tarefa atual por um intervalo simulado.
+ */
+void sim_sleep_us(uint64_t duration_us);
+
+/**
+ * @brief Agenda um evento de periférico. O callback roda no contexto da
+ * tarefa que estiver avançando o relógio (como uma ISR).
+ */
+void sim_schedule_us(uint64_t at_us, std::function<void()> callback);
+
+/**
+ * @brief Cria uma tarefa cooperativa. Ela começa a rodar quando a tarefa
+ * atual dormir (mesma prioridade do loopTask, sem preempção).
+ */
+bool sim_spawn_task(const char* name, std::function<void()> entry);
+
+/**
+ * @brief Encerra a tarefa atual (vTaskDelete(NULL)). Não retorna.
+ */
+[[noreturn]] void sim_exit_current_task();
+
+/**
+ * @brief Número de tarefas criadas por sim_spawn_task() ainda vivas.
+ */
+int sim_live_tasks();
+
+/**
+ * @brief Prepara o núcleo para um despertar (chamado no processo filho).
+ */
+void sim_kernel_boot();
+
+/**
+ * @brief Avança o relógio pelo tempo de deep sleep.
+ * @param run_events Executa os eventos dos periféricos no intervalo (com o
+ *                   ULP ativo); sem ele, os eventos pendentes são descartados.
+ */
+void sim_kernel_deep_sleep(uint64_t duration_us, bool run_events = false);
+
+#endif // SIM_KERNEL_H
@@ -0,0 +1,603 @@
+#include "mbedtls/ssl.h"
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/error.h"
+#include "mbedtls/platform.h"
+#include "sim_kernel.h"
+#include "sim_params.h"
+#include "sim_tls_wire.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Estados do handshake do cliente
+typedef enum {
+    HS_CLIENT_HELLO = 0,
+    HS_WAIT_SERVER_HELLO,
+    HS_WAIT_SERVER_FLIGHT,       // Handshake completo: certificado do servidor
+    HS_WAIT_SERVER_FINISHED,     // Handshake completo: Finished após o voo do cliente
+    HS_WAIT_RESUMED_FINISHED,    // Retomada: Finished logo após o ServerHello
+    HS_DONE,
+} client_hs_state_t;
+
+// Sessão serializada: "SIMS" + id_len + id + certificado do par (mantido pelo IDF)
+#define SESSION_MAGIC "SIMS"
+#define SESSION_PEER_CERT_BYTES 1150
+#define SESSION_BLOB_BYTES (4 + 1 + 32 + SESSION_PEER_CERT_BYTES)
+
+static void cpu_cost(const char* key, double default_ms) {
+    sim_sleep_us((uint64_t)(sim_param(key, default_ms) * 1000.0));
+}
+
+// ===================================================================
+// --- Alocação (MBEDTLS_PLATFORM_MEMORY) ---
+// ===================================================================
+
+static void* (*g_calloc)(size_t, size_t) = calloc;
+static void (*g_free)(void*) = free;
+
+void* mbedtls_calloc(size_t n, size_t size) {
+    return g_calloc(n, size);
+}
+
+void mbedtls_free(void* ptr) {
+    g_free(ptr);
+}
+
+int mbedtls_platform_set_calloc_free(void* (*calloc_func)(size_t, size_t), void (*free_func)(void*)) {
+    g_calloc = calloc_func;
+    g_free = free_func;
+    return 0;
+}
+
+// ===================================================================
+// --- Erros, RNG e entropia ---
+// ===================================================================
+
+void mbedtls_strerror(int errnum, char* buffer, size_t buflen) {
+    static const struct {
+        int code;
+        const char* text;
+    } ERRORS[] = {
+        {MBEDTLS_ERR_SSL_BAD_INPUT_DATA, "SSL - Bad input parameters to function"},
+        {MBEDTLS_ERR_SSL_INVALID_RECORD, "SSL - An invalid SSL record was received"},
+        {MBEDTLS_ERR_SSL_CONN_EOF, "SSL - The connection indicated an EOF"},
+        {MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE, "SSL - A fatal alert message was received from our peer"},
+        {MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY, "SSL - The peer notified us that the connection is going to be closed"},
+        {MBEDTLS_ERR_SSL_BAD_HS_SERVER_HELLO, "SSL - Processing of the ServerHello handshake message failed"},
+        {MBEDTLS_ERR_SSL_ALLOC_FAILED, "SSL - Memory allocation failed"},
+        {MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL, "SSL - A buffer is too small to receive or write a message"},
+        {MBEDTLS_ERR_SSL_WANT_READ, "SSL - No data of requested type currently available on underlying transport"},
+        {MBEDTLS_ERR_SSL_WANT_WRITE, "SSL - Connection requires a write call"},
+        {MBEDTLS_ERR_SSL_TIMEOUT, "SSL - The operation timed out"},
+        {MBEDTLS_ERR_X509_INVALID_FORMAT, "X509 - The CRT/CRL/CSR format is invalid"},
+        {MBEDTLS_ERR_X509_CERT_VERIFY_FAILED, "X509 - Certificate verification failed"},
+        {MBEDTLS_ERR_X509_ALLOC_FAILED, "X509 - Allocation of memory failed"},
+        {MBEDTLS_ERR_PK_KEY_INVALID_FORMAT, "PK - Invalid key tag or value"},
+        {MBEDTLS_ERR_PK_ALLOC_FAILED, "PK - Memory allocation failed"},
+    };
+    if (buflen == 0) {
+        return;
+    }
+    for (const auto& entry : ERRORS) {
+        if (entry.code == errnum) {
+            snprintf(buffer, buflen, "%s", entry.text);
+            return;
+        }
+    }
+    snprintf(buffer, buflen, "UNKNOWN ERROR CODE (%04X)", (unsigned)(errnum < 0 ? -errnum : errnum));
+}
+
+void mbedtls_entropy_init(mbedtls_entropy_context* ctx) {
+    ctx->initialized = 1;
+}
+
+void mbedtls_entropy_free(mbedtls_entropy_context* ctx) {
+    ctx->initialized = 0;
+}
+
+int mbedtls_entropy_func(void* data, unsigned char* output, size_t len) {
+    (void)data;
+    for (size_t i = 0; i < len; i++) {
+        output[i] = (unsigned char)(lrand48() & 0xFF);
+    }
+    return 0;
+}
+
+void mbedtls_ctr_drbg_init(mbedtls_ctr_drbg_context* ctx) {
+    ctx->seeded = 0;
+}
+
+void mbedtls_ctr_drbg_free(mbedtls_ctr_drbg_context* ctx) {
+    ctx->seeded = 0;
+}
+
+int mbedtls_ctr_drbg_seed(mbedtls_ctr_drbg_context* ctx, int (*f_entropy)(void*, unsigned char*, size_t),
+                          void* p_entropy, const unsigned char* custom, size_t len) {
+    (void)custom;
+    (void)len;
+    unsigned char seed[48];
+    int ret = f_entropy(p_entropy, seed, sizeof(seed));
+    ctx->seeded = ret == 0;
+    return ret;
+}
+
+int mbedtls_ctr_drbg_random(void* p_rng, unsigned char* output, size_t output_len) {
+    (void)p_rng;
+    return mbedtls_entropy_func(nullptr, output, output_len);
+}
+
+// ===================================================================
+// --- Certificados e chave ---
+// ===================================================================
+
+void mbedtls_x509_crt_init(mbedtls_x509_crt* crt) {
+    memset(crt, 0, sizeof(*crt));
+}
+
+void mbedtls_x509_crt_free(mbedtls_x509_crt* crt) {
+    mbedtls_free(crt->raw);
+    memset(crt, 0, sizeof(*crt));
+}
+
+int mbedtls_x509_crt_parse(mbedtls_x509_crt* chain, const unsigned char* buf, size_t buflen) {
+    // Como no mbedTLS, um PEM só é reconhecido com o '\0' incluído no tamanho
+    if (buf == nullptr || buflen == 0 || buf[buflen - 1] != '\0' ||
+        strstr((const char*)buf, "-----BEGIN CERTIFICATE-----") == nullptr) {
+        return MBEDTLS_ERR_X509_INVALID_FORMAT;
+    }
+    // Cópia do DER + estruturas analisadas (~ o tamanho do PEM)
+    unsigned char* raw = (unsigned char*)mbedtls_calloc(1, chain->raw_len + buflen);
+    if (raw == nullptr) {
+        return MBEDTLS_ERR_X509_ALLOC_FAILED;
+    }
+    if (chain->raw != nullptr) {
+        memcpy(raw, chain->raw, chain->raw_len);
+        mbedtls_free(chain->raw);
+    }
+    memcpy(raw + chain->raw_len, buf, buflen);
+    chain->raw = raw;
+    chain->raw_len += buflen;
+    for (const char* p = (const char*)buf; (p = strstr(p, "-----BEGIN CERTIFICATE-----")) != nullptr; p++) {
+        chain->count++;
+    }
+    return 0;
+}
+
+void mbedtls_pk_init(mbedtls_pk_context* ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_pk_free(mbedtls_pk_context* ctx) {
+    mbedtls_free(ctx->key);
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+int mbedtls_pk_parse_key(mbedtls_pk_context* ctx, const unsigned char* key, size_t keylen,
+                         const unsigned char* pwd, size_t pwdlen) {
+    (void)pwd;
+    (void)pwdlen;
+    if (key == nullptr || keylen == 0 || key[keylen - 1] != '\0' ||
+        strstr((const char*)key, "PRIVATE KEY-----") == nullptr) {
+        return MBEDTLS_ERR_PK_KEY_INVALID_FORMAT;
+    }
+    ctx->key = (unsigned char*)mbedtls_calloc(1, keylen);
+    if (ctx->key == nullptr) {
+        return MBEDTLS_ERR_PK_ALLOC_FAILED;
+    }
+    memcpy(ctx->key, key, keylen);
+    ctx->key_len = keylen;
+    return 0;
+}
+
+// ===================================================================
+// --- Configuração ---
+// ===================================================================
+
+void mbedtls_ssl_config_init(mbedtls_ssl_config* conf) {
+    memset(conf, 0, sizeof(*conf));
+}
+
+void mbedtls_ssl_config_free(mbedtls_ssl_config* conf) {
+    memset(conf, 0, sizeof(*conf));
+}
+
+int mbedtls_ssl_config_defaults(mbedtls_ssl_config* conf, int endpoint, int transport, int preset) {
+    (void)preset;
+    if (endpoint != MBEDTLS_SSL_IS_CLIENT || transport != MBEDTLS_SSL_TRANSPORT_STREAM) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA; // Só o papel de cliente TCP é simulado
+    }
+    conf->endpoint = endpoint;
+    conf->authmode = MBEDTLS_SSL_VERIFY_REQUIRED;
+    conf->session_tickets = MBEDTLS_SSL_SESSION_TICKETS_ENABLED;
+    return 0;
+}
+
+void mbedtls_ssl_conf_authmode(mbedtls_ssl_config* conf, int authmode) {
+    conf->authmode = authmode;
+}
+
+void mbedtls_ssl_conf_ca_chain(mbedtls_ssl_config* conf, mbedtls_x509_crt* ca_chain, void* ca_crl) {
+    (void)ca_crl;
+    conf->ca_chain = ca_chain;
+}
+
+void mbedtls_ssl_conf_verify(mbedtls_ssl_config* conf, int (*f_vrfy)(void*, mbedtls_x509_crt*, int, uint32_t*),
+                             void* p_vrfy) {
+    conf->f_vrfy = f_vrfy;
+    conf->p_vrfy = p_vrfy;
+}
+
+void mbedtls_ssl_conf_rng(mbedtls_ssl_config* conf, int (*f_rng)(void*, unsigned char*, size_t), void* p_rng) {
+    conf->f_rng = f_rng;
+    conf->p_rng = p_rng;
+}
+
+void mbedtls_ssl_conf_session_tickets(mbedtls_ssl_config* conf, int use_tickets) {
+    conf->session_tickets = use_tickets;
+}
+
+int mbedtls_ssl_conf_max_frag_len(mbedtls_ssl_config* conf, unsigned char mfl_code) {
+    if (mfl_code > MBEDTLS_SSL_MAX_FRAG_LEN_4096) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    conf->mfl_code = mfl_code;
+    return 0;
+}
+
+int mbedtls_ssl_conf_own_cert(mbedtls_ssl_config* conf, mbedtls_x509_crt* own_cert, mbedtls_pk_context* pk_key) {
+    if (own_cert == nullptr || own_cert->raw == nullptr || pk_key == nullptr || pk_key->key == nullptr) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    conf->own_cert = own_cert;
+    conf->own_key = pk_key;
+    return 0;
+}
+
+// ===================================================================
+// --- Contexto ---
+// ===================================================================
+
+void mbedtls_ssl_init(mbedtls_ssl_context* ssl) {
+    memset(ssl, 0, sizeof(*ssl));
+}
+
+void mbedtls_ssl_free(mbedtls_ssl_context* ssl) {
+    mbedtls_free(ssl->in_buf);
+    mbedtls_free(ssl->out_buf);
+    mbedtls_free(ssl->hostname);
+    memset(ssl, 0, sizeof(*ssl));
+}
+
+int mbedtls_ssl_setup(mbedtls_ssl_context* ssl, const mbedtls_ssl_config* conf) {
+    ssl->conf = conf;
+    // Mesmo consumo de heap dos buffers do IDF (conteúdo + cabeçalho/overhead)
+    ssl->in_buf = (unsigned char*)mbedtls_calloc(1, MBEDTLS_SSL_IN_CONTENT_LEN + SIM_TLS_RECORD_HEADER + SIM_TLS_APP_OVERHEAD + 256);
+    ssl->out_buf = (unsigned char*)mbedtls_calloc(1, MBEDTLS_SSL_OUT_CONTENT_LEN + SIM_TLS_RECORD_HEADER + SIM_TLS_APP_OVERHEAD + 256);
+    if (ssl->in_buf == nullptr || ssl->out_buf == nullptr) {
+        mbedtls_free(ssl->in_buf);
+        mbedtls_free(ssl->out_buf);
+        ssl->in_buf = nullptr;
+        ssl->out_buf = nullptr;
+        return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+    }
+    ssl->state = HS_CLIENT_HELLO;
+    return 0;
+}
+
+int mbedtls_ssl_set_hostname(mbedtls_ssl_context* ssl, const char* hostname) {
+    mbedtls_free(ssl->hostname);
+    ssl->hostname = nullptr;
+    if (hostname != nullptr) {
+        size_t len = strlen(hostname) + 1;
+        ssl->hostname = (char*)mbedtls_calloc(1, len);
+        if (ssl->hostname == nullptr) {
+            return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+        }
+        memcpy(ssl->hostname, hostname, len);
+    }
+    return 0;
+}
+
+void mbedtls_ssl_set_bio(mbedtls_ssl_context* ssl, void* p_bio, mbedtls_ssl_send_t* f_send,
+                         mbedtls_ssl_recv_t* f_recv, mbedtls_ssl_recv_timeout_t* f_recv_timeout) {
+    (void)f_recv_timeout;
+    ssl->p_bio = p_bio;
+    ssl->f_send = f_send;
+    ssl->f_recv = f_recv;
+}
+
+// ===================================================================
+// --- Registros ---
+// ===================================================================
+
+/**
+ * @brief (Função Privada) Monta um registro em out_buf e o envia inteiro.
+ */
+static int send_record(mbedtls_ssl_context* ssl, uint8_t type, const unsigned char* body, size_t length) {
+    sim_tls_write_header(ssl->out_buf, type, length);
+    if (body != nullptr) {
+        memcpy(ssl->out_buf + SIM_TLS_RECORD_HEADER, body, length);
+    } else {
+        memset(ssl->out_buf + SIM_TLS_RECORD_HEADER, 0, length);
+    }
+    size_t total = SIM_TLS_RECORD_HEADER + length;
+    size_t sent = 0;
+    while (sent < total) {
+        int ret = ssl->f_send(ssl->p_bio, ssl->out_buf + sent, total - sent);
+        if (ret < 0) {
+            return ret;
+        }
+        sent += (size_t)ret;
+    }
+    return 0;
+}
+
+/**
+ * @brief (Função Privada) Garante um registro completo no início de in_buf.
+ * @return Tamanho do registro, ou um código de erro (ex: WANT_READ).
+ */
+static int fetch_record(mbedtls_ssl_context* ssl) {
+    const size_t capacity = MBEDTLS_SSL_IN_CONTENT_LEN + SIM_TLS_RECORD_HEADER + SIM_TLS_APP_OVERHEAD;
+    for (;;) {
+        size_t size = sim_tls_record_size(ssl->in_buf, ssl->in_len);
+        if (size != 0) {
+            return (int)size;
+        }
+        if (ssl->in_len >= SIM_TLS_RECORD_HEADER &&
+            SIM_TLS_RECORD_HEADER + (((size_t)ssl->in_buf[3] << 8) | ssl->in_buf[4]) > capacity) {
+            return MBEDTLS_ERR_SSL_INVALID_RECORD;
+        }
+        int ret = ssl->f_recv(ssl->p_bio, ssl->in_buf + ssl->in_len, capacity - ssl->in_len);
+        if (ret < 0) {
+            return ret;
+        }
+        if (ret == 0) {
+            return MBEDTLS_ERR_SSL_CONN_EOF;
+        }
+        ssl->in_len += (size_t)ret;
+    }
+}
+
+static void consume_record(mbedtls_ssl_context* ssl, size_t size) {
+    memmove(ssl->in_buf, ssl->in_buf + size, ssl->in_len - size);
+    ssl->in_len -= size;
+}
+
+// ===================================================================
+// --- Handshake ---
+// ===================================================================
+
+/**
+ * @brief (Função Privada) Processa uma mensagem de handshake do servidor.
+ */
+static int handle_server_message(mbedtls_ssl_context* ssl, const unsigned char* body, size_t length) {
+    switch (ssl->state) {
+        case HS_WAIT_SERVER_HELLO: {
+            if (body[0] != SIM_TLS_SERVER_HELLO || length < 2 + SIM_TLS_SESSION_ID_LEN) {
+                return MBEDTLS_ERR_SSL_BAD_HS_SERVER_HELLO;
+            }
+            bool resumed = body[1] != 0;
+            if (resumed && (!ssl->session_offered || memcmp(ssl->session.id, body + 2, SIM_TLS_SESSION_ID_LEN) != 0)) {
+                return MBEDTLS_ERR_SSL_BAD_HS_SERVER_HELLO;
+            }
+            memcpy(ssl->session.id, body + 2, SIM_TLS_SESSION_ID_LEN);
+            ssl->session.id_len = SIM_TLS_SESSION_ID_LEN;
+            ssl->state = resumed ? HS_WAIT_RESUMED_FINISHED : HS_WAIT_SERVER_FLIGHT;
+            return 0;
+        }
+        case HS_WAIT_SERVER_FLIGHT: {
+            if (body[0] != SIM_TLS_SERVER_CERTIFICATE_FLIGHT) {
+                return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+            }
+            // Verificação da cadeia, ECDHE e assinatura do CertificateVerify
+            // (bignums e cadeia analisada: memória de trabalho só durante o cálculo)
+            void* scratch = mbedtls_calloc(1, (size_t)sim_param("tls.client_full_scratch_bytes", 12288));
+            if (scratch == nullptr) {
+                return MBEDTLS_ERR_SSL_ALLOC_FAILED;
+            }
+            cpu_cost("tls.client_full_cpu_ms", 1200);
+            mbedtls_free(scratch);
+            if (ssl->conf->f_vrfy != nullptr) {
+                uint32_t flags = 0;
+                int ret = ssl->conf->f_vrfy(ssl->conf->p_vrfy, ssl->conf->ca_chain, 0, &flags);
+                if (ret != 0) {
+                    return ret;
+                }
+            }
+            unsigned char flight[SIM_TLS_CLIENT_FLIGHT_BYTES] = {SIM_TLS_CLIENT_KEY_FLIGHT};
+            int ret = send_record(ssl, SIM_TLS_HANDSHAKE, flight, sizeof(flight));
+            if (ret != 0) {
+                return ret;
+            }
+            ssl->state = HS_WAIT_SERVER_FINISHED;
+            return 0;
+        }
+        case HS_WAIT_SERVER_FINISHED:
+        case HS_WAIT_RESUMED_FINISHED: {
+            if (body[0] != SIM_TLS_FINISHED) {
+                return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+            }
+            if (ssl->state == HS_WAIT_RESUMED_FINISHED) {
+                cpu_cost("tls.client_resume_cpu_ms", 40);
+                unsigned char finished[SIM_TLS_FINISHED_BYTES] = {SIM_TLS_FINISHED};
+                int ret = send_record(ssl, SIM_TLS_HANDSHAKE, finished, sizeof(finished));
+                if (ret != 0) {
+                    return ret;
+                }
+            }
+            ssl->session.valid = 1;
+            ssl->state = HS_DONE;
+            return 0;
+        }
+        default:
+            return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+}
+
+int mbedtls_ssl_handshake(mbedtls_ssl_context* ssl) {
+    if (ssl->conf == nullptr || ssl->in_buf == nullptr || ssl->f_send == nullptr) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+
+    while (ssl->state != HS_DONE) {
+        if (ssl->state == HS_CLIENT_HELLO) {
+            unsigned char hello[SIM_TLS_CLIENT_HELLO_BYTES] = {SIM_TLS_CLIENT_HELLO};
+            if (ssl->session_offered) {
+                hello[1] = SIM_TLS_SESSION_ID_LEN;
+                memcpy(hello + 2, ssl->session.id, SIM_TLS_SESSION_ID_LEN);
+            }
+            int ret = send_record(ssl, SIM_TLS_HANDSHAKE, hello, sizeof(hello));
+            if (ret != 0) {
+                return ret;
+            }
+            ssl->state = HS_WAIT_SERVER_HELLO;
+            continue;
+        }
+
+        int size = fetch_record(ssl);
+        if (size < 0) {
+            return size;
+        }
+        uint8_t type = ssl->in_buf[0];
+        const unsigned char* body = ssl->in_buf + SIM_TLS_RECORD_HEADER;
+        size_t length = (size_t)size - SIM_TLS_RECORD_HEADER;
+        int ret;
+        if (type == SIM_TLS_ALERT) {
+            ret = MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE;
+        } else if (type != SIM_TLS_HANDSHAKE || length == 0) {
+            ret = MBEDTLS_ERR_SSL_INVALID_RECORD;
+        } else {
+            ret = handle_server_message(ssl, body, length);
+        }
+        consume_record(ssl, (size_t)size);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    return 0;
+}
+
+// ===================================================================
+// --- Dados de aplicação ---
+// ===================================================================
+
+int mbedtls_ssl_read(mbedtls_ssl_context* ssl, unsigned char* buf, size_t len) {
+    if (ssl->state != HS_DONE) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    while (ssl->app_len == 0) {
+        int size = fetch_record(ssl);
+        if (size < 0) {
+            return size;
+        }
+        uint8_t type = ssl->in_buf[0];
+        size_t length = (size_t)size - SIM_TLS_RECORD_HEADER;
+        if (type == SIM_TLS_ALERT) {
+            consume_record(ssl, (size_t)size);
+            return MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY;
+        }
+        if (type != SIM_TLS_APPLICATION_DATA || length < SIM_TLS_APP_OVERHEAD) {
+            consume_record(ssl, (size_t)size);
+            continue; // Ex: NewSessionTicket
+        }
+        if (length == SIM_TLS_APP_OVERHEAD) {
+            consume_record(ssl, (size_t)size);
+            continue;
+        }
+        // "Decifra" no próprio buffer, como o mbedTLS
+        ssl->app_offset = SIM_TLS_RECORD_HEADER;
+        ssl->app_len = length - SIM_TLS_APP_OVERHEAD;
+    }
+
+    if (buf == nullptr || len == 0) {
+        return 0;
+    }
+    size_t n = len < ssl->app_len ? len : ssl->app_len;
+    memcpy(buf, ssl->in_buf + ssl->app_offset, n);
+    ssl->app_offset += n;
+    ssl->app_len -= n;
+    if (ssl->app_len == 0) {
+        size_t size = sim_tls_record_size(ssl->in_buf, ssl->in_len);
+        consume_record(ssl, size);
+        ssl->app_offset = 0;
+    }
+    return (int)n;
+}
+
+int mbedtls_ssl_write(mbedtls_ssl_context* ssl, const unsigned char* buf, size_t len) {
+    if (ssl->state != HS_DONE) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    size_t chunk = len < MBEDTLS_SSL_OUT_CONTENT_LEN ? len : MBEDTLS_SSL_OUT_CONTENT_LEN;
+    // Payload cifrado = dados + nonce + tag (zeros no lugar dos bytes de verdade)
+    memset(ssl->out_buf + SIM_TLS_RECORD_HEADER + chunk, 0, SIM_TLS_APP_OVERHEAD);
+    memcpy(ssl->out_buf + SIM_TLS_RECORD_HEADER, buf, chunk);
+    int ret = send_record(ssl, SIM_TLS_APPLICATION_DATA, ssl->out_buf + SIM_TLS_RECORD_HEADER,
+                          chunk + SIM_TLS_APP_OVERHEAD);
+    return ret != 0 ? ret : (int)chunk;
+}
+
+size_t mbedtls_ssl_get_bytes_avail(const mbedtls_ssl_context* ssl) {
+    return ssl->app_len;
+}
+
+int mbedtls_ssl_close_notify(mbedtls_ssl_context* ssl) {
+    if (ssl->state != HS_DONE) {
+        return 0;
+    }
+    const unsigned char alert[2] = {1, 0}; // warning, close_notify
+    return send_record(ssl, SIM_TLS_ALERT, alert, sizeof(alert));
+}
+
+// ===================================================================
+// --- Sessão ---
+// ===================================================================
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session* session) {
+    memset(session, 0, sizeof(*session));
+}
+
+void mbedtls_ssl_session_free(mbedtls_ssl_session* session) {
+    memset(session, 0, sizeof(*session));
+}
+
+int mbedtls_ssl_session_save(const mbedtls_ssl_session* session, unsigned char* buf, size_t buf_len, size_t* olen) {
+    *olen = SESSION_BLOB_BYTES;
+    if (buf_len < SESSION_BLOB_BYTES) {
+        return MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+    }
+    memset(buf, 0, SESSION_BLOB_BYTES);
+    memcpy(buf, SESSION_MAGIC, 4);
+    buf[4] = (unsigned char)session->id_len;
+    memcpy(buf + 5, session->id, sizeof(session->id));
+    return 0;
+}
+
+int mbedtls_ssl_session_load(mbedtls_ssl_session* session, const unsigned char* buf, size_t len) {
+    if (len != SESSION_BLOB_BYTES || memcmp(buf, SESSION_MAGIC, 4) != 0 || buf[4] > sizeof(session->id)) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    session->id_len = buf[4];
+    memcpy(session->id, buf + 5, sizeof(session->id));
+    session->valid = 1;
+    return 0;
+}
+
+int mbedtls_ssl_set_session(mbedtls_ssl_context* ssl, const mbedtls_ssl_session* session) {
+    if (ssl->state != HS_CLIENT_HELLO || !session->valid || session->id_len != SIM_TLS_SESSION_ID_LEN) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    ssl->session = *session;
+    ssl->session_offered = 1;
+    return 0;
+}
+
+int mbedtls_ssl_get_session(const mbedtls_ssl_context* ssl, mbedtls_ssl_session* session) {
+    if (ssl->state != HS_DONE || !ssl->session.valid) {
+        return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+    }
+    *session = ssl->session;
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include "sim_params.h"
+#include "sim_kernel.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <string>
+#include <vector>
+
+struct ParamValue {
+    uint64_t from_us;
+    std::string value;
+};
+
+// Carregados no processo pai antes do primeiro despertar; os filhos herdam
+// uma cópia (somente leitura) pelo fork().
+static std::map<std::string, std::vector<ParamValue>> g_params;
+
+static std::string trim(const std::string& text) {
+    size_t begin = 0;
+    while (begin < text.size() && isspace((unsigned char)text[begin])) {
+        begin++;
+    }
+    size_t end = text.size();
+    while (end > begin && isspace((unsigned char)text[end - 1])) {
+        end--;
+    }
+    return text.substr(begin, end - begin);
+}
+
+/**
+ * @brief (Função Privada) Converte "90", "15m", "26h", "2d" em microssegundos.
+ */
+static bool parse_time_us(const std::string& text, uint64_t& out_us) {
+    char* end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    if (end == text.c_str() || value < 0) {
+        return false;
+    }
+    double scale = 1.0;
+    switch (*end) {
+        case '\0':
+        case 's': scale = 1.0; break;
+        case 'm': scale = 60.0; break;
+        case 'h': scale = 3600.0; break;
+        case 'd': scale = 86400.0; break;
+        default: return false;
+    }
+    out_us = (uint64_t)(value * scale * 1e6);
+    return true;
+}
+
+/**
+ * @brief (Função Privada) Valor vigente no instante atual, ou nullptr.
+ */
+static const std::string* current_value(const char* key) {
+    auto it = g_params.find(key);
+    if (it == g_params.end()) {
+        return nullptr;
+    }
+    const std::string* value = nullptr;
+    uint64_t now = sim_now_us();
+    for (const ParamValue& entry : it->second) {
+        if (entry.from_us > now) {
+            break;
+        }
+        value = &entry.value;
+    }
+    return value;
+}
+
+void sim_param_set(const char* key, const char* value, uint64_t from_us) {
+    std::vector<ParamValue>& entries = g_params[key];
+    auto pos = entries.begin();
+    while (pos != entries.end() && pos->from_us <= from_us) {
+        pos++;
+    }
+    entries.insert(pos, ParamValue{from_us, value});
+}
+
+bool sim_param_parse_line(const char* line) {
+    std::string text = trim(line);
+    if (text.empty() || text[0] == '#') {
+        return true;
+    }
+
+    uint64_t from_us = 0;
+    if (text[0] == '@') {
+        size_t space = text.find_first_of(" \t");
+        if (space == std::string::npos || !parse_time_us(text.substr(1, space - 1), from_us)) {
+            return false;
+        }
+        text = trim(text.substr(space));
+    }
+
+    size_t eq = text.find('=');
+    if (eq == std::string::npos) {
+        return false;
+    }
+    std::string key = trim(text.substr(0, eq));
+    std::string value = trim(text.substr(eq + 1));
+    if (key.empty()) {
+        return false;
+    }
+    sim_param_set(key.c_str(), value.c_str(), from_us);
+    return true;
+}
+
+bool sim_params_load_file(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == nullptr) {
+        fprintf(stderr, "NativeSim: ERRO - não foi possível abrir o cenário '%s'.\n", path);
+        return false;
+    }
+    char line[512];
+    int line_number = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        line_number++;
+        if (!sim_param_parse_line(line)) {
+            fprintf(stderr, "NativeSim: ERRO - %s:%d: linha inválida.\n", path, line_number);
+            ok = false;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+double sim_param(const char* key, double default_value) {
+    const std::string* value = current_value(key);
+    if (value == nullptr || value->empty()) {
+        return default_value;
+    }
+    return strtod(value->c_str(), nullptr);
+}
+
+const char* sim_param_str(const char* key, const char* default_value) {
+    const std::string* value = current_value(key);
+    return value != nullptr ? value->c_str() : default_value;
+}
+
+bool sim_param_has(const char* key) {
+    return current_value(key) != nullptr;
+}
@@ -0,0 +1,54 @@
+#ifndef SIM_PARAMS_H
+#define SIM_PARAMS_H
+
+#include <stdint.h>
+
+/**
+ * Parâmetros do cenário de simulação (chave = valor).
+ *
+ * Um cenário é um arquivo texto, uma atribuição por linha:
+ *
+ *     # Rede lenta e PM2.5 subindo no segundo dia
+ *     net.register_ms = 45000
+ *     @2d dsm.pm25_lop = 8.5
+ *     @26h at.+CPSMS = ERROR
+ *
+ * O prefixo opcional "@<tempo>" (sufixos s, m, h, d; padrão s) faz a
+ * atribuição valer a partir daquele instante simulado, o que permite roteirizar
+ * mudanças ao longo de vários dias. Os periféricos consultam os parâmetros a
+ * cada uso, então a mudança vale imediatamente.
+ */
+
+/**
+ * @brief Define um parâmetro a partir do instante simulado 'from_us'.
+ */
+void sim_param_set(const char* key, const char* value, uint64_t from_us = 0);
+
+/**
+ * @brief Interpreta uma linha no formato do cenário ("[@tempo] chave = valor").
+ * @return false se a linha for inválida.
+ */
+bool sim_param_parse_line(const char* line);
+
+/**
+ * @brief Carrega um arquivo de cenário.
+ */
+bool sim_params_load_file(const char* path);
+
+/**
+ * @brief Valor numérico do parâmetro no instante atual (ou o padrão).
+ */
+double sim_param(const char* key, double default_value);
+
+/**
+ * @brief Valor textual do parâmetro no instante atual (ou o padrão).
+ * O ponteiro permanece válido até o fim do processo.
+ */
+const char* sim_param_str(const char* key, const char* default_value);
+
+/**
+ * @brief Indica se o parâmetro tem valor no instante atual.
+ */
+bool sim_param_has(const char* key);
+
+#endif // SIM_PARAMS_H
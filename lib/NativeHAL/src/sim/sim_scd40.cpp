@@ -0,0 +1,87 @@
+#include "sim_scd40.h"
+#include "sim_devices.h"
+#include "sim_kernel.h"
+#include "sim_params.h"
+
+// Estado elétrico: depende do trilho, então recomeça a cada despertar
+static sim_scd40_mode_t g_mode = SIM_SCD40_IDLE;
+static uint64_t g_mode_start_us = 0;
+static uint64_t g_rail_session_us = 0;
+static uint32_t g_consumed = 0;
+static bool g_single_shot_ready = false;
+
+/**
+ * @brief (Função Privada) Volta ao estado de power-on se o trilho foi religado.
+ */
+static void sync_with_rail() {
+    if (g_rail_session_us != sim_sensor_rail_on_us()) {
+        g_rail_session_us = sim_sensor_rail_on_us();
+        g_mode = SIM_SCD40_IDLE;
+        g_consumed = 0;
+        g_single_shot_ready = false;
+    }
+}
+
+static uint32_t measurement_interval_us() {
+    return g_mode == SIM_SCD40_LOW_POWER_PERIODIC ? 30000000UL : 5000000UL;
+}
+
+static uint32_t measurements_done() {
+    if (g_mode != SIM_SCD40_PERIODIC && g_mode != SIM_SCD40_LOW_POWER_PERIODIC) {
+        return 0;
+    }
+    return (uint32_t)((sim_now_us() - g_mode_start_us) / measurement_interval_us());
+}
+
+void sim_scd40_boot() {
+    g_mode = SIM_SCD40_IDLE;
+    g_rail_session_us = 0;
+    g_consumed = 0;
+    g_single_shot_ready = false;
+}
+
+bool sim_scd40_responds() {
+    // Datasheet: até 1000 ms do power-up até o sensor entrar em idle
+    return sim_sensor_rail_on() && sim_param("scd40.present", 1) != 0 &&
+           sim_now_us() - sim_sensor_rail_on_us() >= 1000000ULL;
+}
+
+void sim_scd40_set_mode(sim_scd40_mode_t mode) {
+    sync_with_rail();
+    g_mode = mode;
+    g_mode_start_us = sim_now_us();
+    g_consumed = 0;
+}
+
+sim_scd40_mode_t sim_scd40_mode() {
+    sync_with_rail();
+    return g_mode;
+}
+
+bool sim_scd40_data_ready() {
+    sync_with_rail();
+    return g_single_shot_ready || measurements_done() > g_consumed;
+}
+
+void sim_scd40_take_measurement(uint16_t& co2, float& temperature, float& humidity) {
+    sync_with_rail();
+    if (!sim_scd40_data_ready()) {
+        // Sem dado novo o sensor devolve a última medição (ou zeros no início)
+        co2 = 0;
+        temperature = 0.0f;
+        humidity = 0.0f;
+        return;
+    }
+    g_consumed = measurements_done();
+    g_single_shot_ready = false;
+
+    double value = sim_param("scd40.co2", 450.0) + sim_gaussian() * sim_param("scd40.co2_noise", 10.0);
+    co2 = (uint16_t)(value < 0 ? 0 : value);
+    temperature = (float)(sim_param("scd40.temperature", 24.5) + sim_gaussian() * 0.05);
+    humidity = (float)(sim_param("scd40.humidity", 55.0) + sim_gaussian() * 0.2);
+}
+
+void sim_scd40_single_shot_done() {
+    sync_with_rail();
+    g_single_shot_ready = true;
+}
@@ -0,0 +1,36 @@
+#ifndef SIM_SCD40_H
+#define SIM_SCD40_H
+
+#include <stdint.h>
+
+typedef enum {
+    SIM_SCD40_IDLE = 0,
+    SIM_SCD40_PERIODIC,
+    SIM_SCD40_LOW_POWER_PERIODIC,
+    SIM_SCD40_SLEEP,
+} sim_scd40_mode_t;
+
+/**
+ * @brief Indica se o SCD40 responde (trilho ligado há mais de 1 s).
+ */
+bool sim_scd40_responds();
+
+void sim_scd40_set_mode(sim_scd40_mode_t mode);
+sim_scd40_mode_t sim_scd40_mode();
+
+/**
+ * @brief Indica se há uma medição periódica nova ainda não lida.
+ */
+bool sim_scd40_data_ready();
+
+/**
+ * @brief Consome a medição mais recente (CO2 em ppm, °C, %UR).
+ */
+void sim_scd40_take_measurement(uint16_t& co2, float& temperature, float& humidity);
+
+/**
+ * @brief Executa uma medição única (measure_single_shot) e a deixa pronta.
+ */
+void sim_scd40_single_shot_done();
+
+#endif // SIM_SCD40_H
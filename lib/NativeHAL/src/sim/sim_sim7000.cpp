@@ -0,0 +1,1007 @@
+#include "sim_sim7000.h"
+#include "sim_cloud.h"
+#include "sim_devices.h"
+#include "sim_energy.h"
+#include "sim_gpio.h"
+#include "sim_kernel.h"
+#include "sim_params.h"
+#include "Arduino.h"
+#include "config.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+// ===================================================================
+// --- Estado do modem ---
+// O SIM7000 tem alimentação própria: continua ligado (e registrado) enquanto
+// o ESP32 dorme, então o seu estado fica na seção persistente.
+// ===================================================================
+
+struct ModemState {
+    bool powered;
+    uint32_t power_generation;   // Muda a cada boot do modem (descarta respostas antigas)
+    uint64_t ready_us;           // AT disponível a partir deste instante
+    bool echo;
+    bool radio_on;               // AT+CFUN=1
+    uint64_t registered_us;      // Registro concluído a partir deste instante
+    bool registration_lost;
+    bool pdp_active;
+    bool psm_enabled;            // AT+CPSMS=1 (salvo na NVM do modem)
+    uint64_t psm_active_us;      // T3324 negociado
+    char psm_active_timer[9];    // T3324/T3412 pedidos no AT+CPSMS (bits, como na rede)
+    char psm_tau_timer[9];
+    bool edrx_enabled;           // AT+CEDRXS=1
+    char edrx_value[5];
+    uint8_t cereg_mode;          // <n> do AT+CEREG (4 = com os timers de PSM)
+    uint64_t last_activity_us;   // Última atividade (base do timer T3324)
+    bool clock_synced;           // AT+CNTP concluído desde o boot do modem
+    bool gnss_on;
+    uint64_t gnss_on_us;
+    uint64_t gnss_ttff_us;
+    uint32_t gnss_urc_period_s;
+    uint64_t gnss_last_fix_us;   // Efemérides na RAM do modem (hot start)
+    bool xtra_enabled;           // AT+CGNSXTRA=1
+    bool xtra_file;              // /customer/xtra3grc.bin presente
+    double xtra_file_utc;
+    double xtra_installed_utc;   // AT+CGNSCPY
+    uint64_t tx_from_us;         // Rajada de transmissão atual/agendada (modelo de energia)
+    uint64_t tx_until_us;
+    uint64_t rx_from_us;
+    uint64_t rx_until_us;
+    uint64_t signaling_until_us; // Fim da última sinalização (PDP, NTP): base do RRC inactivity
+};
+
+SIM_PERSIST static ModemState g_modem = {};
+
+// Estado da UART e dos sockets: morre com o despertar do ESP32
+static std::string g_line;
+static uint64_t g_uart_busy_us = 0;
+static uint32_t g_urc_generation = 0;
+
+struct Socket {
+    bool open;
+    std::deque<uint8_t> modem_rx;   // Recebido pelo modem, ainda não lido via AT+CARECV
+    std::deque<uint8_t> esp_rx;     // Já transferido para o ESP32
+    uint64_t uplink_busy_us;
+    uint64_t downlink_busy_us;
+};
+
+static Socket g_sockets[SIM_SIM7000_MUX_COUNT];
+
+// ===================================================================
+// --- Tempos ---
+// ===================================================================
+
+static uint64_t ms_param(const char* key, double default_ms) {
+    return (uint64_t)(sim_param(key, default_ms) * 1000.0);
+}
+
+/**
+ * @brief (Função Privada) Tempo de transmissão de 'bytes' na UART (8N1).
+ */
+static uint64_t uart_us(size_t bytes) {
+    unsigned long baud = Serial1.baudRate() > 0 ? Serial1.baudRate() : 57600;
+    return (uint64_t)bytes * 10ULL * 1000000ULL / baud;
+}
+
+/**
+ * @brief (Função Privada) Tempo de rádio para 'bytes' numa taxa em kbit/s.
+ */
+static uint64_t radio_us(size_t bytes, const char* rate_key, double default_kbps) {
+    double kbps = sim_param(rate_key, default_kbps);
+    if (kbps <= 0.0) {
+        kbps = default_kbps;
+    }
+    return (uint64_t)(bytes * 8.0 / kbps * 1000.0);
+}
+
+static uint64_t half_rtt_us() {
+    return ms_param("net.rtt_ms", 150) / 2;
+}
+
+/**
+ * @brief (Função Privada) Registra uma rajada de rádio [start, end) para o
+ * modelo de energia, emendando com a rajada anterior se forem contíguas.
+ */
+static void radio_burst(uint64_t& from_us, uint64_t& until_us, uint64_t start, uint64_t end) {
+    if (start > until_us) {
+        from_us = start;
+    }
+    if (end > until_us) {
+        until_us = end;
+    }
+}
+
+// ===================================================================
+// --- Alimentação, PSM e registro ---
+// ===================================================================
+
+static bool in_psm() {
+    return g_modem.powered && g_modem.psm_enabled && sim_param("net.psm_granted", 1) != 0 &&
+           sim_now_us() >= g_modem.last_activity_us + g_modem.psm_active_us;
+}
+
+/**
+ * @brief (Função Privada) eDRX pedido pelo modem e concedido pela rede.
+ */
+static bool edrx_granted() {
+    return g_modem.edrx_enabled && sim_param("net.edrx_granted", 1) != 0;
+}
+
+static void close_all_sockets() {
+    for (uint8_t mux = 0; mux < SIM_SIM7000_MUX_COUNT; mux++) {
+        if (g_sockets[mux].open) {
+            sim_cloud_close(mux);
+        }
+        g_sockets[mux].open = false;
+        g_sockets[mux].modem_rx.clear();
+        g_sockets[mux].esp_rx.clear();
+    }
+}
+
+static void gnss_off() {
+    if (g_modem.gnss_on && sim_now_us() >= g_modem.gnss_on_us + g_modem.gnss_ttff_us &&
+        sim_param("gnss.available", 1) != 0) {
+        g_modem.gnss_last_fix_us = sim_now_us();
+    }
+    g_modem.gnss_on = false;
+    g_modem.gnss_urc_period_s = 0;
+    g_urc_generation++;
+}
+
+/**
+ * @brief (Função Privada) Boot do modem (power on ou AT+CFUN=1,1).
+ */
+static void modem_boot() {
+    uint64_t now = sim_now_us();
+    close_all_sockets();
+    g_modem.powered = true;
+    g_modem.power_generation++;
+    g_modem.ready_us = now + ms_param("modem.boot_ms", 4500);
+    g_modem.echo = true;
+    g_modem.cereg_mode = 0;
+    g_modem.radio_on = true;
+    g_modem.registration_lost = false;
+    g_modem.registered_us = g_modem.ready_us +
+                            (uint64_t)(ms_param("net.register_ms", 20000) * (0.7 + 0.6 * sim_uniform()));
+    g_modem.pdp_active = false;
+    g_modem.last_activity_us = now;
+    g_modem.clock_synced = false;
+    g_modem.gnss_on = false;
+    g_modem.gnss_urc_period_s = 0;
+    g_modem.gnss_last_fix_us = 0; // Efemérides ficam na RAM
+    g_urc_generation++;
+    g_uart_busy_us = 0;
+}
+
+static void modem_power_off() {
+    close_all_sockets();
+    gnss_off();
+    g_modem.powered = false;
+    g_modem.power_generation++;
+    g_modem.pdp_active = false;
+    g_modem.gnss_last_fix_us = 0;
+    printf("NativeSim: SIM7000 desligado.\n");
+}
+
+/**
+ * @brief (Função Privada) Status de registro no formato +CEREG (0, 1, 2, 3, 5).
+ */
+static int registration_status() {
+    if (!g_modem.powered || !g_modem.radio_on) {
+        return 0;
+    }
+    if (sim_param("net.denied", 0) != 0) {
+        g_modem.pdp_active = false;
+        return 3;
+    }
+    if (sim_param("net.available", 1) == 0) {
+        g_modem.registration_lost = true;
+        g_modem.pdp_active = false;
+        return 2;
+    }
+    if (g_modem.registration_lost) {
+        g_modem.registration_lost = false;
+        g_modem.registered_us = sim_now_us() + ms_param("net.register_ms", 20000);
+    }
+    if (sim_now_us() < g_modem.registered_us) {
+        return 2;
+    }
+    return sim_param("net.roaming", 0) != 0 ? 5 : 1;
+}
+
+static bool registered() {
+    int status = registration_status();
+    return status == 1 || status == 5;
+}
+
+/**
+ * @brief (Função Privada) Hora do modem: UTC após NTP ou NITZ; senão a hora
+ * padrão do RTC do SIM7000 (1980-01-06) mais o tempo desde o boot.
+ */
+static bool modem_clock_valid() {
+    return g_modem.clock_synced || (sim_param("net.nitz", 1) != 0 && registered());
+}
+
+/**
+ * @brief (Função Privada) Pulso no PWRKEY: liga, desliga ou acorda do PSM.
+ */
+static void on_pwrkey_pulse(uint64_t width_us) {
+    if (!g_modem.powered) {
+        if (width_us >= ms_param("modem.pwrkey_on_ms", 1000)) {
+            printf("NativeSim: SIM7000 ligando (PWRKEY).\n");
+            modem_boot();
+        }
+        return;
+    }
+    if (in_psm()) {
+        // Qualquer pulso acorda o modem do PSM; registro e PDP continuam
+        g_modem.last_activity_us = sim_now_us();
+        g_modem.ready_us = sim_now_us() + ms_param("modem.psm_wake_ms", 200);
+        printf("NativeSim: SIM7000 acordou do PSM (PWRKEY).\n");
+        return;
+    }
+    // Datasheet: >= 1.2 s para desligar; o padrão aceita o mesmo pulso do power on
+    if (width_us >= ms_param("modem.pwrkey_off_ms", 1000)) {
+        modem_power_off();
+    }
+}
+
+// ===================================================================
+// --- UART (respostas e URCs) ---
+// ===================================================================
+
+/**
+ * @brief (Função Privada) Envia texto ao ESP32 após 'delay_us', em ordem.
+ */
+static void send_raw(const std::string& text, uint64_t delay_us) {
+    uint64_t start = sim_now_us() + delay_us;
+    if (start < g_uart_busy_us) {
+        start = g_uart_busy_us;
+    }
+    g_uart_busy_us = start + uart_us(text.size());
+    uint32_t generation = g_modem.power_generation;
+    sim_schedule_us(g_uart_busy_us, [text, generation]() {
+        if (generation == g_modem.power_generation && g_modem.powered) {
+            Serial1.sim_inject(text.c_str());
+        }
+    });
+}
+
+/**
+ * @brief (Função Privada) Envia linhas no formato do modem ("\r\n<linha>\r\n").
+ */
+static void send_lines(const std::vector<std::string>& lines, uint64_t delay_us) {
+    std::string text;
+    for (const std::string& line : lines) {
+        text += "\r\n" + line + "\r\n";
+    }
+    send_raw(text, delay_us);
+}
+
+static void reply(std::vector<std::string> lines, const char* final_result = "OK", uint64_t extra_us = 0) {
+    if (final_result != nullptr) {
+        lines.push_back(final_result);
+    }
+    send_lines(lines, ms_param("modem.at_latency_ms", 20) + extra_us);
+}
+
+static void reply_ok() {
+    reply({});
+}
+
+static void reply_error() {
+    reply({}, "ERROR");
+}
+
+/**
+ * @brief (Função Privada) URC assíncrono, descartado se o modem reiniciar.
+ */
+static void send_urc_later(const std::string& line, uint64_t delay_us) {
+    uint32_t generation = g_modem.power_generation;
+    sim_schedule_us(sim_now_us() + delay_us, [line, generation]() {
+        if (generation == g_modem.power_generation) {
+            send_lines({line}, 0);
+        }
+    });
+}
+
+// ===================================================================
+// --- GNSS ---
+// ===================================================================
+
+static bool gnss_fix() {
+    return g_modem.gnss_on && sim_param("gnss.available", 1) != 0 &&
+           sim_now_us() >= g_modem.gnss_on_us + g_modem.gnss_ttff_us;
+}
+
+/**
+ * @brief (Função Privada) Escolhe o TTFF ao ligar o receptor: hot start com
+ * efemérides recentes, XTRA válido (exige hora no modem) ou cold start.
+ */
+static void gnss_power_on() {
+    double ttff_s;
+    const char* kind;
+    uint64_t now = sim_now_us();
+    bool xtra_usable = g_modem.xtra_enabled && g_modem.xtra_installed_utc > 0 &&
+                       sim_true_utc() - g_modem.xtra_installed_utc < sim_param("gnss.xtra_validity_h", 72) * 3600.0 &&
+                       (modem_clock_valid() || sim_param("gnss.xtra_needs_time", 1) == 0);
+
+    if (g_modem.gnss_last_fix_us != 0 &&
+        now - g_modem.gnss_last_fix_us < (uint64_t)(sim_param("gnss.hot_window_s", 4 * 3600) * 1e6)) {
+        ttff_s = sim_param("gnss.hot_ttff_s", 3);
+        kind = "hot";
+    } else if (xtra_usable) {
+        ttff_s = sim_param("gnss.xtra_ttff_s", 12);
+        kind = "XTRA";
+    } else {
+        ttff_s = sim_param("gnss.cold_ttff_s", 45);
+        kind = "cold";
+    }
+    ttff_s *= 0.8 + 0.4 * sim_uniform();
+
+    g_modem.gnss_on = true;
+    g_modem.gnss_on_us = now;
+    g_modem.gnss_ttff_us = (uint64_t)(ttff_s * 1e6);
+    printf("NativeSim: GNSS ligado (%s start, TTFF previsto %.1f s).\n", kind, ttff_s);
+}
+
+/**
+ * @brief (Função Privada) Campos do AT+CGNSINF / +UGNSINF (ordem do SIM7000).
+ */
+static std::string gnss_info_fields() {
+    if (!g_modem.gnss_on) {
+        return "0" + std::string(20, ',');
+    }
+    if (!gnss_fix()) {
+        return "1,0" + std::string(19, ',');
+    }
+
+    double since_fix_s = (sim_now_us() - g_modem.gnss_on_us - g_modem.gnss_ttff_us) / 1e6;
+    double hdop_final = sim_param("gnss.hdop_final", 0.9);
+    double hdop = hdop_final + (sim_param("gnss.hdop_initial", 3.5) - hdop_final) *
+                  exp(-since_fix_s / sim_param("gnss.hdop_tau_s", 8));
+    int used_max = (int)sim_param("gnss.sats_used", 9);
+    int used = 4 + (int)(since_fix_s / 2.0);
+    if (used > used_max) {
+        used = used_max;
+    }
+    int visible = (int)sim_param("gnss.sats_visible", 14);
+    if (visible < used) {
+        visible = used;
+    }
+
+    // Erro horizontal ~ HDOP x UERE (~2.5 m)
+    double sigma_deg = hdop * 2.5 / 111320.0;
+    double lat = sim_param("gnss.lat", -23.5505) + sim_gaussian() * sigma_deg;
+    double lon = sim_param("gnss.lon", -46.6333) + sim_gaussian() * sigma_deg;
+    double alt = sim_param("gnss.alt", 760) + sim_gaussian() * hdop * 4.0;
+
+    time_t utc = (time_t)sim_true_utc();
+    struct tm tm_utc;
+    gmtime_r(&utc, &tm_utc);
+
+    char fields[200];
+    snprintf(fields, sizeof(fields),
+             "1,1,%04d%02d%02d%02d%02d%02d.000,%.6f,%.6f,%.3f,0.00,0.0,1,,%.1f,%.1f,%.1f,,%d,%d,,,%d,,",
+             tm_utc.tm_year + 1900, tm_utc.tm_mon + 1, tm_utc.tm_mday, tm_utc.tm_hour, tm_utc.tm_min,
+             tm_utc.tm_sec, lat, lon, alt, hdop, hdop * 1.3, hdop * 0.9, visible, used, 40);
+    return fields;
+}
+
+static void schedule_gnss_urc(uint32_t generation) {
+    uint64_t period_us = (uint64_t)g_modem.gnss_urc_period_s * 1000000ULL;
+    sim_schedule_us(sim_now_us() + period_us, [generation]() {
+        if (generation != g_urc_generation || !g_modem.gnss_on || g_modem.gnss_urc_period_s == 0) {
+            return;
+        }
+        send_lines({"+UGNSINF: " + gnss_info_fields()}, 0);
+        schedule_gnss_urc(generation);
+    });
+}
+
+// ===================================================================
+// --- Comandos AT ---
+// ===================================================================
+
+/**
+ * @brief (Função Privada) Resposta roteirizada pelo cenário ("at.<comando>").
+ * @return true se o cenário tratou o comando.
+ */
+static bool scripted_reply(const std::string& head) {
+    std::string key = "at." + head;
+    if (!sim_param_has(key.c_str())) {
+        return false;
+    }
+    std::string script = sim_param_str(key.c_str(), "");
+    if (script == "NONE") {
+        return true;
+    }
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while (start <= script.size()) {
+        size_t bar = script.find('|', start);
+        if (bar == std::string::npos) {
+            bar = script.size();
+        }
+        lines.push_back(script.substr(start, bar - start));
+        start = bar + 1;
+    }
+    reply(lines, nullptr);
+    return true;
+}
+
+/**
+ * @brief (Função Privada) Valor binário de um timer GPRS ("00100011") em µs.
+ * Unidade do T3324 nos 3 bits altos: 000 = 2 s, 001 = 1 min, 010 = 6 min.
+ */
+static uint64_t t3324_us(const std::string& bits) {
+    if (bits.size() != 8) {
+        return 0;
+    }
+    unsigned value = (unsigned)strtoul(bits.c_str(), nullptr, 2);
+    unsigned unit = value >> 5;
+    unsigned count = value & 0x1F;
+    static const uint64_t UNIT_S[] = {2, 60, 360};
+    if (unit > 2) {
+        return 0; // Desativado
+    }
+    return count * UNIT_S[unit] * 1000000ULL;
+}
+
+/**
+ * @brief (Função Privada) Extrai os campos entre aspas de uma lista de argumentos.
+ */
+static std::vector<std::string> quoted_args(const std::string& args) {
+    std::vector<std::string> out;
+    size_t pos = 0;
+    while ((pos = args.find('"', pos)) != std::string::npos) {
+        size_t end = args.find('"', pos + 1);
+        if (end == std::string::npos) {
+            break;
+        }
+        out.push_back(args.substr(pos + 1, end - pos - 1));
+        pos = end + 1;
+    }
+    return out;
+}
+
+static void handle_network_command(const std::string& head, const std::string& args) {
+    if (head == "+CEREG?" && g_modem.cereg_mode == 4) {
+        // Formato estendido: os timers só aparecem se a rede concedeu o PSM
+        int status = registration_status();
+        char line[128];
+        snprintf(line, sizeof(line), "+CEREG: 4,%d,\"%04X\",\"%08lX\",9", status,
+                 (unsigned)sim_param("net.tac", 0x1A2B), (unsigned long)sim_param("net.cell_id", 27446553));
+        std::string text = line;
+        if ((status == 1 || status == 5) && g_modem.psm_enabled && sim_param("net.psm_granted", 1) != 0) {
+            text += std::string(",,,\"") + g_modem.psm_active_timer + "\",\"" + g_modem.psm_tau_timer + "\"";
+        }
+        reply({text});
+    } else if (head == "+CEREG?" || head == "+CGREG?" || head == "+CREG?") {
+        std::string name = head.substr(1, head.size() - 2);
+        reply({"+" + name + ": " + (head == "+CEREG?" ? std::to_string(g_modem.cereg_mode) : "0") + "," +
+               std::to_string(registration_status())});
+    } else if (head == "+CEREG") {
+        g_modem.cereg_mode = (uint8_t)atoi(args.c_str() + 1);
+        reply_ok();
+    } else if (head == "+CEDRXRDP") {
+        if (registered() && edrx_granted()) {
+            reply({std::string("+CEDRXRDP: 4,\"") + g_modem.edrx_value + "\",\"" + g_modem.edrx_value + "\",\"0000\""});
+        } else {
+            reply({"+CEDRXRDP: 0"});
+        }
+    } else if (head == "+CSQ") {
+        int csq = registered() || registration_status() == 2 ? (int)sim_param("net.csq", 18) : 99;
+        reply({"+CSQ: " + std::to_string(csq) + ",99"});
+    } else if (head == "+CPSI?") {
+        if (!registered()) {
+            reply({"+CPSI: NO SERVICE,Online"});
+            return;
+        }
+        char line[128];
+        snprintf(line, sizeof(line), "+CPSI: LTE CAT-M1,Online,724-05,0x%04X,%lu,256,EUTRAN-BAND28,9410,3,3,-11,-95,-67,14",
+                 (unsigned)sim_param("net.tac", 0x1A2B), (unsigned long)sim_param("net.cell_id", 27446553));
+        reply({line});
+    } else if (head == "+CGDCONT" || head == "+CGATT" || head == "+CNCFG") {
+        if (head == "+CGATT" && args == "=1" && !registered()) {
+            reply_error();
+            return;
+        }
+        reply_ok();
+    } else if (head == "+CNACT?") {
+        reply({g_modem.pdp_active && registered() ? "+CNACT: 1,\"10.64.23.117\"" : "+CNACT: 0,\"0.0.0.0\""});
+    } else if (head == "+CNACT") {
+        if (args.compare(0, 2, "=1") == 0) {
+            reply_ok();
+            if (!registered()) {
+                send_urc_later("+APP PDP: DEACTIVE", ms_param("net.pdp_ms", 1500));
+                return;
+            }
+            uint64_t pdp_us = ms_param("net.pdp_ms", 1500);
+            g_modem.signaling_until_us = sim_now_us() + pdp_us;
+            uint32_t generation = g_modem.power_generation;
+            sim_schedule_us(sim_now_us() + pdp_us, [generation]() {
+                if (generation == g_modem.power_generation) {
+                    g_modem.pdp_active = true;
+                }
+            });
+            send_urc_later("+APP PDP: ACTIVE", pdp_us);
+        } else {
+            g_modem.pdp_active = false;
+            close_all_sockets();
+            reply_ok();
+            send_urc_later("+APP PDP: DEACTIVE", ms_param("modem.at_latency_ms", 20) * 2);
+        }
+    } else if (head == "+CNTPCID") {
+        reply_ok();
+    } else if (head == "+CNTP") {
+        if (!args.empty()) {
+            reply_ok(); // Configuração do servidor
+            return;
+        }
+        reply_ok();
+        if (g_modem.pdp_active && sim_param("net.ntp_available", 1) != 0) {
+            uint64_t ntp_us = ms_param("net.ntp_ms", 1200);
+            g_modem.signaling_until_us = sim_now_us() + ntp_us;
+            uint32_t generation = g_modem.power_generation;
+            sim_schedule_us(sim_now_us() + ntp_us, [generation]() {
+                if (generation == g_modem.power_generation) {
+                    g_modem.clock_synced = true;
+                }
+            });
+            send_urc_later("+CNTP: 1", ntp_us);
+        } else {
+            send_urc_later("+CNTP: 61", ms_param("net.ntp_ms", 1200));
+        }
+    } else if (head == "+CCLK?") {
+        time_t t;
+        if (modem_clock_valid()) {
+            t = (time_t)sim_true_utc();
+        } else {
+            t = (time_t)315964800 + (time_t)((sim_now_us() - g_modem.ready_us) / 1000000ULL);
+        }
+        struct tm tm_utc;
+        gmtime_r(&t, &tm_utc);
+        char line[48];
+        snprintf(line, sizeof(line), "+CCLK: \"%02d/%02d/%02d,%02d:%02d:%02d+00\"", tm_utc.tm_year % 100,
+                 tm_utc.tm_mon + 1, tm_utc.tm_mday, tm_utc.tm_hour, tm_utc.tm_min, tm_utc.tm_sec);
+        reply({line});
+    } else {
+        reply_error();
+    }
+}
+
+static void handle_gnss_command(const std::string& head, const std::string& args) {
+    if (head == "+CGNSPWR") {
+        if (args == "=1") {
+            if (!g_modem.gnss_on) {
+                gnss_power_on();
+            }
+        } else if (args == "=0") {
+            gnss_off();
+        }
+        reply_ok();
+    } else if (head == "+CGNSINF") {
+        reply({"+CGNSINF: " + gnss_info_fields()});
+    } else if (head == "+CGNSURC") {
+        g_modem.gnss_urc_period_s = (uint32_t)atoi(args.c_str() + 1);
+        g_urc_generation++;
+        if (g_modem.gnss_urc_period_s > 0) {
+            schedule_gnss_urc(g_urc_generation);
+        }
+        reply_ok();
+    } else if (head == "+SGPIO") {
+        reply_ok();
+    } else if (head == "+CGNSXTRA") {
+        g_modem.xtra_enabled = args == "=1";
+        reply_ok();
+    } else if (head == "+CGNSCPY") {
+        if (!g_modem.xtra_file) {
+            reply_error();
+            return;
+        }
+        g_modem.xtra_installed_utc = g_modem.xtra_file_utc;
+        reply({}, "OK", ms_param("gnss.xtra_copy_ms", 300));
+    } else if (head == "+HTTPTOFS") {
+        reply_ok();
+        int status = (int)sim_param("gnss.xtra_http_status", 200);
+        size_t size = (size_t)sim_param("gnss.xtra_bytes", 41000);
+        if (!g_modem.pdp_active) {
+            send_urc_later("+HTTPTOFS: 603,0", ms_param("modem.http_setup_ms", 1500));
+            return;
+        }
+        uint64_t download_us = ms_param("modem.http_setup_ms", 1500) + 3 * ms_param("net.rtt_ms", 150) +
+                               radio_us(size, "net.downlink_kbps", 300);
+        g_modem.signaling_until_us = sim_now_us() + download_us;
+        if (status == 200) {
+            radio_burst(g_modem.rx_from_us, g_modem.rx_until_us,
+                        sim_now_us() + download_us - radio_us(size, "net.downlink_kbps", 300),
+                        sim_now_us() + download_us);
+            uint32_t generation = g_modem.power_generation;
+            sim_schedule_us(sim_now_us() + download_us, [generation]() {
+                if (generation == g_modem.power_generation) {
+                    g_modem.xtra_file = true;
+                    g_modem.xtra_file_utc = sim_true_utc();
+                }
+            });
+        }
+        send_urc_later("+HTTPTOFS: " + std::to_string(status) + "," + std::to_string(status == 200 ? size : 0),
+                       download_us);
+    } else {
+        reply_error();
+    }
+}
+
+/**
+ * @brief (Função Privada) Executa uma linha de comando recebida na UART.
+ */
+static void execute_command(std::string line) {
+    if (g_modem.echo) {
+        send_raw(line + "\r", 0);
+    }
+    g_modem.last_activity_us = sim_now_us();
+
+    std::string upper = line;
+    for (char& c : upper) {
+        c = (char)toupper((unsigned char)c);
+    }
+    if (upper.compare(0, 2, "AT") != 0) {
+        return;
+    }
+    std::string command = line.substr(2);
+    size_t split = command.find_first_of("=?");
+    std::string head = command.substr(0, split);
+    std::string args = split == std::string::npos ? "" : command.substr(split);
+    if (args == "?") {
+        head += "?"; // Consultas são tratadas como um comando próprio ("+CPSI?")
+    }
+    for (char& c : head) {
+        c = (char)toupper((unsigned char)c);
+    }
+
+    if (scripted_reply(head)) {
+        return;
+    }
+
+    if (head.empty()) {
+        reply_ok();
+    } else if (head == "E0" || head == "E1") {
+        g_modem.echo = head == "E1";
+        reply_ok();
+    } else if (head == "+CMEE" || head == "+CLTS" || head == "+CMNB" || head == "+CNMP" || head == "&W") {
+        reply_ok();
+    } else if (head == "+CPIN?") {
+        reply({"+CPIN: READY"});
+    } else if (head == "I") {
+        reply({"SIMCOM_SIM7000G", "R1529"});
+    } else if (head == "+CFUN") {
+        if (args == "=1,1") {
+            reply_ok();
+            uint32_t generation = g_modem.power_generation;
+            sim_schedule_us(sim_now_us() + ms_param("modem.at_latency_ms", 20) + 1000, [generation]() {
+                if (generation == g_modem.power_generation) {
+                    modem_boot();
+                }
+            });
+            return;
+        }
+        g_modem.radio_on = args != "=0";
+        if (g_modem.radio_on) {
+            g_modem.registration_lost = true;
+        } else {
+            g_modem.pdp_active = false;
+            close_all_sockets();
+        }
+        reply({}, "OK", ms_param("modem.cfun_ms", 800));
+    } else if (head == "+CPSMS") {
+        std::vector<std::string> timers = quoted_args(args);
+        g_modem.psm_enabled = args.compare(0, 2, "=1") == 0;
+        g_modem.psm_active_us = timers.size() >= 2 ? t3324_us(timers[1]) : ms_param("modem.psm_active_ms", 2000);
+        snprintf(g_modem.psm_tau_timer, sizeof(g_modem.psm_tau_timer), "%s",
+                 timers.size() >= 1 ? timers[0].c_str() : "00100100");
+        snprintf(g_modem.psm_active_timer, sizeof(g_modem.psm_active_timer), "%s",
+                 timers.size() >= 2 ? timers[1].c_str() : "00000001");
+        reply_ok();
+    } else if (head == "+CEDRXS") {
+        std::vector<std::string> value = quoted_args(args);
+        g_modem.edrx_enabled = args.compare(0, 2, "=1") == 0;
+        snprintf(g_modem.edrx_value, sizeof(g_modem.edrx_value), "%s", value.empty() ? "0101" : value[0].c_str());
+        reply_ok();
+    } else if (head == "+CPOWD") {
+        reply({"NORMAL POWER DOWN"}, nullptr);
+        uint32_t generation = g_modem.power_generation;
+        sim_schedule_us(sim_now_us() + ms_param("modem.at_latency_ms", 20) + 50000, [generation]() {
+            if (generation == g_modem.power_generation) {
+                modem_power_off();
+            }
+        });
+    } else if (head.compare(0, 5, "+CGNS") == 0 || head == "+SGPIO" || head == "+HTTPTOFS") {
+        handle_gnss_command(head, args);
+    } else {
+        handle_network_command(head, args);
+    }
+}
+
+/**
+ * @brief (Função Privada) Bytes transmitidos pelo ESP32 na Serial1.
+ */
+static void on_uart_tx(const uint8_t* data, size_t length) {
+    if (!sim_sim7000_at_ready()) {
+        g_line.clear();
+        return; // Modem desligado, em boot ou em PSM: os bytes se perdem
+    }
+    for (size_t i = 0; i < length; i++) {
+        char c = (char)data[i];
+        if (c == '\r') {
+            if (!g_line.empty()) {
+                execute_command(g_line);
+            }
+            g_line.clear();
+        } else if (c != '\n') {
+            g_line += c;
+        }
+    }
+}
+
+void sim_sim7000_boot() {
+    g_line.clear();
+    g_uart_busy_us = 0;
+    g_urc_generation++;
+    for (Socket& socket : g_sockets) {
+        socket = Socket();
+    }
+
+    Serial1.sim_attach_device(on_uart_tx);
+
+    // PWRKEY (via transistor): nível alto no GPIO = PWRKEY do modem em nível baixo
+    static uint64_t pulse_start_us = 0;
+    pulse_start_us = 0;
+    sim_gpio_watch(MODEM_PWRKEY_PIN, [](int level) {
+        if (level == HIGH) {
+            pulse_start_us = sim_now_us();
+        } else if (pulse_start_us != 0) {
+            on_pwrkey_pulse(sim_now_us() - pulse_start_us);
+            pulse_start_us = 0;
+        }
+    });
+
+    // GNSS ligado com URCs ativos continua emitindo após o ESP32 acordar
+    if (g_modem.powered && g_modem.gnss_on && g_modem.gnss_urc_period_s > 0) {
+        schedule_gnss_urc(g_urc_generation);
+    }
+}
+
+bool sim_sim7000_at_ready() {
+    return g_modem.powered && sim_now_us() >= g_modem.ready_us && !in_psm();
+}
+
+// ===================================================================
+// --- Sockets (plano de dados) ---
+// ===================================================================
+
+/**
+ * @brief (Função Privada) Custo de um comando AT de dados (+CAOPEN, +CASEND...).
+ */
+static void at_exchange(size_t bytes_to_modem, size_t bytes_from_modem) {
+    g_modem.last_activity_us = sim_now_us();
+    sim_sleep_us(ms_param("modem.at_latency_ms", 20) + uart_us(24 + bytes_to_modem) + uart_us(12 + bytes_from_modem));
+}
+
+bool sim_sim7000_socket_open(uint8_t mux, const char* host, uint16_t port) {
+    if (mux >= SIM_SIM7000_MUX_COUNT || !sim_sim7000_at_ready()) {
+        return false;
+    }
+    Socket& socket = g_sockets[mux];
+    if (socket.open) {
+        sim_sim7000_socket_close(mux);
+    }
+    at_exchange(strlen(host) + 16, 0);
+    if (!g_modem.pdp_active || !registered()) {
+        return false;
+    }
+    // DNS + SYN/SYN-ACK
+    g_modem.signaling_until_us = sim_now_us() + 2 * ms_param("net.rtt_ms", 150);
+    sim_sleep_us(2 * ms_param("net.rtt_ms", 150));
+    if (!sim_cloud_open(mux, host, port)) {
+        return false;
+    }
+    socket = Socket();
+    socket.open = true;
+    return true;
+}
+
+size_t sim_sim7000_socket_send(uint8_t mux, const uint8_t* data, size_t length) {
+    if (mux >= SIM_SIM7000_MUX_COUNT || !g_sockets[mux].open || !sim_sim7000_at_ready()) {
+        return 0;
+    }
+    Socket& socket = g_sockets[mux];
+    at_exchange(length, 0);
+
+    uint64_t start = sim_now_us();
+    if (start < socket.uplink_busy_us) {
+        start = socket.uplink_busy_us;
+    }
+    socket.uplink_busy_us = start + radio_us(length + 40, "net.uplink_kbps", 100);
+    radio_burst(g_modem.tx_from_us, g_modem.tx_until_us, start, socket.uplink_busy_us);
+    std::vector<uint8_t> payload(data, data + length);
+    uint32_t generation = g_modem.power_generation;
+    sim_schedule_us(socket.uplink_busy_us + half_rtt_us(), [mux, payload, generation]() {
+        if (generation == g_modem.power_generation && g_sockets[mux].open) {
+            sim_cloud_receive(mux, payload.data(), payload.size());
+        }
+    });
+    return length;
+}
+
+void sim_sim7000_socket_deliver(uint8_t mux, const uint8_t* data, size_t length, uint64_t extra_delay_us) {
+    if (mux >= SIM_SIM7000_MUX_COUNT || !g_sockets[mux].open) {
+        return;
+    }
+    Socket& socket = g_sockets[mux];
+    uint64_t start = sim_now_us() + extra_delay_us;
+    if (start < socket.downlink_busy_us) {
+        start = socket.downlink_busy_us;
+    }
+    socket.downlink_busy_us = start + radio_us(length + 40, "net.downlink_kbps", 300);
+    radio_burst(g_modem.rx_from_us, g_modem.rx_until_us, start, socket.downlink_busy_us);
+    std::vector<uint8_t> payload(data, data + length);
+    uint32_t generation = g_modem.power_generation;
+    sim_schedule_us(socket.downlink_busy_us + half_rtt_us(), [mux, payload, generation]() {
+        if (generation == g_modem.power_generation && g_sockets[mux].open) {
+            g_sockets[mux].modem_rx.insert(g_sockets[mux].modem_rx.end(), payload.begin(), payload.end());
+        }
+    });
+}
+
+void sim_sim7000_socket_remote_close(uint8_t mux) {
+    if (mux >= SIM_SIM7000_MUX_COUNT) {
+        return;
+    }
+    // Depois dos dados já em trânsito
+    uint64_t at = g_sockets[mux].downlink_busy_us + half_rtt_us();
+    if (at < sim_now_us() + half_rtt_us()) {
+        at = sim_now_us() + half_rtt_us();
+    }
+    uint32_t generation = g_modem.power_generation;
+    sim_schedule_us(at, [mux, generation]() {
+        if (generation == g_modem.power_generation) {
+            g_sockets[mux].open = false;
+        }
+    });
+}
+
+size_t sim_sim7000_socket_available(uint8_t mux) {
+    if (mux >= SIM_SIM7000_MUX_COUNT) {
+        return 0;
+    }
+    Socket& socket = g_sockets[mux];
+    size_t pending = socket.esp_rx.size() + socket.modem_rx.size();
+    if (pending == 0) {
+        // Consulta ao modem (URC/AT+CARECV?) custa tempo: evita espera ocupada
+        sim_sleep_us(1000);
+    }
+    return pending;
+}
+
+int sim_sim7000_socket_read(uint8_t mux, uint8_t* buffer, size_t length) {
+    if (mux >= SIM_SIM7000_MUX_COUNT) {
+        return -1;
+    }
+    Socket& socket = g_sockets[mux];
+    if (socket.esp_rx.empty() && !socket.modem_rx.empty()) {
+        // AT+CARECV: transfere um lote do buffer do modem para o ESP32
+        size_t batch = socket.modem_rx.size() < 1460 ? socket.modem_rx.size() : 1460;
+        at_exchange(0, batch);
+        socket.esp_rx.insert(socket.esp_rx.end(), socket.modem_rx.begin(), socket.modem_rx.begin() + batch);
+        socket.modem_rx.erase(socket.modem_rx.begin(), socket.modem_rx.begin() + batch);
+    }
+    if (socket.esp_rx.empty()) {
+        return -1;
+    }
+    size_t n = 0;
+    while (n < length && !socket.esp_rx.empty()) {
+        buffer[n++] = socket.esp_rx.front();
+        socket.esp_rx.pop_front();
+    }
+    return (int)n;
+}
+
+bool sim_sim7000_socket_connected(uint8_t mux) {
+    if (mux >= SIM_SIM7000_MUX_COUNT) {
+        return false;
+    }
+    const Socket& socket = g_sockets[mux];
+    return socket.open || !socket.esp_rx.empty() || !socket.modem_rx.empty();
+}
+
+void sim_sim7000_socket_close(uint8_t mux) {
+    if (mux >= SIM_SIM7000_MUX_COUNT || !g_sockets[mux].open) {
+        return;
+    }
+    if (sim_sim7000_at_ready()) {
+        at_exchange(12, 0);
+    }
+    g_sockets[mux].open = false;
+    g_sockets[mux].modem_rx.clear();
+    g_sockets[mux].esp_rx.clear();
+    sim_cloud_close(mux);
+}
+
+// ===================================================================
+// --- Modelo de energia ---
+// ===================================================================
+
+static void clamp_until(uint64_t* until_us, uint64_t t_us, uint64_t change_us) {
+    if (change_us > t_us && change_us < *until_us) {
+        *until_us = change_us;
+    }
+}
+
+const char* sim_sim7000_energy_state(uint64_t t_us, uint64_t* until_us) {
+    if (!g_modem.powered) {
+        return "off";
+    }
+    if (t_us < g_modem.ready_us) {
+        clamp_until(until_us, t_us, g_modem.ready_us);
+        return "boot";
+    }
+    if (g_modem.psm_enabled && sim_param("net.psm_granted", 1) != 0) {
+        uint64_t psm_at = g_modem.last_activity_us + g_modem.psm_active_us;
+        if (t_us >= psm_at) {
+            return "psm";
+        }
+        clamp_until(until_us, t_us, psm_at);
+    }
+    if (!g_modem.radio_on) {
+        return "min_func";
+    }
+    if (sim_param("net.denied", 0) != 0 || sim_param("net.available", 1) == 0 || g_modem.registration_lost ||
+        t_us < g_modem.registered_us) {
+        clamp_until(until_us, t_us, g_modem.registered_us);
+        return "search";
+    }
+
+    clamp_until(until_us, t_us, g_modem.tx_from_us);
+    clamp_until(until_us, t_us, g_modem.rx_from_us);
+    if (t_us >= g_modem.tx_from_us && t_us < g_modem.tx_until_us) {
+        clamp_until(until_us, t_us, g_modem.tx_until_us);
+        return "tx";
+    }
+    if (t_us >= g_modem.rx_from_us && t_us < g_modem.rx_until_us) {
+        clamp_until(until_us, t_us, g_modem.rx_until_us);
+        return "rx";
+    }
+
+    uint64_t last_traffic = g_modem.signaling_until_us;
+    if (g_modem.tx_until_us > last_traffic) {
+        last_traffic = g_modem.tx_until_us;
+    }
+    if (g_modem.rx_until_us > last_traffic) {
+        last_traffic = g_modem.rx_until_us;
+    }
+    uint64_t rrc_release = last_traffic + ms_param("net.rrc_inactivity_ms", 10000);
+    if (last_traffic != 0 && t_us < rrc_release) {
+        clamp_until(until_us, t_us, rrc_release);
+        return "connected";
+    }
+    return edrx_granted() ? "edrx" : "idle";
+}
+
+const char* sim_sim7000_gnss_energy_state(uint64_t t_us, uint64_t* until_us) {
+    if (!g_modem.powered || !g_modem.gnss_on) {
+        return "off";
+    }
+    uint64_t fix_us = g_modem.gnss_on_us + g_modem.gnss_ttff_us;
+    if (t_us < fix_us || sim_param("gnss.available", 1) == 0) {
+        clamp_until(until_us, t_us, fix_us);
+        return "acquire";
+    }
+    return "track";
+}
@@ -0,0 +1,67 @@
+#ifndef SIM_SIM7000_H
+#define SIM_SIM7000_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * SIM7000G simulado: diálogo AT na Serial1, alimentação pelo PWRKEY,
+ * registro LTE-M, PDP, PSM/eDRX, GNSS (com XTRA) e sockets TCP.
+ *
+ * O plano de controle é AT puro: o substituto do TinyGSM escreve comandos na
+ * Serial1 e lê as respostas que este módulo injeta nela, com a latência do
+ * modem e o tempo de UART. As respostas podem ser roteirizadas por comando
+ * com parâmetros "at.<comando>" (linhas separadas por '|', NONE = sem resposta):
+ *
+ *     at.+CPSMS = ERROR
+ *     at.+CPSI? = +CPSI: NO SERVICE,Online|OK
+ *
+ * O plano de dados (sockets) é servido por chamadas diretas, com o custo de
+ * AT+CASEND/AT+CARECV, UART e rádio contabilizado no relógio simulado. A outra
+ * ponta dos sockets é a nuvem simulada (sim_cloud.h).
+ */
+
+#define SIM_SIM7000_MUX_COUNT 4
+
+/**
+ * @brief Indica se o modem está ligado e respondendo a comandos AT.
+ */
+bool sim_sim7000_at_ready();
+
+/**
+ * @brief Abre um socket TCP (bloqueia pelo tempo do AT+CAOPEN).
+ */
+bool sim_sim7000_socket_open(uint8_t mux, const char* host, uint16_t port);
+
+/**
+ * @brief Envia dados pelo socket (bloqueia pelo tempo do AT+CASEND).
+ * @return Bytes aceitos (0 se o socket não está aberto).
+ */
+size_t sim_sim7000_socket_send(uint8_t mux, const uint8_t* data, size_t length);
+
+/**
+ * @brief Bytes já recebidos pelo modem e ainda não lidos pelo ESP32.
+ * Quando não há nada, gasta o tempo de uma consulta ao modem.
+ */
+size_t sim_sim7000_socket_available(uint8_t mux);
+
+/**
+ * @brief Lê dados recebidos (o custo do AT+CARECV é cobrado por lote).
+ */
+int sim_sim7000_socket_read(uint8_t mux, uint8_t* buffer, size_t length);
+
+bool sim_sim7000_socket_connected(uint8_t mux);
+void sim_sim7000_socket_close(uint8_t mux);
+
+/**
+ * @brief (Lado da nuvem) Entrega dados ao socket após a latência de descida.
+ * @param extra_delay_us Tempo de processamento no servidor.
+ */
+void sim_sim7000_socket_deliver(uint8_t mux, const uint8_t* data, size_t length, uint64_t extra_delay_us);
+
+/**
+ * @brief (Lado da nuvem) O servidor fechou a conexão.
+ */
+void sim_sim7000_socket_remote_close(uint8_t mux);
+
+#endif // SIM_SIM7000_H
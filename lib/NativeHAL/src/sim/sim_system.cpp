@@ -0,0 +1,227 @@
+#include "sim_system.h"
+#include "sim_devices.h"
+#include "sim_energy.h"
+#include "sim_gpio.h"
+#include "sim_kernel.h"
+#include "sim_params.h"
+#include "sim_ulp.h"
+#include "Arduino.h"
+#include "esp_sleep.h"
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Códigos de saída do processo de um despertar
+#define SIM_EXIT_DEEP_SLEEP 0
+#define SIM_EXIT_RESTART 3
+#define SIM_EXIT_FAILURE 4
+
+// Limites da seção persistente (gerados pelo linker para seções com nome de identificador C)
+extern "C" char __start_native_rtc[];
+extern "C" char __stop_native_rtc[];
+
+SIM_PERSIST static uint32_t g_boot_count = 0;
+SIM_PERSIST static uint8_t g_next_boot_reason = SIM_BOOT_POWER_ON;
+
+// Relógio de sistema do ESP32: hora = offset + tempo simulado + erro do RTC.
+// O erro acumula só no deep sleep (o RTC slow clock deriva; o cristal não).
+SIM_PERSIST static int64_t g_sys_time_offset_us = 0;
+SIM_PERSIST static int64_t g_rtc_error_us = 0;
+SIM_PERSIST static bool g_sys_time_initialized = false;
+
+static void* g_shared_rtc = nullptr;
+static bool g_mcu_asleep = false;
+static uint64_t g_boot_us = 0;
+static sim_boot_reason_t g_boot_reason = SIM_BOOT_POWER_ON;
+static size_t g_heap_baseline = 0;
+static uint32_t g_min_free_heap = 0;
+
+/**
+ * @brief (Função Privada) Salva a seção persistente e termina o processo filho.
+ */
+[[noreturn]] static void finish_wake(int exit_code) {
+    fflush(stdout);
+    fflush(stderr);
+    memcpy(g_shared_rtc, __start_native_rtc, (size_t)(__stop_native_rtc - __start_native_rtc));
+    _exit(exit_code);
+}
+
+/**
+ * @brief (Função Privada) Corpo de um despertar (processo filho).
+ */
+[[noreturn]] static void run_wake() {
+    g_boot_count++;
+    g_boot_reason = (sim_boot_reason_t)g_next_boot_reason;
+    g_next_boot_reason = SIM_BOOT_SOFTWARE_RESET; // Se o firmware "travar" e reiniciar
+    srand48((long)sim_param("sim.seed", 1) * 7919L + (long)g_boot_count);
+
+    if (!g_sys_time_initialized) {
+        // Boot "frio": o relógio do sistema começa em 0 (1970) até o NTP
+        g_sys_time_offset_us = -(int64_t)sim_now_us();
+        g_sys_time_initialized = true;
+    }
+
+    sim_kernel_boot();
+    sim_energy_wake_begin();
+    g_boot_us = sim_now_us();
+    g_heap_baseline = mallinfo2().uordblks;
+    g_min_free_heap = sim_system_heap_size();
+
+    sim_gpio_reset();
+    sim_devices_boot();
+    sim_ulp_boot();
+
+    if (g_boot_reason == SIM_BOOT_DEEP_SLEEP) {
+        esp_wake_deep_sleep();
+    }
+
+    setup();
+    for (;;) {
+        loop();
+    }
+}
+
+int sim_system_run_cycles(uint32_t cycles, uint64_t until_us) {
+    size_t size = (size_t)(__stop_native_rtc - __start_native_rtc);
+    g_shared_rtc = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (g_shared_rtc == MAP_FAILED) {
+        perror("NativeSim: mmap");
+        return 1;
+    }
+
+    for (uint32_t cycle = 0; cycle < cycles && sim_now_us() < until_us; cycle++) {
+        printf("\n===== NativeSim: despertar %u (t = %.1f s) =====\n",
+               g_boot_count + 1, sim_now_us() / 1e6);
+        fflush(stdout);
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("NativeSim: fork");
+            return 1;
+        }
+        if (pid == 0) {
+            run_wake();
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) ||
+            (WEXITSTATUS(status) != SIM_EXIT_DEEP_SLEEP && WEXITSTATUS(status) != SIM_EXIT_RESTART)) {
+            fprintf(stderr, "NativeSim: ERRO - o despertar %u terminou sem deep sleep (status 0x%x).\n",
+                    g_boot_count + 1, status);
+            return 1;
+        }
+        memcpy(__start_native_rtc, g_shared_rtc, size);
+    }
+    sim_energy_report();
+    return 0;
+}
+
+uint64_t sim_system_boot_us() {
+    return g_boot_us;
+}
+
+sim_boot_reason_t sim_system_boot_reason() {
+    return g_boot_reason;
+}
+
+uint32_t sim_system_boot_count() {
+    return g_boot_count;
+}
+
+void sim_system_deep_sleep(uint64_t duration_us) {
+    if (sim_live_tasks() > 0) {
+        fprintf(stderr, "NativeSim: ERRO - deep sleep com %d tarefa(s) ainda ativa(s).\n", sim_live_tasks());
+        fflush(stdout);
+        _exit(SIM_EXIT_FAILURE);
+    }
+    sim_energy_wake_end();
+    g_mcu_asleep = true;
+    // As ISRs de GPIO do firmware não rodam com os núcleos desligados
+    for (uint8_t pin = 0; pin < SIM_GPIO_COUNT; pin++) {
+        sim_gpio_detach_isr(pin);
+    }
+    sim_kernel_deep_sleep(duration_us, sim_ulp_running());
+    g_rtc_error_us += (int64_t)((double)duration_us * sim_param("esp.rtc_drift_ppm", 200.0) * 1e-6);
+    g_next_boot_reason = SIM_BOOT_DEEP_SLEEP;
+    finish_wake(SIM_EXIT_DEEP_SLEEP);
+}
+
+void sim_system_restart() {
+    sim_energy_wake_end();
+    g_next_boot_reason = SIM_BOOT_SOFTWARE_RESET;
+    finish_wake(SIM_EXIT_RESTART);
+}
+
+const char* sim_system_mcu_energy_state(uint64_t t_us, uint64_t* until_us) {
+    (void)t_us;
+    (void)until_us;
+    if (!g_mcu_asleep) {
+        return "active";
+    }
+    return sim_ulp_running() ? "deep_sleep_ulp" : "deep_sleep";
+}
+
+double sim_true_utc() {
+    return sim_param("sim.start_epoch", 1767225600.0) + sim_now_us() / 1e6;
+}
+
+uint32_t sim_system_heap_size() {
+    return (uint32_t)sim_param("esp.heap_bytes", 300000);
+}
+
+uint32_t sim_system_free_heap() {
+    long used = (long)mallinfo2().uordblks - (long)g_heap_baseline;
+    long free_bytes = (long)sim_system_heap_size() - (used > 0 ? used : 0);
+    uint32_t result = free_bytes > 0 ? (uint32_t)free_bytes : 0;
+    if (result < g_min_free_heap) {
+        g_min_free_heap = result;
+    }
+    return result;
+}
+
+uint32_t sim_system_min_free_heap() {
+    sim_system_free_heap();
+    return g_min_free_heap;
+}
+
+// ===================================================================
+// --- Relógio de sistema (time/gettimeofday/settimeofday) ---
+// Substituem os da libc para que o firmware veja o relógio simulado.
+// ===================================================================
+
+static int64_t system_time_us() {
+    return g_sys_time_offset_us + (int64_t)sim_now_us() + g_rtc_error_us;
+}
+
+extern "C" int gettimeofday(struct timeval* __restrict tv, void* __restrict tz) noexcept {
+    (void)tz;
+    int64_t now = system_time_us();
+    tv->tv_sec = (time_t)(now / 1000000);
+    tv->tv_usec = (suseconds_t)(now % 1000000);
+    return 0;
+}
+
+extern "C" int settimeofday(const struct timeval* tv, const struct timezone* tz) noexcept {
+    (void)tz;
+    if (tv != nullptr) {
+        int64_t target = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec;
+        g_sys_time_offset_us = target - (int64_t)sim_now_us() - g_rtc_error_us;
+    }
+    return 0;
+}
+
+extern "C" time_t time(time_t* out) noexcept {
+    time_t now = (time_t)(system_time_us() / 1000000);
+    if (out != nullptr) {
+        *out = now;
+    }
+    return now;
+}
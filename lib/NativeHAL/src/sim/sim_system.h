@@ -0,0 +1,65 @@
+#ifndef SIM_SYSTEM_H
+#define SIM_SYSTEM_H
+
+#include <stdint.h>
+
+/**
+ * Ciclo de vida da placa simulada: boot, deep sleep, reset e relógios.
+ *
+ * Cada despertar executa setup() num processo filho criado por fork(). Ao
+ * dormir, o filho devolve ao pai apenas a seção SIM_PERSIST (memória RTC do
+ * ESP32 + estado dos periféricos externos) e termina; o próximo filho parte
+ * da imagem "limpa" do pai com essa seção restaurada. Assim, como no ESP32,
+ * toda variável global que não é RTC_DATA_ATTR volta ao valor inicial.
+ */
+
+// Motivo do último boot, visto pelo firmware
+typedef enum {
+    SIM_BOOT_POWER_ON = 0,
+    SIM_BOOT_DEEP_SLEEP,
+    SIM_BOOT_SOFTWARE_RESET,
+} sim_boot_reason_t;
+
+/**
+ * @brief Executa até 'cycles' despertares (setup() -> deep sleep), parando
+ * antes se o relógio simulado passar de 'until_us'. Ao final imprime o
+ * relatório de energia (sim_energy.h).
+ * @return 0 se todos terminaram em deep sleep, 1 em caso de falha do firmware.
+ */
+int sim_system_run_cycles(uint32_t cycles, uint64_t until_us = UINT64_MAX);
+
+/**
+ * @brief Instante simulado (µs) do boot atual. millis()/micros() contam daqui.
+ */
+uint64_t sim_system_boot_us();
+
+sim_boot_reason_t sim_system_boot_reason();
+
+/**
+ * @brief Número de boots desde a energização (começa em 1).
+ */
+uint32_t sim_system_boot_count();
+
+/**
+ * @brief Termina o despertar atual com deep sleep. Não retorna.
+ */
+[[noreturn]] void sim_system_deep_sleep(uint64_t duration_us);
+
+/**
+ * @brief Reinicia o ESP32 (ESP.restart()). A memória RTC é preservada.
+ */
+[[noreturn]] void sim_system_restart();
+
+/**
+ * @brief Hora UTC "verdadeira" (referência da rede/NTP), em segundos.
+ */
+double sim_true_utc();
+
+/**
+ * @brief Heap livre simulado (bytes), derivado das alocações do processo.
+ */
+uint32_t sim_system_free_heap();
+uint32_t sim_system_min_free_heap();
+uint32_t sim_system_heap_size();
+
+#endif // SIM_SYSTEM_H
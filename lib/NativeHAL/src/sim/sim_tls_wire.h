@@ -0,0 +1,67 @@
+#ifndef SIM_TLS_WIRE_H
+#define SIM_TLS_WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Formato "no fio" do TLS simulado, compartilhado pelo mbedTLS simulado
+ * (cliente, sim_mbedtls.cpp) e pelo servidor da nuvem (sim_cloud.cpp).
+ *
+ * Não há criptografia: os registros têm o cabeçalho do TLS 1.2
+ * ([tipo][0x03][0x03][tamanho16]) e os tamanhos dos voos do handshake e o
+ * overhead dos registros de aplicação imitam os reais, para que tempo de
+ * rádio, bytes transmitidos e o efeito da retomada de sessão sejam realistas.
+ *
+ * Handshake completo:                  Retomada (session ID aceito):
+ *   C: ClientHello                       C: ClientHello (com session ID)
+ *   S: ServerHello + Certificate...      S: ServerHello (resumed) + Finished
+ *   C: Certificate + KeyExchange...      C: Finished
+ *   S: Finished
+ */
+
+#define SIM_TLS_RECORD_HEADER 5
+#define SIM_TLS_APP_OVERHEAD 24          // Nonce explícito (8) + tag GCM (16)
+#define SIM_TLS_SESSION_ID_LEN 32
+#define SIM_TLS_MAX_RECORD 16384
+
+// Tipos de registro
+#define SIM_TLS_ALERT 21
+#define SIM_TLS_HANDSHAKE 22
+#define SIM_TLS_APPLICATION_DATA 23
+
+// Primeiro byte das mensagens de handshake
+#define SIM_TLS_CLIENT_HELLO 1
+#define SIM_TLS_SERVER_HELLO 2
+#define SIM_TLS_SERVER_CERTIFICATE_FLIGHT 11
+#define SIM_TLS_CLIENT_KEY_FLIGHT 16
+#define SIM_TLS_FINISHED 20
+
+// Tamanhos típicos dos voos (AWS IoT, ECDHE + certificado de cliente)
+#define SIM_TLS_CLIENT_HELLO_BYTES 220
+#define SIM_TLS_CLIENT_FLIGHT_BYTES 1450
+#define SIM_TLS_FINISHED_BYTES 45
+
+/**
+ * @brief Escreve o cabeçalho de um registro.
+ */
+static inline void sim_tls_write_header(uint8_t* out, uint8_t type, size_t length) {
+    out[0] = type;
+    out[1] = 0x03;
+    out[2] = 0x03;
+    out[3] = (uint8_t)(length >> 8);
+    out[4] = (uint8_t)(length & 0xFF);
+}
+
+/**
+ * @brief Tamanho total do registro no início de 'data', ou 0 se incompleto.
+ */
+static inline size_t sim_tls_record_size(const uint8_t* data, size_t available) {
+    if (available < SIM_TLS_RECORD_HEADER) {
+        return 0;
+    }
+    size_t total = SIM_TLS_RECORD_HEADER + (((size_t)data[3] << 8) | data[4]);
+    return available >= total ? total : 0;
+}
+
+#endif // SIM_TLS_WIRE_H
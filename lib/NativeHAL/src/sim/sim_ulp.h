@@ -0,0 +1,15 @@
+#ifndef SIM_ULP_H
+#define SIM_ULP_H
+
+/**
+ * @brief Retoma o timer do ULP no início do despertar, se ele estava armado
+ * (no ESP32 o ULP continua rodando através do reset de saída do deep sleep).
+ */
+void sim_ulp_boot();
+
+/**
+ * @brief Indica se o timer do ULP está armado (ulp_run() chamado).
+ */
+bool sim_ulp_running();
+
+#endif // SIM_ULP_H
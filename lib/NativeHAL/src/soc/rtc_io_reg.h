@@ -0,0 +1,8 @@
+#ifndef NATIVE_HAL_SOC_RTC_IO_REG_H
+#define NATIVE_HAL_SOC_RTC_IO_REG_H
+
+// Registrador de entrada dos RTC GPIOs (nível de RTC_GPIOn no bit RTC_GPIO_IN_NEXT_S + n)
+#define RTC_GPIO_IN_REG 0x3ff48424
+#define RTC_GPIO_IN_NEXT_S 14
+
+#endif // NATIVE_HAL_SOC_RTC_IO_REG_H
@@ -3,9 +3,19 @@
 #include "modules/SCD40/scd40_handler.h"
 #include "modules/ADS1115/ads1115_handler.h"
 #include "modules/MICS6814/mics6814_handler.h" 
+#include "modules/MICS6814/mics6814_baseline.h"
+#include "modules/DSM501A/dsm501a_handler.h"
+#include "modules/UlpSampler/ulp_sampler.h"
+#include "modules/SensorWarmup/sensor_warmup.h"
 #include "modules/ConnectivityHandler/comm_manager.h"
+#include "modules/ConnectivityHandler/tls_arena.h"
+#include "modules/RTOSTasks/rtos_tasks.h"
+#include "modules/SampleBuffer/sample_buffer.h"
+#include "modules/Diagnostics/diagnostics.h"
+#include "modules/WakeManager/wake_manager.h"
 
-// Insira os valores de R0 que você obteve do script "MICS_Calibrar.ino"
+// Insira os valores de R0 que você obteve do script "MICS_Calibrar.ino".
+// Usados só enquanto a NVS não tiver calibração (ver mics6814_baseline.h).
 const int16_t CALIBRATED_R0_CO  = 12345; // <-- SUBSTITUA ESTE VALOR
 const int16_t CALIBRATED_R0_NO2 = 6789;  // <-- SUBSTITUA ESTE VALOR
 const int16_t CALIBRATED_R0_NH3 = 10111; // <-- SUBSTITUA ESTE VALOR
@@ -16,67 +26,228 @@ MICS6814_Data mics6814SensorData;
 DSM501A_Data dsm501aSensorData;
 GPS_Data gpsLocationData;
 
+#if ULP_SAMPLER_ENABLED
+// Contagens do ULP no último sono (lidas no início da aquisição)
+static UlpSampler_Stats ulpSleepStats;
+static bool ulpSleepStatsValid = false;
 
-void setup() {
-    Serial.begin(115200);
-    delay(2000);
-    Serial.println(F("\n--- System Boot / Wake Up  ---"));
+/**
+ * @brief Combina a LOP do sono (ULP) com a da janela deste despertar,
+ * ponderando pelo tempo: o valor publicado vira a média do intervalo.
+ */
+static void merge_sleep_exposure(DSM501A_Data& data) {
+    if (!ulpSleepStatsValid) {
+        return;
+    }
+    float sleep_ms = (float)ulpSleepStats.duration_ms;
+    float window_ms = data.isValid ? (float)dsm501a_window_stats().elapsed_ms : 0.0f;
+    float sleep_pm25 = 100.0f * ulpSleepStats.low_pm25 / ulpSleepStats.samples;
+    float sleep_pm10 = 100.0f * ulpSleepStats.low_pm10 / ulpSleepStats.samples;
 
-    init_serial(); // Inicializa SerialAT para o modem
-    setup_sensor_power(); // Configura o pino do MOSFET para controle de energia dos sensores
-    Wire.begin(); 
+    data.low_pulse_occupancy_ratio_pm25 =
+        (sleep_pm25 * sleep_ms + data.low_pulse_occupancy_ratio_pm25 * window_ms) / (sleep_ms + window_ms);
+    data.low_pulse_occupancy_ratio_pm10 =
+        (sleep_pm10 * sleep_ms + data.low_pulse_occupancy_ratio_pm10 * window_ms) / (sleep_ms + window_ms);
+    data.isValid = true;
+    Serial.printf("Main: DSM501A combinado com o sono (%lu s pelo ULP + %lu s de janela).\n",
+                  (unsigned long)(sleep_ms / 1000), (unsigned long)(window_ms / 1000));
+}
+#endif
+
+
+/**
+ * @brief (Função Privada) Lê o SCD40 (medição periódica já iniciada e pronta).
+ */
+static void read_scd40() {
+    diag_phase_begin(DIAG_PHASE_SCD40_READ);
+    if (scd40_read_measurements(scd40SensorData) && scd40SensorData.isValid) {
+        Serial.println(F("Main: SCD40 data read."));
+        Serial.printf("SCD40: CO2:%.1f ppm, Temp:%.1f C, Hum:%.1f %%RH\n",
+                         scd40SensorData.co2, scd40SensorData.temperature, scd40SensorData.humidity);
+    } else { 
+        scd40SensorData.isValid = false; 
+        Serial.println(F("Main: Failed SCD40 read."));
+    }
+    diag_phase_end(DIAG_PHASE_SCD40_READ);
+    if (!scd40SensorData.isValid) {
+        diag_count(DIAG_COUNTER_SENSOR_FAILURES);
+    }
+}
+
+/**
+ * @brief (Função Privada) Lê o MICS6814 via ADS1115 e alimenta o rastreamento do R0.
+ */
+static void read_mics6814() {
+    Serial.println(F("Main: Lendo MICS6814..."));
+    diag_phase_begin(DIAG_PHASE_MICS6814_READ);
+    if (!mics6814_read_data(mics6814SensorData)) {
+        Serial.println(F("Main: Falha ao ler dados do MICS6814."));
+        diag_count(DIAG_COUNTER_SENSOR_FAILURES);
+    }
+    diag_phase_end(DIAG_PHASE_MICS6814_READ);
+    if (mics6814_baseline_update(mics6814SensorData)) {
+        // A leitura moveu o R0: converte-a pela calibração nova, como o backlog
+        mics6814_convert_batch(&mics6814SensorData, 1);
+    }
+    Serial.printf("Main: MICS (isValid: %d) -> CO: %.2f ppm\n", mics6814SensorData.isValid, mics6814SensorData.ppm_co);
+}
 
-    // // ETAPA 1: Ligar, Ler e Desligar Sensores
+/**
+ * @brief Etapa de sensores do ciclo: liga o trilho, lê cada sensor assim que
+ * ele termina o aquecimento (ver sensor_warmup.h) e desliga após o último.
+ * Executada por rtos_run_acquisition_stage() em paralelo com a subida da rede.
+ */
+static void acquire_sensor_data() {
     Serial.println(F("Main: Powering ON sensors..."));
-    // // O SENSOR_STABILIZATION_DELAY_MS no config.h deve ser longo o suficiente
-    // // para o pré-aquecimento do MICS6814 e SPS30 
+    diag_phase_begin(DIAG_PHASE_SENSOR_RAIL);
+    diag_phase_begin(DIAG_PHASE_SENSOR_POWER_ON);
     power_sensors_on(); 
+    diag_phase_end(DIAG_PHASE_SENSOR_POWER_ON);
+
+#if ULP_SAMPLER_ENABLED
+    // Antes do dsm501a_init(): devolve os pinos do DSM501A ao GPIO digital
+    ulpSleepStatsValid = ulp_sampler_collect(ulpSleepStats);
+#endif
+
+    dsm501a_init();
 
-    if (!ads1115_init(0x48)) { // 0x48 é o endereço (ADDR no GND)
+    bool adsReady = ads1115_init(0x48); // 0x48 é o endereço (ADDR no GND)
+    if (!adsReady) {
         Serial.println(F("Main: FALHA CRÍTICA - ADS1115 não encontrado."));
     }
 
-    //inicializa o handler do MICS com os valores de calibração
-    mics6814_init(CALIBRATED_R0_CO, CALIBRATED_R0_NO2, CALIBRATED_R0_NH3);
+    //inicializa o handler do MICS com a calibração da NVS (ou a de fábrica)
+    mics6814_baseline_begin(CALIBRATED_R0_CO, CALIBRATED_R0_NO2, CALIBRATED_R0_NH3);
 
-    // // Leitura do SCD40
-    if (scd40_init()) {
-        if (scd40_read_measurements(scd40SensorData) && scd40SensorData.isValid) {
-            Serial.println(F("Main: SCD40 data read."));
-            Serial.printf("SCD40: CO2:%.1f ppm, Temp:%.1f C, Hum:%.1f %%RH\n",
-                             scd40SensorData.co2, scd40SensorData.temperature, scd40SensorData.humidity);
-        } else { 
-            scd40SensorData.isValid = false; 
-            Serial.println(F("Main: Failed SCD40 read."));
-        }
-    } else { 
+    // Inicia a medição periódica já: a primeira fica pronta em ~5 s
+    bool scd40Started = scd40_init();
+    warmup_begin();
+    if (!scd40Started) {
         scd40SensorData.isValid = false; 
         Serial.println(F("Main: Failed SCD40 init."));
+        diag_count(DIAG_COUNTER_SENSOR_FAILURES);
+        warmup_mark_done(WARMUP_SENSOR_SCD40);
+    }
+    if (!adsReady) {
+        // Sem o ADC o MICS6814 não pode ser lido (nem sondado): não espera o aquecimento
+        mics6814SensorData.isValid = false;
+        diag_count(DIAG_COUNTER_SENSOR_FAILURES);
+        warmup_mark_done(WARMUP_SENSOR_MICS6814);
     }
 
-    // Leitura do MICS6814 via ADS1115
-    Serial.println(F("Main: Lendo MICS6814..."));
-    // As funções antigas (read_voltages, calculate_ppm) foram substituídas
-    // por esta única chamada:
-    if (!mics6814_read_data(mics6814SensorData)) {
-        Serial.println(F("Main: Falha ao ler dados do MICS6814."));
+    // Cada sensor é lido assim que fica pronto. A janela do DSM501A começa
+    // quando ele termina de aquecer e corre em segundo plano.
+    bool dsmWindowStarted = false;
+    bool dsmWaitStarted = false;
+    while (!warmup_all_done()) {
+        if (!warmup_done(WARMUP_SENSOR_SCD40) && warmup_ready(WARMUP_SENSOR_SCD40)) {
+            read_scd40();
+            warmup_mark_done(WARMUP_SENSOR_SCD40);
+        }
+        if (!warmup_done(WARMUP_SENSOR_MICS6814) && warmup_ready(WARMUP_SENSOR_MICS6814)) {
+            read_mics6814();
+            warmup_mark_done(WARMUP_SENSOR_MICS6814);
+        }
+        if (!dsmWindowStarted && warmup_ready(WARMUP_SENSOR_DSM501A)) {
+            dsmWindowStarted = true;
+            if (!dsm501a_window_start(DEFAULT_DSM501A_SAMPLE_TIME_MS)) {
+                warmup_mark_done(WARMUP_SENSOR_DSM501A);
+            }
+        }
+        if (dsmWindowStarted && !warmup_done(WARMUP_SENSOR_DSM501A) && dsm501a_window_poll()) {
+            warmup_mark_done(WARMUP_SENSOR_DSM501A);
+        }
+
+        // Só o DSM501A falta: o restante é espera pela janela dele
+        if (!dsmWaitStarted && warmup_done(WARMUP_SENSOR_SCD40) && warmup_done(WARMUP_SENSOR_MICS6814) &&
+            !warmup_done(WARMUP_SENSOR_DSM501A)) {
+            dsmWaitStarted = true;
+            diag_phase_begin(DIAG_PHASE_DSM501A_WAIT);
+        }
+        if (!warmup_all_done()) {
+            delay(WARMUP_POLL_MS);
+        }
     }
-    Serial.printf("Main: MICS (isValid: %d) -> CO: %.2f ppm\n", mics6814SensorData.isValid, mics6814SensorData.ppm_co);
+    diag_phase_end(DIAG_PHASE_DSM501A_WAIT);
 
-    
+    dsm501a_window_finish(dsm501aSensorData);
+#if ULP_SAMPLER_ENABLED
+    merge_sleep_exposure(dsm501aSensorData);
+#endif
+    if (!dsm501aSensorData.isValid) {
+        diag_count(DIAG_COUNTER_SENSOR_FAILURES);
+    }
+    Serial.printf("Main: DSM501A (isValid: %d) -> LOP PM2.5: %.2f %%, PM10: %.2f %%\n", dsm501aSensorData.isValid,
+                  dsm501aSensorData.low_pulse_occupancy_ratio_pm25, dsm501aSensorData.low_pulse_occupancy_ratio_pm10);
+
+#if ULP_SAMPLER_ENABLED
+    // O trilho continua ligado: o ULP amostra o DSM501A durante o deep sleep
+    Serial.println(F("Main: Sensores continuam ligados (amostragem pelo ULP)."));
+#else
     Serial.println(F("Main: Powering OFF sensors..."));
-    delay(5000);
     power_sensors_off(); // Desliga o MOSFET (desconecta GND dos sensores)
- 
+#endif
+    diag_phase_end(DIAG_PHASE_SENSOR_RAIL);
+}
+
+/**
+ * @brief Comandos recebidos pelo tópico AWS_IOT_COMMAND_TOPIC durante o upload.
+ */
+static void handle_remote_command(const char* command) {
+    if (!mics6814_baseline_handle_command(command)) {
+        Serial.printf("Main: Comando remoto desconhecido: %s\n", command);
+    }
+}
+
+void setup() {
+    Serial.begin(115200);
+
+    sample_buffer_register_wake();
+    diag_register_wake();
+    bool uploadDue = sample_buffer_upload_due();
+    wake_type_t wakeType = wake_classify(uploadDue);
+
+    // A espera pelo monitor serial só vale em boots de recuperação
+    if (wakeType == WAKE_TYPE_RECOVERY) {
+        delay(WAKE_RECOVERY_SERIAL_DELAY_MS);
+    }
+    Serial.println(F("\n--- System Boot / Wake Up  ---"));
+    wake_log(wakeType);
+
+    if (uploadDue) {
+        init_serial(); // Inicializa SerialAT para o modem (só quando ele vai ser usado)
+    }
+    setup_sensor_power(); // Configura o pino do MOSFET para controle de energia dos sensores
+    Wire.begin(); 
+
+    // ETAPA 1: Ligar, Ler e Desligar Sensores.
+    // Em despertares de upload, o modem sobe em paralelo com os sensores.
+    if (uploadDue) {
+        comm_set_gnss_refresh(wake_gnss_refresh_expected(wakeType));
+        // Reserva a arena do TLS antes que sensores e modem fragmentem o heap
+        tls_arena_init();
+        bool networkReady = rtos_run_acquisition_stage(acquire_sensor_data);
+        if (!networkReady) {
+            Serial.println(F("Main: Rede não ficou pronta durante a aquisição."));
+        }
+    } else {
+        acquire_sensor_data();
+    }
+
+    // Guarda a leitura na memória RTC (sobrevive ao deep sleep)
+    sample_buffer_push(scd40SensorData, mics6814SensorData, dsm501aSensorData);
+
+    if (!uploadDue) {
+        Serial.println(F("Main: Upload não é devido neste despertar. Voltando a dormir."));
+        enter_deep_sleep();
+    }
 
-    // ETAPA 2: Comunicação de Dados Completa
+    // ETAPA 2: Comunicação de Dados Completa (envia todo o backlog)
     Serial.println(F("Main: Starting full communication cycle..."));
+    comm_set_command_handler(handle_remote_command);
     unsigned long commStartTime = millis();
 
     bool dataTransmissionSuccessful = perform_communication_cycle(
-        scd40SensorData,
-        mics6814SensorData,
-        dsm501aSensorData,
         gpsLocationData // Passada por referência, ela será preenchida
     );
 
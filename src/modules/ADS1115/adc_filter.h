@@ -0,0 +1,138 @@
+#ifndef ADC_FILTER_H
+#define ADC_FILTER_H
+
+#include <Arduino.h>
+
+/*
+ * Núcleos de filtragem (ponto fixo) para os buffers de amostras brutas do
+ * ADS1115. São templates no número de amostras: com N constante o
+ * compilador desenrola os laços e troca a divisão por N por deslocamentos
+ * quando N é potência de dois.
+ *
+ * O tipo em uso é escolhido em tempo de compilação (ADS_FILTER_KIND, ver
+ * ads1115_handler.h).
+ */
+
+#define ADS_FILTER_MEAN 0          // Média simples (comportamento original)
+#define ADS_FILTER_MEDIAN 1        // Mediana das N amostras
+#define ADS_FILTER_TRIMMED_MEAN 2  // Média sem as ADS_FILTER_TRIM menores e maiores
+#define ADS_FILTER_IIR 3           // Passa-baixa de 1ª ordem, alfa = 1 / 2^ADS_FILTER_IIR_SHIFT
+
+// Bits fracionários do estado do filtro IIR
+#define ADC_FILTER_IIR_FRACTION_BITS 8
+
+/**
+ * @brief (Função Privada) Divisão inteira com arredondamento para o mais próximo.
+ */
+static inline int32_t adc_filter_div_round(int32_t sum, int32_t n) {
+    return (sum >= 0) ? (sum + n / 2) / n : (sum - n / 2) / n;
+}
+
+/**
+ * @brief (Função Privada) Ordena uma cópia das amostras (insertion sort:
+ * N é pequeno e o buffer já chega quase ordenado em sinais estáveis).
+ */
+template <size_t N>
+static inline void adc_filter_sorted_copy(const int16_t* samples, int16_t (&sorted)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        int16_t value = samples[i];
+        size_t j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+}
+
+/**
+ * @brief Média das N amostras.
+ */
+template <size_t N>
+int16_t adc_filter_mean(const int16_t* samples) {
+    static_assert(N > 0, "N deve ser positivo");
+    int32_t sum = 0;
+    for (size_t i = 0; i < N; i++) {
+        sum += samples[i];
+    }
+    return (int16_t)adc_filter_div_round(sum, (int32_t)N);
+}
+
+/**
+ * @brief Mediana das N amostras (média dos dois centrais quando N é par).
+ */
+template <size_t N>
+int16_t adc_filter_median(const int16_t* samples) {
+    static_assert(N > 0, "N deve ser positivo");
+    int16_t sorted[N];
+    adc_filter_sorted_copy<N>(samples, sorted);
+    if (N % 2 == 1) {
+        return sorted[N / 2];
+    }
+    return (int16_t)adc_filter_div_round((int32_t)sorted[N / 2 - 1] + sorted[N / 2], 2);
+}
+
+/**
+ * @brief Média das N amostras descartando as Trim menores e as Trim maiores.
+ * Robusta a picos isolados (ex: chaveamento do aquecedor do MICS6814).
+ */
+template <size_t N, size_t Trim>
+int16_t adc_filter_trimmed_mean(const int16_t* samples) {
+    static_assert(2 * Trim < N, "Trim deve deixar ao menos uma amostra");
+    int16_t sorted[N];
+    adc_filter_sorted_copy<N>(samples, sorted);
+    int32_t sum = 0;
+    for (size_t i = Trim; i < N - Trim; i++) {
+        sum += sorted[i];
+    }
+    return (int16_t)adc_filter_div_round(sum, (int32_t)(N - 2 * Trim));
+}
+
+/**
+ * @brief Passa-baixa exponencial sobre as amostras, na ordem de aquisição.
+ * O estado parte da primeira amostra; retorna o estado após a última.
+ */
+template <size_t N, unsigned Shift>
+int16_t adc_filter_iir(const int16_t* samples) {
+    static_assert(N > 0, "N deve ser positivo");
+    static_assert(Shift > 0 && Shift < 16, "Shift fora da faixa");
+    int32_t state = (int32_t)samples[0] * (1 << ADC_FILTER_IIR_FRACTION_BITS);
+    for (size_t i = 1; i < N; i++) {
+        int32_t input = (int32_t)samples[i] * (1 << ADC_FILTER_IIR_FRACTION_BITS);
+        state += (input - state) / (1 << Shift);
+    }
+    return (int16_t)adc_filter_div_round(state, 1 << ADC_FILTER_IIR_FRACTION_BITS);
+}
+
+/**
+ * @brief Variância (populacional) das N amostras brutas, em contagens².
+ * Mede o ruído de cada leitura, independentemente do filtro escolhido.
+ */
+template <size_t N>
+uint32_t adc_filter_variance(const int16_t* samples) {
+    static_assert(N > 0, "N deve ser positivo");
+    int64_t sum = 0;
+    int64_t sum_sq = 0;
+    for (size_t i = 0; i < N; i++) {
+        sum += samples[i];
+        sum_sq += (int64_t)samples[i] * samples[i];
+    }
+    int64_t scaled = (int64_t)N * sum_sq - sum * sum; // N² · variância
+    return (uint32_t)(scaled / ((int64_t)N * (int64_t)N));
+}
+
+/**
+ * @brief Filtro selecionado por 'Kind' (um dos ADS_FILTER_*).
+ */
+template <size_t N, int Kind, size_t Trim, unsigned Shift>
+int16_t adc_filter_apply(const int16_t* samples) {
+    static_assert(Kind >= ADS_FILTER_MEAN && Kind <= ADS_FILTER_IIR, "ADS_FILTER_KIND desconhecido");
+    switch (Kind) {
+        case ADS_FILTER_MEDIAN:       return adc_filter_median<N>(samples);
+        case ADS_FILTER_TRIMMED_MEAN: return adc_filter_trimmed_mean<N, Trim>(samples);
+        case ADS_FILTER_IIR:          return adc_filter_iir<N, Shift>(samples);
+        default:                      return adc_filter_mean<N>(samples);
+    }
+}
+
+#endif // ADC_FILTER_H
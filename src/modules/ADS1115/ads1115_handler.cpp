@@ -1,6 +1,8 @@
 #include "ads1115_handler.h"
 #include <Wire.h>     
 #include <Adafruit_ADS1X15.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 Adafruit_ADS1115 ads; 
 
@@ -17,6 +19,140 @@ const adsGain_t ADC_GAIN = GAIN_TWOTHIRDS;
 // (6.144 / 32767.0 = 0.0001875)
 const float VOLTAGE_MULTIPLIER_16BIT_6V = 0.0001875f;
 
+// Taxa de dados (RATE_ADS1115_860SPS) e o período de uma conversão, já com
+// a tolerância de +10% do oscilador interno do ADS1115.
+const uint32_t ADC_RATE_SPS = 860;
+const uint32_t CONVERSION_PERIOD_US = 1100000UL / ADC_RATE_SPS;
+
+// Transações I2C de ads.startADCReading(): configuração + limiares Hi/Lo do ALERT/RDY
+const uint8_t START_TRANSACTIONS = 3;
+
+static_assert(ADS_SCAN_SAMPLES > 0 && ADS_SCAN_SAMPLES <= 255, "ADS_SCAN_SAMPLES deve caber em uint8_t");
+
+// Bordas do ALERT/RDY que podem faltar antes de a varredura passar a usar só o tempo
+const uint8_t RDY_MAX_MISSES = 4;
+
+// ===================================================================
+// --- Estado da varredura (Privado) ---
+// ===================================================================
+
+static bool g_ads_ready = false;
+
+static int16_t g_samples[ADS_CHANNEL_COUNT][ADS_SCAN_SAMPLES];
+static uint8_t g_sample_count[ADS_CHANNEL_COUNT];
+
+static ads_channel_t g_scan_channels[ADS_CHANNEL_COUNT];
+static uint8_t g_scan_channel_count = 0;
+static uint8_t g_scan_index = 0;
+static bool g_discard_next = false;
+static ads_scan_state_t g_scan_state = ADS_SCAN_IDLE;
+
+static uint32_t g_scan_start_us = 0;
+static uint32_t g_next_due_us = 0;   // Fim previsto da próxima conversão (micros)
+static uint16_t g_i2c_transactions = 0;
+static uint16_t g_rdy_timeouts = 0;
+
+// Conversão pronta: liberado pela ISR do ALERT/RDY
+static SemaphoreHandle_t g_rdy_semaphore = NULL;
+static bool g_rdy_attached = false;
+static bool g_rdy_pending = false;
+
+#if ADS1115_ALERT_PIN >= 0
+/**
+ * @brief (ISR) Borda de descida do ALERT/RDY: fim de uma conversão.
+ * O I2C não pode ser usado aqui; a leitura fica para ads1115_scan_poll().
+ */
+static void IRAM_ATTR on_conversion_ready() {
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(g_rdy_semaphore, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR();
+    }
+}
+#endif
+
+/**
+ * @brief (Função Privada) Configura o GPIO do ALERT/RDY e a sua ISR.
+ */
+static void attach_conversion_ready() {
+#if ADS1115_ALERT_PIN >= 0
+    if (g_rdy_attached) {
+        return;
+    }
+    if (g_rdy_semaphore == NULL) {
+        g_rdy_semaphore = xSemaphoreCreateBinary();
+    }
+    if (g_rdy_semaphore == NULL) {
+        Serial.println("ADS1115: AVISO - Sem memória para o semáforo do ALERT/RDY. Usando o tempo de conversão.");
+        return;
+    }
+    pinMode(ADS1115_ALERT_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(ADS1115_ALERT_PIN), on_conversion_ready, FALLING);
+    g_rdy_attached = true;
+    Serial.printf("ADS1115: ALERT/RDY no GPIO %d.\n", ADS1115_ALERT_PIN);
+#endif
+}
+
+/**
+ * @brief (Função Privada) Indica se há uma conversão nova para ler.
+ */
+static bool conversion_ready() {
+    int32_t late_us = (int32_t)(micros() - g_next_due_us);
+    if (!g_rdy_attached) {
+        return late_us >= 0;
+    }
+    if (g_rdy_pending || xSemaphoreTake(g_rdy_semaphore, 0) == pdTRUE) {
+        g_rdy_pending = false;
+        return true;
+    }
+    // Sem borda um período inteiro após o previsto (pino solto?): o tempo serve de reserva
+    if (late_us < (int32_t)CONVERSION_PERIOD_US) {
+        return false;
+    }
+    if (++g_rdy_timeouts >= RDY_MAX_MISSES) {
+        detachInterrupt(digitalPinToInterrupt(ADS1115_ALERT_PIN));
+        g_rdy_attached = false;
+        Serial.println("ADS1115: AVISO - ALERT/RDY não responde. Usando o tempo de conversão.");
+    }
+    return true;
+}
+
+/**
+ * @brief (Função Privada) Programa o canal em modo contínuo.
+ */
+static void start_channel(ads_channel_t channel) {
+    ads.startADCReading(MUX_BY_CHANNEL[channel], /*continuous=*/true);
+    g_i2c_transactions += START_TRANSACTIONS;
+    g_next_due_us = micros() + CONVERSION_PERIOD_US;
+    // Bordas que chegaram durante a escrita pertencem ao canal anterior
+    if (g_rdy_attached) {
+        xSemaphoreTake(g_rdy_semaphore, 0);
+    }
+    g_rdy_pending = false;
+    // A conversão em andamento na troca pode ter usado o multiplexador anterior
+    g_discard_next = true;
+}
+
+/**
+ * @brief (Função Privada) Encerra a varredura e devolve o ADC ao power-down.
+ */
+static void finish_scan(ads_scan_state_t state) {
+    // Uma conversão single-shot deixa o ADS1115 em power-down ao terminar
+    ads.startADCReading(MUX_BY_CHANNEL[g_scan_channels[0]], /*continuous=*/false);
+    g_i2c_transactions += START_TRANSACTIONS;
+    g_scan_state = state;
+
+    uint32_t elapsed_us = micros() - g_scan_start_us;
+    if (state == ADS_SCAN_DONE) {
+        Serial.printf("ADS1115: Varredura de %u canal(is) x %u amostras em %lu us (%u transações I2C, %u RDY perdido(s)).\n",
+                      g_scan_channel_count, (unsigned)ADS_SCAN_SAMPLES, (unsigned long)elapsed_us,
+                      g_i2c_transactions, g_rdy_timeouts);
+    } else {
+        Serial.printf("ADS1115: ERRO - Varredura interrompida após %lu us (canal %u de %u).\n",
+                      (unsigned long)elapsed_us, g_scan_index + 1, g_scan_channel_count);
+    }
+}
+
 /**
  * @brief Inicializa o sensor ADS1115. (Função pública do .h)
  */
@@ -26,6 +162,7 @@ bool ads1115_init(uint8_t i2c_address) {
     // Passamos o ponteiro &Wire para a biblioteca
     if (!ads.begin(i2c_address, &Wire)) {
         Serial.println("ADS1115: FALHA CRÍTICA - Não foi possível encontrar o ADC.");
+        g_ads_ready = false;
         return false;
     }
 
@@ -33,9 +170,12 @@ bool ads1115_init(uint8_t i2c_address) {
     ads.setGain(ADC_GAIN);
     
     // Opcional: Aumentar a taxa de dados. 860 amostras por segundo
-    // torna nossa leitura de 32 amostras (próxima função) mais rápida.
+    // torna a varredura de 32 amostras por canal mais rápida.
     ads.setDataRate(RATE_ADS1115_860SPS);
 
+    attach_conversion_ready();
+    g_ads_ready = true;
+
     Serial.printf("ADS1115: Inicialização bem-sucedida no endereço 0x%X.\n", i2c_address);
     Serial.printf("ADS1115: Ganho de hardware definido para: 2/3 (FS +/-6.144V)\n");
     return true;
@@ -45,24 +185,114 @@ bool ads1115_init(uint8_t i2c_address) {
  * @brief Lê um canal analógico de forma robusta. (Função pública do .h)
  */
 int16_t ads1115_read_stable_raw_value(ads_channel_t channel) {
-    
-    // Esta é a lógica de "oversampling" que encontramos no driver profissional.
-    // Ela filtra ruídos elétricos (ex: do aquecedor do MICS).
-    const int NUM_SAMPLES = 32;
-    
-    // Usamos int32_t para o acumulador para evitar "estouro" (overflow)
-    int32_t adc_sum = 0; 
+    // Oversampling: ADS_SCAN_SAMPLES amostras filtradas (ADS_FILTER_KIND)
+    // eliminam ruídos elétricos (ex: do aquecedor do MICS).
+    int16_t value = 0;
+    if (!ads1115_scan_start(&channel, 1) || ads1115_scan_wait(ADS_SCAN_TIMEOUT_MS) != ADS_SCAN_DONE) {
+        return 0;
+    }
+    ads1115_scan_collect(channel, value);
+    return value;
+}
+
+bool ads1115_scan_start(const ads_channel_t* channels, uint8_t channel_count) {
+    if (!g_ads_ready || g_scan_state == ADS_SCAN_RUNNING || channels == nullptr ||
+        channel_count == 0 || channel_count > ADS_CHANNEL_COUNT) {
+        return false;
+    }
+    for (uint8_t i = 0; i < channel_count; i++) {
+        if ((unsigned)channels[i] >= ADS_CHANNEL_COUNT) {
+            return false;
+        }
+    }
+
+    memset(g_sample_count, 0, sizeof(g_sample_count));
+    memcpy(g_scan_channels, channels, channel_count * sizeof(ads_channel_t));
+    g_scan_channel_count = channel_count;
+    g_scan_index = 0;
+    g_i2c_transactions = 0;
+    g_rdy_timeouts = 0;
+    g_scan_start_us = micros();
+    g_scan_state = ADS_SCAN_RUNNING;
+
+    start_channel(g_scan_channels[0]);
+    return true;
+}
 
-    // 1. Lê o ADC 32 vezes o mais rápido possível
-    for (int i = 0; i < NUM_SAMPLES; i++) {
-        // A biblioteca da Adafruit mapeia 0, 1, 2, 3 para os canais
-        adc_sum += (int32_t)ads.readADC_SingleEnded(channel);
+ads_scan_state_t ads1115_scan_poll() {
+    if (g_scan_state != ADS_SCAN_RUNNING || !conversion_ready()) {
+        return g_scan_state;
     }
 
-    // 2. Retorna a média.
-    //    (adc_sum >> 5) é uma forma muito rápida (bit-shift) 
-    //    de fazer (adc_sum / 32).
-    return (int16_t)(adc_sum >> 5);
+    int16_t value = ads.getLastConversionResults();
+    g_i2c_transactions++;
+    // No modo contínuo as conversões se sucedem sem esperar a leitura
+    g_next_due_us += CONVERSION_PERIOD_US;
+    if ((int32_t)(micros() - g_next_due_us) > 0) {
+        g_next_due_us = micros() + CONVERSION_PERIOD_US;
+    }
+    if (g_discard_next) {
+        g_discard_next = false;
+        return g_scan_state;
+    }
+
+    ads_channel_t channel = g_scan_channels[g_scan_index];
+    g_samples[channel][g_sample_count[channel]++] = value;
+    if (g_sample_count[channel] < ADS_SCAN_SAMPLES) {
+        return g_scan_state;
+    }
+
+    g_scan_index++;
+    if (g_scan_index < g_scan_channel_count) {
+        start_channel(g_scan_channels[g_scan_index]);
+    } else {
+        finish_scan(ADS_SCAN_DONE);
+    }
+    return g_scan_state;
+}
+
+ads_scan_state_t ads1115_scan_wait(uint32_t timeout_ms) {
+    uint32_t start_ms = millis();
+    while (ads1115_scan_poll() == ADS_SCAN_RUNNING) {
+        if (millis() - start_ms >= timeout_ms) {
+            finish_scan(ADS_SCAN_FAILED);
+            break;
+        }
+        if (g_rdy_attached) {
+            // Dorme até a ISR (a CPU fica livre durante a conversão)
+            if (xSemaphoreTake(g_rdy_semaphore, pdMS_TO_TICKS(2)) == pdTRUE) {
+                g_rdy_pending = true;
+            }
+        } else {
+            int32_t wait_us = (int32_t)(g_next_due_us - micros());
+            if (wait_us > 0) {
+                delayMicroseconds((uint32_t)wait_us);
+            }
+        }
+    }
+    return g_scan_state;
+}
+
+bool ads1115_scan_collect(ads_channel_t channel, int16_t& out_value, uint32_t* out_variance) {
+    if (g_scan_state != ADS_SCAN_DONE || (unsigned)channel >= ADS_CHANNEL_COUNT ||
+        g_sample_count[channel] != ADS_SCAN_SAMPLES) {
+        return false;
+    }
+    const int16_t* samples = g_samples[channel];
+    out_value = adc_filter_apply<ADS_SCAN_SAMPLES, ADS_FILTER_KIND, ADS_FILTER_TRIM, ADS_FILTER_IIR_SHIFT>(samples);
+    if (out_variance != nullptr) {
+        *out_variance = adc_filter_variance<ADS_SCAN_SAMPLES>(samples);
+    }
+    return true;
+}
+
+const int16_t* ads1115_scan_samples(ads_channel_t channel, uint8_t& out_count) {
+    if ((unsigned)channel >= ADS_CHANNEL_COUNT) {
+        out_count = 0;
+        return nullptr;
+    }
+    out_count = g_sample_count[channel];
+    return g_samples[channel];
 }
 
 /**
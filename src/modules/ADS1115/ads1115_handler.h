@@ -2,14 +2,61 @@
 #define ADS1115_HANDLER_H
 
 #include <Arduino.h>
+#include "adc_filter.h"
 
 
+// GPIO ligado ao pino ALERT/RDY do ADS1115 (open-drain: requer pull-up).
+// O padrão é -1 porque a placa de referência não liga esse pino. Só com ele
+// ligado a varredura é dirigida por interrupção e a tarefa dorme durante as
+// conversões. Com -1 (ou se o pino parar de responder), o fim de cada
+// conversão é estimado pelo tempo e ads1115_scan_wait() espera ocupando a
+// CPU (delayMicroseconds). Defina o GPIO no config.h quando o pino estiver
+// ligado.
+#ifndef ADS1115_ALERT_PIN
+#define ADS1115_ALERT_PIN -1
+#endif
+
+// Amostras por canal em cada leitura (e capacidade dos buffers de cada canal).
+// Mais amostras = menos ruído e mais tempo de aquisição (~1,3 ms por amostra).
+#ifndef ADS_SCAN_SAMPLES
+#define ADS_SCAN_SAMPLES 32
+#endif
+
+// Filtro aplicado às amostras de cada canal (ADS_FILTER_*, ver adc_filter.h)
+#ifndef ADS_FILTER_KIND
+#define ADS_FILTER_KIND ADS_FILTER_TRIMMED_MEAN
+#endif
+
+// Amostras descartadas em cada ponta na média aparada
+#ifndef ADS_FILTER_TRIM
+#define ADS_FILTER_TRIM (ADS_SCAN_SAMPLES / 8)
+#endif
+
+// Constante do filtro IIR: alfa = 1 / 2^ADS_FILTER_IIR_SHIFT
+#ifndef ADS_FILTER_IIR_SHIFT
+#define ADS_FILTER_IIR_SHIFT 3
+#endif
+
+// Tempo máximo de uma varredura em ads1115_read_stable_raw_value() e no MICS6814
+#ifndef ADS_SCAN_TIMEOUT_MS
+#define ADS_SCAN_TIMEOUT_MS 1000
+#endif
+
+#define ADS_CHANNEL_COUNT 4 // Entradas AIN0..AIN3
+
 typedef enum {
     ADS_CHANNEL_MICS_NH3 = 0,
     ADS_CHANNEL_MICS_CO = 1,
     ADS_CHANNEL_MICS_NO2 = 2,
 } ads_channel_t;
 
+typedef enum {
+    ADS_SCAN_IDLE = 0,   // Nenhuma varredura iniciada neste despertar
+    ADS_SCAN_RUNNING,
+    ADS_SCAN_DONE,       // Amostras prontas para ads1115_scan_collect()
+    ADS_SCAN_FAILED,     // Estourou o tempo: os buffers estão incompletos
+} ads_scan_state_t;
+
 
 /**
  * @brief Inicializa o sensor ADS1115 no barramento I2C.
@@ -24,14 +71,69 @@ bool ads1115_init(uint8_t i2c_address);
 /**
  * @brief Lê um canal analógico usando "oversampling".
  *
- * Esta função lê o ADC 32 vezes em um loop rápido e retorna a média.
- * Isso filtra o ruído elétrico e fornece uma leitura estável,
+ * Faz uma varredura de ADS_SCAN_SAMPLES amostras do canal e aplica o filtro
+ * ADS_FILTER_KIND. Isso filtra o ruído elétrico e fornece uma leitura estável,
  *
  * @param channel O canal a ser lido (ex: ADS_CHANNEL_MICS_NH3).
- * @return O valor RAW (bruto) de 16 bits (de -32768 a 32767) lido do ADC.
+ * @return O valor RAW (bruto) de 16 bits (de -32768 a 32767) lido do ADC,
+ * ou 0 se a varredura falhar.
  */
 int16_t ads1115_read_stable_raw_value(ads_channel_t channel);
 
+/**
+ * @brief Inicia uma varredura não bloqueante de vários canais.
+ *
+ * Cada canal é lido em modo de conversão contínua: o multiplexador é
+ * programado uma vez por canal e cada amostra custa uma única leitura I2C do
+ * registrador de conversão, feita quando o ALERT/RDY sinaliza (ou, sem o
+ * pino, quando o período de conversão termina). A primeira conversão após a
+ * troca de canal é descartada. Ao final, o ADC volta ao modo single-shot
+ * (power-down).
+ *
+ * Cada canal recebe ADS_SCAN_SAMPLES amostras.
+ *
+ * @param channels Canais, na ordem da varredura.
+ * @param channel_count De 1 a ADS_CHANNEL_COUNT.
+ * @return false se os parâmetros forem inválidos, o ADC não foi inicializado
+ * ou outra varredura está em andamento.
+ */
+bool ads1115_scan_start(const ads_channel_t* channels, uint8_t channel_count);
+
+/**
+ * @brief Avança a varredura sem bloquear: lê a conversão pronta (se houver)
+ * e passa ao próximo canal quando o atual completa suas amostras.
+ *
+ * @note A varredura só avança quando esta função (ou ads1115_scan_wait())
+ * é chamada, sempre pela mesma tarefa que usa o barramento I2C.
+ */
+ads_scan_state_t ads1115_scan_poll();
+
+/**
+ * @brief Bloqueia até a varredura terminar. Entre as conversões a tarefa
+ * dorme no semáforo liberado pela ISR do ALERT/RDY, deixando a CPU livre.
+ *
+ * @param timeout_ms Tempo máximo de espera.
+ * @return ADS_SCAN_DONE, ou ADS_SCAN_FAILED se o tempo estourar.
+ */
+ads_scan_state_t ads1115_scan_wait(uint32_t timeout_ms);
+
+/**
+ * @brief Valor filtrado (ADS_FILTER_KIND) de um canal da última varredura concluída.
+ *
+ * @param out_value Leitura filtrada (RAW, 16 bits).
+ * @param out_variance Opcional: variância das amostras brutas (contagens²).
+ * @return false se a varredura não terminou ou não incluiu o canal.
+ */
+bool ads1115_scan_collect(ads_channel_t channel, int16_t& out_value, uint32_t* out_variance = nullptr);
+
+/**
+ * @brief Buffer com as amostras brutas de um canal da última varredura.
+ *
+ * @param out_count Número de amostras válidas no buffer.
+ * @return Ponteiro para o buffer do canal (válido até a próxima varredura).
+ */
+const int16_t* ads1115_scan_samples(ads_channel_t channel, uint8_t& out_count);
+
 /**
  * @brief Converte um valor RAW (bruto) de 16 bits para Volts (float).
  *
@@ -1,12 +1,16 @@
 #include "comm_manager.h"
 #include "config.h"
+#include "modules/SampleBuffer/sample_buffer.h"
+#include "modules/PayloadCodec/binary_payload.h"
+#include "modules/PayloadCodec/json_payload.h"
+#include "modules/Diagnostics/diagnostics.h"
 
 // --- Bibliotecas de Comunicação ---
 #include <TinyGsmClient.h>
 #include <TinyGsmClientSIM7000.h>
 #include <PubSubClient.h>
-#include <ArduinoJson.h>      
-#include <SSLClientESP32.h>    
+#include "tls_client.h"
+#include "gps_cache.h"
 #include <time.h>     
 #include <sys/time.h>  
 
@@ -17,9 +21,51 @@
 // Objetos de comunicação (estáticos para este módulo)
 static TinyGsm modem(SerialAT);
 static TinyGsmClient base_client(modem, 0);
-static SSLClientESP32 ssl_client(&base_client);
+static TlsClient ssl_client(&base_client); // TLS com retomada de sessão entre despertares
 static PubSubClient mqtt_client(ssl_client);
 
+// Estado da camada de rede (modem + GPRS) neste despertar. Permite que a
+// subida da rede seja iniciada antecipadamente (ver RTOSTasks) e que o
+// perform_communication_cycle() apenas reaproveite o resultado.
+typedef enum {
+    COMM_NETWORK_NOT_STARTED = 0,
+    COMM_NETWORK_READY,
+    COMM_NETWORK_FAILED,
+} comm_network_state_t;
+
+static volatile comm_network_state_t g_network_state = COMM_NETWORK_NOT_STARTED;
+
+// true quando o modem foi deixado em PSM/eDRX (em vez de desligado) no ciclo
+// anterior. Fica na memória RTC para sobreviver ao deep sleep do ESP32.
+RTC_DATA_ATTR static bool g_modem_low_power_active = false;
+
+// Estado do receptor GNSS neste despertar (pode ser ligado logo após o
+// restart() do modem, em paralelo com o registro na rede).
+static bool g_gps_powered = false;
+static unsigned long g_gps_power_on_ms = 0;
+// Despertar classificado como WAKE_TYPE_GNSS_REFRESH (ver comm_set_gnss_refresh())
+static bool g_gnss_refresh_wake = false;
+
+// Momento (UTC) do último download bem-sucedido do XTRA (A-GNSS).
+// O arquivo em si fica no sistema de arquivos do modem, que sobrevive ao
+// desligamento pelo PWRKEY.
+RTC_DATA_ATTR static uint32_t g_xtra_download_epoch = 0;
+
+// Histórico de sincronização do relógio (para pular o NTP quando possível).
+// A deriva do RTC slow clock do ESP32 é estimado a cada sincronização.
+RTC_DATA_ATTR static uint32_t g_last_ntp_sync_epoch = 0;
+RTC_DATA_ATTR static float g_clock_drift_ppm = 0.0f;
+RTC_DATA_ATTR static float g_clock_drift_window_s = 0.0f; // Janela da última medição
+RTC_DATA_ATTR static bool g_clock_drift_known = false;
+
+// Comandos remotos: quem os trata e quando o tópico foi assinado neste ciclo
+static comm_command_handler_t g_command_handler = nullptr;
+static bool g_command_subscribed = false;
+static unsigned long g_command_subscribed_ms = 0;
+
+static bool gps_power_on();
+static bool synchronize_time_with_ntp();
+
 // --- Implementação das Funções ---
 
 /**
@@ -67,6 +113,174 @@ void init_serial() {
     SerialMon.println(F("CommManager: SerialAT (57600) e pinos de controle inicializados."));
 }
 
+/**
+ * @brief (Função Privada) Tenta reaproveitar o modem deixado em PSM/eDRX.
+ *
+ * Em PSM o modem está "dormindo" mas continua anexado à rede (o contexto PDP
+ * é mantido pela operadora); um pulso no PWRKEY o acorda, mas só é enviado
+ * se ele não responder ao AT. Em eDRX ele nunca
+ * desligou. Se o modem responder e ainda estiver registrado, o restart() e a
+ * espera de registro (20-60 s) são evitados.
+ *
+ * @return true se o modem respondeu e continua registrado na rede.
+ */
+static bool resume_modem_from_low_power() {
+    DiagScope diag_scope(DIAG_PHASE_MODEM_RESUME);
+
+    // Em PSM, o pulso só vai se o modem não responder: acordado (ainda dentro
+    // do T3324, ou a rede caiu para eDRX), o mesmo pulso o desligaria.
+    bool awake = modem.testAT(MODEM_RESUME_PROBE_MS);
+    if (!awake && MODEM_LOW_POWER_MODE == MODEM_LOW_POWER_PSM) {
+        SerialMon.println(F("CommManager: Acordando o modem do PSM..."));
+        modemPowerOn();
+        awake = modem.testAT(5000);
+    }
+
+    if (!awake) {
+        SerialMon.println(F("CommManager: Modem não respondeu após PSM/eDRX. Usando sequência completa."));
+        return false;
+    }
+
+    if (!modem.isNetworkConnected() && !modem.waitForNetwork(10000L)) {
+        SerialMon.println(F("CommManager: Modem perdeu o registro. Usando sequência completa."));
+        return false;
+    }
+
+    if (MODEM_LOW_POWER_MODE == MODEM_LOW_POWER_PSM) {
+        // Com o PSM ainda ativo, o modem voltaria a dormir T3324 depois da
+        // última atividade, no meio do ciclo (a aquisição dos sensores
+        // roda em paralelo). enter_modem_low_power() o reativa no final.
+        modem.sendAT(GF("+CPSMS=0"));
+        modem.waitResponse(5000L);
+    }
+
+    SerialMon.println(F("CommManager: Modem reaproveitado (registro mantido). restart() evitado."));
+    return true;
+}
+
+/**
+ * @brief (Função Privada) Campo 'index' (a partir de 0) da linha 'prefix' de
+ * uma resposta AT separada por vírgulas, sem espaços e sem aspas.
+ * @return String vazia se a linha ou o campo não existirem.
+ */
+static String response_field(const String& response, const char* prefix, int index) {
+    int pos = response.indexOf(prefix);
+    if (pos < 0) {
+        return String();
+    }
+    pos += strlen(prefix);
+    int end = response.indexOf('\n', pos);
+    String line = end < 0 ? response.substring(pos) : response.substring(pos, end);
+
+    for (int i = 0; i < index; i++) {
+        int comma = line.indexOf(',');
+        if (comma < 0) {
+            return String();
+        }
+        line = line.substring(comma + 1);
+    }
+    int comma = line.indexOf(',');
+    String field = comma < 0 ? line : line.substring(0, comma);
+    field.trim();
+    field.replace("\"", "");
+    return field;
+}
+
+/**
+ * @brief (Função Privada) Confere se a rede concedeu o PSM.
+ *
+ * O OK do AT+CPSMS só diz que o modem aceitou o pedido; a concessão vem no
+ * Attach/TAU accept. Com AT+CEREG=4 o +CEREG? traz o T3324 (Active-Time,
+ * 8º campo) e o T3412 (Periodic-TAU) concedidos; sem eles, não há PSM.
+ */
+static bool psm_granted_by_network() {
+    modem.sendAT(GF("+CEREG=4"));
+    modem.waitResponse();
+
+    bool granted = false;
+    for (int poll = 0; poll < MODEM_LOW_POWER_GRANT_POLLS && !granted; poll++) {
+        if (poll > 0) {
+            delay(1000); // O TAU com o pedido de PSM pode ainda estar em andamento
+        }
+        String response;
+        modem.sendAT(GF("+CEREG?"));
+        if (modem.waitResponse(2000L, response) != 1) {
+            continue;
+        }
+        String active_time = response_field(response, "+CEREG:", 7);
+        // Unidade 0b111 no T3324 = desativado
+        granted = active_time.length() == 8 && !active_time.startsWith("111");
+        if (granted) {
+            SerialMon.printf("CommManager: PSM concedido (T3324 %s, T3412 %s).\n", active_time.c_str(),
+                             response_field(response, "+CEREG:", 8).c_str());
+        }
+    }
+
+    // O TinyGSM lê o status do +CEREG? no formato curto
+    modem.sendAT(GF("+CEREG=0"));
+    modem.waitResponse();
+    return granted;
+}
+
+/**
+ * @brief (Função Privada) Confere se a rede concedeu o eDRX (AT+CEDRXRDP).
+ * Tipo de acesso 0 na resposta = eDRX não está em uso na célula.
+ */
+static bool edrx_granted_by_network() {
+    for (int poll = 0; poll < MODEM_LOW_POWER_GRANT_POLLS; poll++) {
+        if (poll > 0) {
+            delay(1000);
+        }
+        String response;
+        modem.sendAT(GF("+CEDRXRDP"));
+        if (modem.waitResponse(2000L, response) != 1) {
+            continue;
+        }
+        String act_type = response_field(response, "+CEDRXRDP:", 0);
+        if (act_type.length() > 0 && act_type != "0") {
+            SerialMon.printf("CommManager: eDRX concedido (ciclo %s).\n",
+                             response_field(response, "+CEDRXRDP:", 2).c_str());
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief (Função Privada) Negocia PSM ou eDRX com a rede antes de dormir.
+ * @return true se a rede concedeu o modo de baixo consumo (não basta o OK
+ * do modem ao pedido).
+ */
+static bool enter_modem_low_power() {
+    if (MODEM_LOW_POWER_MODE == MODEM_LOW_POWER_PSM) {
+        SerialMon.println(F("CommManager: Solicitando PSM (AT+CPSMS)..."));
+        modem.sendAT(GF("+CPSMS=1,,,\""), MODEM_PSM_TAU_TIMER, GF("\",\""), MODEM_PSM_ACTIVE_TIMER, GF("\""));
+    } else {
+        SerialMon.println(F("CommManager: Solicitando eDRX (AT+CEDRXS)..."));
+        modem.sendAT(GF("+CEDRXS=1,"), MODEM_EDRX_ACT_TYPE, GF(",\""), MODEM_EDRX_VALUE, GF("\""));
+    }
+
+    if (modem.waitResponse(5000L) != 1) {
+        SerialMon.println(F("CommManager: AVISO - Modem recusou o modo de baixo consumo."));
+        return false;
+    }
+
+    bool granted = (MODEM_LOW_POWER_MODE == MODEM_LOW_POWER_PSM) ? psm_granted_by_network()
+                                                                 : edrx_granted_by_network();
+    if (!granted) {
+        SerialMon.println(F("CommManager: AVISO - Rede não concedeu PSM/eDRX. Desligando o modem."));
+        // A configuração fica na NVM do modem: desfaz para o próximo boot
+        // não cair no PSM no meio do restart() e do registro.
+        if (MODEM_LOW_POWER_MODE == MODEM_LOW_POWER_PSM) {
+            modem.sendAT(GF("+CPSMS=0"));
+        } else {
+            modem.sendAT(GF("+CEDRXS=0"));
+        }
+        modem.waitResponse(5000L);
+    }
+    return granted;
+}
+
 /**
  * @brief (Função Privada) Liga o modem, reinicia e aguarda o registro na rede.
  * * @note Esta é a função principal de inicialização do modem, chamada a cada 
@@ -78,12 +292,25 @@ void init_serial() {
 static bool setup_modem_and_network() {
     SerialMon.println(F("--- Iniciando Sequência de Modem ---"));
 
+    if (MODEM_LOW_POWER_MODE != MODEM_LOW_POWER_OFF && g_modem_low_power_active) {
+        g_modem_low_power_active = false;
+        if (resume_modem_from_low_power()) {
+            return true;
+        }
+        // Se o pulso de PSM não acordou o modem, ele pode estar desligado:
+        // segue a sequência completa (que envia um novo pulso de power on).
+    }
+
+    diag_phase_begin(DIAG_PHASE_MODEM_RESTART);
     modemPowerOn();
 
     SerialMon.println(F("CommManager: Reiniciando modem (TinyGSM) e aguardando boot..."));
 
-    if (!modem.restart()) {
+    bool restarted = modem.restart();
+    diag_phase_end(DIAG_PHASE_MODEM_RESTART);
+    if (!restarted) {
         SerialMon.println(F("CommManager: Falha ao reiniciar modem (não respondeu aos comandos AT)!"));
+        diag_count(DIAG_COUNTER_NETWORK_FAILURES);
         
         modemPowerOff(); 
         return false;
@@ -93,9 +320,22 @@ static bool setup_modem_and_network() {
     SerialMon.print(F("CommManager: Informação do Modem: "));
     SerialMon.println(modemInfo);
 
+#if GPS_CONCURRENT_WITH_LTE
+    // O cold/warm start do GNSS corre em paralelo com o registro na rede.
+    // A célula servidora ainda é desconhecida: vale a classificação do despertar.
+    if (g_gnss_refresh_wake) {
+        SerialMon.println(F("CommManager: Ligando o GNSS em paralelo com o registro..."));
+        gps_power_on();
+    }
+#endif
+
     SerialMon.println(F("CommManager: Aguardando registro na rede (max 3 min)..."));
-    if (!modem.waitForNetwork(180000L)) { 
+    diag_phase_begin(DIAG_PHASE_REGISTRATION);
+    bool registered = modem.waitForNetwork(180000L);
+    diag_phase_end(DIAG_PHASE_REGISTRATION);
+    if (!registered) { 
         SerialMon.println(F("CommManager: Falha ao registrar na rede celular."));
+        diag_count(DIAG_COUNTER_NETWORK_FAILURES);
         modemPowerOff();
         return false;
     }
@@ -107,21 +347,109 @@ static bool setup_modem_and_network() {
 }
 
 /**
- * @brief (Função Privada) Tenta obter uma localização GPS válida do modem.
-    // 5. Desliga fisicamente o modem
+ * @brief (Função Privada) Aguarda um evento do GNSS ou o fim do intervalo.
  *
- * Esta função liga o GPS, faz um loop de "polling" (sondagem) por um
- * período de timeout e tenta obter um "fix" válido.
+ * Com GPS_USE_URC o modem envia, a cada solução, uma linha não solicitada
+ * "+UGNSINF: <run status>,<fix status>,...". A espera termina assim que chega
+ * um URC com fix status = 1, sem esperar o fim do intervalo de polling.
  *
- * @note Ela assume que o NTP já foi sincronizado (em uma etapa anterior)
- * para permitir um "Hot Start" rápido (TTFF de ~30s).
+ * @param wait_ms Tempo máximo de espera.
+ * @return true se um URC com fix chegou (hora de consultar o GPS).
+ */
+static bool wait_gnss_event(uint32_t wait_ms) {
+#if GPS_USE_URC
+    unsigned long start = millis();
+    while (millis() - start < wait_ms) {
+        uint32_t remaining = wait_ms - (millis() - start);
+        if (modem.waitResponse(remaining, GF("+UGNSINF:")) != 1) {
+            return false;
+        }
+        String urc = modem.stream.readStringUntil('\n');
+        int comma = urc.indexOf(',');
+        if (comma >= 0 && urc.charAt(comma + 1) == '1') {
+            return true;
+        }
+    }
+    return false;
+#else
+    delay(wait_ms);
+    return false;
+#endif
+}
+
+#if GPS_XTRA_ENABLED
+/**
+ * @brief (Função Privada) Indica se o XTRA baixado ainda está no período de validade.
+ * @note Após um boot "frio" a memória RTC é perdida e o XTRA é tratado como vencido.
+ */
+static bool xtra_data_valid() {
+    if (g_xtra_download_epoch == 0) {
+        return false;
+    }
+    time_t now = time(NULL);
+    if (now < (time_t)g_xtra_download_epoch) {
+        return false; // Relógio ainda não sincronizado
+    }
+    return (uint32_t)(now - g_xtra_download_epoch) < GPS_XTRA_VALIDITY_HOURS * 3600UL;
+}
+
+/**
+ * @brief (Função Privada) Baixa o XTRA pelo GPRS e o copia para o GNSS.
  *
- * @param gps_data Referência para a struct GPS_Data que será preenchida.
- * @param timeout_seconds Duração máxima em segundos para tentar obter o "fix".
- * @return true se um "fix" válido foi obtido, false caso contrário.
+ * Sequência do SIM7000: AT+HTTPTOFS (download para /customer) e AT+CGNSCPY
+ * (cópia para a área do GNSS). Executada no máximo uma vez por período de
+ * validade (GPS_XTRA_VALIDITY_HOURS).
+ *
+ * @note Requer GPRS conectado e o relógio sincronizado (NTP).
+ * @return true se o XTRA foi baixado e copiado com sucesso.
  */
-bool get_gps_location(GPS_Data& gps_data, uint16_t timeout_seconds) {
-    gps_data.isValid = false;
+static bool refresh_xtra_data() {
+    if (xtra_data_valid()) {
+        return false;
+    }
+
+    SerialMon.println(F("CommManager: XTRA vencido ou ausente. Baixando dados de assistência..."));
+    unsigned long start = millis();
+
+    modem.sendAT(GF("+HTTPTOFS=\""), GPS_XTRA_URL, GF("\",\"/customer/xtra3grc.bin\""));
+    if (modem.waitResponse(5000L) != 1) {
+        SerialMon.println(F("CommManager: AVISO - AT+HTTPTOFS recusado."));
+        return false;
+    }
+
+    // Resultado assíncrono: "+HTTPTOFS: <status http>,<tamanho>"
+    if (modem.waitResponse(60000L, GF("+HTTPTOFS:")) != 1) {
+        SerialMon.println(F("CommManager: AVISO - Timeout no download do XTRA."));
+        return false;
+    }
+    int http_status = modem.stream.parseInt();
+    modem.stream.readStringUntil('\n');
+    if (http_status != 200) {
+        SerialMon.printf("CommManager: AVISO - Download do XTRA falhou (HTTP %d).\n", http_status);
+        return false;
+    }
+
+    modem.sendAT(GF("+CGNSCPY"));
+    if (modem.waitResponse(10000L) != 1) {
+        SerialMon.println(F("CommManager: AVISO - AT+CGNSCPY falhou."));
+        return false;
+    }
+
+    g_xtra_download_epoch = (uint32_t)time(NULL);
+    SerialMon.printf("CommManager: XTRA atualizado em %lu ms.\n", millis() - start);
+    return true;
+}
+
+#endif // GPS_XTRA_ENABLED
+
+/**
+ * @brief (Função Privada) Liga a antena (SGPIO) e o receptor GNSS do modem.
+ * @return true se o GNSS foi ligado (ou já estava ligado).
+ */
+static bool gps_power_on() {
+    if (g_gps_powered) {
+        return true;
+    }
     Serial.println(F("CommManager: Habilitando GPS ..."));
 
     modem.sendAT(F("+SGPIO=0,4,1,1"));
@@ -129,6 +457,16 @@ bool get_gps_location(GPS_Data& gps_data, uint16_t timeout_seconds) {
         SerialMon.println(F("CommManager: AVISO - Comando SGPIO (ligar antena) falhou."));
     }
 
+#if GPS_XTRA_ENABLED
+    // Injeta os dados de assistência antes de ligar o receptor, se válidos
+    if (xtra_data_valid()) {
+        modem.sendAT(GF("+CGNSXTRA=1"));
+        if (modem.waitResponse() == 1) {
+            SerialMon.println(F("CommManager: XTRA habilitado para este start do GNSS."));
+        }
+    }
+#endif
+
     SerialMon.println(F("CommManager: Habilitando GPS (Etapa 2: Rádio)..."));
     if (!modem.enableGPS()) {
         SerialMon.println(F("CommManager: Falha ao ligar o módulo GPS (AT+CGNSPWR=1)."));
@@ -138,6 +476,65 @@ bool get_gps_location(GPS_Data& gps_data, uint16_t timeout_seconds) {
         return false;
     }
 
+    g_gps_powered = true;
+    g_gps_power_on_ms = millis();
+    return true;
+}
+
+/**
+ * @brief (Função Privada) Desliga o receptor GNSS (e os URCs de solução).
+ */
+static void gps_power_off() {
+    if (!g_gps_powered) {
+        return;
+    }
+#if GPS_USE_URC
+    modem.sendAT(GF("+CGNSURC=0"));
+    modem.waitResponse();
+#endif
+
+    SerialMon.println(F("CommManager: Desabilitando o GPS..."));
+    modem.disableGPS();
+    g_gps_powered = false;
+}
+
+/**
+ * @brief (Função Privada) Tenta obter uma localização GPS válida do modem.
+ *
+ * Se o GNSS ainda não foi ligado (ver GPS_CONCURRENT_WITH_LTE), liga-o agora.
+ * Depois consulta o "fix" com intervalo adaptativo: rápido no início
+ * (GPS_POLL_INITIAL_MS), dobrando até GPS_POLL_MAX_MS. Com GPS_USE_URC, a
+ * consulta é antecipada pelos URCs de solução do modem.
+ *
+ * Sai assim que um fix atinge os limiares de qualidade (GPS_MAX_HDOP e
+ * GPS_MIN_SATELLITES_USED). Se o timeout chegar antes, usa o melhor fix
+ * (menor HDOP) obtido, se houver.
+ *
+ * @note Ela assume que o NTP já foi sincronizado (em uma etapa anterior)
+ * para permitir um "Hot Start" rápido (TTFF de ~30s).
+ *
+ * @param gps_data Referência para a struct GPS_Data que será preenchida
+ * (incluindo ttff_ms, o tempo desde que o GNSS foi ligado até o fix).
+ * @param timeout_seconds Duração máxima em segundos para tentar obter o "fix"
+ * a partir desta chamada.
+ * @return true se um "fix" válido foi obtido, false caso contrário.
+ */
+bool get_gps_location(GPS_Data& gps_data, uint16_t timeout_seconds) {
+    DiagScope diag_scope(DIAG_PHASE_GNSS);
+    gps_data.isValid = false;
+
+    if (!gps_power_on()) {
+        return false;
+    }
+
+#if GPS_USE_URC
+    // Só aqui: durante o registro os URCs apenas poluiriam a SerialAT
+    modem.sendAT(GF("+CGNSURC=1")); // Um URC a cada solução do GNSS
+    if (modem.waitResponse() != 1) {
+        SerialMon.println(F("CommManager: AVISO - AT+CGNSURC falhou. Usando apenas polling."));
+    }
+#endif
+
     SerialMon.print(F("CommManager: GPS habilitado. Aguardando 'fix' (timeout: "));
 
     SerialMon.print(timeout_seconds);
@@ -145,46 +542,119 @@ bool get_gps_location(GPS_Data& gps_data, uint16_t timeout_seconds) {
     SerialMon.println(F("s)..."));
 
     unsigned long start_time = millis();
+    uint32_t poll_interval_ms = GPS_POLL_INITIAL_MS;
     bool got_fix = false;
+    GPS_Data candidate;
+    GPS_Data best;
+    uint32_t best_ttff_ms = 0;
 
     while (millis() - start_time < (unsigned long)timeout_seconds * 1000) {
 
-        // 3. Pede os dados (TinyGSM envia AT+CGNSINF e faz o parse)
-        if (modem.getGPS(&gps_data.latitude, &gps_data.longitude, 
-                         &gps_data.speed_kph, &gps_data.altitude, 
-                         &gps_data.satellites_visible, &gps_data.satellites_used, 
-                         &gps_data.accuracy)) {
+        // Pede os dados (TinyGSM envia AT+CGNSINF e faz o parse)
+        diag_count(DIAG_COUNTER_GNSS_POLLS);
+        if (modem.getGPS(&candidate.latitude, &candidate.longitude, 
+                         &candidate.speed_kph, &candidate.altitude, 
+                         &candidate.satellites_visible, &candidate.satellites_used, 
+                         &candidate.accuracy)) {
 
             // A função getGPS() pode retornar true mas com dados 0.0 se não houver fix.
-            if (gps_data.latitude != 0.00 ) {
-                SerialMon.println(F("--- FIX VÁLIDO OBTIDO! ---"));
-                SerialMon.printf("Lat: %s, Lon: %s, Precisão: %s, Satélites Visiveis: %d, Satélites Utilizados: %d\n",
-                                 String(gps_data.latitude, 6).c_str(), 
-                                 String(gps_data.longitude, 6).c_str(),
-                                 String(gps_data.accuracy, 2).c_str(),
-                                 gps_data.satellites_visible, gps_data.satellites_used);
-                                 
-                gps_data.isValid = true;
-                got_fix = true;
-                break; // Sucesso, sai do loop
+            if (candidate.latitude != 0.00) {
+                if (!best.isValid || candidate.accuracy < best.accuracy) {
+                    best = candidate;
+                    best.isValid = true;
+                    best_ttff_ms = millis() - g_gps_power_on_ms;
+                }
+
+                if (candidate.satellites_used >= GPS_MIN_SATELLITES_USED &&
+                    candidate.accuracy <= GPS_MAX_HDOP) {
+                    got_fix = true;
+                    break; // Sucesso, sai do loop
+                }
             }
         }
         
         SerialMon.print(F(".")); // Imprime um ponto a cada tentativa
-        delay(5000); // Tenta a cada 5 segundos
+
+        // Backoff só quando nenhum evento de fix antecipou a consulta
+        if (!wait_gnss_event(poll_interval_ms)) {
+            poll_interval_ms *= 2;
+            if (poll_interval_ms > GPS_POLL_MAX_MS) {
+                poll_interval_ms = GPS_POLL_MAX_MS;
+            }
+        }
     }
 
-    if (!got_fix) {
+    if (best.isValid) {
+        gps_data = best;
+        gps_data.fix_epoch_utc = (uint32_t)time(NULL);
+        gps_data.from_cache = false;
+        gps_data.ttff_ms = best_ttff_ms;
+
+        if (got_fix) {
+            SerialMon.println(F("--- FIX VÁLIDO OBTIDO! ---"));
+        } else {
+            SerialMon.println(F("\nTimeout! Usando o melhor fix obtido (limiares de qualidade não atingidos)."));
+        }
+        SerialMon.printf("Lat: %s, Lon: %s, Precisão: %s, Satélites Visiveis: %d, Satélites Utilizados: %d, TTFF: %lu ms\n",
+                         String(gps_data.latitude, 6).c_str(), 
+                         String(gps_data.longitude, 6).c_str(),
+                         String(gps_data.accuracy, 2).c_str(),
+                         gps_data.satellites_visible, gps_data.satellites_used,
+                         (unsigned long)gps_data.ttff_ms);
+    } else {
         Serial.println(F("\nTimeout! Não foi possível obter um fix de GPS."));
     }
 
-    SerialMon.println(F("CommManager: Desabilitando o GPS..."));
-    modem.disableGPS();
+    gps_power_off();
 
     return gps_data.isValid;
 }
 
 
+/**
+ * @brief (Função Privada) Lê a identificação da célula servidora (AT+CPSI?).
+ *
+ * Resposta típica: "+CPSI: LTE CAT-M1,Online,724-05,0x1A2B,27446553,..."
+ * O TAC (4º campo) e o Cell ID (5º campo) são combinados em um único valor.
+ *
+ * @return Identificador da célula, ou 0 se não foi possível obtê-lo.
+ */
+static uint32_t read_serving_cell_id() {
+    String response;
+    modem.sendAT(GF("+CPSI?"));
+    if (modem.waitResponse(2000L, response) != 1) {
+        return 0;
+    }
+
+    int start = response.indexOf("+CPSI:");
+    if (start < 0) {
+        return 0;
+    }
+
+    // Separa os campos por vírgula a partir do início da resposta
+    String fields[5];
+    int field = 0;
+    int pos = start + 6;
+    while (field < 5) {
+        int comma = response.indexOf(',', pos);
+        if (comma < 0) {
+            fields[field++] = response.substring(pos);
+            break;
+        }
+        fields[field++] = response.substring(pos, comma);
+        pos = comma + 1;
+    }
+    if (field < 5) {
+        return 0;
+    }
+
+    fields[3].trim();
+    fields[4].trim();
+    uint32_t tac = strtoul(fields[3].c_str(), NULL, 0);
+    uint32_t cell = strtoul(fields[4].c_str(), NULL, 0);
+    return (tac << 16) ^ cell;
+}
+
 /**
  * @brief (Função Privada) Estabelece a conexão GPRS (contexto PDP) usando
  * as credenciais do config.
@@ -195,6 +665,14 @@ bool get_gps_location(GPS_Data& gps_data, uint16_t timeout_seconds) {
  * @return true se a conexão GPRS for estabelecida, false caso contrário.
  */
 static bool connect_gprs() {
+    DiagScope diag_scope(DIAG_PHASE_GPRS);
+
+    // Após PSM/eDRX o contexto PDP pode continuar ativo
+    if (modem.isGprsConnected()) {
+        SerialMon.println(F("CommManager: GPRS já conectado (contexto PDP mantido)."));
+        return true;
+    }
+
     SerialMon.print(F("CommManager: Conectando ao GPRS (APN: "));
     SerialMon.print(APN);
     SerialMon.println(F(")..."));
@@ -235,9 +713,115 @@ static void mqtt_callback(char* topic, byte* payload, unsigned int len) {
     msg_buffer[len] = '\0';
 
     SerialMon.println(msg_buffer);
+
+    // Payload vazio = mensagem retida apagada no broker
+    if (g_command_handler != nullptr && len > 0 && strcmp(topic, AWS_IOT_COMMAND_TOPIC) == 0) {
+        g_command_handler(msg_buffer);
+    }
+}
+
+/**
+ * @brief (Função Privada) Assina o tópico de comandos (uma vez por conexão).
+ */
+static void subscribe_commands() {
+    g_command_subscribed = false;
+    if (g_command_handler == nullptr) {
+        return;
+    }
+    if (mqtt_client.subscribe(AWS_IOT_COMMAND_TOPIC)) {
+        g_command_subscribed = true;
+        g_command_subscribed_ms = millis();
+        SerialMon.printf("CommManager: Assinado o tópico de comandos '%s'.\n", AWS_IOT_COMMAND_TOPIC);
+    } else {
+        SerialMon.println(F("CommManager: AVISO - Falha ao assinar o tópico de comandos."));
+    }
+}
+
+/**
+ * @brief (Função Privada) Dá tempo para a mensagem retida do tópico de
+ * comandos chegar antes de desligar o modem (MQTT_COMMAND_WAIT_MS após a
+ * assinatura; o tempo já gasto publicando conta).
+ */
+static void wait_for_commands() {
+    if (!g_command_subscribed) {
+        return;
+    }
+    while (mqtt_client.connected() && millis() - g_command_subscribed_ms < MQTT_COMMAND_WAIT_MS) {
+        mqtt_client.loop();
+        delay(20);
+    }
+    mqtt_client.loop();
+}
+
+void comm_set_command_handler(comm_command_handler_t handler) {
+    g_command_handler = handler;
+}
+
+void comm_set_gnss_refresh(bool refresh) {
+    g_gnss_refresh_wake = refresh;
+}
+
+/**
+ * @brief (Função Privada) Converte uma data civil (UTC) em epoch Unix.
+ *
+ * Substitui o mktime(), que depende do fuso configurado na libc e normaliza
+ * a struct tm inteira. Algoritmo "days from civil" (H. Hinnant).
+ */
+static time_t epoch_from_civil(int year, int month, int day, int hour, int min, int sec) {
+    year -= (month <= 2) ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = (unsigned)(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    const long days = (long)era * 146097L + (long)doe - 719468L;
+    return (time_t)(days * 86400L + hour * 3600L + min * 60L + sec);
+}
+
+/**
+ * @brief (Função Privada) Estima o erro atual do relógio interno.
+ *
+ * erro = deriva x tempo desde a última sincronização + incerteza base.
+ * A deriva usada é a maior entre a medida, a resolução da medida (2 s de
+ * quantização sobre a janela) e CLOCK_DEFAULT_DRIFT_PPM: uma deriva real
+ * de centenas de ppm pode ser medida como 0 e não pode dispensar o NTP
+ * para sempre.
+ *
+ * @return Erro previsto em segundos, ou um valor negativo se o relógio
+ * nunca foi sincronizado ou se a sincronização forçada venceu.
+ */
+static float predicted_clock_error_s() {
+    time_t now = time(NULL);
+    if (g_last_ntp_sync_epoch == 0 || now < (time_t)g_last_ntp_sync_epoch) {
+        return -1.0f;
+    }
+    float elapsed_s = (float)(now - g_last_ntp_sync_epoch);
+    if (elapsed_s >= (float)CLOCK_FORCED_SYNC_INTERVAL_S) {
+        return -1.0f;
+    }
+    float drift_ppm = CLOCK_DEFAULT_DRIFT_PPM;
+    if (g_clock_drift_known) {
+        drift_ppm = fmaxf(drift_ppm, fmaxf(fabsf(g_clock_drift_ppm), 2.0f / g_clock_drift_window_s * 1e6f));
+    }
+    return elapsed_s * drift_ppm * 1e-6f + CLOCK_BASE_UNCERTAINTY_S;
+}
+
+/**
+ * @brief (Função Privada) Sincroniza o relógio apenas se o erro previsto
+ * ultrapassar CLOCK_MAX_ERROR_S.
+ * @return true se o relógio está confiável (sincronizado agora ou antes).
+ */
+static bool synchronize_time_if_needed() {
+    float error_s = predicted_clock_error_s();
+    if (error_s >= 0.0f && error_s < CLOCK_MAX_ERROR_S) {
+        SerialMon.printf("CommManager: NTP dispensado (erro previsto: %.2f s, limite: %.1f s).\n",
+                         error_s, (float)CLOCK_MAX_ERROR_S);
+        return true;
+    }
+    return synchronize_time_with_ntp();
 }
 
 static bool synchronize_time_with_ntp() {
+    DiagScope diag_scope(DIAG_PHASE_NTP);
     SerialMon.println(F("CommManager: Sincronizando NTP ..."));
 
     if (!modem.NTPServerSync("pool.ntp.org", 0)) {
@@ -263,30 +847,43 @@ static bool synchronize_time_with_ntp() {
             SerialMon.printf("  FUSO HORÁRIO (Timezone) reportado: %f (quartos de hora)\n", ntp_timezone);
             SerialMon.println(F("============================================="));
 
-            struct tm timeinfo = {0};
-            timeinfo.tm_year = ntp_year - 1900; 
-            timeinfo.tm_mon = ntp_month - 1;    
-            timeinfo.tm_mday = ntp_day;
-            timeinfo.tm_hour = ntp_hour;
-            timeinfo.tm_min = ntp_min;
-            timeinfo.tm_sec = ntp_sec;
-
-            time_t epoch_time_lida = mktime(&timeinfo);
+            time_t epoch_time_lida = epoch_from_civil(ntp_year, ntp_month, ntp_day,
+                                                      ntp_hour, ntp_min, ntp_sec);
             
             long timezone_seconds = (long)(ntp_timezone * 15.0f * 60.0f);
             time_t epoch_time_utc = epoch_time_lida - timezone_seconds; 
 
+            // Mede a deriva do relógio interno desde a última sincronização
+            time_t epoch_time_rtc = time(NULL);
+            if (g_last_ntp_sync_epoch != 0 && epoch_time_utc > (time_t)g_last_ntp_sync_epoch) {
+                float elapsed_s = (float)(epoch_time_utc - g_last_ntp_sync_epoch);
+                if (elapsed_s >= CLOCK_MIN_DRIFT_WINDOW_S) {
+                    float drift_ppm = (float)(epoch_time_utc - epoch_time_rtc) / elapsed_s * 1e6f;
+                    // Média móvel para suavizar a quantização de 1 s da hora da rede
+                    g_clock_drift_ppm = g_clock_drift_known
+                                        ? 0.5f * g_clock_drift_ppm + 0.5f * drift_ppm
+                                        : drift_ppm;
+                    g_clock_drift_window_s = elapsed_s;
+                    g_clock_drift_known = true;
+                    SerialMon.printf("CommManager: Deriva do relógio: %.1f ppm (estimada: %.1f ppm).\n",
+                                     drift_ppm, g_clock_drift_ppm);
+                }
+            }
+
             struct timeval tv;
             tv.tv_sec = epoch_time_utc; 
             tv.tv_usec = 0;
             settimeofday(&tv, NULL); 
 
             SerialMon.println(F("CommManager: Relógio interno (RTC) do ESP32 sincronizado para UTC!"));
+            g_last_ntp_sync_epoch = (uint32_t)epoch_time_utc;
+            sample_buffer_clock_synced((int64_t)epoch_time_utc - (int64_t)epoch_time_rtc);
             
             return true; 
 
         } else {
             SerialMon.println(F("CommManager: Falha ao ler a hora... retentando em 5s."));
+            diag_count(DIAG_COUNTER_NTP_RETRIES);
             delay(5000L); 
         }
     }
@@ -300,7 +897,7 @@ static bool synchronize_time_with_ntp() {
  * @brief (Função Privada) Configura o cliente SSL e conecta ao AWS IoT via MQTT.
  *
  * Esta função carrega os certificados (CA, Certificado, Chave Privada)
- * na instância do SSLClient e, em seguida, usa o PubSubClient para
+ * na instância do TlsClient e, em seguida, usa o PubSubClient para
  * estabelecer a conexão MQTT segura (porta 8883) com o endpoint da AWS.
  *
  * Inclui uma lógica de 5 retentativas com 5s de espera em caso de falha.
@@ -308,6 +905,7 @@ static bool synchronize_time_with_ntp() {
  * @return true se a conexão MQTT for estabelecida, false caso contrário.
  */
 static bool connect_aws_iot() {
+    DiagScope diag_scope(DIAG_PHASE_MQTT_CONNECT);
 
     // Log de Heap: Para depurar falhas de alocação de memória SSL
     SerialMon.printf("CommManager: Free Heap antes da configuração SSL: %u\n", ESP.getFreeHeap());
@@ -321,7 +919,7 @@ static bool connect_aws_iot() {
     // 2. Configura o cliente MQTT
     mqtt_client.setServer(AWS_IOT_ENDPOINT, 8883); // Porta padrão AWS IoT
     mqtt_client.setCallback(mqtt_callback); // Define o "ouvido"
-    mqtt_client.setBufferSize(512); // Aumenta o buffer 
+    mqtt_client.setBufferSize(MQTT_PACKET_BUFFER_SIZE); // Aumenta o buffer (lotes de amostras)
 
     SerialMon.print(F("CommManager: Tentando conexão MQTT com o AWS IoT..."));
     int retries = 0;
@@ -332,11 +930,19 @@ static bool connect_aws_iot() {
 
         if (mqtt_client.connect(AWS_IOT_CLIENT_ID)) {
             SerialMon.println(F("CommManager: MQTT conectado com o AWS IoT!"));
+
+            const TLS_Metrics& tls = tls_client_metrics();
+            SerialMon.printf("CommManager: TLS handshake %lu ms (%s), retomadas %u/%u.\n",
+                             (unsigned long)tls.last_handshake_ms,
+                             tls.last_resumed ? "retomado" : "completo",
+                             tls.resumption_hits, tls.resumption_offers);
+            subscribe_commands();
             return true;
         } else {
             SerialMon.print(F("CommManager: conexão MQTT falhou, rc="));
             SerialMon.print(mqtt_client.state()); 
             SerialMon.println(F(". Tentando novamente em 5 segundos..."));
+            diag_count(DIAG_COUNTER_MQTT_RETRIES);
             
             delay(5000);
             retries++;
@@ -349,99 +955,58 @@ static bool connect_aws_iot() {
 
 
 /**
- * @brief (Função Privada) Serializa todos os dados dos sensores em um JSON
- * e o publica no tópico MQTT da AWS IoT.
-
- * @return true se a publicação MQTT for bem-sucedida, false caso contrário.
+ * @brief (Função Privada) Serializa o maior lote (a partir de 'first') que cabe
+ * em 'capacity' bytes, no formato escolhido por PAYLOAD_FORMAT.
+ *
+ * @param diag Relatório de diagnóstico a anexar ao lote, ou nullptr.
+ * @param out_batch Recebe a quantidade de amostras serializadas.
+ * @return Número de bytes do payload, ou 0 se nem uma amostra couber.
  */
-static bool publish_data(
-    const SCD40_Data& scd40_data, 
-    const MICS6814_Data& mics_data, 
-    const DSM501A_Data& dsm_data, 
-    const GPS_Data& gps_data) {
-
-    if (!modem.isGprsConnected()) {
-         SerialMon.println(F("CommManager: GPRS não conectado. Não é possível publicar dados."));
-         return false;
-    }
-    if (!mqtt_client.connected()) {
-        SerialMon.println(F("CommManager: Cliente MQTT não conectado. Tentando reconexão..."));
-        if (!connect_aws_iot()) { // Tenta reconectar ao MQTT
-            SerialMon.println(F("CommManager: Falha ao reconectar MQTT. Não é possível publicar dados."));
-            return false;
-        }
+static size_t serialize_batch(size_t first, size_t available, const GPS_Data& gps_data,
+                              const Diag_Report* diag,
+                              uint8_t* buffer, size_t capacity, size_t& out_batch) {
+    out_batch = 0;
+
+    // Cópia estática (não no heap) das amostras pendentes
+    static StoredSample batch_samples[SAMPLE_BUFFER_CAPACITY];
+    size_t count = 0;
+    while (count < available && count < SAMPLE_BUFFER_CAPACITY &&
+           sample_buffer_peek(first + count, batch_samples[count])) {
+        count++;
     }
 
-    JsonDocument jsonDoc; 
-    jsonDoc["deviceId"] = AWS_IOT_CLIENT_ID;
-    
-    time_t now_epoch_utc;
-    time(&now_epoch_utc); 
-    jsonDoc["timestamp_utc_sec"] = now_epoch_utc;
-
-    char time_str[32];
-    struct tm *ptm = gmtime(&now_epoch_utc); 
-    strftime(time_str, sizeof(time_str), "%Y-%m-%dT%H:%M:%SZ", ptm); 
-    jsonDoc["datetime_utc_str"] = time_str;
-
-
-
-     if (scd40_data.isValid) {
-        JsonObject scd_json = jsonDoc["scd40"].to<JsonObject>();
-        scd_json["co2"] = round(scd40_data.co2 * 100.0) / 100.0; 
-        scd_json["temperature"] = round(scd40_data.temperature * 100.0) / 100.0;
-        scd_json["humidity"] = round(scd40_data.humidity * 100.0) / 100.0;
-    }
-    
-    if (mics_data.isValid) {
-        JsonObject mics_json = jsonDoc["mics6814"].to<JsonObject>();
-        // Enviar tanto a tensão (para depuração) quanto o PPM (para análise)
-        mics_json["ppm_co"] = String(mics_data.ppm_co, 2);
-        mics_json["ppm_no2"] = String(mics_data.ppm_no2, 2);
-        mics_json["ppm_nh3"] = String(mics_data.ppm_nh3, 2);
-        mics_json["raw_co"] = mics_data.raw_co;
-        mics_json["raw_no2"] = mics_data.raw_no2;
-        mics_json["raw_nh3"] = mics_data.raw_nh3;
-}
-
-    if (dsm_data.isValid) {
-        JsonObject dsm_json = jsonDoc["dsm501a"].to<JsonObject>();
-        dsm_json["lop_ratio_pm25"] = round(dsm_data.low_pulse_occupancy_ratio_pm25 * 100.0) / 100.0; 
-        dsm_json["lop_ratio_pm10"] = round(dsm_data.low_pulse_occupancy_ratio_pm10 * 100.0) / 100.0;
-    }
-
-    if (gps_data.isValid) {
-        JsonObject location_json = jsonDoc["location"].to<JsonObject>();
-        location_json["latitude"] = serialized(String(gps_data.latitude, 6));
-        location_json["longitude"] = serialized(String(gps_data.longitude, 6));
-        location_json["accuracy_m"] = round(gps_data.accuracy * 100.0) / 100.0; 
-
-        location_json["satellites_used"] = gps_data.satellites_used;
-        
-        location_json["satellites_visible"] = gps_data.satellites_visible;
-        location_json["altitude_m"] = round(gps_data.altitude * 100.0) / 100.0;
-    }
-
-    char jsonBuffer[1024];
-    size_t n = serializeJson(jsonDoc, jsonBuffer);
-    if (n == 0) {
-        SerialMon.println(F("CommManager: FALHA CRÍTICA - serializeJson() falhou. (JSON > 1024 bytes?)"));
-        return false;
-    }
+#if PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+    return binary_payload_encode(buffer, capacity, AWS_IOT_CLIENT_ID,
+                                 batch_samples, count, gps_data, diag, out_batch);
+#else
+    // +1: o terminador nulo não vai no pacote MQTT (o buffer tem folga para ele)
+    return json_payload_encode(buffer, capacity + 1, AWS_IOT_CLIENT_ID,
+                               batch_samples, count, gps_data, diag, out_batch);
+#endif
+}
 
+/**
+ * @brief (Função Privada) Publica um payload já serializado no tópico da AWS IoT.
+ */
+static bool publish_payload(const uint8_t* payload, size_t length) {
     SerialMon.print(F("CommManager: Publicando mensagem ("));
-    SerialMon.print(n);
+    SerialMon.print(length);
+#if PAYLOAD_FORMAT == PAYLOAD_FORMAT_BINARY
+    SerialMon.print(F(" bytes, binário v"));
+    SerialMon.print(BINARY_PAYLOAD_VERSION);
+    SerialMon.println(F(")."));
+#else
     SerialMon.print(F(" bytes): "));
-    SerialMon.println(jsonBuffer);
+    SerialMon.println((const char*)payload);
+#endif
 
     mqtt_client.loop();
     delay(100);
 
-    if (mqtt_client.publish(AWS_IOT_PUBLISH_TOPIC, jsonBuffer)) { 
+    if (mqtt_client.publish(AWS_IOT_PUBLISH_TOPIC, payload, length, false)) { 
         SerialMon.println(AWS_IOT_PUBLISH_TOPIC);
         SerialMon.println(F("CommManager: Mensagem publicada no tópico com sucesso!"));
         mqtt_client.loop();
-        delay(500);
         return true;
     } else {
         SerialMon.print(F("CommManager: Falha ao publicar a mensagem. estado MQTT: "));
@@ -450,20 +1015,26 @@ static bool publish_data(
     }
 }
 
-
 /**
  * @brief (Função Privada) Desconecta e desliga todas as camadas da rede.
  *
  * Desliga a pilha na ordem correta (de cima para baixo):
  * 1. MQTT (PubSubClient)
- * 2. SSL (SSLClientESP32)
+ * 2. SSL (TlsClient)
  * 3. TCP (TinyGsmClient)
  * 4. GPRS (TinyGSM)
  * 5. Hardware (Pulso de energia)
+ *
+ * @note Com MODEM_LOW_POWER_MODE em PSM/eDRX, as etapas 4 e 5 são trocadas
+ * pela negociação do modo de baixo consumo: o modem continua anexado à rede
+ * e o próximo ciclo o reaproveita (ver resume_modem_from_low_power()).
  */
 static void disconnect_and_powerdown_modem() {
     SerialMon.println(F("CommManager: Iniciando sequência de desligamento..."));
 
+    // O GNSS pode ter sido ligado cedo e o ciclo abortado antes da leitura
+    gps_power_off();
+
     if (mqtt_client.connected()) {
         mqtt_client.disconnect();
         SerialMon.println(F("CommManager: MQTT desconectado."));
@@ -479,6 +1050,14 @@ static void disconnect_and_powerdown_modem() {
         SerialMon.println(F("CommManager: Cliente Base (TCP) parado."));
     }
 
+    if (MODEM_LOW_POWER_MODE != MODEM_LOW_POWER_OFF && g_network_state == COMM_NETWORK_READY) {
+        if (enter_modem_low_power()) {
+            g_modem_low_power_active = true;
+            SerialMon.println(F("CommManager: Modem mantido em PSM/eDRX (não desligado)."));
+            return;
+        }
+    }
+
     if (modem.isGprsConnected()) {
         modem.gprsDisconnect(); 
         SerialMon.println(F("CommManager: GPRS desconectado."));
@@ -488,41 +1067,138 @@ static void disconnect_and_powerdown_modem() {
     SerialMon.println(F("CommManager: Modem desligado fisicamente."));
 }
 
-bool perform_communication_cycle(
-    const SCD40_Data& scd_data,
-    const MICS6814_Data& mics_data,
-    const DSM501A_Data& dsm_data,
-    GPS_Data& out_gps_data
-) {
-    bool publication_successful = false;
-
-    //===========
-    int ntp_year = 0, ntp_month = 0, ntp_day = 0;
-    int ntp_hour = 0, ntp_min = 0, ntp_sec = 0;
-    float ntp_timezone = 0.0f;
-    bool time_synced = false;
-    String time_str;
-
-    SerialMon.println(F("\n=== INICIANDO CICLO DE COMUNICAÇÃO ==="));
+bool comm_bring_up_network() {
+    if (g_network_state != COMM_NETWORK_NOT_STARTED) {
+        return g_network_state == COMM_NETWORK_READY;
+    }
 
     if (!setup_modem_and_network()) {
         SerialMon.println(F("Comm. Cycle: FALHA CRÍTICA - Não foi possível ligar ou registrar o modem."));
-        goto cleanup; 
+        g_network_state = COMM_NETWORK_FAILED;
+        return false;
     }
 
     if (!connect_gprs()) {
         SerialMon.println(F("Comm. Cycle: FALHA CRÍTICA - Não foi possível conectar ao GPRS (APN)."));
+        g_network_state = COMM_NETWORK_FAILED;
+        return false;
+    }
+
+    g_network_state = COMM_NETWORK_READY;
+    return true;
+}
+
+/**
+ * @brief (Função Privada) Publica todas as amostras pendentes do SampleBuffer
+ * em lotes (JSON colunar ou binário, conforme PAYLOAD_FORMAT) e remove as que
+ * foram publicadas.
+ *
+ * Cada lote recebe o maior número de amostras cujo payload ainda cabe no buffer
+ * do PubSubClient; o backlog é dividido automaticamente em várias publicações.
+ *
+ * @return true se TODO o backlog foi publicado, false caso contrário.
+ */
+static bool publish_backlog(const GPS_Data& gps_data) {
+    DiagScope diag_scope(DIAG_PHASE_PUBLISH);
+    size_t pending = sample_buffer_count();
+    size_t published = 0;
+
+    if (!modem.isGprsConnected()) {
+         SerialMon.println(F("CommManager: GPRS não conectado. Não é possível publicar dados."));
+         return false;
+    }
+    if (!mqtt_client.connected()) {
+        SerialMon.println(F("CommManager: Cliente MQTT não conectado. Tentando reconexão..."));
+        if (!connect_aws_iot()) { // Tenta reconectar ao MQTT
+            SerialMon.println(F("CommManager: Falha ao reconectar MQTT. Não é possível publicar dados."));
+            return false;
+        }
+    }
+
+    // O pacote PUBLISH precisa caber inteiro no buffer do PubSubClient:
+    // cabeçalho fixo (até 5 bytes) + tamanho do tópico (2) + tópico + payload.
+    const size_t max_payload = MQTT_PACKET_BUFFER_SIZE - 5 - 2 - strlen(AWS_IOT_PUBLISH_TOPIC);
+    static uint8_t payload_buffer[MQTT_PACKET_BUFFER_SIZE];
+
+    SerialMon.printf("CommManager: Publicando backlog de %u amostra(s)...\n", (unsigned)pending);
+
+    // O relatório de diagnóstico vai apenas no primeiro lote publicado
+    const Diag_Report* diag = DIAG_TELEMETRY_ENABLED ? &diag_report() : nullptr;
+
+    while (published < pending) {
+        size_t batch = 0;
+        size_t n = serialize_batch(published, pending - published, gps_data, diag,
+                                   payload_buffer, max_payload, batch);
+        if (n == 0 && diag != nullptr) {
+            SerialMon.println(F("CommManager: AVISO - Bloco de diagnóstico não cabe no lote. Publicando sem ele."));
+            diag = nullptr;
+            continue;
+        }
+        if (n == 0) {
+            SerialMon.println(F("CommManager: FALHA CRÍTICA - Uma única amostra não cabe no buffer MQTT."));
+            break;
+        }
+
+        SerialMon.printf("CommManager: Lote de %u amostra(s).\n", (unsigned)batch);
+        if (!publish_payload(payload_buffer, n)) {
+            diag_count(DIAG_COUNTER_PUBLISH_FAILURES);
+            break;
+        }
+        if (diag != nullptr) {
+            diag_report_delivered();
+            diag = nullptr;
+        }
+        published += batch;
+    }
+
+    // Remove apenas o que foi confirmado; o restante fica para o próximo upload
+    sample_buffer_discard(published);
+    delay(500);
+
+    SerialMon.printf("CommManager: %u/%u amostra(s) publicadas.\n", (unsigned)published, (unsigned)pending);
+    return published == pending;
+}
+
+bool perform_communication_cycle(GPS_Data& out_gps_data) {
+    bool publication_successful = false;
+
+    SerialMon.println(F("\n=== INICIANDO CICLO DE COMUNICAÇÃO ==="));
+
+    // Se a rede já foi levantada em paralelo (RTOSTasks), apenas reaproveita
+    // o resultado; caso contrário, executa a sequência completa aqui.
+    if (!comm_bring_up_network()) {
         goto cleanup;
     }
 
-    if (!synchronize_time_with_ntp()) {
+    if (!synchronize_time_if_needed()) {
         SerialMon.println(F("Comm. Cycle: AVISO - Falha ao sincronizar o relógio."));
     } else {
         SerialMon.println(F("Comm. Cycle: Sincronização de relógio bem-sucedida."));
     }
     
-    SerialMon.println(F("Comm. Cycle: Tentando obter localização GPS..."));
-    get_gps_location(out_gps_data, 150);
+    {
+        // O GNSS é o maior consumidor de tempo acordado: só tenta um novo fix
+        // quando há indício de que a unidade saiu do lugar.
+        uint32_t cell_id = read_serving_cell_id();
+        out_gps_data.isValid = false;
+
+        if (gps_cache_refresh_needed(cell_id)) {
+#if GPS_XTRA_ENABLED
+            // Com XTRA novo, reinicia o receptor já ligado (raro: 1x por validade)
+            if (refresh_xtra_data() && g_gps_powered) {
+                gps_power_off();
+            }
+#endif
+            SerialMon.println(F("Comm. Cycle: Tentando obter localização GPS..."));
+            if (get_gps_location(out_gps_data, 150)) {
+                gps_cache_store(out_gps_data, cell_id);
+            }
+        }
+
+        if (!out_gps_data.isValid && gps_cache_load(out_gps_data)) {
+            SerialMon.println(F("Comm. Cycle: Usando a localização em cache."));
+        }
+    }
 
     if (!connect_aws_iot()) {
         SerialMon.println(F("Comm. Cycle: FALHA CRÍTICA - Não foi possível conectar ao AWS IoT (MQTT)."));
@@ -530,17 +1206,19 @@ bool perform_communication_cycle(
     }
 
     SerialMon.println(F("Comm. Cycle: Publicando dados dos sensores..."));
-    if (publish_data(scd_data, mics_data, dsm_data, out_gps_data)) {
+    if (publish_backlog(out_gps_data)) {
         SerialMon.println(F("Comm. Cycle: Publicação de dados BEM-SUCEDIDA."));
         publication_successful = true; 
     } else {
         SerialMon.println(F("Comm. Cycle: FALHA - Não foi possível publicar os dados."));
     }
+    wait_for_commands();
 
 cleanup:
 SerialMon.println(F("Comm. Cycle: Executando limpeza e desligamento do modem..."));
 
 disconnect_and_powerdown_modem();
+g_network_state = COMM_NETWORK_NOT_STARTED;
 
 SerialMon.println(F("=== CICLO DE COMUNICAÇÃO FINALIZADO ==="));
 
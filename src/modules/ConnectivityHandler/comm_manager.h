@@ -7,6 +7,146 @@
 #include "modules/MICS6814/mics6814_handler.h"
 #include "modules/DSM501A/dsm501a_handler.h"
 
+// Tamanho do buffer do PubSubClient (pacote MQTT inteiro: cabeçalho + tópico + payload).
+// Define o tamanho máximo de cada lote publicado.
+#ifndef MQTT_PACKET_BUFFER_SIZE
+#define MQTT_PACKET_BUFFER_SIZE 1024
+#endif
+
+// Polling adaptativo do GNSS: começa rápido e dobra o intervalo até o máximo.
+#ifndef GPS_POLL_INITIAL_MS
+#define GPS_POLL_INITIAL_MS 500
+#endif
+
+#ifndef GPS_POLL_MAX_MS
+#define GPS_POLL_MAX_MS 5000
+#endif
+
+// Limiares de qualidade para encerrar a busca antes do timeout.
+// O campo 'accuracy' do SIM7000 (AT+CGNSINF) é o HDOP.
+#ifndef GPS_MAX_HDOP
+#define GPS_MAX_HDOP 2.5f
+#endif
+
+#ifndef GPS_MIN_SATELLITES_USED
+#define GPS_MIN_SATELLITES_USED 4
+#endif
+
+// Usa os URCs de solução do GNSS (AT+CGNSURC) para antecipar as consultas.
+#ifndef GPS_USE_URC
+#define GPS_USE_URC 1
+#endif
+
+// Liga o GNSS logo após o restart() do modem, em paralelo com o registro na
+// rede. Desabilite (0) em firmwares do SIM7000 que não suportam GNSS e LTE
+// ao mesmo tempo.
+#ifndef GPS_CONCURRENT_WITH_LTE
+#define GPS_CONCURRENT_WITH_LTE 1
+#endif
+
+// A-GNSS: dados de assistência XTRA (efemérides previstas) do SIM7000,
+// baixados pelo GPRS no máximo uma vez por período de validade.
+#ifndef GPS_XTRA_ENABLED
+#define GPS_XTRA_ENABLED 1
+#endif
+
+#ifndef GPS_XTRA_URL
+#define GPS_XTRA_URL "http://iot1.xtracloud.net/xtra3grc.bin"
+#endif
+
+#ifndef GPS_XTRA_VALIDITY_HOURS
+#define GPS_XTRA_VALIDITY_HOURS 72
+#endif
+
+// O NTP é pulado enquanto o erro previsto do relógio interno ficar abaixo de
+// CLOCK_MAX_ERROR_S (segundos). A deriva é medida entre sincronizações, mas a
+// previsão nunca usa menos que CLOCK_DEFAULT_DRIFT_PPM.
+#ifndef CLOCK_MAX_ERROR_S
+#define CLOCK_MAX_ERROR_S 5.0f
+#endif
+
+// Deriva mínima assumida. Típica do RC de 150 kHz do RTC slow clock numa
+// temperatura estável, não o pior caso: com variação de temperatura ele
+// pode derivar mais, e a sincronização forçada abaixo limita o erro.
+#ifndef CLOCK_DEFAULT_DRIFT_PPM
+#define CLOCK_DEFAULT_DRIFT_PPM 1000.0f
+#endif
+
+// Intervalo máximo (segundos) sem NTP, qualquer que seja o erro previsto
+#ifndef CLOCK_FORCED_SYNC_INTERVAL_S
+#define CLOCK_FORCED_SYNC_INTERVAL_S 86400UL
+#endif
+
+// Quantização da hora da rede (resolução de 1 s) somada ao erro previsto
+#ifndef CLOCK_BASE_UNCERTAINTY_S
+#define CLOCK_BASE_UNCERTAINTY_S 1.0f
+#endif
+
+// Janela mínima entre sincronizações para que a deriva medida seja confiável
+#ifndef CLOCK_MIN_DRIFT_WINDOW_S
+#define CLOCK_MIN_DRIFT_WINDOW_S 1800.0f
+#endif
+
+// Modo de baixo consumo do modem entre ciclos de comunicação.
+// OFF:  desliga o modem pelo PWRKEY (novo restart + registro a cada ciclo).
+// PSM:  3GPP Power Saving Mode (AT+CPSMS); o modem dorme anexado à rede.
+// EDRX: extended DRX (AT+CEDRXS); o modem fica ocioso, paginado raramente.
+#define MODEM_LOW_POWER_OFF  0
+#define MODEM_LOW_POWER_PSM  1
+#define MODEM_LOW_POWER_EDRX 2
+
+#ifndef MODEM_LOW_POWER_MODE
+#define MODEM_LOW_POWER_MODE MODEM_LOW_POWER_OFF
+#endif
+
+// T3412 (TAU periódico) e T3324 (tempo ativo) no formato de 8 bits do 3GPP
+// TS 24.008. O TAU deve ser maior que o intervalo entre uploads.
+// "00100100" = 4 horas; "00000001" = 2 segundos.
+#ifndef MODEM_PSM_TAU_TIMER
+#define MODEM_PSM_TAU_TIMER "00100100"
+#endif
+
+#ifndef MODEM_PSM_ACTIVE_TIMER
+#define MODEM_PSM_ACTIVE_TIMER "00000001"
+#endif
+
+// eDRX: tipo de acesso (4 = LTE Cat-M1, 5 = NB-IoT) e ciclo ("0101" = 81,92 s)
+#ifndef MODEM_EDRX_ACT_TYPE
+#define MODEM_EDRX_ACT_TYPE 4
+#endif
+
+#ifndef MODEM_EDRX_VALUE
+#define MODEM_EDRX_VALUE "0101"
+#endif
+
+// Consultas (1 s entre elas) pela concessão do PSM/eDRX pela rede antes de
+// desistir e desligar o modem normalmente
+#ifndef MODEM_LOW_POWER_GRANT_POLLS
+#define MODEM_LOW_POWER_GRANT_POLLS 3
+#endif
+
+// Espera pela resposta ao AT antes de acordar o modem do PSM pelo PWRKEY (ms)
+#ifndef MODEM_RESUME_PROBE_MS
+#define MODEM_RESUME_PROBE_MS 1000
+#endif
+
+// Tópico de comandos remotos (ex: recalibração do MICS6814). Publique o
+// comando como mensagem "retained": o dispositivo dorme entre uploads e só a
+// recebe ao assinar o tópico no próximo ciclo. Por padrão deriva de
+// AWS_IOT_PUBLISH_TOPIC (deve ser um literal de string no config.h).
+#ifndef AWS_IOT_COMMAND_TOPIC
+#define AWS_IOT_COMMAND_TOPIC AWS_IOT_PUBLISH_TOPIC "/cmd"
+#endif
+
+// Tempo mínimo entre a assinatura do tópico de comandos e o desligamento do
+// modem, para a mensagem retida chegar (conta o tempo gasto publicando).
+#ifndef MQTT_COMMAND_WAIT_MS
+#define MQTT_COMMAND_WAIT_MS 500
+#endif
+
+// Recebe o payload (texto terminado em '\0') de cada comando remoto
+typedef void (*comm_command_handler_t)(const char* command);
+
 struct GPS_Data {
     float latitude = 0.0f;
     float longitude = 0.0f;
@@ -15,9 +155,26 @@ struct GPS_Data {
     int satellites_visible = 0;
     int satellites_used = 0;
     float accuracy = 0.0f;
+    uint32_t fix_epoch_utc = 0; // Momento em que o fix foi obtido (UTC)
+    uint32_t ttff_ms = 0;       // Tempo entre ligar o GNSS e obter o fix
+    bool from_cache = false;    // true se veio do GpsCache (fix de um ciclo anterior)
     bool isValid = false;
 };
 
+/**
+ * @brief Registra quem trata os comandos recebidos em AWS_IOT_COMMAND_TOPIC.
+ * Sem handler, o tópico não é assinado.
+ */
+void comm_set_command_handler(comm_command_handler_t handler);
+
+/**
+ * @brief Informa se este despertar deve tentar um novo fix (ver WAKE_TYPE_GNSS_REFRESH).
+ * Com GPS_CONCURRENT_WITH_LTE, o GNSS é ligado logo após o restart() do modem.
+ * Chamar antes de subir a rede. A decisão final, já com a célula servidora,
+ * continua em perform_communication_cycle().
+ */
+void comm_set_gnss_refresh(bool refresh);
+
 /**
  * @brief Inicializa a(s) porta(s) serial e os pinos de controle de hardware
  * para comunicação com o modem.
@@ -29,28 +186,41 @@ struct GPS_Data {
  */
 void init_serial();
 
+/**
+ * @brief Liga o modem, aguarda o registro na rede celular e conecta o GPRS.
+ *
+ * Pode ser chamada antecipadamente (ex: por uma tarefa FreeRTOS em paralelo
+ * com o aquecimento dos sensores). O resultado fica guardado e é reaproveitado
+ * pelo perform_communication_cycle(), que não repete a sequência.
+ *
+ * @note Bloqueante: pode levar até ~3 min (timeout de registro na rede).
+ * @return true se o modem estiver registrado e com GPRS conectado.
+ */
+bool comm_bring_up_network();
+
 /**
  * @brief Executa o ciclo de comunicação completo:
- * 1. Liga o modem e conecta à rede celular.
- * 2. Conecta GPRS e sincroniza o NTP (para o relógio e para o A-GPS).
- * 3. Obtém a localização GPS (agora rápida, graças ao NTP).
+ * 1. Liga o modem e conecta à rede celular (se comm_bring_up_network()
+ *    ainda não tiver sido chamada neste despertar).
+ * 2. Conecta GPRS e sincroniza o NTP (para o relógio e para o A-GPS), se
+ *    o erro previsto do relógio interno exceder CLOCK_MAX_ERROR_S ou se
+ *    passaram CLOCK_FORCED_SYNC_INTERVAL_S desde a última sincronização.
+ * 3. Obtém a localização GPS (agora rápida, graças ao NTP) apenas se o
+ *    GpsCache indicar possível deslocamento; senão reaproveita o último fix.
  * 4. Conecta ao AWS IoT (MQTT).
- * 5. Publica os dados dos sensores.
- * 6. Desconecta e desliga o modem de forma segura.
+ * 5. Publica TODAS as amostras pendentes no SampleBuffer (backlog), em
+ *    lotes colunares divididos para caber no buffer MQTT.
+ * 6. Desconecta e desliga o modem de forma segura (ou o deixa em PSM/eDRX,
+ *    conforme MODEM_LOW_POWER_MODE).
+ *
+ * @note As amostras publicadas são removidas do SampleBuffer; as que falharem
+ * permanecem na memória RTC para o próximo upload.
  *
- * @param scd_data Dados do sensor SCD40.
- * @param mics_data Dados do sensor MICS6814.
- * @param dsm_data Dados do sensor DSM501A.
  * @param out_gps_data Referência para a struct GPS_Data, que será PREENCHIDA
  * por esta função.
- * @return true se a PUBLICAÇÃO dos dados foi bem-sucedida, false caso contrário.
+ * @return true se TODO o backlog foi publicado com sucesso, false caso contrário.
  */
-bool perform_communication_cycle(
-    const SCD40_Data& scd_data,
-    const MICS6814_Data& mics_data,
-    const DSM501A_Data& dsm_data,
-    GPS_Data& out_gps_data // Passado por referência para ser preenchido
-);
+bool perform_communication_cycle(GPS_Data& out_gps_data);
 
 
 
@@ -0,0 +1,70 @@
+#include "gps_cache.h"
+#include <time.h>
+
+// Último fix bom (memória RTC: sobrevive ao deep sleep)
+RTC_DATA_ATTR static GPS_Data g_cached_fix;
+RTC_DATA_ATTR static uint32_t g_cached_cell_id = 0;
+
+/**
+ * @brief (Função Privada) Idade do fix em cache pelo relógio do sistema (s).
+ */
+static uint32_t cached_fix_age_s() {
+    time_t now = time(NULL);
+    return (now > (time_t)g_cached_fix.fix_epoch_utc) ? (uint32_t)(now - g_cached_fix.fix_epoch_utc) : 0;
+}
+
+/**
+ * @brief (Função Privada) Entrada de movimento ativa (sempre false sem o pino).
+ */
+static bool motion_input_active() {
+#if GPS_MOTION_INPUT_PIN >= 0
+    pinMode(GPS_MOTION_INPUT_PIN, INPUT);
+    return digitalRead(GPS_MOTION_INPUT_PIN) == HIGH;
+#else
+    return false;
+#endif
+}
+
+bool gps_cache_refresh_needed(uint32_t cell_id) {
+    if (gps_cache_refresh_due()) {
+        if (!g_cached_fix.isValid) {
+            Serial.println("GpsCache: Sem fix em cache. Novo fix necessário.");
+        } else {
+            Serial.printf("GpsCache: Fix em cache tem %lu s (limite %lu s) ou há movimento. Novo fix necessário.\n",
+                          (unsigned long)cached_fix_age_s(), (unsigned long)(GPS_REFRESH_INTERVAL_HOURS * 3600UL));
+        }
+        return true;
+    }
+
+    if (cell_id != 0 && g_cached_cell_id != 0 && cell_id != g_cached_cell_id) {
+        Serial.printf("GpsCache: Célula mudou (0x%08lX -> 0x%08lX). Possível deslocamento.\n",
+                      (unsigned long)g_cached_cell_id, (unsigned long)cell_id);
+        return true;
+    }
+
+    Serial.printf("GpsCache: Reaproveitando fix em cache (idade: %lu s).\n", (unsigned long)cached_fix_age_s());
+    return false;
+}
+
+bool gps_cache_refresh_due() {
+    return !g_cached_fix.isValid || cached_fix_age_s() > GPS_REFRESH_INTERVAL_HOURS * 3600UL ||
+           motion_input_active();
+}
+
+void gps_cache_store(const GPS_Data& gps_data, uint32_t cell_id) {
+    if (!gps_data.isValid) {
+        return;
+    }
+    g_cached_fix = gps_data;
+    g_cached_fix.from_cache = false;
+    g_cached_cell_id = cell_id;
+}
+
+bool gps_cache_load(GPS_Data& gps_data) {
+    if (!g_cached_fix.isValid) {
+        return false;
+    }
+    gps_data = g_cached_fix;
+    gps_data.from_cache = true;
+    return true;
+}
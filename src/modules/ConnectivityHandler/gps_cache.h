@@ -0,0 +1,52 @@
+#ifndef GPS_CACHE_H
+#define GPS_CACHE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "comm_manager.h" // Para o tipo GPS_Data
+
+// Intervalo máximo entre tentativas de novo "fix", mesmo sem indício de movimento.
+#ifndef GPS_REFRESH_INTERVAL_HOURS
+#define GPS_REFRESH_INTERVAL_HOURS 24
+#endif
+
+// Entrada opcional de movimento (ex: chave de vibração). NÍVEL ALTO = movimento.
+// -1 desabilita.
+#ifndef GPS_MOTION_INPUT_PIN
+#define GPS_MOTION_INPUT_PIN -1
+#endif
+
+/**
+ * @brief Decide se vale a pena ligar o GNSS neste ciclo.
+ *
+ * A maioria das unidades é fixa (postes), então o último "fix" bom é
+ * reaproveitado. Um novo "fix" só é tentado quando:
+ * - não existe fix em cache;
+ * - o fix em cache é mais velho que GPS_REFRESH_INTERVAL_HOURS;
+ * - a célula servidora mudou desde o fix (indício de deslocamento);
+ * - a entrada de movimento (GPS_MOTION_INPUT_PIN) está ativa.
+ *
+ * @param cell_id Identificador da célula servidora atual (0 se desconhecido).
+ * @return true se um novo fix deve ser tentado.
+ */
+bool gps_cache_refresh_needed(uint32_t cell_id);
+
+/**
+ * @brief Critérios de gps_cache_refresh_needed() que não dependem da rede:
+ * tudo menos a troca de célula. Não registra na Serial.
+ * Usada na classificação do despertar (ver wake_manager.h).
+ */
+bool gps_cache_refresh_due();
+
+/**
+ * @brief Guarda um fix válido na memória RTC, junto com a célula em que foi obtido.
+ */
+void gps_cache_store(const GPS_Data& gps_data, uint32_t cell_id);
+
+/**
+ * @brief Preenche 'gps_data' com o último fix em cache (from_cache = true).
+ * @return true se havia um fix em cache, false caso contrário.
+ */
+bool gps_cache_load(GPS_Data& gps_data);
+
+#endif // GPS_CACHE_H
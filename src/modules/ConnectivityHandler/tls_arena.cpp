@@ -0,0 +1,163 @@
+#include "tls_arena.h"
+#include <mbedtls/platform.h>
+
+// Cada bloco da arena começa com este cabeçalho; 'size' inclui o cabeçalho e
+// é múltiplo de ARENA_ALIGN. Os blocos são contíguos do início ao fim da arena.
+struct ArenaBlock {
+    uint32_t size;
+    uint32_t used;
+};
+
+static const size_t ARENA_ALIGN = 8;
+static const size_t HEADER_SIZE = sizeof(ArenaBlock);
+static const size_t MIN_BLOCK_SIZE = HEADER_SIZE + ARENA_ALIGN;
+
+static uint8_t* g_arena = nullptr;
+static size_t g_capacity = 0;
+static TLS_ArenaStats g_stats = {};
+
+#if defined(MBEDTLS_PLATFORM_MEMORY) && !defined(MBEDTLS_PLATFORM_CALLOC_MACRO)
+#define TLS_ARENA_SUPPORTED 1
+#else
+#define TLS_ARENA_SUPPORTED 0
+#endif
+
+static size_t align_up(size_t n) {
+    return (n + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+static ArenaBlock* block_at(size_t offset) {
+    return (ArenaBlock*)(g_arena + offset);
+}
+
+/**
+ * @brief (Função Privada) Junta ao bloco livre em 'offset' os blocos livres seguintes.
+ */
+static void coalesce(size_t offset) {
+    ArenaBlock* block = block_at(offset);
+    size_t next = offset + block->size;
+    while (next < g_capacity && !block_at(next)->used) {
+        block->size += block_at(next)->size;
+        next = offset + block->size;
+    }
+}
+
+static bool in_arena(const void* ptr) {
+    return g_arena != nullptr && (const uint8_t*)ptr >= g_arena && (const uint8_t*)ptr < g_arena + g_capacity;
+}
+
+/**
+ * @brief (Função Privada) First-fit com divisão do bloco e junção preguiçosa dos livres.
+ */
+static void* arena_alloc(size_t bytes) {
+    size_t need = align_up(bytes) + HEADER_SIZE;
+    for (size_t offset = 0; offset < g_capacity; offset += block_at(offset)->size) {
+        ArenaBlock* block = block_at(offset);
+        if (block->used) {
+            continue;
+        }
+        coalesce(offset);
+        if (block->size < need) {
+            continue;
+        }
+        if (block->size - need >= MIN_BLOCK_SIZE) {
+            ArenaBlock* rest = block_at(offset + need);
+            rest->size = block->size - need;
+            rest->used = 0;
+            block->size = need;
+        }
+        block->used = 1;
+        g_stats.in_use += block->size;
+        if (g_stats.in_use > g_stats.peak) {
+            g_stats.peak = g_stats.in_use;
+        }
+        return (uint8_t*)block + HEADER_SIZE;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief (Função Privada) calloc do mbedTLS: arena primeiro, heap como último recurso.
+ */
+static void* arena_calloc(size_t n, size_t size) {
+    if (n != 0 && size > SIZE_MAX / n) {
+        return nullptr;
+    }
+    size_t bytes = n * size;
+    void* ptr = arena_alloc(bytes);
+    if (ptr != nullptr) {
+        memset(ptr, 0, bytes);
+        return ptr;
+    }
+
+    ptr = calloc(n, size);
+    if (ptr != nullptr) {
+        if (g_stats.heap_fallbacks < UINT16_MAX) g_stats.heap_fallbacks++;
+    } else {
+        if (g_stats.failures < UINT16_MAX) g_stats.failures++;
+    }
+    return ptr;
+}
+
+static void arena_free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (!in_arena(ptr)) {
+        free(ptr);
+        return;
+    }
+    ArenaBlock* block = (ArenaBlock*)((uint8_t*)ptr - HEADER_SIZE);
+    block->used = 0;
+    g_stats.in_use -= block->size;
+}
+
+bool tls_arena_init(size_t size) {
+#if TLS_ARENA_SUPPORTED
+    if (g_arena != nullptr) {
+        return true;
+    }
+    size = align_up(size);
+    g_arena = (uint8_t*)malloc(size);
+    if (g_arena == nullptr || size < MIN_BLOCK_SIZE) {
+        Serial.printf("TlsArena: AVISO - Não foi possível reservar %u bytes. Usando o heap.\n", (unsigned)size);
+        free(g_arena);
+        g_arena = nullptr;
+        return false;
+    }
+    g_capacity = size;
+    block_at(0)->size = (uint32_t)size;
+    block_at(0)->used = 0;
+    g_stats = {};
+
+    mbedtls_platform_set_calloc_free(arena_calloc, arena_free);
+    Serial.printf("TlsArena: %u bytes reservados para o mbedTLS.\n", (unsigned)size);
+    return true;
+#else
+    (void)size;
+    Serial.println("TlsArena: AVISO - mbedTLS sem MBEDTLS_PLATFORM_MEMORY. Usando o heap.");
+    return false;
+#endif
+}
+
+TLS_ArenaStats tls_arena_stats() {
+    TLS_ArenaStats stats = g_stats;
+    stats.capacity = (uint32_t)g_capacity;
+    stats.largest_free = 0;
+    for (size_t offset = 0; offset < g_capacity; offset += block_at(offset)->size) {
+        if (!block_at(offset)->used) {
+            coalesce(offset);
+            uint32_t usable = block_at(offset)->size - HEADER_SIZE;
+            if (usable > stats.largest_free) {
+                stats.largest_free = usable;
+            }
+        }
+    }
+    return stats;
+}
+
+void tls_arena_reset_peak() {
+    g_stats.peak = g_stats.in_use;
+    g_stats.heap_fallbacks = 0;
+    g_stats.failures = 0;
+}
@@ -0,0 +1,46 @@
+#ifndef TLS_ARENA_H
+#define TLS_ARENA_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Tamanho da arena do mbedTLS, reservada de uma vez no boot (antes dos
+// sensores e do modem fragmentarem o heap). Cobre os buffers de registro
+// (MBEDTLS_SSL_IN/OUT_CONTENT_LEN), os certificados e a chave analisados e
+// os temporários do handshake completo.
+#ifndef TLS_ARENA_SIZE
+#define TLS_ARENA_SIZE (48 * 1024)
+#endif
+
+// Estatísticas da arena (desde o último tls_arena_reset_peak())
+struct TLS_ArenaStats {
+    uint32_t capacity;        // Bytes reservados (0 se a arena não está ativa)
+    uint32_t in_use;          // Bytes em uso agora (inclui cabeçalhos dos blocos)
+    uint32_t peak;            // Maior uso observado
+    uint32_t largest_free;    // Maior bloco livre contíguo
+    uint16_t heap_fallbacks;  // Alocações que não couberam e foram para o heap
+    uint16_t failures;        // Alocações que falharam também no heap
+};
+
+/**
+ * @brief Reserva a arena e passa a servir todas as alocações do mbedTLS por ela.
+ *
+ * Deve ser chamada cedo no setup() dos despertares de upload. Se a arena
+ * esgotar, a alocação cai no heap comum (contada em heap_fallbacks).
+ *
+ * @param size Tamanho da arena em bytes.
+ * @return true se a arena foi reservada e instalada (ou já estava ativa).
+ */
+bool tls_arena_init(size_t size = TLS_ARENA_SIZE);
+
+/**
+ * @brief Estatísticas atuais da arena.
+ */
+TLS_ArenaStats tls_arena_stats();
+
+/**
+ * @brief Reinicia o pico (ex: antes de cada handshake) e os contadores de fallback.
+ */
+void tls_arena_reset_peak();
+
+#endif // TLS_ARENA_H
@@ -0,0 +1,491 @@
+#include "tls_client.h"
+#include "tls_arena.h"
+#include "modules/Diagnostics/diagnostics.h"
+#include <mbedtls/error.h>
+#include <mbedtls/version.h>
+#include <time.h>
+
+// ===================================================================
+// --- Cache de sessão e métricas (memória RTC) ---
+// Sobrevivem ao deep sleep; são zerados apenas em um boot "frio".
+// ===================================================================
+
+RTC_DATA_ATTR static uint8_t g_session_blob[TLS_SESSION_CACHE_SIZE];
+RTC_DATA_ATTR static uint16_t g_session_len = 0;
+RTC_DATA_ATTR static uint32_t g_session_saved_epoch = 0;
+RTC_DATA_ATTR static TLS_Metrics g_tls_metrics = {0, false, 0, 0, 0, 0, 0};
+
+static const char* TLS_PERS = "pollution_monitor_tls";
+
+/**
+ * @brief (Função Privada) Loga um erro do mbedTLS com a descrição textual.
+ */
+static void log_mbedtls_error(const char* what, int ret) {
+    char error_buf[100];
+    mbedtls_strerror(ret, error_buf, sizeof(error_buf));
+    Serial.printf("TlsClient: %s falhou: -0x%04X (%s)\n", what, (unsigned)-ret, error_buf);
+}
+
+/**
+ * @brief (Função Privada) Indica se há uma sessão em cache ainda utilizável.
+ */
+static bool session_cache_valid() {
+    if (g_session_len == 0) {
+        return false;
+    }
+    time_t now = time(NULL);
+    // Sem relógio confiável (antes do primeiro NTP) a idade não é verificável
+    if (now > (time_t)g_session_saved_epoch &&
+        (uint32_t)(now - g_session_saved_epoch) > TLS_SESSION_MAX_AGE_S) {
+        Serial.println("TlsClient: Sessão em cache expirada. Descartando.");
+        g_session_len = 0;
+        return false;
+    }
+    return true;
+}
+
+const TLS_Metrics& tls_client_metrics() {
+    return g_tls_metrics;
+}
+
+void tls_client_forget_session() {
+    g_session_len = 0;
+    g_session_saved_epoch = 0;
+}
+
+// ===================================================================
+// --- Callbacks do mbedTLS ---
+// ===================================================================
+
+int TlsClient::bio_send(void* ctx, const unsigned char* buf, size_t len) {
+    Client* transport = static_cast<Client*>(ctx);
+    if (!transport->connected()) {
+        return MBEDTLS_ERR_SSL_CONN_EOF;
+    }
+    size_t written = transport->write(buf, len);
+    if (written == 0) {
+        return MBEDTLS_ERR_SSL_WANT_WRITE;
+    }
+    return (int)written;
+}
+
+int TlsClient::bio_recv(void* ctx, unsigned char* buf, size_t len) {
+    Client* transport = static_cast<Client*>(ctx);
+    if (!transport->available()) {
+        return transport->connected() ? MBEDTLS_ERR_SSL_WANT_READ : MBEDTLS_ERR_SSL_CONN_EOF;
+    }
+    int n = transport->read(buf, len);
+    if (n <= 0) {
+        return MBEDTLS_ERR_SSL_WANT_READ;
+    }
+    return n;
+}
+
+int TlsClient::verify_callback(void* ctx, mbedtls_x509_crt* crt, int depth, uint32_t* flags) {
+    (void)crt;
+    (void)depth;
+    (void)flags;
+    // Só é chamado quando o servidor envia o certificado, ou seja,
+    // em um handshake completo. Numa retomada ele não é chamado.
+    static_cast<TlsClient*>(ctx)->_peer_cert_seen = true;
+    return 0;
+}
+
+// ===================================================================
+// --- Implementação da classe ---
+// ===================================================================
+
+TlsClient::TlsClient(Client* transport) : _transport(transport) {
+}
+
+TlsClient::~TlsClient() {
+    free_context();
+}
+
+void TlsClient::setCACert(const char* root_ca) {
+    _root_ca = root_ca;
+}
+
+void TlsClient::setCertificate(const char* client_cert) {
+    _client_cert = client_cert;
+}
+
+void TlsClient::setPrivateKey(const char* private_key) {
+    _private_key = private_key;
+}
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+/**
+ * @brief (Função Privada) Código mbedTLS para TLS_MAX_FRAGMENT_LENGTH.
+ */
+static unsigned char max_fragment_length_code() {
+    switch (TLS_MAX_FRAGMENT_LENGTH) {
+        case 512:  return MBEDTLS_SSL_MAX_FRAG_LEN_512;
+        case 1024: return MBEDTLS_SSL_MAX_FRAG_LEN_1024;
+        case 2048: return MBEDTLS_SSL_MAX_FRAG_LEN_2048;
+        case 4096: return MBEDTLS_SSL_MAX_FRAG_LEN_4096;
+        default:   return MBEDTLS_SSL_MAX_FRAG_LEN_NONE;
+    }
+}
+#endif
+
+/**
+ * @brief Prepara os contextos mbedTLS (RNG, certificados, configuração).
+ */
+bool TlsClient::setup_context(const char* host) {
+    int ret;
+
+    mbedtls_ssl_init(&_ssl);
+    mbedtls_ssl_config_init(&_conf);
+    mbedtls_ctr_drbg_init(&_drbg);
+    mbedtls_entropy_init(&_entropy);
+    mbedtls_x509_crt_init(&_ca_crt);
+    mbedtls_x509_crt_init(&_client_crt);
+    mbedtls_pk_init(&_client_key);
+    _context_ready = true;
+
+    ret = mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy,
+                                (const unsigned char*)TLS_PERS, strlen(TLS_PERS));
+    if (ret != 0) {
+        log_mbedtls_error("mbedtls_ctr_drbg_seed", ret);
+        return false;
+    }
+
+    if (_root_ca == nullptr || _client_cert == nullptr || _private_key == nullptr) {
+        Serial.println("TlsClient: ERRO - Certificados não configurados.");
+        return false;
+    }
+
+    // Os PEMs são strings: o tamanho deve incluir o '\0' final
+    ret = mbedtls_x509_crt_parse(&_ca_crt, (const unsigned char*)_root_ca, strlen(_root_ca) + 1);
+    if (ret != 0) {
+        log_mbedtls_error("Parse do CA", ret);
+        return false;
+    }
+    ret = mbedtls_x509_crt_parse(&_client_crt, (const unsigned char*)_client_cert, strlen(_client_cert) + 1);
+    if (ret != 0) {
+        log_mbedtls_error("Parse do certificado", ret);
+        return false;
+    }
+#if MBEDTLS_VERSION_MAJOR >= 3
+    ret = mbedtls_pk_parse_key(&_client_key, (const unsigned char*)_private_key, strlen(_private_key) + 1,
+                               NULL, 0, mbedtls_ctr_drbg_random, &_drbg);
+#else
+    ret = mbedtls_pk_parse_key(&_client_key, (const unsigned char*)_private_key, strlen(_private_key) + 1,
+                               NULL, 0);
+#endif
+    if (ret != 0) {
+        log_mbedtls_error("Parse da chave privada", ret);
+        return false;
+    }
+
+    ret = mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_CLIENT,
+                                      MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    if (ret != 0) {
+        log_mbedtls_error("mbedtls_ssl_config_defaults", ret);
+        return false;
+    }
+
+    mbedtls_ssl_conf_authmode(&_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    mbedtls_ssl_conf_ca_chain(&_conf, &_ca_crt, NULL);
+    mbedtls_ssl_conf_verify(&_conf, verify_callback, this);
+    mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_drbg);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    mbedtls_ssl_conf_session_tickets(&_conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#endif
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    if (max_fragment_length_code() != MBEDTLS_SSL_MAX_FRAG_LEN_NONE) {
+        ret = mbedtls_ssl_conf_max_frag_len(&_conf, max_fragment_length_code());
+        if (ret != 0) {
+            log_mbedtls_error("mbedtls_ssl_conf_max_frag_len", ret);
+        }
+    }
+#endif
+
+    ret = mbedtls_ssl_conf_own_cert(&_conf, &_client_crt, &_client_key);
+    if (ret != 0) {
+        log_mbedtls_error("mbedtls_ssl_conf_own_cert", ret);
+        return false;
+    }
+
+    ret = mbedtls_ssl_setup(&_ssl, &_conf);
+    if (ret != 0) {
+        log_mbedtls_error("mbedtls_ssl_setup", ret);
+        return false;
+    }
+
+    ret = mbedtls_ssl_set_hostname(&_ssl, host);
+    if (ret != 0) {
+        log_mbedtls_error("mbedtls_ssl_set_hostname", ret);
+        return false;
+    }
+
+    mbedtls_ssl_set_bio(&_ssl, _transport, bio_send, bio_recv, NULL);
+    return true;
+}
+
+void TlsClient::free_context() {
+    if (!_context_ready) {
+        return;
+    }
+    mbedtls_ssl_free(&_ssl);
+    mbedtls_ssl_config_free(&_conf);
+    mbedtls_ctr_drbg_free(&_drbg);
+    mbedtls_entropy_free(&_entropy);
+    mbedtls_x509_crt_free(&_ca_crt);
+    mbedtls_x509_crt_free(&_client_crt);
+    mbedtls_pk_free(&_client_key);
+    _context_ready = false;
+}
+
+/**
+ * @brief Executa o handshake, oferecendo a sessão em cache se solicitado.
+ * @return 0 em caso de sucesso, código de erro mbedTLS caso contrário.
+ */
+int TlsClient::handshake(bool offer_session) {
+    bool offered = false;
+
+    if (offer_session) {
+        mbedtls_ssl_session cached;
+        mbedtls_ssl_session_init(&cached);
+        int ret = mbedtls_ssl_session_load(&cached, g_session_blob, g_session_len);
+        if (ret == 0) {
+            ret = mbedtls_ssl_set_session(&_ssl, &cached);
+        }
+        mbedtls_ssl_session_free(&cached);
+
+        if (ret == 0) {
+            offered = true;
+            Serial.println("TlsClient: Oferecendo sessão em cache (retomada).");
+        } else {
+            log_mbedtls_error("Carregar sessão em cache", ret);
+            tls_client_forget_session();
+        }
+    }
+
+    _peer_cert_seen = false;
+    unsigned long start = millis();
+    int ret;
+
+    while ((ret = mbedtls_ssl_handshake(&_ssl)) != 0) {
+        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            return ret;
+        }
+        if (millis() - start > TLS_HANDSHAKE_TIMEOUT_MS) {
+            return MBEDTLS_ERR_SSL_TIMEOUT;
+        }
+        delay(10);
+    }
+
+    uint32_t elapsed = millis() - start;
+    diag_heap_checkpoint(); // Buffers de registro e contexto ainda alocados
+    bool resumed = offered && !_peer_cert_seen;
+
+    g_tls_metrics.last_handshake_ms = elapsed;
+    g_tls_metrics.last_resumed = resumed;
+    g_tls_metrics.handshakes++;
+    if (offered) {
+        g_tls_metrics.resumption_offers++;
+        if (resumed) {
+            g_tls_metrics.resumption_hits++;
+        }
+    }
+
+    Serial.printf("TlsClient: Handshake %s em %lu ms (retomadas: %u/%u).\n",
+                  resumed ? "RETOMADO" : "completo", (unsigned long)elapsed,
+                  g_tls_metrics.resumption_hits, g_tls_metrics.resumption_offers);
+    return 0;
+}
+
+/**
+ * @brief Registra o pico da arena e a fragmentação do heap após o handshake.
+ */
+void TlsClient::report_memory() {
+    TLS_ArenaStats arena = tls_arena_stats();
+    uint32_t free_heap = ESP.getFreeHeap();
+    uint32_t largest = ESP.getMaxAllocHeap();
+
+    g_tls_metrics.arena_peak_bytes = arena.peak;
+    g_tls_metrics.heap_largest_free = largest;
+    if (arena.heap_fallbacks > 0) {
+        diag_count(DIAG_COUNTER_TLS_HEAP_FALLBACKS, arena.heap_fallbacks);
+    }
+
+    Serial.printf("TlsClient: Arena pico %lu/%lu B (em uso %lu B, %u fallback(s) para o heap); "
+                  "heap livre %lu B, maior bloco %lu B (fragmentação %u%%).\n",
+                  (unsigned long)arena.peak, (unsigned long)arena.capacity, (unsigned long)arena.in_use,
+                  arena.heap_fallbacks, (unsigned long)free_heap, (unsigned long)largest,
+                  free_heap > 0 ? (unsigned)(100 - (uint64_t)largest * 100 / free_heap) : 0);
+}
+
+/**
+ * @brief Serializa a sessão atual na memória RTC para o próximo despertar.
+ */
+void TlsClient::save_session() {
+    mbedtls_ssl_session session;
+    mbedtls_ssl_session_init(&session);
+
+    int ret = mbedtls_ssl_get_session(&_ssl, &session);
+    if (ret == 0) {
+        size_t olen = 0;
+        ret = mbedtls_ssl_session_save(&session, g_session_blob, sizeof(g_session_blob), &olen);
+        if (ret == 0) {
+            g_session_len = (uint16_t)olen;
+            g_session_saved_epoch = (uint32_t)time(NULL);
+            Serial.printf("TlsClient: Sessão salva na memória RTC (%u bytes).\n", (unsigned)olen);
+        }
+    }
+    if (ret != 0) {
+        log_mbedtls_error("Salvar sessão", ret);
+        g_session_len = 0;
+    }
+
+    mbedtls_ssl_session_free(&session);
+}
+
+int TlsClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip.toString().c_str(), port);
+}
+
+int TlsClient::connect(const char* host, uint16_t port) {
+    DiagScope diag_scope(DIAG_PHASE_TLS);
+    stop();
+    tls_arena_reset_peak();
+
+    bool offer = TLS_SESSION_RESUMPTION_ENABLED && session_cache_valid();
+
+    // No máximo duas tentativas: com a sessão em cache e, se falhar, sem ela
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (!_transport->connect(host, port)) {
+            Serial.println("TlsClient: Falha na conexão TCP.");
+            return 0;
+        }
+
+        if (!setup_context(host)) {
+            stop();
+            return 0;
+        }
+
+        int ret = handshake(offer);
+        if (ret == 0) {
+            _connected = true;
+            if (TLS_SESSION_RESUMPTION_ENABLED) {
+                save_session();
+            }
+            report_memory();
+            return 1;
+        }
+
+        log_mbedtls_error("Handshake TLS", ret);
+        stop();
+
+        if (!offer) {
+            return 0;
+        }
+        // Retomada rejeitada de forma não recuperável: volta ao handshake completo
+        Serial.println("TlsClient: Descartando a sessão em cache e refazendo o handshake completo.");
+        tls_client_forget_session();
+        diag_count(DIAG_COUNTER_TLS_FALLBACKS);
+        offer = false;
+    }
+    return 0;
+}
+
+size_t TlsClient::write(uint8_t b) {
+    return write(&b, 1);
+}
+
+size_t TlsClient::write(const uint8_t* buf, size_t size) {
+    if (!_connected) {
+        return 0;
+    }
+    size_t sent = 0;
+    unsigned long start = millis();
+    while (sent < size) {
+        int ret = mbedtls_ssl_write(&_ssl, buf + sent, size - sent);
+        if (ret > 0) {
+            sent += ret;
+        } else if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+            if (millis() - start > TLS_HANDSHAKE_TIMEOUT_MS) {
+                break;
+            }
+            delay(1);
+        } else {
+            log_mbedtls_error("mbedtls_ssl_write", ret);
+            stop();
+            break;
+        }
+    }
+    return sent;
+}
+
+int TlsClient::available() {
+    if (!_connected) {
+        return 0;
+    }
+    // Processa registros pendentes no transporte sem consumir dados da aplicação
+    int ret = mbedtls_ssl_read(&_ssl, NULL, 0);
+    if (ret < 0 && ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+        if (ret != MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY) {
+            log_mbedtls_error("mbedtls_ssl_read", ret);
+        }
+        stop();
+        return 0;
+    }
+    return (int)mbedtls_ssl_get_bytes_avail(&_ssl) + (_peek >= 0 ? 1 : 0);
+}
+
+int TlsClient::read() {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int TlsClient::read(uint8_t* buf, size_t size) {
+    if (!_connected || size == 0) {
+        return -1;
+    }
+    size_t offset = 0;
+    if (_peek >= 0) {
+        buf[offset++] = (uint8_t)_peek;
+        _peek = -1;
+        if (offset == size) {
+            return (int)offset;
+        }
+    }
+    int ret = mbedtls_ssl_read(&_ssl, buf + offset, size - offset);
+    if (ret > 0) {
+        return (int)offset + ret;
+    }
+    if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE && ret != 0) {
+        stop();
+    }
+    return offset > 0 ? (int)offset : -1;
+}
+
+int TlsClient::peek() {
+    if (_peek < 0 && available() > 0) {
+        _peek = read();
+    }
+    return _peek;
+}
+
+void TlsClient::flush() {
+    _transport->flush();
+}
+
+void TlsClient::stop() {
+    if (_connected) {
+        mbedtls_ssl_close_notify(&_ssl);
+    }
+    _connected = false;
+    _peek = -1;
+    _transport->stop();
+    free_context(); // Devolve ao heap a memória do handshake e dos certificados
+}
+
+uint8_t TlsClient::connected() {
+    if (!_connected) {
+        return 0;
+    }
+    return _transport->connected() || mbedtls_ssl_get_bytes_avail(&_ssl) > 0;
+}
@@ -0,0 +1,124 @@
+#ifndef TLS_CLIENT_H
+#define TLS_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+#include "config.h"
+
+#include <mbedtls/ssl.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/x509_crt.h>
+#include <mbedtls/pk.h>
+
+// Retomada de sessão TLS (session ID / session ticket) entre despertares.
+#ifndef TLS_SESSION_RESUMPTION_ENABLED
+#define TLS_SESSION_RESUMPTION_ENABLED 1
+#endif
+
+// Espaço na memória RTC para a sessão serializada. Com o certificado do
+// servidor mantido na sessão (padrão do ESP-IDF), ~1.5 KB são necessários.
+#ifndef TLS_SESSION_CACHE_SIZE
+#define TLS_SESSION_CACHE_SIZE 2048
+#endif
+
+// Idade máxima de uma sessão em cache antes de ser descartada.
+#ifndef TLS_SESSION_MAX_AGE_S
+#define TLS_SESSION_MAX_AGE_S (24UL * 3600UL)
+#endif
+
+// Max Fragment Length (RFC 6066) pedido ao servidor: 512, 1024, 2048 ou 4096
+// bytes; 0 não pede. O servidor pode ignorar o pedido (registros de até 16 KB).
+#ifndef TLS_MAX_FRAGMENT_LENGTH
+#define TLS_MAX_FRAGMENT_LENGTH 4096
+#endif
+
+#ifndef TLS_HANDSHAKE_TIMEOUT_MS
+#define TLS_HANDSHAKE_TIMEOUT_MS 30000UL
+#endif
+
+// Métricas do handshake TLS (acumuladas na memória RTC entre despertares)
+struct TLS_Metrics {
+    uint32_t last_handshake_ms;   // Duração do último handshake
+    bool last_resumed;            // O último handshake foi uma retomada?
+    uint16_t handshakes;          // Handshakes concluídos
+    uint16_t resumption_offers;   // Handshakes em que uma sessão foi oferecida
+    uint16_t resumption_hits;     // Ofertas aceitas pelo servidor
+    uint32_t arena_peak_bytes;    // Pico de uso da arena do mbedTLS na última conexão
+    uint32_t heap_largest_free;   // Maior bloco livre do heap ao fim da última conexão
+};
+
+/**
+ * @brief Cliente TLS (mbedTLS) sobre um Client de transporte (ex: TinyGsmClient).
+ *
+ * Substitui o SSLClientESP32 para poder oferecer, ANTES do handshake, a sessão
+ * guardada na memória RTC no despertar anterior (o SSLClientESP32 executa o
+ * setup e o handshake numa única chamada, sem ponto de extensão entre eles).
+ *
+ * Se o servidor recusar a retomada, o mbedTLS segue automaticamente com o
+ * handshake completo. Se o handshake falhar com uma sessão oferecida, o cache
+ * é descartado e uma nova tentativa é feita sem ela.
+ */
+class TlsClient : public Client {
+public:
+    explicit TlsClient(Client* transport);
+    ~TlsClient();
+
+    void setCACert(const char* root_ca);
+    void setCertificate(const char* client_cert);
+    void setPrivateKey(const char* private_key);
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t b) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buf, size_t size) override;
+    int peek() override;
+    void flush() override;
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected(); }
+
+private:
+    bool setup_context(const char* host);
+    void free_context();
+    int handshake(bool offer_session);
+    void save_session();
+    void report_memory();
+
+    static int bio_send(void* ctx, const unsigned char* buf, size_t len);
+    static int bio_recv(void* ctx, unsigned char* buf, size_t len);
+    static int verify_callback(void* ctx, mbedtls_x509_crt* crt, int depth, uint32_t* flags);
+
+    Client* _transport;
+    const char* _root_ca = nullptr;
+    const char* _client_cert = nullptr;
+    const char* _private_key = nullptr;
+
+    mbedtls_ssl_context _ssl;
+    mbedtls_ssl_config _conf;
+    mbedtls_ctr_drbg_context _drbg;
+    mbedtls_entropy_context _entropy;
+    mbedtls_x509_crt _ca_crt;
+    mbedtls_x509_crt _client_crt;
+    mbedtls_pk_context _client_key;
+
+    bool _context_ready = false;
+    bool _connected = false;
+    bool _peer_cert_seen = false; // Certificado recebido => handshake completo
+    int _peek = -1;
+};
+
+/**
+ * @brief Retorna as métricas de handshake TLS (duração e taxa de retomada).
+ */
+const TLS_Metrics& tls_client_metrics();
+
+/**
+ * @brief Descarta a sessão TLS guardada na memória RTC.
+ */
+void tls_client_forget_session();
+
+#endif // TLS_CLIENT_H
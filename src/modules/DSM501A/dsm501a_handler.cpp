@@ -1,5 +1,171 @@
 #include "dsm501a_handler.h"
 
+#if DSM501A_CAPTURE_BACKEND == DSM501A_CAPTURE_MCPWM
+#include "driver/mcpwm.h"
+#include "hal/mcpwm_ll.h"
+#elif DSM501A_CAPTURE_BACKEND != DSM501A_CAPTURE_GPIO_ISR
+#error "DSM501A_CAPTURE_BACKEND desconhecido"
+#endif
+
+// ===================================================================
+// --- Janela de amostragem ---
+// g_window é escrita pelos callbacks de captura enquanto a janela está
+// aberta e só é lida pela tarefa depois de capture_stop().
+// ===================================================================
+
+static DSM501A_Window g_window = {};
+static bool g_window_open = false;
+static unsigned long g_window_start_ms = 0;
+static unsigned long g_window_duration_ms = 0;
+
+/**
+ * @brief (Função Privada) Acumula um pulso LOW completo nas estatísticas da saída.
+ * Chamada em contexto de interrupção.
+ *
+ * @param width_us Largura do pulso.
+ * @param end_offset Fim do pulso em us desde o início da janela (só posiciona o pulso na série por segundo).
+ */
+static void IRAM_ATTR account_pulse(DSM501A_Channel& channel, uint32_t width_us, uint32_t end_offset) {
+    channel.total_low_us += width_us;
+    channel.pulses++;
+
+    uint32_t bin = width_us / (DSM501A_HIST_BIN_MS * 1000UL);
+    if (bin >= DSM501A_HIST_BINS) {
+        bin = DSM501A_HIST_BINS - 1;
+    }
+    if (channel.width_hist[bin] < UINT16_MAX) {
+        channel.width_hist[bin]++;
+    }
+
+    // Distribui a duração pelos segundos da janela que o pulso cobriu
+    uint32_t offset = (width_us < end_offset) ? end_offset - width_us : 0;
+    while (offset < end_offset) {
+        uint32_t second = offset / 1000000UL;
+        if (second >= DSM501A_SERIES_MAX_S) {
+            break;
+        }
+        uint32_t second_end = (second + 1) * 1000000UL;
+        uint32_t chunk_end = (end_offset < second_end) ? end_offset : second_end;
+        channel.low_us_per_s[second] += chunk_end - offset;
+        offset = chunk_end;
+    }
+}
+
+#if DSM501A_CAPTURE_BACKEND == DSM501A_CAPTURE_MCPWM
+
+// ===================================================================
+// --- Captura por hardware (MCPWM) ---
+// O periférico trava o contador de 80 MHz na borda e só depois chama o
+// callback: a duração medida não depende de quando a CPU atende.
+// ===================================================================
+
+// Pulsos do contador de captura por microssegundo (clock APB)
+#define CAPTURE_TICKS_PER_US 80
+
+// Estado de uma saída do sensor. Escrito só pelo callback da captura.
+struct DsmCapture {
+    volatile uint32_t low_start_ticks;
+    volatile bool in_low;
+    DSM501A_Channel* stats;
+};
+
+static DsmCapture g_capture_pm25 = {};
+static DsmCapture g_capture_pm10 = {};
+
+// Contador de captura no início da janela (captura por software no CAP2, sem pino)
+static uint32_t g_window_start_ticks = 0;
+// Última borda (em pulsos desde o início da janela) e voltas do contador desde então
+static volatile uint32_t g_last_edge_ticks = 0;
+static volatile uint32_t g_counter_wraps = 0;
+
+// Bordas das duas saídas atendidas na mesma interrupção podem chegar fora de ordem
+#define CAPTURE_REORDER_TICKS (CAPTURE_TICKS_PER_US * 1000000UL)
+
+/**
+ * @brief (Função Privada) Converte o contador travado numa borda em us desde o início da janela.
+ * Chamada em cada borda: uma borda bem "antes" da anterior indica que o contador deu a
+ * volta. Só falha se nenhuma das saídas mudar por mais de ~52 s.
+ */
+static uint32_t IRAM_ATTR window_offset_us(uint32_t cap_value) {
+    uint32_t ticks = cap_value - g_window_start_ticks;
+    if (ticks < g_last_edge_ticks) {
+        if (g_last_edge_ticks - ticks > CAPTURE_REORDER_TICKS) {
+            g_counter_wraps++;
+            g_last_edge_ticks = ticks;
+        }
+    } else {
+        g_last_edge_ticks = ticks;
+    }
+    return (uint32_t)((((uint64_t)g_counter_wraps << 32) | ticks) / CAPTURE_TICKS_PER_US);
+}
+
+/**
+ * @brief Callback da captura (contexto de ISR do driver MCPWM), chamado em cada borda.
+ */
+static bool IRAM_ATTR dsm_capture_cb(mcpwm_unit_t /*unit*/, mcpwm_capture_channel_id_t /*channel*/,
+                                     const cap_event_data_t* edata, void* user_data) {
+    DsmCapture* capture = (DsmCapture*)user_data;
+    uint32_t offset_us = window_offset_us(edata->cap_value);
+    if (edata->cap_edge == MCPWM_NEG_EDGE) {
+        // O pulso LOW começou
+        capture->low_start_ticks = edata->cap_value;
+        capture->in_low = true;
+    } else if (capture->in_low) {
+        // O pulso LOW terminou. A subtração sem sinal continua certa quando
+        // o contador de 32 bits dá a volta (~53 s) no meio do pulso.
+        uint32_t width_ticks = edata->cap_value - capture->low_start_ticks;
+        account_pulse(*capture->stats, width_ticks / CAPTURE_TICKS_PER_US, offset_us);
+        capture->in_low = false;
+    }
+    return false; // Nenhuma tarefa de maior prioridade acordada
+}
+
+/**
+ * @brief (Função Privada) Habilita um canal de captura nas duas bordas.
+ */
+static void capture_channel_start(mcpwm_capture_channel_id_t channel, DsmCapture* capture, DSM501A_Channel* stats) {
+    capture->in_low = false;
+    capture->stats = stats;
+    mcpwm_capture_config_t config = {};
+    config.cap_edge = MCPWM_BOTH_EDGE;
+    config.cap_prescale = 1;
+    config.capture_cb = dsm_capture_cb;
+    config.user_data = capture;
+    if (mcpwm_capture_enable_channel((mcpwm_unit_t)DSM501A_MCPWM_UNIT, channel, &config) != ESP_OK) {
+        Serial.printf("DSM501A: ERRO - Falha ao habilitar a captura %d do MCPWM.\n", (int)channel);
+    }
+}
+
+/**
+ * @brief (Função Privada) Começa a medir (g_window já zerada).
+ */
+static void capture_start() {
+    // Trava o contador agora: as bordas são posicionadas na série em relação a ele.
+    // O CAP2 não tem pino nem callback; a captura por software não tem API no driver legado.
+    mcpwm_capture_config_t config = {};
+    config.cap_edge = MCPWM_POS_EDGE;
+    config.cap_prescale = 1;
+    mcpwm_capture_enable_channel((mcpwm_unit_t)DSM501A_MCPWM_UNIT, MCPWM_SELECT_CAP2, &config);
+    mcpwm_ll_trigger_soft_capture(MCPWM_LL_GET_HW(DSM501A_MCPWM_UNIT), MCPWM_SELECT_CAP2);
+    g_window_start_ticks = mcpwm_capture_signal_get_value((mcpwm_unit_t)DSM501A_MCPWM_UNIT, MCPWM_SELECT_CAP2);
+    g_last_edge_ticks = 0;
+    g_counter_wraps = 0;
+
+    capture_channel_start(MCPWM_SELECT_CAP0, &g_capture_pm25, &g_window.pm25);
+    capture_channel_start(MCPWM_SELECT_CAP1, &g_capture_pm10, &g_window.pm10);
+}
+
+/**
+ * @brief (Função Privada) Para de medir.
+ */
+static void capture_stop() {
+    mcpwm_capture_disable_channel((mcpwm_unit_t)DSM501A_MCPWM_UNIT, MCPWM_SELECT_CAP0);
+    mcpwm_capture_disable_channel((mcpwm_unit_t)DSM501A_MCPWM_UNIT, MCPWM_SELECT_CAP1);
+    mcpwm_capture_disable_channel((mcpwm_unit_t)DSM501A_MCPWM_UNIT, MCPWM_SELECT_CAP2);
+}
+
+#else // DSM501A_CAPTURE_GPIO_ISR
+
 // ===================================================================
 // --- Variáveis Globais para as Interrupções (ISR) ---
 // Precisamos de 'volatile' para dizer ao compilador que estas
@@ -8,11 +174,12 @@
 
 // Variáveis para o pino PM2.5
 static volatile unsigned long g_dsm_pm25_low_start_time_us = 0;
-static volatile unsigned long g_dsm_pm25_total_low_time_us = 0;
 
 // Variáveis para o pino PM10
 static volatile unsigned long g_dsm_pm10_low_start_time_us = 0;
-static volatile unsigned long g_dsm_pm10_total_low_time_us = 0;
+
+// micros() no início da janela
+static uint32_t g_window_start_us = 0;
 
 
 // ===================================================================
@@ -37,7 +204,8 @@ void IRAM_ATTR dsm_pm25_isr() {
         // O pulso LOW acabou de terminar.
         // Se já tínhamos um tempo de início, calcule a duração e some ao total.
         if (g_dsm_pm25_low_start_time_us > 0) {
-            g_dsm_pm25_total_low_time_us += (micros() - g_dsm_pm25_low_start_time_us);
+            unsigned long now_us = micros();
+            account_pulse(g_window.pm25, now_us - g_dsm_pm25_low_start_time_us, now_us - g_window_start_us);
             g_dsm_pm25_low_start_time_us = 0; // Reseta para a próxima
         }
     }
@@ -52,12 +220,58 @@ void IRAM_ATTR dsm_pm10_isr() {
         g_dsm_pm10_low_start_time_us = micros();
     } else {
         if (g_dsm_pm10_low_start_time_us > 0) {
-            g_dsm_pm10_total_low_time_us += (micros() - g_dsm_pm10_low_start_time_us);
+            unsigned long now_us = micros();
+            account_pulse(g_window.pm10, now_us - g_dsm_pm10_low_start_time_us, now_us - g_window_start_us);
             g_dsm_pm10_low_start_time_us = 0;
         }
     }
 }
 
+/**
+ * @brief (Função Privada) Anexa as interrupções (g_window já zerada).
+ */
+static void capture_start() {
+    g_dsm_pm25_low_start_time_us = 0;
+    g_dsm_pm10_low_start_time_us = 0;
+    g_window_start_us = micros();
+
+    // digitalPinToInterrupt() é a forma correta de mapear GPIO 19 -> ID da Interrupção
+    // CHANGE = Dispara a ISR em CADA mudança (subida ou descida)
+    attachInterrupt(digitalPinToInterrupt(DSM501A_PM25_PIN), dsm_pm25_isr, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(DSM501A_PM10_PIN), dsm_pm10_isr, CHANGE);
+}
+
+/**
+ * @brief (Função Privada) Desanexa as interrupções.
+ */
+static void capture_stop() {
+    detachInterrupt(digitalPinToInterrupt(DSM501A_PM25_PIN));
+    detachInterrupt(digitalPinToInterrupt(DSM501A_PM10_PIN));
+}
+
+#endif // DSM501A_CAPTURE_BACKEND
+
+/**
+ * @brief (Função Privada) Registra na Serial o total, a série por segundo e o histograma de uma saída.
+ */
+static void log_channel(const char* name, const DSM501A_Channel& channel, float lop_ratio) {
+    Serial.printf("DSM501A: %s Tempo total em BAIXO: %lu us (%lu pulsos)\n", name,
+                  (unsigned long)channel.total_low_us, (unsigned long)channel.pulses);
+    Serial.printf("DSM501A: %s LOP Ratio: %.2f %%\n", name, lop_ratio);
+
+    Serial.printf("DSM501A: %s LOP por segundo (%%):", name);
+    for (uint16_t s = 0; s < g_window.seconds; s++) {
+        Serial.printf(" %.1f", channel.low_us_per_s[s] / 10000.0f);
+    }
+    Serial.println();
+
+    Serial.printf("DSM501A: %s Larguras (faixas de %d ms):", name, DSM501A_HIST_BIN_MS);
+    for (int i = 0; i < DSM501A_HIST_BINS; i++) {
+        Serial.printf(" %u", channel.width_hist[i]);
+    }
+    Serial.println();
+}
+
 
 // ===================================================================
 // --- Funções Públicas ---
@@ -74,66 +288,92 @@ void dsm501a_init() {
     
     Serial.printf("DSM501A: Pino PM2.5 (GPIO %d) configurado como ENTRADA.\n", DSM501A_PM25_PIN);
     Serial.printf("DSM501A: Pino PM10 (GPIO %d) configurado como ENTRADA.\n", DSM501A_PM10_PIN);
+#if DSM501A_CAPTURE_BACKEND == DSM501A_CAPTURE_MCPWM
+    // Roteia os pinos (pela matriz de GPIO) para as entradas de captura
+    mcpwm_gpio_init((mcpwm_unit_t)DSM501A_MCPWM_UNIT, MCPWM_CAP_0, DSM501A_PM25_PIN);
+    mcpwm_gpio_init((mcpwm_unit_t)DSM501A_MCPWM_UNIT, MCPWM_CAP_1, DSM501A_PM10_PIN);
+    Serial.println("DSM501A: Handler (captura MCPWM) inicializado.");
+#else
     Serial.println("DSM501A: Handler (Interrupt-based) inicializado.");
+#endif
     Serial.println("DSM501A: AVISO - Sensor requer 1 minuto de aquecimento (warm-up) após ligar.");
 }
 
-/**
- * @brief Realiza a leitura dos dados do sensor DSM501A usando interrupções.
- */
-bool dsm501a_read_data(DSM501A_Data &data, unsigned long sample_time_ms) {
-    data.isValid = false; 
-
+bool dsm501a_window_start(unsigned long sample_time_ms) {
     // O datasheet do DSM501A recomenda 30 segundos de amostragem.
-    if (sample_time_ms < 10000) { // Mínimo de 10s
+    if (sample_time_ms < DSM501A_MIN_SAMPLE_TIME_MS) {
         Serial.printf("DSM501A: AVISO - Tempo de amostragem (%lu ms) é muito baixo. Recomendado: 30000 ms.\n", sample_time_ms);
     }
     if (sample_time_ms == 0) return false;
 
-    Serial.printf("DSM501A: Iniciando amostragem por %lu ms (usando interrupções)...\n", sample_time_ms);
-
-    // 1. Zera os contadores globais
-    g_dsm_pm25_total_low_time_us = 0;
-    g_dsm_pm25_low_start_time_us = 0;
-    g_dsm_pm10_total_low_time_us = 0;
-    g_dsm_pm10_low_start_time_us = 0;
-
-    // 2. Anexa as interrupções (liga os "ouvidos")
-    //    digitalPinToInterrupt() é a forma correta de mapear GPIO 19 -> ID da Interrupção
-    //    CHANGE = Dispara a ISR em CADA mudança (subida ou descida)
-    attachInterrupt(digitalPinToInterrupt(DSM501A_PM25_PIN), dsm_pm25_isr, CHANGE);
-    attachInterrupt(digitalPinToInterrupt(DSM501A_PM10_PIN), dsm_pm10_isr, CHANGE);
+    if (g_window_open) {
+        capture_stop();
+    }
+    memset(&g_window, 0, sizeof(g_window));
+    g_window_duration_ms = sample_time_ms;
+    g_window_start_ms = millis();
+    g_window_open = true;
+    capture_start();
 
-    // 3. Dorme (bloqueia) pelo tempo de amostragem
-    //    Enquanto o 'delay' roda, as ISRs 'dsm_pm25_isr' e 'dsm_pm10_isr'
-    //    estão rodando em segundo plano, contando os pulsos.
-    delay(sample_time_ms);
+    Serial.printf("DSM501A: Janela de %lu ms iniciada (em segundo plano).\n", sample_time_ms);
+    return true;
+}
 
-    // 4. Desanexa as interrupções (desliga os "ouvidos")
-    detachInterrupt(digitalPinToInterrupt(DSM501A_PM25_PIN));
-    detachInterrupt(digitalPinToInterrupt(DSM501A_PM10_PIN));
+bool dsm501a_window_poll() {
+    return !g_window_open || (millis() - g_window_start_ms) >= g_window_duration_ms;
+}
 
-    Serial.println("DSM501A: Amostragem concluída. Calculando LOP Ratio...");
+bool dsm501a_window_finish(DSM501A_Data &data) {
+    data.isValid = false;
+    data.low_pulse_occupancy_ratio_pm25 = 0.0f;
+    data.low_pulse_occupancy_ratio_pm10 = 0.0f;
+    if (!g_window_open) {
+        Serial.println("DSM501A: ERRO - Nenhuma janela de amostragem aberta.");
+        return false;
+    }
 
-    // 5. Calcula os resultados
-    float sample_time_us = (float)(sample_time_ms * 1000.0f);
+    capture_stop();
+    g_window_open = false;
+    g_window.elapsed_ms = millis() - g_window_start_ms;
+    uint32_t full_seconds = g_window.elapsed_ms / 1000UL;
+    g_window.seconds = (uint16_t)((full_seconds < DSM501A_SERIES_MAX_S) ? full_seconds : DSM501A_SERIES_MAX_S);
 
-    // PM2.5
-    data.low_pulse_occupancy_ratio_pm25 = ((float)g_dsm_pm25_total_low_time_us / sample_time_us) * 100.0f;
-    Serial.printf("DSM501A: PM2.5 Tempo total em BAIXO: %lu us\n", (unsigned long)g_dsm_pm25_total_low_time_us);
-    Serial.printf("DSM501A: PM2.5 LOP Ratio: %.2f %%\n", data.low_pulse_occupancy_ratio_pm25);
+    Serial.printf("DSM501A: Amostragem concluída (%lu ms). Calculando LOP Ratio...\n", (unsigned long)g_window.elapsed_ms);
+    if (g_window.elapsed_ms == 0) {
+        return true;
+    }
 
-    // PM10
-    data.low_pulse_occupancy_ratio_pm10 = ((float)g_dsm_pm10_total_low_time_us / sample_time_us) * 100.0f;
-    Serial.printf("DSM501A: PM10 Tempo total em BAIXO: %lu us\n", (unsigned long)g_dsm_pm10_total_low_time_us);
-    Serial.printf("DSM501A: PM10 LOP Ratio: %.2f %%\n", data.low_pulse_occupancy_ratio_pm10);
+    // LOP sobre a duração real: a janela pode ter sido encerrada depois do previsto
+    float sample_time_us = (float)g_window.elapsed_ms * 1000.0f;
+    data.low_pulse_occupancy_ratio_pm25 = ((float)g_window.pm25.total_low_us / sample_time_us) * 100.0f;
+    data.low_pulse_occupancy_ratio_pm10 = ((float)g_window.pm10.total_low_us / sample_time_us) * 100.0f;
+    log_channel("PM2.5", g_window.pm25, data.low_pulse_occupancy_ratio_pm25);
+    log_channel("PM10", g_window.pm10, data.low_pulse_occupancy_ratio_pm10);
 
-    // Se qualquer leitura for > 0, consideramos o sensor válido
-    if (g_dsm_pm25_total_low_time_us > 0 || g_dsm_pm10_total_low_time_us > 0) {
-        data.isValid = true; 
+    if (g_window.elapsed_ms < DSM501A_MIN_SAMPLE_TIME_MS) {
+        Serial.println("DSM501A: AVISO - Janela encerrada cedo demais. Leitura descartada.");
+    } else if (g_window.pm25.total_low_us > 0 || g_window.pm10.total_low_us > 0) {
+        // Se qualquer leitura for > 0, consideramos o sensor válido
+        data.isValid = true;
     } else {
         Serial.println("DSM501A: AVISO - Leituras de pulso ainda são 0 us. Verifique o warm-up e a fiação.");
     }
+    return true;
+}
 
-    return true; 
-}
\ No newline at end of file
+const DSM501A_Window& dsm501a_window_stats() {
+    return g_window;
+}
+
+/**
+ * @brief Realiza a leitura dos dados do sensor DSM501A (bloqueante).
+ */
+bool dsm501a_read_data(DSM501A_Data &data, unsigned long sample_time_ms) {
+    data.isValid = false; 
+    if (!dsm501a_window_start(sample_time_ms)) {
+        return false;
+    }
+    // Enquanto o 'delay' roda, a captura (ou as ISRs) mede os pulsos em segundo plano.
+    delay(sample_time_ms);
+    return dsm501a_window_finish(data);
+}
@@ -8,6 +8,44 @@
 // para leituras estáveis. 300ms é muito rápido e pode dar 0.
 const unsigned long DEFAULT_DSM501A_SAMPLE_TIME_MS = 30000; // 30 segundos
 
+// Janelas mais curtas que isto são descartadas (isValid = false)
+#ifndef DSM501A_MIN_SAMPLE_TIME_MS
+#define DSM501A_MIN_SAMPLE_TIME_MS 10000
+#endif
+
+// Como os pulsos em nível baixo são medidos:
+// - DSM501A_CAPTURE_MCPWM: as unidades de captura do MCPWM registram em
+//   hardware o instante de cada borda (contador de 80 MHz). A CPU só soma
+//   durações já medidas: sem jitter de latência de interrupção e sem
+//   digitalRead()/micros() por borda.
+// - DSM501A_CAPTURE_GPIO_ISR: ISR de GPIO em CHANGE com digitalRead() e
+//   micros() (implementação original).
+#define DSM501A_CAPTURE_GPIO_ISR 0
+#define DSM501A_CAPTURE_MCPWM 1
+
+#ifndef DSM501A_CAPTURE_BACKEND
+#define DSM501A_CAPTURE_BACKEND DSM501A_CAPTURE_MCPWM
+#endif
+
+// Unidade MCPWM usada (canais de captura 0 = PM2.5, 1 = PM10 e 2 = início da janela)
+#ifndef DSM501A_MCPWM_UNIT
+#define DSM501A_MCPWM_UNIT 0
+#endif
+
+// Segundos guardados na série de LOP por segundo (o resto da janela só entra no total)
+#ifndef DSM501A_SERIES_MAX_S
+#define DSM501A_SERIES_MAX_S 60
+#endif
+
+// Histograma de larguras de pulso: faixas de DSM501A_HIST_BIN_MS; a última é aberta.
+// O datasheet dá pulsos de 10-90 ms.
+#ifndef DSM501A_HIST_BIN_MS
+#define DSM501A_HIST_BIN_MS 10
+#endif
+#ifndef DSM501A_HIST_BINS
+#define DSM501A_HIST_BINS 10
+#endif
+
 // Estrutura para armazenar os dados lidos do DSM501A
 struct DSM501A_Data {
     float low_pulse_occupancy_ratio_pm25; // LOP ratio para PM2.5 (%)
@@ -15,18 +53,64 @@ struct DSM501A_Data {
     bool isValid; 
 };
 
+// Detalhe de uma saída (PM2.5 ou PM10) ao longo da janela
+struct DSM501A_Channel {
+    uint32_t total_low_us;                        // Tempo total em nível baixo
+    uint32_t pulses;                              // Pulsos completos
+    uint32_t low_us_per_s[DSM501A_SERIES_MAX_S];  // Tempo em nível baixo em cada segundo
+    uint16_t width_hist[DSM501A_HIST_BINS];       // Pulsos por faixa de largura
+};
+
+// Detalhe da última janela encerrada
+struct DSM501A_Window {
+    uint32_t elapsed_ms; // Duração real (de start a finish)
+    uint16_t seconds;    // Segundos completos na série (até DSM501A_SERIES_MAX_S)
+    DSM501A_Channel pm25;
+    DSM501A_Channel pm10;
+};
+
 /**
  * @brief Inicializa os pinos GPIO para leitura do(s) sensor(es) DSM501A.
  */
 void dsm501a_init();
 
 /**
- * @brief Realiza a leitura dos dados do sensor DSM501A usando interrupções.
- * Esta função é BLOQUEANTE e irá pausar pelo 'sample_time_ms'.
+ * @brief Abre uma janela de amostragem em segundo plano e retorna imediatamente.
+ * Os pulsos são medidos (ver DSM501A_CAPTURE_BACKEND) até dsm501a_window_finish().
+ *
+ * @param sample_time_ms Duração da janela (Recomendado: 30000 ms).
+ * @return false se o tempo é 0.
+ */
+bool dsm501a_window_start(unsigned long sample_time_ms = DEFAULT_DSM501A_SAMPLE_TIME_MS);
+
+/**
+ * @brief Não bloqueia.
+ * @return true quando a duração pedida já passou (ou não há janela aberta).
+ */
+bool dsm501a_window_poll();
+
+/**
+ * @brief Encerra a janela e calcula as LOP ratios sobre a duração real.
+ * O detalhe (série por segundo e histograma) fica em dsm501a_window_stats().
+ *
+ * @param data Preenchida sempre (isValid = false se a janela foi curta ou sem pulsos).
+ * @return false se não havia janela aberta.
+ */
+bool dsm501a_window_finish(DSM501A_Data &data);
+
+/**
+ * @brief Detalhe da última janela encerrada.
+ */
+const DSM501A_Window& dsm501a_window_stats();
+
+/**
+ * @brief Realiza a leitura dos dados do sensor DSM501A (ver DSM501A_CAPTURE_BACKEND).
+ * Esta função é BLOQUEANTE e irá pausar pelo 'sample_time_ms'
+ * (start + delay + finish; prefira a janela em segundo plano).
  * * @param data Referência para a estrutura DSM501A_Data onde os dados serão armazenados.
  * @param sample_time_ms O tempo total de amostragem (Recomendado: 30000 ms).
  * @return true se a leitura foi bem-sucedida, false caso contrário.
  */
 bool dsm501a_read_data(DSM501A_Data &data, unsigned long sample_time_ms = DEFAULT_DSM501A_SAMPLE_TIME_MS);
 
-#endif // DSM501A_HANDLER_H
\ No newline at end of file
+#endif // DSM501A_HANDLER_H
@@ -0,0 +1,132 @@
+#include "diagnostics.h"
+
+// Relatório acumulado entre uploads (sobrevive ao deep sleep)
+RTC_DATA_ATTR static Diag_Report g_report = {};
+
+// Fases em andamento neste despertar
+static bool g_active[DIAG_PHASE_COUNT] = {};
+static uint32_t g_start_us[DIAG_PHASE_COUNT] = {};
+static uint32_t g_min_heap[DIAG_PHASE_COUNT] = {};
+static uint32_t g_watermark_at_start[DIAG_PHASE_COUNT] = {};
+
+static const char* const PHASE_NAMES[DIAG_PHASE_COUNT] = {
+    "awake", "sens_on", "scd40", "mics", "modem_resume", "modem_restart",
+    "reg", "gprs", "ntp", "gnss", "tls", "mqtt", "pub", "dsm_wait", "rail",
+};
+
+static const char* const COUNTER_NAMES[DIAG_COUNTER_COUNT] = {
+    "net_fail", "ntp_retry", "gnss_poll", "tls_fallback", "mqtt_retry", "pub_fail", "sensor_fail",
+    "tls_heap_fallback", "recovery",
+};
+
+/**
+ * @brief (Função Privada) Soma saturando em UINT32_MAX.
+ */
+static uint32_t add_saturated(uint32_t a, uint32_t b) {
+    return (a > UINT32_MAX - b) ? UINT32_MAX : a + b;
+}
+
+/**
+ * @brief (Função Privada) Acumula uma execução de 'phase' no relatório.
+ */
+static void record_phase(diag_phase_t phase, uint32_t elapsed_us, uint32_t min_heap) {
+    Diag_PhaseStats& stats = g_report.phases[phase];
+    if (stats.count == 0 || min_heap < stats.min_free_heap) {
+        stats.min_free_heap = min_heap;
+    }
+    if (stats.count < UINT16_MAX) {
+        stats.count++;
+    }
+    stats.last_us = elapsed_us;
+    if (elapsed_us > stats.max_us) {
+        stats.max_us = elapsed_us;
+    }
+    stats.total_us = add_saturated(stats.total_us, elapsed_us);
+}
+
+void diag_register_wake() {
+    if (g_report.wakes < UINT16_MAX) {
+        g_report.wakes++;
+    }
+    // A fase "awake" começa no boot (micros() = 0)
+    g_active[DIAG_PHASE_AWAKE] = true;
+    g_start_us[DIAG_PHASE_AWAKE] = 0;
+    g_min_heap[DIAG_PHASE_AWAKE] = ESP.getFreeHeap();
+    g_watermark_at_start[DIAG_PHASE_AWAKE] = UINT32_MAX;
+}
+
+void diag_phase_begin(diag_phase_t phase) {
+    if (phase >= DIAG_PHASE_COUNT) {
+        return;
+    }
+    g_min_heap[phase] = ESP.getFreeHeap();
+    g_watermark_at_start[phase] = ESP.getMinFreeHeap();
+    g_start_us[phase] = micros();
+    g_active[phase] = true;
+}
+
+void diag_phase_end(diag_phase_t phase) {
+    if (phase >= DIAG_PHASE_COUNT || !g_active[phase]) {
+        return;
+    }
+    uint32_t elapsed_us = micros() - g_start_us[phase];
+    g_active[phase] = false;
+
+    // O pico de uso pode ter ocorrido entre as amostras: se a marca mínima do
+    // heap (desde o boot) caiu durante a fase, o novo mínimo é desta fase.
+    uint32_t min_heap = g_min_heap[phase];
+    uint32_t free_heap = ESP.getFreeHeap();
+    if (free_heap < min_heap) {
+        min_heap = free_heap;
+    }
+    uint32_t watermark = ESP.getMinFreeHeap();
+    if (watermark < g_watermark_at_start[phase] && watermark < min_heap) {
+        min_heap = watermark;
+    }
+
+    record_phase(phase, elapsed_us, min_heap);
+
+#if DIAG_LOG_PHASES
+    Serial.printf("Diag: %s %lu us (heap min %lu B).\n", PHASE_NAMES[phase],
+                  (unsigned long)elapsed_us, (unsigned long)min_heap);
+#endif
+}
+
+void diag_heap_checkpoint() {
+    uint32_t free_heap = ESP.getFreeHeap();
+    for (int i = 0; i < DIAG_PHASE_COUNT; i++) {
+        if (g_active[i] && free_heap < g_min_heap[i]) {
+            g_min_heap[i] = free_heap;
+        }
+    }
+}
+
+void diag_count(diag_counter_t counter, uint16_t n) {
+    if (counter >= DIAG_COUNTER_COUNT) {
+        return;
+    }
+    uint16_t& value = g_report.counters[counter];
+    value = (value > UINT16_MAX - n) ? UINT16_MAX : value + n;
+}
+
+void diag_wake_end() {
+    diag_phase_end(DIAG_PHASE_AWAKE);
+}
+
+const Diag_Report& diag_report() {
+    return g_report;
+}
+
+void diag_report_delivered() {
+    memset(&g_report, 0, sizeof(g_report));
+    // Este despertar ainda não terminou: ele conta no próximo relatório
+    g_report.wakes = 1;
+}
+
+const char* diag_phase_name(diag_phase_t phase) {
+    return phase < DIAG_PHASE_COUNT ? PHASE_NAMES[phase] : "?";
+}
+
+const char* diag_counter_name(diag_counter_t counter) {
+    return counter < DIAG_COUNTER_COUNT ? COUNTER_NAMES[counter] : "?";
+}
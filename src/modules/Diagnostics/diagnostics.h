@@ -0,0 +1,150 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Anexa o bloco "diag" ao primeiro lote de cada upload. Com 0, as fases
+// continuam sendo medidas (e registradas na Serial), mas não são publicadas.
+#ifndef DIAG_TELEMETRY_ENABLED
+#define DIAG_TELEMETRY_ENABLED 1
+#endif
+
+// Registra na Serial a duração de cada fase ao final dela.
+#ifndef DIAG_LOG_PHASES
+#define DIAG_LOG_PHASES 1
+#endif
+
+/*
+ * Fases instrumentadas do ciclo. A ordem (e o identificador numérico) faz
+ * parte do payload binário: novas fases entram sempre no final.
+ */
+typedef enum {
+    DIAG_PHASE_AWAKE = 0,         // Despertar inteiro (boot até o deep sleep)
+    DIAG_PHASE_SENSOR_POWER_ON,   // MOSFET + assentamento do trilho (o aquecimento é por sensor)
+    DIAG_PHASE_SCD40_READ,        // Leitura após o "Data Ready"
+    DIAG_PHASE_MICS6814_READ,
+    DIAG_PHASE_MODEM_RESUME,      // Modem reaproveitado do PSM/eDRX
+    DIAG_PHASE_MODEM_RESTART,     // Pulso PWRKEY + restart() do TinyGSM
+    DIAG_PHASE_REGISTRATION,      // Espera de registro na rede celular
+    DIAG_PHASE_GPRS,
+    DIAG_PHASE_NTP,
+    DIAG_PHASE_GNSS,
+    DIAG_PHASE_TLS,               // TCP + handshake (inclui o fallback sem retomada)
+    DIAG_PHASE_MQTT_CONNECT,      // Inclui a fase TLS e as retentativas
+    DIAG_PHASE_PUBLISH,           // Backlog inteiro (todos os lotes)
+    DIAG_PHASE_DSM501A_WAIT,      // Espera pelo fim da janela do DSM501A após os demais sensores
+    DIAG_PHASE_SENSOR_RAIL,       // Trilho dos sensores ligado (até a última leitura)
+    DIAG_PHASE_COUNT
+} diag_phase_t;
+
+/*
+ * Contadores de retentativas e falhas. Mesma regra de ordem das fases.
+ */
+typedef enum {
+    DIAG_COUNTER_NETWORK_FAILURES = 0, // Restart ou registro sem sucesso
+    DIAG_COUNTER_NTP_RETRIES,          // Leituras da hora da rede que falharam
+    DIAG_COUNTER_GNSS_POLLS,           // Consultas AT+CGNSINF
+    DIAG_COUNTER_TLS_FALLBACKS,        // Retomadas recusadas (refeito o handshake completo)
+    DIAG_COUNTER_MQTT_RETRIES,
+    DIAG_COUNTER_PUBLISH_FAILURES,
+    DIAG_COUNTER_SENSOR_FAILURES,      // Leituras inválidas de qualquer sensor
+    DIAG_COUNTER_TLS_HEAP_FALLBACKS,   // Alocações do mbedTLS que não couberam na arena
+    DIAG_COUNTER_RECOVERY_BOOTS,       // Boots fora de um deep sleep limpo (ver wake_manager.h)
+    DIAG_COUNTER_COUNT
+} diag_counter_t;
+
+// Estatísticas de uma fase desde o último relatório entregue
+struct Diag_PhaseStats {
+    uint16_t count;          // Execuções
+    uint32_t last_us;        // Duração da execução mais recente
+    uint32_t max_us;
+    uint32_t total_us;       // Soma (satura em UINT32_MAX)
+    uint32_t min_free_heap;  // Menor heap livre observado durante a fase (bytes)
+};
+
+// Relatório acumulado na memória RTC entre uploads
+struct Diag_Report {
+    uint16_t wakes;          // Despertares cobertos
+    Diag_PhaseStats phases[DIAG_PHASE_COUNT];
+    uint16_t counters[DIAG_COUNTER_COUNT];
+};
+
+/**
+ * @brief Registra um novo despertar. Deve ser chamada uma vez no início do setup().
+ */
+void diag_register_wake();
+
+/**
+ * @brief Inicia a medição de uma fase (tempo em micros() e heap livre).
+ *
+ * @note Cada fase é medida por uma única tarefa por vez: as fases de sensores
+ * rodam na tarefa de aquisição e as de rede na tarefa de rede (ver RTOSTasks),
+ * então os registros não precisam de trava.
+ */
+void diag_phase_begin(diag_phase_t phase);
+
+/**
+ * @brief Encerra a medição de uma fase e acumula no relatório.
+ * Ignorada se a fase não foi iniciada neste despertar.
+ */
+void diag_phase_end(diag_phase_t phase);
+
+/**
+ * @brief Amostra o heap livre para todas as fases em andamento.
+ * Útil logo após grandes alocações (ex: buffers do handshake TLS).
+ */
+void diag_heap_checkpoint();
+
+/**
+ * @brief Incrementa um contador de retentativas/falhas (satura em UINT16_MAX).
+ */
+void diag_count(diag_counter_t counter, uint16_t n = 1);
+
+/**
+ * @brief Encerra a fase DIAG_PHASE_AWAKE. Chamada antes do deep sleep.
+ */
+void diag_wake_end();
+
+/**
+ * @brief Relatório acumulado desde a última entrega.
+ */
+const Diag_Report& diag_report();
+
+/**
+ * @brief Zera o relatório após a publicação do lote que o carregava.
+ * Fases em andamento continuam sendo medidas e entram no próximo relatório.
+ */
+void diag_report_delivered();
+
+/**
+ * @brief Nome curto da fase (chave do bloco "diag" no JSON).
+ */
+const char* diag_phase_name(diag_phase_t phase);
+
+/**
+ * @brief Nome curto do contador (chave do bloco "diag" no JSON).
+ */
+const char* diag_counter_name(diag_counter_t counter);
+
+/**
+ * @brief Mede a fase durante o escopo atual (begin no construtor, end no destrutor).
+ *
+ *     {
+ *         DiagScope scope(DIAG_PHASE_GPRS);
+ *         ...
+ *     }
+ */
+class DiagScope {
+public:
+    explicit DiagScope(diag_phase_t phase) : _phase(phase) { diag_phase_begin(phase); }
+    ~DiagScope() { diag_phase_end(_phase); }
+
+    DiagScope(const DiagScope&) = delete;
+    DiagScope& operator=(const DiagScope&) = delete;
+
+private:
+    diag_phase_t _phase;
+};
+
+#endif // DIAGNOSTICS_H
@@ -0,0 +1,241 @@
+#include "mics6814_baseline.h"
+#include <Preferences.h>
+#include "modules/SampleBuffer/sample_buffer.h"
+
+#define NVS_NAMESPACE "mics6814"
+#define NVS_KEY_CALIBRATION "cal"
+#define CALIBRATION_RECORD_VERSION 1
+
+enum { GAS_CO = 0, GAS_NO2, GAS_NH3, GAS_COUNT };
+
+static const char* const GAS_NAMES[GAS_COUNT] = {"CO", "NO2", "NH3"};
+
+// Sentido do "ar limpo" na leitura bruta, pelas curvas de mics6814_handler:
+// o PPM de CO e NH3 (redutores) cai quando a leitura sobe; o de NO2
+// (oxidante) sobe com ela.
+static const bool CLEANER_IS_HIGHER[GAS_COUNT] = {true, false, true};
+
+static const char* const SOURCE_NAMES[] = {"fábrica", "rastreado", "recalibrado", "remoto", "manual"};
+
+// Registro gravado na NVS (sobrevive à falta de energia e à regravação do firmware)
+struct CalibrationRecord {
+    uint8_t version;
+    uint8_t source;           // mics_r0_source_t
+    uint8_t recal_pending;    // Recalibração remota aceita e ainda não concluída
+    uint8_t reserved;
+    int16_t r0[GAS_COUNT];
+    uint16_t tracked_windows; // Janelas que moveram o R0 desde a última calibração
+    uint32_t last_command_id; // Último comando remoto executado
+};
+
+// Janela de rastreamento e recalibração em andamento (memória RTC)
+struct BaselineWindow {
+    uint16_t readings;
+    int16_t cleanest[GAS_COUNT];
+    uint8_t recal_count;
+    int32_t recal_sum[GAS_COUNT];
+};
+
+static CalibrationRecord g_record = {};
+RTC_DATA_ATTR static BaselineWindow g_window = {};
+
+/**
+ * @brief (Função Privada) R0 plausível para o ADC de 16 bits.
+ */
+static bool valid_r0(int32_t r0) {
+    return r0 > 0 && r0 < 32767;
+}
+
+/**
+ * @brief (Função Privada) Lê o registro da NVS.
+ * @return false se não existe ou é de outra versão / inválido.
+ */
+static bool load_record(CalibrationRecord& record) {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, /*readOnly=*/true)) {
+        return false;
+    }
+    size_t n = prefs.getBytes(NVS_KEY_CALIBRATION, &record, sizeof(record));
+    prefs.end();
+    if (n != sizeof(record) || record.version != CALIBRATION_RECORD_VERSION) {
+        return false;
+    }
+    for (int i = 0; i < GAS_COUNT; i++) {
+        if (!valid_r0(record.r0[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief (Função Privada) Grava o registro atual na NVS.
+ */
+static void save_record() {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, /*readOnly=*/false) ||
+        prefs.putBytes(NVS_KEY_CALIBRATION, &g_record, sizeof(g_record)) != sizeof(g_record)) {
+        Serial.println("MICS6814: ERRO - Não foi possível gravar a calibração na NVS.");
+    }
+    prefs.end();
+}
+
+/**
+ * @brief (Função Privada) Aplica os R0 do registro ao handler.
+ */
+static void apply_record() {
+    mics6814_init(g_record.r0[GAS_CO], g_record.r0[GAS_NO2], g_record.r0[GAS_NH3]);
+}
+
+/**
+ * @brief (Função Privada) Grava e aplica um R0 novo e reconverte as leituras
+ * que ainda aguardam publicação, tiradas com o R0 anterior.
+ */
+static void commit_record() {
+    save_record();
+    apply_record();
+    sample_buffer_reconvert_mics6814();
+}
+
+/**
+ * @brief (Função Privada) Zera a janela de rastreamento e a recalibração em andamento.
+ */
+static void reset_window() {
+    memset(&g_window, 0, sizeof(g_window));
+}
+
+/**
+ * @brief (Função Privada) Fecha uma janela: move cada R0 em direção à leitura
+ * mais limpa da janela (1/MICS_BASELINE_GAIN_DIV do caminho, passo limitado).
+ * @return true se algum R0 mudou.
+ */
+static bool close_window() {
+    bool changed = false;
+    for (int i = 0; i < GAS_COUNT; i++) {
+        int32_t r0 = g_record.r0[i];
+        int32_t step = ((int32_t)g_window.cleanest[i] - r0) / MICS_BASELINE_GAIN_DIV;
+        int32_t max_step = r0 * MICS_BASELINE_MAX_STEP_PERMILLE / 1000;
+        if (max_step < 1) {
+            max_step = 1;
+        }
+        step = constrain(step, -max_step, max_step);
+        if (step != 0 && valid_r0(r0 + step)) {
+            Serial.printf("MICS6814: Baseline %s: R0 %ld -> %ld (mais limpo da janela: %d).\n", GAS_NAMES[i],
+                          (long)r0, (long)(r0 + step), g_window.cleanest[i]);
+            g_record.r0[i] = (int16_t)(r0 + step);
+            changed = true;
+        }
+    }
+    uint16_t readings = g_window.readings;
+    reset_window();
+
+    if (!changed) {
+        Serial.printf("MICS6814: Baseline estável após %u leituras.\n", readings);
+        return false;
+    }
+    g_record.source = MICS_R0_SOURCE_TRACKED;
+    if (g_record.tracked_windows < UINT16_MAX) {
+        g_record.tracked_windows++;
+    }
+    commit_record();
+    return true;
+}
+
+void mics6814_baseline_begin(int16_t factory_r0_co, int16_t factory_r0_no2, int16_t factory_r0_nh3) {
+    if (!load_record(g_record)) {
+        memset(&g_record, 0, sizeof(g_record));
+        g_record.version = CALIBRATION_RECORD_VERSION;
+        g_record.source = MICS_R0_SOURCE_FACTORY;
+        g_record.r0[GAS_CO] = factory_r0_co;
+        g_record.r0[GAS_NO2] = factory_r0_no2;
+        g_record.r0[GAS_NH3] = factory_r0_nh3;
+        Serial.println("MICS6814: Sem calibração na NVS. Usando os R0 de fábrica.");
+    } else {
+        Serial.printf("MICS6814: Calibração da NVS (origem: %s, %u ajuste(s) de baseline%s).\n",
+                      SOURCE_NAMES[g_record.source < 5 ? g_record.source : 0], g_record.tracked_windows,
+                      g_record.recal_pending ? ", recalibração pendente" : "");
+    }
+    apply_record();
+}
+
+bool mics6814_baseline_update(const MICS6814_Data& data) {
+    if (!data.isValid) {
+        return false;
+    }
+    const int16_t raw[GAS_COUNT] = {data.raw_co, data.raw_no2, data.raw_nh3};
+
+    if (g_record.recal_pending) {
+        for (int i = 0; i < GAS_COUNT; i++) {
+            g_window.recal_sum[i] += raw[i];
+        }
+        g_window.recal_count++;
+        Serial.printf("MICS6814: Recalibração remota: leitura %u de %u.\n", g_window.recal_count, MICS_RECAL_READINGS);
+        if (g_window.recal_count >= MICS_RECAL_READINGS) {
+            mics6814_baseline_store((int16_t)(g_window.recal_sum[GAS_CO] / g_window.recal_count),
+                                    (int16_t)(g_window.recal_sum[GAS_NO2] / g_window.recal_count),
+                                    (int16_t)(g_window.recal_sum[GAS_NH3] / g_window.recal_count),
+                                    MICS_R0_SOURCE_RECALIBRATED);
+            return true;
+        }
+        return false;
+    }
+
+    for (int i = 0; i < GAS_COUNT; i++) {
+        bool cleaner = CLEANER_IS_HIGHER[i] ? raw[i] > g_window.cleanest[i] : raw[i] < g_window.cleanest[i];
+        if (g_window.readings == 0 || cleaner) {
+            g_window.cleanest[i] = raw[i];
+        }
+    }
+    g_window.readings++;
+    if (g_window.readings >= MICS_BASELINE_WINDOW_READINGS) {
+        return close_window();
+    }
+    return false;
+}
+
+bool mics6814_baseline_handle_command(const char* command) {
+    unsigned long id = 0;
+    int r0_co = 0, r0_no2 = 0, r0_nh3 = 0;
+
+    bool recal = sscanf(command, "mics_recal %lu", &id) == 1;
+    bool set_r0 = !recal && sscanf(command, "mics_r0 %lu %d %d %d", &id, &r0_co, &r0_no2, &r0_nh3) == 4;
+    if (!recal && !set_r0) {
+        return false;
+    }
+    if ((uint32_t)id == g_record.last_command_id) {
+        Serial.printf("MICS6814: Comando %lu já executado. Ignorando.\n", id);
+        return true;
+    }
+
+    if (set_r0) {
+        if (!valid_r0(r0_co) || !valid_r0(r0_no2) || !valid_r0(r0_nh3)) {
+            Serial.printf("MICS6814: ERRO - Comando %lu com R0 fora da faixa. Ignorando.\n", id);
+            return true;
+        }
+        g_record.last_command_id = (uint32_t)id;
+        Serial.printf("MICS6814: Comando %lu: novos R0 recebidos.\n", id);
+        mics6814_baseline_store((int16_t)r0_co, (int16_t)r0_no2, (int16_t)r0_nh3, MICS_R0_SOURCE_REMOTE);
+        return true;
+    }
+
+    g_record.last_command_id = (uint32_t)id;
+    g_record.recal_pending = 1;
+    reset_window();
+    save_record();
+    Serial.printf("MICS6814: Comando %lu: recalibração nas próximas %u leituras (a unidade deve estar em ar limpo).\n",
+                  id, MICS_RECAL_READINGS);
+    return true;
+}
+
+void mics6814_baseline_store(int16_t r0_co, int16_t r0_no2, int16_t r0_nh3, mics_r0_source_t source) {
+    g_record.version = CALIBRATION_RECORD_VERSION;
+    g_record.source = (uint8_t)source;
+    g_record.recal_pending = 0;
+    g_record.tracked_windows = 0;
+    g_record.r0[GAS_CO] = r0_co;
+    g_record.r0[GAS_NO2] = r0_no2;
+    g_record.r0[GAS_NH3] = r0_nh3;
+    reset_window();
+    Serial.printf("MICS6814: Calibração gravada na NVS (origem: %s).\n", SOURCE_NAMES[source]);
+    commit_record();
+}
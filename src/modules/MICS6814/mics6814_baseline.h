@@ -0,0 +1,90 @@
+#ifndef MICS6814_BASELINE_H
+#define MICS6814_BASELINE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "mics6814_handler.h"
+
+/*
+ * Calibração persistente do MICS6814.
+ *
+ * Os R0 (leitura bruta em ar limpo) ficam na NVS e são atualizados sem
+ * intervenção de duas formas:
+ * - rastreamento de baseline: a cada janela (~1 dia de leituras), a leitura
+ *   mais "limpa" da janela puxa o R0 uma fração do caminho, com passo
+ *   limitado. Acompanha o envelhecimento do sensor ao longo de dias sem
+ *   reagir a um episódio isolado de poluição;
+ * - comandos remotos (tópico AWS_IOT_COMMAND_TOPIC, ver comm_manager.h):
+ *     "mics_recal <id>"                 média das próximas MICS_RECAL_READINGS
+ *                                       leituras vira o novo R0 (unidade em ar limpo)
+ *     "mics_r0 <id> <co> <no2> <nh3>"   grava os R0 informados
+ *   <id> é um número escolhido por quem envia. Como o comando é "retained",
+ *   ele chega a cada upload; só é executado quando o <id> muda.
+ */
+
+// Leituras válidas por janela de rastreamento (~1 dia com o intervalo de sono configurado)
+#ifndef MICS_BASELINE_WINDOW_READINGS
+#define MICS_BASELINE_WINDOW_READINGS ((24 * 60) / TIME_TO_SLEEP_INTERVAL_MINUTES)
+#endif
+
+// Por janela, o R0 anda 1/N da distância até a leitura mais limpa
+#ifndef MICS_BASELINE_GAIN_DIV
+#define MICS_BASELINE_GAIN_DIV 8
+#endif
+
+// Passo máximo por janela, em milésimos do R0 atual
+#ifndef MICS_BASELINE_MAX_STEP_PERMILLE
+#define MICS_BASELINE_MAX_STEP_PERMILLE 20
+#endif
+
+// Leituras (uma por despertar) médias numa recalibração remota
+#ifndef MICS_RECAL_READINGS
+#define MICS_RECAL_READINGS 4
+#endif
+
+// Origem dos R0 em uso
+typedef enum {
+    MICS_R0_SOURCE_FACTORY = 0,  // Valores compilados (NVS vazia)
+    MICS_R0_SOURCE_TRACKED,      // Ajustados pelo rastreamento de baseline
+    MICS_R0_SOURCE_RECALIBRATED, // Recalibração remota (média em ar limpo)
+    MICS_R0_SOURCE_REMOTE,       // Valores enviados por comando
+    MICS_R0_SOURCE_MANUAL,       // mics6814_calibrate() + mics6814_baseline_store()
+} mics_r0_source_t;
+
+/**
+ * @brief Carrega os R0 da NVS e inicializa o handler (mics6814_init()).
+ * Substitui a chamada direta a mics6814_init() no setup().
+ *
+ * @param factory_r0_co Usado se a NVS ainda não tiver calibração.
+ * @param factory_r0_no2 Idem.
+ * @param factory_r0_nh3 Idem.
+ */
+void mics6814_baseline_begin(int16_t factory_r0_co, int16_t factory_r0_no2, int16_t factory_r0_nh3);
+
+/**
+ * @brief Alimenta o rastreamento (ou a recalibração pendente) com uma leitura.
+ * Leituras com isValid = false são ignoradas.
+ *
+ * Quando a leitura fecha uma janela ou uma recalibração, o R0 muda e as
+ * amostras pendentes no buffer são reconvertidas (ver
+ * sample_buffer_reconvert_mics6814()); a própria leitura ainda não está lá.
+ *
+ * @return true se o R0 mudou (reconverta 'data' com mics6814_convert_batch()).
+ */
+bool mics6814_baseline_update(const MICS6814_Data& data);
+
+/**
+ * @brief Trata um comando remoto ("mics_recal ..." / "mics_r0 ...").
+ *
+ * @param command Payload recebido (texto).
+ * @return true se o comando é deste módulo (mesmo que já executado antes).
+ */
+bool mics6814_baseline_handle_command(const char* command);
+
+/**
+ * @brief Grava novos R0 na NVS e os aplica (reinicia a janela de rastreamento).
+ * As amostras pendentes no buffer são reconvertidas com os novos R0.
+ */
+void mics6814_baseline_store(int16_t r0_co, int16_t r0_no2, int16_t r0_nh3, mics_r0_source_t source);
+
+#endif // MICS6814_BASELINE_H
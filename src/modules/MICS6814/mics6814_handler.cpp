@@ -1,5 +1,5 @@
 #include "mics6814_handler.h"
-#include <math.h> // Para a função pow()
+#include "mics6814_lut.h" // Curvas PPM x (Rs/R0) tabeladas (tools/gen_mics6814_lut.py)
 
 // ===================================================================
 // --- Variáveis Globais (Privadas) do Módulo ---
@@ -11,30 +11,87 @@ static int16_t g_r0_co = 0;
 static int16_t g_r0_no2 = 0;
 static int16_t g_r0_nh3 = 0;
 
-const float ADC_MAX_VALUE = 32767.0f;
+const int32_t ADC_MAX_VALUE = 32767;
+
+// Bits fracionários da razão Rs/R0 em ponto fixo
+#define RATIO_FRACTION_BITS 16
+
+// Ordem da varredura no ADS1115
+static const ads_channel_t MICS_CHANNELS[] = {ADS_CHANNEL_MICS_CO, ADS_CHANNEL_MICS_NO2, ADS_CHANNEL_MICS_NH3};
+
+// Leitura da sonda de aquecimento anterior (mesma ordem de MICS_CHANNELS)
+static int16_t g_warmup_prev[3] = {};
+static bool g_warmup_has_prev = false;
 
 /**
- * @brief (Função Privada) Calcula o "ratio" (Rs/R0)
+ * @brief (Função Privada) Calcula o "ratio" (Rs/R0) em ponto fixo Q16.16.
  *
  * Esta é a fórmula de "ratio" que encontramos no driver ESP-IDF,
- * mas corrigida para usar o valor de 16 bits (32767.0) 
- * do nosso ADS1115.
+ * mas corrigida para usar o valor de 16 bits (32767)
+ * do nosso ADS1115:
+ *     ratio = (Rs / R0) * (ADC_MAX - R0) / (ADC_MAX - Rs)
  *
  * @param rs_raw O valor ATUAL (bruto) lido do ADC.
  * @param r0_raw O valor de CALIBRAÇÃO (bruto) lido em ar limpo.
- * @return O ratio (float) para ser usado nas fórmulas de PPM.
+ * @return O ratio em Q16.16 (satura em UINT32_MAX).
  */
-static float calculate_ratio(int16_t rs_raw, int16_t r0_raw) {
-    if (r0_raw == 0 || rs_raw == 0) {
+static uint32_t calculate_ratio_q16(int16_t rs_raw, int16_t r0_raw) {
+    if (r0_raw <= 0 || rs_raw <= 0) {
         return 0; // Evita divisão por zero
     }
-    
-    float rs_f = (float)rs_raw;
-    float r0_f = (float)r0_raw;
+    if (rs_raw >= ADC_MAX_VALUE) {
+        return UINT32_MAX;
+    }
 
-    float ratio = (rs_f / r0_f) * (ADC_MAX_VALUE - r0_f) / (ADC_MAX_VALUE - rs_f);
-    
-    return ratio;
+    uint64_t numerator = ((uint64_t)rs_raw * (uint64_t)(ADC_MAX_VALUE - r0_raw)) << RATIO_FRACTION_BITS;
+    uint64_t denominator = (uint64_t)r0_raw * (uint64_t)(ADC_MAX_VALUE - rs_raw);
+    uint64_t ratio = numerator / denominator;
+    return ratio > UINT32_MAX ? UINT32_MAX : (uint32_t)ratio;
+}
+
+/**
+ * @brief (Função Privada) PPM x MICS_LUT_SCALE para uma razão Q16.16.
+ *
+ * O bit mais significativo da razão dá a oitava e os MICS_LUT_SEGMENT_BITS
+ * seguintes o segmento; o restante interpola linearmente entre os dois
+ * pontos da tabela, só com deslocamentos. Razões fora da faixa da tabela
+ * ficam presas nas pontas.
+ */
+static uint32_t lut_interpolate(const uint32_t* table, uint32_t ratio_q16) {
+    const uint32_t min_q16 = 1UL << (RATIO_FRACTION_BITS + MICS_LUT_RATIO_MIN_EXP);
+    const uint32_t max_q16 = 1UL << (RATIO_FRACTION_BITS + MICS_LUT_RATIO_MAX_EXP);
+    if (ratio_q16 < min_q16) {
+        ratio_q16 = min_q16;
+    }
+    if (ratio_q16 >= max_q16) {
+        return table[MICS_LUT_ENTRIES - 1];
+    }
+
+    int msb = 31 - __builtin_clz(ratio_q16);
+    int shift = msb - MICS_LUT_SEGMENT_BITS;
+    uint32_t offset = ratio_q16 - (1UL << msb);
+    size_t index = (size_t)(msb - RATIO_FRACTION_BITS - MICS_LUT_RATIO_MIN_EXP) * (1u << MICS_LUT_SEGMENT_BITS) +
+                   (offset >> shift);
+    uint32_t rest = offset & ((1UL << shift) - 1);
+
+    int64_t delta = ((int64_t)table[index + 1] - (int64_t)table[index]) * rest;
+    return (uint32_t)((int64_t)table[index] + (delta >> shift));
+}
+
+/**
+ * @brief (Função Privada) Converte raw_* em PPM com os R0 atuais.
+ */
+static void convert_reading(MICS6814_Data& data, uint32_t ratios_q16[3]) {
+    ratios_q16[0] = calculate_ratio_q16(data.raw_co, g_r0_co);
+    ratios_q16[1] = calculate_ratio_q16(data.raw_no2, g_r0_no2);
+    ratios_q16[2] = calculate_ratio_q16(data.raw_nh3, g_r0_nh3);
+
+    // Curvas do driver ESP-IDF (tabeladas). As fórmulas podem precisar de
+    // ajuste fino, mas são um excelente ponto de partida.
+    const float to_ppm = 1.0f / MICS_LUT_SCALE;
+    data.ppm_co = lut_interpolate(MICS_LUT_CO, ratios_q16[0]) * to_ppm;    // CO: 1 a 1000 ppm
+    data.ppm_no2 = lut_interpolate(MICS_LUT_NO2, ratios_q16[1]) * to_ppm;  // NO2: 0.05 a 10 ppm
+    data.ppm_nh3 = lut_interpolate(MICS_LUT_NH3, ratios_q16[2]) * to_ppm;  // NH3: 1 a 500 ppm
 }
 
 
@@ -86,7 +143,8 @@ void mics6814_calibrate(int16_t& out_r0_co, int16_t& out_r0_no2, int16_t& out_r0
     Serial.printf("MICS6814: R0 (CO)  calculado: %d\n", out_r0_co);
     Serial.printf("MICS6814: R0 (NO2) calculado: %d\n", out_r0_no2);
     Serial.printf("MICS6814: R0 (NH3) calculado: %d\n", out_r0_nh3);
-    Serial.println("MICS6814: Copie estes valores e passe-os para a função mics6814_init().");
+    Serial.println("MICS6814: Grave-os com mics6814_baseline_store(..., MICS_R0_SOURCE_MANUAL)\n"
+                   "MICS6814: ou envie o comando remoto \"mics_r0 <id> <co> <no2> <nh3>\".");
 }
 
 /**
@@ -102,35 +160,84 @@ bool mics6814_read_data(MICS6814_Data &data) {
     }
 
     // 2. Lê os valores ATUAIS (Rs - Resistência do Sensor)
-    //    Usando nossa função de leitura estável
-    data.raw_co = ads1115_read_stable_raw_value(ADS_CHANNEL_MICS_CO);
-    data.raw_no2 = ads1115_read_stable_raw_value(ADS_CHANNEL_MICS_NO2);
-    data.raw_nh3 = ads1115_read_stable_raw_value(ADS_CHANNEL_MICS_NH3);
-
-    // 3. Calcula os Ratios (Rs/R0)
-    float ratio_co = calculate_ratio(data.raw_co, g_r0_co);
-    float ratio_no2 = calculate_ratio(data.raw_no2, g_r0_no2);
-    float ratio_nh3 = calculate_ratio(data.raw_nh3, g_r0_nh3);
-
-    // 4. Converte os Ratios para PPM (Fórmulas do driver ESP-IDF)
-    //    As fórmulas podem precisar de ajuste fino, mas são um 
-    //    excelente ponto de partida.
-    
-    // CO (Monóxido de Carbono) - 1 a 1000 ppm
-    data.ppm_co = pow(ratio_co, -1.179f) * 4.385f;
-
-    // NO2 (Dióxido de Nitrogênio) - 0.05 a 10 ppm
-    data.ppm_no2 = pow(ratio_no2, 1.007f) / 6.855f;
-
-    // NH3 (Amônia) - 1 a 500 ppm
-    data.ppm_nh3 = pow(ratio_nh3, -1.67f) / 1.47f;
+    //    Uma única varredura dos três canais, com média por canal
+    if (!ads1115_scan_start(MICS_CHANNELS, sizeof(MICS_CHANNELS) / sizeof(MICS_CHANNELS[0])) ||
+        ads1115_scan_wait(ADS_SCAN_TIMEOUT_MS) != ADS_SCAN_DONE) {
+        Serial.println("MICS6814: ERRO - Varredura do ADS1115 falhou.");
+        return false;
+    }
+    // Variância das amostras brutas (contagens²): o ruído que sobrou para o
+    // filtro (ADS_FILTER_KIND). Só vai para o log; a estrutura fica no buffer
+    // RTC a cada amostra e não a carrega.
+    uint32_t var_co = 0, var_no2 = 0, var_nh3 = 0;
+    ads1115_scan_collect(ADS_CHANNEL_MICS_CO, data.raw_co, &var_co);
+    ads1115_scan_collect(ADS_CHANNEL_MICS_NO2, data.raw_no2, &var_no2);
+    ads1115_scan_collect(ADS_CHANNEL_MICS_NH3, data.raw_nh3, &var_nh3);
+
+    // 3. Calcula os Ratios (Rs/R0) e converte para PPM
+    uint32_t ratios_q16[3];
+    convert_reading(data, ratios_q16);
     
     data.isValid = true;
     
     // Log para depuração
     Serial.printf("MICS6814: Leituras Brutas (Rs): CO=%d, NO2=%d, NH3=%d\n", data.raw_co, data.raw_no2, data.raw_nh3);
-    Serial.printf("MICS6814: Ratios (Rs/R0): CO=%.2f, NO2=%.2f, NH3=%.2f\n", ratio_co, ratio_no2, ratio_nh3);
+    Serial.printf("MICS6814: Variância (contagens²): CO=%lu, NO2=%lu, NH3=%lu\n",
+                  (unsigned long)var_co, (unsigned long)var_no2, (unsigned long)var_nh3);
+    Serial.printf("MICS6814: Ratios (Rs/R0): CO=%.2f, NO2=%.2f, NH3=%.2f\n",
+                  ratios_q16[0] / 65536.0f, ratios_q16[1] / 65536.0f, ratios_q16[2] / 65536.0f);
     Serial.printf("MICS6814: PPM Calculados: CO=%.2f, NO2=%.2f, NH3=%.2f\n", data.ppm_co, data.ppm_no2, data.ppm_nh3);
 
     return true;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Sonda de aquecimento. (Função pública do .h)
+ */
+bool mics6814_warmup_settled() {
+    if (!ads1115_scan_start(MICS_CHANNELS, sizeof(MICS_CHANNELS) / sizeof(MICS_CHANNELS[0])) ||
+        ads1115_scan_wait(ADS_SCAN_TIMEOUT_MS) != ADS_SCAN_DONE) {
+        return false;
+    }
+
+    uint32_t worst_permille = 0;
+    for (size_t i = 0; i < 3; i++) {
+        int16_t value = 0;
+        ads1115_scan_collect(MICS_CHANNELS[i], value);
+        if (g_warmup_has_prev) {
+            int32_t reference = g_warmup_prev[i] > 0 ? g_warmup_prev[i] : 1;
+            uint32_t permille = (uint32_t)(abs((int32_t)value - g_warmup_prev[i]) * 1000L / reference);
+            if (permille > worst_permille) {
+                worst_permille = permille;
+            }
+        }
+        g_warmup_prev[i] = value;
+    }
+
+    if (!g_warmup_has_prev) {
+        g_warmup_has_prev = true;
+        return false;
+    }
+    Serial.printf("MICS6814: Aquecimento - maior variação entre sondas: %lu/1000\n", (unsigned long)worst_permille);
+    return worst_permille <= MICS_WARMUP_SETTLED_PERMILLE;
+}
+
+/**
+ * @brief Reconverte leituras guardadas para PPM. (Função pública do .h)
+ */
+size_t mics6814_convert_batch(MICS6814_Data* readings, size_t count, size_t stride) {
+    if (readings == nullptr || g_r0_co == 0 || g_r0_no2 == 0 || g_r0_nh3 == 0) {
+        return 0;
+    }
+    size_t converted = 0;
+    uint32_t ratios_q16[3];
+    uint8_t* cursor = reinterpret_cast<uint8_t*>(readings);
+    for (size_t i = 0; i < count; i++, cursor += stride) {
+        MICS6814_Data& reading = *reinterpret_cast<MICS6814_Data*>(cursor);
+        if (reading.isValid) {
+            convert_reading(reading, ratios_q16);
+            converted++;
+        }
+    }
+    return converted;
+}
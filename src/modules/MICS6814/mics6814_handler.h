@@ -4,6 +4,12 @@
 #include <Arduino.h>
 #include "modules/ADS1115/ads1115_handler.h" // Precisamos do nosso leitor de ADC
 
+// Variação máxima (milésimos) entre duas sondas de aquecimento para
+// considerar as saídas estáveis (ver mics6814_warmup_settled())
+#ifndef MICS_WARMUP_SETTLED_PERMILLE
+#define MICS_WARMUP_SETTLED_PERMILLE 5
+#endif
+
 // Estrutura para armazenar os dados lidos
 struct MICS6814_Data {
     // Valores de PPM (Partes por Milhão) calculados
@@ -47,7 +53,7 @@ void mics6814_calibrate(int16_t& out_r0_co, int16_t& out_r0_no2, int16_t& out_r0
  * @brief Lê os valores atuais do sensor (Rs) e os converte para PPM.
  *
  * @note PRESSUPÕE que o sensor já foi aquecido (Warm-up) por 1-3 minutos
- * (controlado pelo PowerManager no main.cpp).
+ * (controlado pelo escalonador de aquecimento, ver sensor_warmup.h).
  *
  * @param data Referência para a estrutura MICS6814_Data onde os dados 
  * calculados (PPM) serão armazenados.
@@ -55,4 +61,34 @@ void mics6814_calibrate(int16_t& out_r0_co, int16_t& out_r0_no2, int16_t& out_r0
  */
 bool mics6814_read_data(MICS6814_Data &data);
 
+/**
+ * @brief Sonda de aquecimento: lê os três canais e compara com a sonda anterior.
+ *
+ * O aquecedor leva as saídas a convergir exponencialmente; quando a maior
+ * variação relativa entre duas sondas consecutivas fica abaixo de
+ * MICS_WARMUP_SETTLED_PERMILLE, a leitura já está no regime. A primeira
+ * sonda de cada despertar só guarda a referência (retorna false).
+ *
+ * @note Chamada em intervalos fixos pelo escalonador (ver sensor_warmup.h).
+ * @return true se a inclinação se estabilizou.
+ */
+bool mics6814_warmup_settled();
+
+/**
+ * @brief Recalcula os PPM de leituras já feitas a partir dos valores brutos
+ * (raw_*) e dos R0 atuais. Ex: reprocessar o backlog após nova calibração
+ * (ver sample_buffer_reconvert_mics6814()).
+ *
+ * A conversão usa só aritmética inteira e as curvas tabeladas
+ * (mics6814_lut.h), sem pow() nem divisões em ponto flutuante.
+ *
+ * @param readings Primeira leitura a converter (in-place). Só as com isValid são tocadas.
+ * @param count Número de leituras.
+ * @param stride Distância em bytes entre leituras consecutivas: permite
+ * converter o campo MICS6814_Data de um vetor de estruturas maiores
+ * (ex: sizeof(StoredSample)).
+ * @return Quantas leituras foram convertidas (0 se os R0 não foram carregados).
+ */
+size_t mics6814_convert_batch(MICS6814_Data* readings, size_t count, size_t stride = sizeof(MICS6814_Data));
+
 #endif // MICS6814_HANDLER_H
\ No newline at end of file
@@ -0,0 +1,132 @@
+#ifndef MICS6814_LUT_H
+#define MICS6814_LUT_H
+
+// GERADO por tools/gen_mics6814_lut.py - não editar à mão.
+//
+// Curvas PPM x (Rs/R0) do MICS6814 (fórmulas do driver ESP-IDF) em
+// 16 segmentos lineares por oitava de Rs/R0, de 2^-7 a 2^6.
+// Valores em PPM x 1000000. Erro de interpolação < 0.5% na faixa.
+
+#include <stdint.h>
+
+#define MICS_LUT_RATIO_MIN_EXP (-7)
+#define MICS_LUT_RATIO_MAX_EXP (6)
+#define MICS_LUT_SEGMENT_BITS 4
+#define MICS_LUT_ENTRIES 209
+#define MICS_LUT_SCALE 1000000
+
+static constexpr uint32_t MICS_LUT_CO[MICS_LUT_ENTRIES] = {
+    1337735191u, 1245455839u, 1164290431u, 1092388491u, 1028284398u, 970802895u,
+    918991027u, 872068286u, 829389547u, 790417125u, 754699451u, 721854609u,
+    691557495u, 663529708u, 637531506u, 613355374u, 590820815u, 550064944u,
+    514217631u, 482461598u, 454149543u, 428762405u, 405879303u, 385155521u,
+    366306135u, 349093672u, 333318692u, 318812520u, 305431572u, 293052889u,
+    281570588u, 270893017u, 260940459u, 242940322u, 227108087u, 213082796u,
+    200578564u, 189366143u, 179259649u, 170106835u, 161781861u, 154179847u,
+    147212709u, 140805949u, 134896152u, 129429014u, 124357769u, 119641939u,
+    115246318u, 107296422u, 100303996u, 94109620u, 88587032u, 83634982u,
+    79171373u, 75128964u, 71452177u, 68094690u, 65017601u, 62188007u,
+    59577901u, 57163298u, 54923545u, 52840763u, 50899403u, 47388272u,
+    44300015u, 41564222u, 39125129u, 36938019u, 34966633u, 33181272u,
+    31557392u, 30074532u, 28715513u, 27465801u, 26313028u, 25246601u,
+    24257397u, 23337521u, 22480105u, 20929387u, 19565435u, 18357151u,
+    17279908u, 16313954u, 15443276u, 14654759u, 13937559u, 13282644u,
+    12682422u, 12130478u, 11621347u, 11150351u, 10713462u, 10307192u,
+    9928507u, 9243621u, 8641222u, 8107574u, 7631801u, 7205181u,
+    6820639u, 6472384u, 6155628u, 5866379u, 5601287u, 5357517u,
+    5132655u, 4924637u, 4731681u, 4552249u, 4385000u, 4082515u,
+    3816461u, 3580771u, 3370642u, 3182222u, 3012387u, 2858577u,
+    2718679u, 2590931u, 2473851u, 2366188u, 2266876u, 2175003u,
+    2089783u, 2010535u, 1936668u, 1803073u, 1685569u, 1581475u,
+    1488670u, 1405452u, 1330443u, 1262512u, 1200725u, 1144304u,
+    1092595u, 1045045u, 1001183u, 960606u, 922968u, 887968u,
+    855344u, 796341u, 744444u, 698470u, 657482u, 620729u,
+    587600u, 557598u, 530309u, 505390u, 482553u, 461552u,
+    442180u, 424259u, 407636u, 392178u, 377769u, 351710u,
+    328789u, 308485u, 290382u, 274149u, 259518u, 246267u,
+    234215u, 223210u, 213123u, 203848u, 195292u, 187377u,
+    180035u, 173208u, 166845u, 155335u, 145212u, 136245u,
+    128249u, 121080u, 114618u, 108766u, 103443u, 98582u,
+    94127u, 90031u, 86252u, 82757u, 79514u, 76499u,
+    73688u, 68605u, 64134u, 60173u, 56642u, 53476u,
+    50622u, 48037u, 45686u, 43540u, 41572u, 39763u,
+    38094u, 36550u, 35118u, 33786u, 32545u,
+};
+
+static constexpr uint32_t MICS_LUT_NO2[MICS_LUT_ENTRIES] = {
+    1102u, 1171u, 1240u, 1310u, 1379u, 1449u,
+    1518u, 1588u, 1657u, 1727u, 1796u, 1866u,
+    1935u, 2005u, 2075u, 2144u, 2214u, 2353u,
+    2493u, 2632u, 2772u, 2911u, 3051u, 3191u,
+    3330u, 3470u, 3610u, 3750u, 3890u, 4030u,
+    4169u, 4309u, 4449u, 4730u, 5010u, 5290u,
+    5571u, 5851u, 6132u, 6412u, 6693u, 6974u,
+    7255u, 7536u, 7817u, 8098u, 8380u, 8661u,
+    8942u, 9505u, 10068u, 10632u, 11195u, 11759u,
+    12323u, 12887u, 13451u, 14016u, 14581u, 15145u,
+    15710u, 16275u, 16841u, 17406u, 17971u, 19103u,
+    20234u, 21367u, 22499u, 23632u, 24766u, 25900u,
+    27034u, 28168u, 29303u, 30438u, 31573u, 32709u,
+    33845u, 34981u, 36118u, 38391u, 40666u, 42941u,
+    45217u, 47495u, 49772u, 52051u, 54330u, 56610u,
+    58891u, 61172u, 63454u, 65736u, 68019u, 70302u,
+    72586u, 77156u, 81727u, 86300u, 90875u, 95451u,
+    100029u, 104608u, 109189u, 113771u, 118354u, 122939u,
+    127525u, 132112u, 136700u, 141289u, 145879u, 155062u,
+    164249u, 173440u, 182634u, 191831u, 201031u, 210234u,
+    219440u, 228649u, 237860u, 247074u, 256290u, 265509u,
+    274729u, 283952u, 293177u, 311633u, 330096u, 348567u,
+    367044u, 385528u, 404018u, 422514u, 441015u, 459522u,
+    478034u, 496551u, 515073u, 533600u, 552131u, 570666u,
+    589206u, 626297u, 663403u, 700524u, 737658u, 774806u,
+    811966u, 849138u, 886321u, 923514u, 960719u, 997933u,
+    1035157u, 1072390u, 1109633u, 1146884u, 1184143u, 1258686u,
+    1333260u, 1407862u, 1482493u, 1557149u, 1631830u, 1706535u,
+    1781263u, 1856013u, 1930783u, 2005574u, 2080384u, 2155213u,
+    2230059u, 2304924u, 2379805u, 2529616u, 2679489u, 2829420u,
+    2979406u, 3129445u, 3279534u, 3429671u, 3579854u, 3730080u,
+    3880348u, 4030657u, 4181005u, 4331390u, 4481812u, 4632269u,
+    4782760u, 5083839u, 5385043u, 5686364u, 5987795u, 6289333u,
+    6590971u, 6892705u, 7194531u, 7496445u, 7798443u, 8100523u,
+    8402681u, 8704915u, 9007222u, 9309599u, 9612045u,
+};
+
+static constexpr uint32_t MICS_LUT_NH3[MICS_LUT_ENTRIES] = {
+    2247622208u, 2031206076u, 1846284408u, 1686883818u, 1548401534u, 1427241494u,
+    1320558998u, 1226078281u, 1141960053u, 1066703871u, 999075236u, 938050457u,
+    882774487u, 832528346u, 786703695u, 744782832u, 706322794u, 638313301u,
+    580201049u, 530108880u, 486590359u, 448515412u, 414990080u, 385299199u,
+    358864765u, 335215258u, 313962734u, 294785493u, 277414834u, 261624816u,
+    247224267u, 234050495u, 221964300u, 200592089u, 182330119u, 166588488u,
+    152912647u, 140947468u, 130412020u, 121081562u, 112774452u, 105342516u,
+    98663839u, 92637327u, 87178539u, 82216473u, 77691052u, 73551151u,
+    69753023u, 63036735u, 57297850u, 52350989u, 48053311u, 44293213u,
+    40982413u, 38050286u, 35439749u, 33104238u, 31005441u, 29111590u,
+    27396147u, 25836802u, 24414673u, 23113695u, 21920121u, 19809505u,
+    18006041u, 16451473u, 15100914u, 13919290u, 12878860u, 11957429u,
+    11137060u, 10403117u, 9743564u, 9148414u, 8609331u, 8119301u,
+    7672393u, 7263556u, 6888471u, 6225203u, 5658459u, 5169931u,
+    4745513u, 4374184u, 4047225u, 3757662u, 3499858u, 3269214u,
+    3061947u, 2874920u, 2705511u, 2551518u, 2411075u, 2282597u,
+    2164725u, 1956291u, 1778190u, 1624668u, 1491293u, 1374602u,
+    1271854u, 1180858u, 1099842u, 1027362u, 962227u, 903453u,
+    850216u, 801823u, 757688u, 717314u, 680272u, 614771u,
+    558802u, 510557u, 468644u, 431973u, 399684u, 371089u,
+    345629u, 322852u, 302383u, 283913u, 267183u, 251976u,
+    238106u, 225418u, 213778u, 193194u, 175605u, 160444u,
+    147273u, 135749u, 125602u, 116616u, 108615u, 101457u,
+    95025u, 89221u, 83963u, 79184u, 74826u, 70838u,
+    67180u, 60712u, 55185u, 50420u, 46281u, 42660u,
+    39471u, 36647u, 34133u, 31883u, 29862u, 28038u,
+    26386u, 24884u, 23514u, 22261u, 21112u, 19079u,
+    17342u, 15845u, 14544u, 13406u, 12404u, 11516u,
+    10726u, 10019u, 9384u, 8811u, 8292u, 7820u,
+    7389u, 6996u, 6634u, 5996u, 5450u, 4979u,
+    4570u, 4213u, 3898u, 3619u, 3371u, 3149u,
+    2949u, 2769u, 2606u, 2457u, 2322u, 2198u,
+    2085u, 1884u, 1713u, 1565u, 1436u, 1324u,
+    1225u, 1137u, 1059u, 989u, 927u, 870u,
+    819u, 772u, 730u, 691u, 655u,
+};
+
+#endif // MICS6814_LUT_H
@@ -0,0 +1,243 @@
+#include "binary_payload.h"
+#include <math.h>
+#include <time.h>
+
+// Tamanhos fixos de cada bloco do layout (BINARY_PAYLOAD_VERSION)
+static const size_t HEADER_FIXED_SIZE = 9;  // magic, version, flags, count, base_ts, id_len
+static const size_t LOCATION_SIZE = 22;
+static const size_t DIAG_FIXED_SIZE = 4;    // wakes, phase_count, counter_count
+static const size_t DIAG_PHASE_SIZE = 15;
+static const size_t DIAG_COUNTER_SIZE = 3;
+static const size_t SAMPLE_FIXED_SIZE = 5;  // dt + valid
+static const size_t SCD40_BLOCK_SIZE = 6;
+static const size_t MICS6814_BLOCK_SIZE = 18;
+static const size_t DSM501A_BLOCK_SIZE = 4;
+
+// ===================================================================
+// --- Escrita little-endian (Funções Privadas) ---
+// ===================================================================
+
+static uint8_t* put_u8(uint8_t* p, uint8_t v) {
+    *p++ = v;
+    return p;
+}
+
+static uint8_t* put_u16(uint8_t* p, uint16_t v) {
+    *p++ = (uint8_t)(v & 0xFF);
+    *p++ = (uint8_t)(v >> 8);
+    return p;
+}
+
+static uint8_t* put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        *p++ = (uint8_t)(v >> (8 * i));
+    }
+    return p;
+}
+
+static uint8_t* put_f32(uint8_t* p, float v) {
+    uint32_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return put_u32(p, bits);
+}
+
+/**
+ * @brief (Função Privada) Converte para inteiro escalado, saturando em [min_value, max_value].
+ * NaN/infinito viram null_value (fora da faixa), como o null de put_fixed() no JSON.
+ */
+static int32_t scale_clamped(float value, float scale, int32_t min_value, int32_t max_value, int32_t null_value) {
+    if (!isfinite(value)) return null_value;
+    float scaled = roundf(value * scale);
+    if (scaled < (float)min_value) return min_value;
+    if (scaled > (float)max_value) return max_value;
+    return (int32_t)scaled;
+}
+
+/**
+ * @brief (Função Privada) Coordenada em graus x 1e6 (BINARY_NULL_I32 se não for finita).
+ */
+static int32_t coordinate_e6(float degrees) {
+    if (!isfinite(degrees) || fabsf(degrees) > 180.0f) return BINARY_NULL_I32;
+    return (int32_t)lround((double)degrees * 1e6);
+}
+
+static uint8_t sample_valid_flags(const StoredSample& sample) {
+    uint8_t valid = 0;
+    if (sample.scd40.isValid) valid |= BINARY_SAMPLE_HAS_SCD40;
+    if (sample.mics6814.isValid) valid |= BINARY_SAMPLE_HAS_MICS6814;
+    if (sample.dsm501a.isValid) valid |= BINARY_SAMPLE_HAS_DSM501A;
+    return valid;
+}
+
+static size_t diag_encoded_size(const Diag_Report& diag) {
+    size_t size = DIAG_FIXED_SIZE;
+    for (int i = 0; i < DIAG_PHASE_COUNT; i++) {
+        if (diag.phases[i].count != 0) size += DIAG_PHASE_SIZE;
+    }
+    for (int i = 0; i < DIAG_COUNTER_COUNT; i++) {
+        if (diag.counters[i] != 0) size += DIAG_COUNTER_SIZE;
+    }
+    return size;
+}
+
+static uint8_t* put_diag(uint8_t* p, const Diag_Report& diag) {
+    p = put_u16(p, diag.wakes);
+
+    uint8_t phase_count = 0;
+    for (int i = 0; i < DIAG_PHASE_COUNT; i++) {
+        if (diag.phases[i].count != 0) phase_count++;
+    }
+    p = put_u8(p, phase_count);
+    for (int i = 0; i < DIAG_PHASE_COUNT; i++) {
+        const Diag_PhaseStats& stats = diag.phases[i];
+        if (stats.count == 0) {
+            continue;
+        }
+        p = put_u8(p, (uint8_t)i);
+        p = put_u16(p, stats.count);
+        p = put_u32(p, stats.total_us / 1000);
+        p = put_u32(p, stats.max_us / 1000);
+        p = put_u32(p, stats.min_free_heap);
+    }
+
+    uint8_t counter_count = 0;
+    for (int i = 0; i < DIAG_COUNTER_COUNT; i++) {
+        if (diag.counters[i] != 0) counter_count++;
+    }
+    p = put_u8(p, counter_count);
+    for (int i = 0; i < DIAG_COUNTER_COUNT; i++) {
+        if (diag.counters[i] != 0) {
+            p = put_u8(p, (uint8_t)i);
+            p = put_u16(p, diag.counters[i]);
+        }
+    }
+    return p;
+}
+
+static size_t sample_encoded_size(uint8_t valid) {
+    size_t size = SAMPLE_FIXED_SIZE;
+    if (valid & BINARY_SAMPLE_HAS_SCD40) size += SCD40_BLOCK_SIZE;
+    if (valid & BINARY_SAMPLE_HAS_MICS6814) size += MICS6814_BLOCK_SIZE;
+    if (valid & BINARY_SAMPLE_HAS_DSM501A) size += DSM501A_BLOCK_SIZE;
+    return size;
+}
+
+// ===================================================================
+// --- Funções Públicas ---
+// ===================================================================
+
+size_t binary_payload_encode(uint8_t* out, size_t capacity,
+                             const char* device_id,
+                             const StoredSample* samples, size_t count,
+                             const GPS_Data& gps_data,
+                             const Diag_Report* diag,
+                             size_t& out_encoded) {
+    out_encoded = 0;
+    if (count == 0) {
+        return 0;
+    }
+    if (count > 255) {
+        count = 255; // sample_count é um u8
+    }
+
+    size_t id_len = strlen(device_id);
+    if (id_len > 255) {
+        id_len = 255;
+    }
+
+    size_t header_size = HEADER_FIXED_SIZE + id_len;
+    if (gps_data.isValid) {
+        header_size += LOCATION_SIZE;
+    }
+    if (diag != nullptr) {
+        header_size += diag_encoded_size(*diag);
+    }
+
+    // Quantas amostras cabem junto com o cabeçalho?
+    size_t total = header_size;
+    size_t fit = 0;
+    while (fit < count) {
+        size_t next = sample_encoded_size(sample_valid_flags(samples[fit]));
+        if (total + next > capacity) {
+            break;
+        }
+        total += next;
+        fit++;
+    }
+    if (fit == 0) {
+        return 0;
+    }
+
+    uint32_t base_ts = samples[0].timestamp_utc_sec;
+    uint8_t* p = out;
+
+    p = put_u8(p, BINARY_PAYLOAD_MAGIC);
+    p = put_u8(p, BINARY_PAYLOAD_VERSION);
+    uint8_t flags = 0;
+    if (gps_data.isValid) {
+        flags |= BINARY_PAYLOAD_FLAG_LOCATION;
+        if (gps_data.from_cache) {
+            flags |= BINARY_PAYLOAD_FLAG_LOCATION_CACHED;
+        }
+    }
+    if (diag != nullptr) {
+        flags |= BINARY_PAYLOAD_FLAG_DIAG;
+    }
+    p = put_u8(p, flags);
+    p = put_u8(p, (uint8_t)fit);
+    p = put_u32(p, base_ts);
+    p = put_u8(p, (uint8_t)id_len);
+    memcpy(p, device_id, id_len);
+    p += id_len;
+
+    if (gps_data.isValid) {
+        p = put_u32(p, (uint32_t)coordinate_e6(gps_data.latitude));
+        p = put_u32(p, (uint32_t)coordinate_e6(gps_data.longitude));
+        p = put_u16(p, (uint16_t)(int16_t)scale_clamped(gps_data.altitude, 1.0f, INT16_MIN + 1, INT16_MAX, BINARY_NULL_I16));
+        p = put_u16(p, (uint16_t)scale_clamped(gps_data.accuracy, 100.0f, 0, UINT16_MAX - 1, BINARY_NULL_U16));
+        p = put_u8(p, (uint8_t)constrain(gps_data.satellites_used, 0, 255));
+        p = put_u8(p, (uint8_t)constrain(gps_data.satellites_visible, 0, 255));
+
+        time_t now_epoch_utc = time(NULL);
+        p = put_u32(p, (now_epoch_utc > (time_t)gps_data.fix_epoch_utc)
+                       ? (uint32_t)(now_epoch_utc - gps_data.fix_epoch_utc) : 0);
+        p = put_u32(p, gps_data.from_cache ? 0 : gps_data.ttff_ms);
+    }
+
+    if (diag != nullptr) {
+        p = put_diag(p, *diag);
+    }
+
+    for (size_t i = 0; i < fit; i++) {
+        const StoredSample& sample = samples[i];
+        uint8_t valid = sample_valid_flags(sample);
+
+        // Com sinal: uma amostra pode ser mais velha que a primeira se o NTP atrasou o relógio
+        p = put_u32(p, (uint32_t)(int32_t)((int64_t)sample.timestamp_utc_sec - (int64_t)base_ts));
+        p = put_u8(p, valid);
+
+        if (valid & BINARY_SAMPLE_HAS_SCD40) {
+            p = put_u16(p, (uint16_t)scale_clamped(sample.scd40.co2, 1.0f, 0, UINT16_MAX - 1, BINARY_NULL_U16));
+            p = put_u16(p, (uint16_t)(int16_t)scale_clamped(sample.scd40.temperature, 100.0f, INT16_MIN + 1, INT16_MAX,
+                                                             BINARY_NULL_I16));
+            p = put_u16(p, (uint16_t)scale_clamped(sample.scd40.humidity, 100.0f, 0, UINT16_MAX - 1, BINARY_NULL_U16));
+        }
+        if (valid & BINARY_SAMPLE_HAS_MICS6814) {
+            p = put_f32(p, sample.mics6814.ppm_co);
+            p = put_f32(p, sample.mics6814.ppm_no2);
+            p = put_f32(p, sample.mics6814.ppm_nh3);
+            p = put_u16(p, (uint16_t)sample.mics6814.raw_co);
+            p = put_u16(p, (uint16_t)sample.mics6814.raw_no2);
+            p = put_u16(p, (uint16_t)sample.mics6814.raw_nh3);
+        }
+        if (valid & BINARY_SAMPLE_HAS_DSM501A) {
+            p = put_u16(p, (uint16_t)scale_clamped(sample.dsm501a.low_pulse_occupancy_ratio_pm25, 100.0f, 0, UINT16_MAX - 1,
+                                                   BINARY_NULL_U16));
+            p = put_u16(p, (uint16_t)scale_clamped(sample.dsm501a.low_pulse_occupancy_ratio_pm10, 100.0f, 0, UINT16_MAX - 1,
+                                                   BINARY_NULL_U16));
+        }
+    }
+
+    out_encoded = fit;
+    return (size_t)(p - out);
+}
@@ -0,0 +1,92 @@
+#ifndef BINARY_PAYLOAD_H
+#define BINARY_PAYLOAD_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "modules/SampleBuffer/sample_buffer.h"
+#include "modules/ConnectivityHandler/comm_manager.h" // Para o tipo GPS_Data
+#include "modules/Diagnostics/diagnostics.h"
+
+// Formatos de payload disponíveis para a publicação MQTT
+#define PAYLOAD_FORMAT_JSON   0
+#define PAYLOAD_FORMAT_BINARY 1
+
+// Escolha do formato em tempo de compilação (config.h ou build_flags)
+#ifndef PAYLOAD_FORMAT
+#define PAYLOAD_FORMAT PAYLOAD_FORMAT_JSON
+#endif
+
+// Primeiro byte do payload binário. Não é ASCII, então o ingest distingue
+// um lote binário de um lote JSON (que sempre começa com '{').
+#define BINARY_PAYLOAD_MAGIC   0xB5
+#define BINARY_PAYLOAD_VERSION 1
+
+// Bits do campo 'flags' do cabeçalho
+#define BINARY_PAYLOAD_FLAG_LOCATION        0x01
+#define BINARY_PAYLOAD_FLAG_LOCATION_CACHED 0x02
+#define BINARY_PAYLOAD_FLAG_DIAG            0x04
+
+// Bits do campo 'valid' de cada amostra (grupos presentes)
+#define BINARY_SAMPLE_HAS_SCD40    0x01
+#define BINARY_SAMPLE_HAS_MICS6814 0x02
+#define BINARY_SAMPLE_HAS_DSM501A  0x04
+
+// Campos escalados sem valor (NaN/infinito): o equivalente ao null do JSON.
+// Valores válidos saturam um passo antes.
+#define BINARY_NULL_U16 0xFFFF
+#define BINARY_NULL_I16 INT16_MIN
+#define BINARY_NULL_I32 INT32_MIN
+
+/*
+ * Layout v1 (= BINARY_PAYLOAD_VERSION; little-endian). Decodificador de referência: tools/decode_payload.py
+ *
+ * Cabeçalho:
+ *   u8  magic (0xB5)       u8  version (BINARY_PAYLOAD_VERSION)
+ *   u8  flags              u8  sample_count
+ *   u32 base_ts (UTC)      u8  device_id_len, device_id[device_id_len]
+ *   [se FLAG_LOCATION]
+ *   i32 latitude_e6        i32 longitude_e6
+ *   i16 altitude_m         u16 accuracy_x100
+ *   u8  satellites_used    u8  satellites_visible
+ *   u32 fix_age_s          (FLAG_LOCATION_CACHED: fix de um ciclo anterior)
+ *   u32 ttff_ms            (tempo até o fix; 0 se em cache)
+ *   [se FLAG_DIAG]
+ *   u16 wakes              u8  phase_count
+ *   phase_count x { u8 phase_id, u16 count, u32 total_ms, u32 max_ms, u32 min_free_heap }
+ *   u8  counter_count
+ *   counter_count x { u8 counter_id, u16 value }
+ *   (ids = diag_phase_t / diag_counter_t; só fases executadas e contadores != 0)
+ *
+ * Cada amostra:
+ *   i32 dt (segundos desde base_ts; negativo se o relógio voltou)   u8 valid
+ *   [HAS_SCD40]    u16 co2_ppm, i16 temperature_x100, u16 humidity_x100
+ *   [HAS_MICS6814] f32 ppm_co, f32 ppm_no2, f32 ppm_nh3,
+ *                  i16 raw_co, i16 raw_no2, i16 raw_nh3
+ *   [HAS_DSM501A]  u16 lop_ratio_pm25_x100, u16 lop_ratio_pm10_x100
+ *   (escalados = BINARY_NULL_U16/_I16/_I32 e f32 = NaN: sem valor)
+ */
+
+/**
+ * @brief Codifica um lote de amostras no formato binário (BINARY_PAYLOAD_VERSION).
+ *
+ * Codifica o maior número de amostras (a partir da primeira) que cabe em
+ * 'capacity' bytes. O campo sample_count do cabeçalho reflete esse número.
+ *
+ * @param out Buffer de saída.
+ * @param capacity Tamanho do buffer de saída, em bytes.
+ * @param device_id Identificador do dispositivo (até 255 caracteres).
+ * @param samples Amostras do lote, da mais antiga para a mais nova.
+ * @param count Quantidade de amostras disponíveis em 'samples'.
+ * @param gps_data Localização do lote (incluída somente se isValid).
+ * @param diag Relatório de diagnóstico a anexar, ou nullptr.
+ * @param out_encoded Recebe a quantidade de amostras codificadas.
+ * @return Número de bytes escritos, ou 0 se nem o cabeçalho e uma amostra couberem.
+ */
+size_t binary_payload_encode(uint8_t* out, size_t capacity,
+                             const char* device_id,
+                             const StoredSample* samples, size_t count,
+                             const GPS_Data& gps_data,
+                             const Diag_Report* diag,
+                             size_t& out_encoded);
+
+#endif // BINARY_PAYLOAD_H
@@ -0,0 +1,405 @@
+#include "json_payload.h"
+#include <math.h>
+#include <time.h>
+
+// Grupos de sensores (bits) e colunas de cada grupo, na ordem do documento
+#define GROUP_SCD40    0x01
+#define GROUP_MICS6814 0x02
+#define GROUP_DSM501A  0x04
+
+struct JsonGroup {
+    uint8_t bit;
+    const char* key;
+};
+
+struct JsonColumn {
+    uint8_t group;
+    const char* key;
+};
+
+static const JsonGroup GROUPS[] = {
+    {GROUP_SCD40, "scd40"},
+    {GROUP_MICS6814, "mics6814"},
+    {GROUP_DSM501A, "dsm501a"},
+};
+
+typedef enum {
+    COLUMN_CO2 = 0,
+    COLUMN_TEMPERATURE,
+    COLUMN_HUMIDITY,
+    COLUMN_PPM_CO,
+    COLUMN_PPM_NO2,
+    COLUMN_PPM_NH3,
+    COLUMN_RAW_CO,
+    COLUMN_RAW_NO2,
+    COLUMN_RAW_NH3,
+    COLUMN_LOP_PM25,
+    COLUMN_LOP_PM10,
+    COLUMN_COUNT
+} json_column_t;
+
+static const JsonColumn COLUMNS[COLUMN_COUNT] = {
+    {GROUP_SCD40, "co2"},
+    {GROUP_SCD40, "temperature"},
+    {GROUP_SCD40, "humidity"},
+    {GROUP_MICS6814, "ppm_co"},
+    {GROUP_MICS6814, "ppm_no2"},
+    {GROUP_MICS6814, "ppm_nh3"},
+    {GROUP_MICS6814, "raw_co"},
+    {GROUP_MICS6814, "raw_no2"},
+    {GROUP_MICS6814, "raw_nh3"},
+    {GROUP_DSM501A, "lop_ratio_pm25"},
+    {GROUP_DSM501A, "lop_ratio_pm10"},
+};
+
+static const int64_t POW10[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+// Escritor sequencial com limite: ao estourar a capacidade, para de escrever
+// e marca 'overflow' (o chamador tenta um lote menor).
+struct JsonWriter {
+    uint8_t* out;
+    size_t capacity; // Bytes disponíveis, sem o terminador nulo
+    size_t len;
+    bool overflow;
+};
+
+// ===================================================================
+// --- Escrita (Funções Privadas) ---
+// ===================================================================
+
+static void put_raw(JsonWriter& w, const char* s, size_t n) {
+    if (w.overflow || n > w.capacity - w.len) {
+        w.overflow = true;
+        return;
+    }
+    memcpy(w.out + w.len, s, n);
+    w.len += n;
+}
+
+static void put_char(JsonWriter& w, char c) {
+    put_raw(w, &c, 1);
+}
+
+static void put_literal(JsonWriter& w, const char* s) {
+    put_raw(w, s, strlen(s));
+}
+
+static void put_uint(JsonWriter& w, uint64_t v) {
+    char digits[20];
+    size_t n = 0;
+    do {
+        digits[sizeof(digits) - 1 - n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    put_raw(w, digits + sizeof(digits) - n, n);
+}
+
+static void put_int(JsonWriter& w, int64_t v) {
+    if (v < 0) {
+        put_char(w, '-');
+        put_uint(w, (uint64_t)(-(v + 1)) + 1);
+    } else {
+        put_uint(w, (uint64_t)v);
+    }
+}
+
+/**
+ * @brief (Função Privada) Escreve 'value' em ponto fixo com 'decimals' casas (até 6).
+ *
+ * Com 'trim', omite os zeros à direita (e o ponto), como o ArduinoJson faz
+ * com um double já arredondado: 21.50 -> 21.5, 400.00 -> 400.
+ * NaN, infinito ou valores fora da faixa viram null.
+ */
+static void put_fixed(JsonWriter& w, double value, uint8_t decimals, bool trim) {
+    double scaled = round(value * (double)POW10[decimals]);
+    if (!isfinite(scaled) || fabs(scaled) > 9.0e15) {
+        put_literal(w, "null");
+        return;
+    }
+
+    int64_t fixed = (int64_t)scaled;
+    if (fixed < 0) {
+        put_char(w, '-');
+        fixed = -fixed;
+    }
+    put_uint(w, (uint64_t)(fixed / POW10[decimals]));
+
+    uint64_t frac = (uint64_t)(fixed % POW10[decimals]);
+    uint8_t digits = decimals;
+    if (trim) {
+        while (digits > 0 && frac % 10 == 0) {
+            frac /= 10;
+            digits--;
+        }
+    }
+    if (digits == 0) {
+        return;
+    }
+
+    char text[8];
+    text[0] = '.';
+    for (int i = digits; i > 0; i--) {
+        text[i] = (char)('0' + frac % 10);
+        frac /= 10;
+    }
+    put_raw(w, text, digits + 1);
+}
+
+static void put_string(JsonWriter& w, const char* s) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    put_char(w, '"');
+    for (; *s != '\0'; s++) {
+        uint8_t c = (uint8_t)*s;
+        if (c == '"' || c == '\\') {
+            put_char(w, '\\');
+            put_char(w, (char)c);
+        } else if (c < 0x20) {
+            char escaped[6] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0x0F]};
+            put_raw(w, escaped, sizeof(escaped));
+        } else {
+            put_char(w, (char)c);
+        }
+    }
+    put_char(w, '"');
+}
+
+/**
+ * @brief (Função Privada) Escreve ",\"key\":" (ou sem a vírgula, se 'first').
+ */
+static void put_key(JsonWriter& w, const char* key, bool first = false) {
+    if (!first) {
+        put_char(w, ',');
+    }
+    put_char(w, '"');
+    put_literal(w, key);
+    put_literal(w, "\":");
+}
+
+// ===================================================================
+// --- Documento (Funções Privadas) ---
+// ===================================================================
+
+static uint8_t sample_groups(const StoredSample& sample) {
+    uint8_t groups = 0;
+    if (sample.scd40.isValid) groups |= GROUP_SCD40;
+    if (sample.mics6814.isValid) groups |= GROUP_MICS6814;
+    if (sample.dsm501a.isValid) groups |= GROUP_DSM501A;
+    return groups;
+}
+
+static void put_column_value(JsonWriter& w, const StoredSample& sample, json_column_t column) {
+    switch (column) {
+        case COLUMN_CO2:         put_fixed(w, sample.scd40.co2, 2, true); break;
+        case COLUMN_TEMPERATURE: put_fixed(w, sample.scd40.temperature, 2, true); break;
+        case COLUMN_HUMIDITY:    put_fixed(w, sample.scd40.humidity, 2, true); break;
+        case COLUMN_PPM_CO:      put_fixed(w, sample.mics6814.ppm_co, 2, true); break;
+        case COLUMN_PPM_NO2:     put_fixed(w, sample.mics6814.ppm_no2, 2, true); break;
+        case COLUMN_PPM_NH3:     put_fixed(w, sample.mics6814.ppm_nh3, 2, true); break;
+        case COLUMN_RAW_CO:      put_int(w, sample.mics6814.raw_co); break;
+        case COLUMN_RAW_NO2:     put_int(w, sample.mics6814.raw_no2); break;
+        case COLUMN_RAW_NH3:     put_int(w, sample.mics6814.raw_nh3); break;
+        case COLUMN_LOP_PM25:    put_fixed(w, sample.dsm501a.low_pulse_occupancy_ratio_pm25, 2, true); break;
+        case COLUMN_LOP_PM10:    put_fixed(w, sample.dsm501a.low_pulse_occupancy_ratio_pm10, 2, true); break;
+        default:                 put_literal(w, "null"); break;
+    }
+}
+
+static void put_location(JsonWriter& w, const GPS_Data& gps_data) {
+    put_key(w, "location");
+    put_char(w, '{');
+    put_key(w, "latitude", true);
+    put_fixed(w, gps_data.latitude, 6, false);
+    put_key(w, "longitude");
+    put_fixed(w, gps_data.longitude, 6, false);
+    put_key(w, "accuracy_m");
+    put_fixed(w, gps_data.accuracy, 2, true);
+    put_key(w, "satellites_used");
+    put_int(w, gps_data.satellites_used);
+    put_key(w, "satellites_visible");
+    put_int(w, gps_data.satellites_visible);
+    put_key(w, "altitude_m");
+    put_fixed(w, gps_data.altitude, 2, true);
+
+    time_t now_epoch_utc = time(NULL);
+    put_key(w, "age_s");
+    put_uint(w, (now_epoch_utc > (time_t)gps_data.fix_epoch_utc)
+                ? (uint64_t)(now_epoch_utc - gps_data.fix_epoch_utc) : 0);
+    put_key(w, "cached");
+    put_literal(w, gps_data.from_cache ? "true" : "false");
+    if (!gps_data.from_cache) {
+        put_key(w, "ttff_ms");
+        put_uint(w, gps_data.ttff_ms);
+    }
+    put_char(w, '}');
+}
+
+static void put_diag(JsonWriter& w, const Diag_Report& diag) {
+    put_key(w, "diag");
+    put_char(w, '{');
+    put_key(w, "wakes", true);
+    put_uint(w, diag.wakes);
+
+    put_key(w, "ph");
+    put_char(w, '{');
+    bool first = true;
+    for (int i = 0; i < DIAG_PHASE_COUNT; i++) {
+        const Diag_PhaseStats& stats = diag.phases[i];
+        if (stats.count == 0) {
+            continue;
+        }
+        put_key(w, diag_phase_name((diag_phase_t)i), first);
+        first = false;
+        put_char(w, '[');
+        put_uint(w, stats.count);
+        put_char(w, ',');
+        put_uint(w, stats.total_us / 1000);
+        put_char(w, ',');
+        put_uint(w, stats.max_us / 1000);
+        put_char(w, ',');
+        put_uint(w, stats.min_free_heap);
+        put_char(w, ']');
+    }
+    put_char(w, '}');
+
+    put_key(w, "cnt");
+    put_char(w, '{');
+    first = true;
+    for (int i = 0; i < DIAG_COUNTER_COUNT; i++) {
+        if (diag.counters[i] == 0) {
+            continue;
+        }
+        put_key(w, diag_counter_name((diag_counter_t)i), first);
+        first = false;
+        put_uint(w, diag.counters[i]);
+    }
+    put_literal(w, "}}");
+}
+
+/**
+ * @brief (Função Privada) Escreve o documento completo com as 'count' primeiras amostras.
+ */
+static void put_document(JsonWriter& w, const char* device_id,
+                         const StoredSample* samples, size_t count,
+                         const GPS_Data& gps_data, const Diag_Report* diag) {
+    uint32_t base_ts = samples[0].timestamp_utc_sec;
+
+    put_char(w, '{');
+    put_key(w, "deviceId", true);
+    put_string(w, device_id);
+    put_key(w, "v");
+    put_uint(w, 1);
+    put_key(w, "base_ts");
+    put_uint(w, base_ts);
+
+    char time_str[32];
+    time_t base_epoch_utc = (time_t)base_ts;
+    struct tm tm_utc;
+    gmtime_r(&base_epoch_utc, &tm_utc);
+    strftime(time_str, sizeof(time_str), "%Y-%m-%dT%H:%M:%SZ", &tm_utc);
+    put_key(w, "datetime_utc_str");
+    put_string(w, time_str);
+
+    put_key(w, "dt");
+    put_char(w, '[');
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            put_char(w, ',');
+        }
+        put_int(w, (int64_t)samples[i].timestamp_utc_sec - (int64_t)base_ts);
+    }
+    put_char(w, ']');
+
+    // Só cria os grupos de sensores que têm ao menos uma leitura válida
+    uint8_t present = 0;
+    for (size_t i = 0; i < count; i++) {
+        present |= sample_groups(samples[i]);
+    }
+
+    for (size_t g = 0; g < sizeof(GROUPS) / sizeof(GROUPS[0]); g++) {
+        if (!(present & GROUPS[g].bit)) {
+            continue;
+        }
+        put_key(w, GROUPS[g].key);
+        put_char(w, '{');
+        bool first = true;
+        for (int c = 0; c < COLUMN_COUNT; c++) {
+            if (COLUMNS[c].group != GROUPS[g].bit) {
+                continue;
+            }
+            put_key(w, COLUMNS[c].key, first);
+            first = false;
+            put_char(w, '[');
+            for (size_t i = 0; i < count; i++) {
+                if (i > 0) {
+                    put_char(w, ',');
+                }
+                if (sample_groups(samples[i]) & GROUPS[g].bit) {
+                    put_column_value(w, samples[i], (json_column_t)c);
+                } else {
+                    put_literal(w, "null");
+                }
+            }
+            put_char(w, ']');
+        }
+        put_char(w, '}');
+    }
+
+    if (gps_data.isValid) {
+        put_location(w, gps_data);
+    }
+    if (diag != nullptr) {
+        put_diag(w, *diag);
+    }
+    put_char(w, '}');
+}
+
+// ===================================================================
+// --- Funções Públicas ---
+// ===================================================================
+
+size_t json_payload_encode(uint8_t* out, size_t capacity,
+                           const char* device_id,
+                           const StoredSample* samples, size_t count,
+                           const GPS_Data& gps_data,
+                           const Diag_Report* diag,
+                           size_t& out_encoded) {
+    out_encoded = 0;
+    if (count == 0 || capacity == 0) {
+        return 0;
+    }
+
+    // O documento só cresce com o lote: tenta o lote inteiro (caso comum) e,
+    // se não couber, busca binária pelo maior lote que cabe.
+    size_t best = 0;
+    size_t written = 0;
+    size_t last = 0;
+    size_t low = 1;
+    size_t high = count;
+    size_t n = count;
+    while (low <= high) {
+        JsonWriter w = {out, capacity - 1, 0, false};
+        put_document(w, device_id, samples, n, gps_data, diag);
+        last = n;
+        if (!w.overflow) {
+            best = n;
+            written = w.len;
+            low = n + 1;
+        } else {
+            high = n - 1;
+        }
+        n = low + (high - low) / 2;
+    }
+    if (best == 0) {
+        return 0;
+    }
+
+    // A última tentativa pode ter sido maior que 'best' (e ficado incompleta)
+    if (last != best) {
+        JsonWriter w = {out, capacity - 1, 0, false};
+        put_document(w, device_id, samples, best, gps_data, diag);
+        written = w.len;
+    }
+    out[written] = '\0';
+    out_encoded = best;
+    return written;
+}
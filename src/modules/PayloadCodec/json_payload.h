@@ -0,0 +1,54 @@
+#ifndef JSON_PAYLOAD_H
+#define JSON_PAYLOAD_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "modules/SampleBuffer/sample_buffer.h"
+#include "modules/ConnectivityHandler/comm_manager.h" // Para o tipo GPS_Data
+#include "modules/Diagnostics/diagnostics.h"
+
+/*
+ * Lote JSON "colunar" (batch v1), escrito diretamente no buffer de saída:
+ * sem JsonDocument, sem String e sem nenhuma alocação no heap (o publish
+ * acontece logo após o handshake TLS, com o heap fragmentado).
+ *
+ * {"deviceId":..,"v":1,"base_ts":..,"datetime_utc_str":..,"dt":[0,900,..],
+ *  "scd40":{"co2":[..],"temperature":[..],"humidity":[..]},
+ *  "mics6814":{"ppm_co":[..],..,"raw_nh3":[..]},
+ *  "dsm501a":{"lop_ratio_pm25":[..],"lop_ratio_pm10":[..]},
+ *  "location":{..},
+ *  "diag":{"wakes":4,"ph":{"gprs":[n,total_ms,max_ms,min_heap],..},"cnt":{"mqtt_retry":1,..}}}
+ *
+ * Os timestamps são deslocamentos (segundos) em relação a base_ts. Só os
+ * grupos de sensores com ao menos uma leitura válida aparecem; uma leitura
+ * inválida é null na sua posição. Os valores reais são formatados em ponto
+ * fixo: 2 casas (zeros à direita omitidos) e 6 casas para latitude/longitude.
+ * O bloco "diag" (ver Diagnostics) traz só as fases executadas e os
+ * contadores diferentes de zero.
+ */
+
+/**
+ * @brief Codifica um lote de amostras em JSON (batch v1).
+ *
+ * Codifica o maior número de amostras (a partir da primeira) cujo documento
+ * cabe em 'capacity' bytes, incluindo o terminador nulo. Nunca escreve além
+ * de 'capacity'.
+ *
+ * @param out Buffer de saída (recebe o texto terminado em '\0').
+ * @param capacity Tamanho do buffer de saída, em bytes.
+ * @param device_id Identificador do dispositivo.
+ * @param samples Amostras do lote, da mais antiga para a mais nova.
+ * @param count Quantidade de amostras disponíveis em 'samples'.
+ * @param gps_data Localização do lote (incluída somente se isValid).
+ * @param diag Relatório de diagnóstico a anexar, ou nullptr.
+ * @param out_encoded Recebe a quantidade de amostras codificadas.
+ * @return Tamanho do documento (sem o '\0'), ou 0 se nem uma amostra couber.
+ */
+size_t json_payload_encode(uint8_t* out, size_t capacity,
+                           const char* device_id,
+                           const StoredSample* samples, size_t count,
+                           const GPS_Data& gps_data,
+                           const Diag_Report* diag,
+                           size_t& out_encoded);
+
+#endif // JSON_PAYLOAD_H
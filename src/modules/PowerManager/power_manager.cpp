@@ -1,12 +1,37 @@
 #include "power_manager.h"
 #include "config.h" 
+#include "modules/Diagnostics/diagnostics.h"
+#include "modules/UlpSampler/ulp_sampler.h"
+#include "modules/WakeManager/wake_manager.h"
+#if ULP_SAMPLER_ENABLED
+#include "driver/gpio.h"
+#endif
 
 // Fatores de conversão para o tempo de sleep
 #define uS_TO_S_FACTOR 1000000ULL
 #define MINUTES_TO_uS_FACTOR (60ULL * uS_TO_S_FACTOR)
 
+// Estado do trilho dos sensores neste despertar
+static bool g_rail_on = false;
+static bool g_rail_held = false; // Ligado desde antes do boot (retido no deep sleep)
+static uint32_t g_rail_on_ms = 0;
+
 void setup_sensor_power() {
     pinMode(SENSOR_POWER_CTRL_PIN, OUTPUT);
+#if ULP_SAMPLER_ENABLED
+    // O trilho ficou retido ligado durante o sono (ver ulp_sampler_start()):
+    // escreve o mesmo nível antes de soltar a retenção, para não desligá-lo
+    if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_UNDEFINED) {
+        digitalWrite(SENSOR_POWER_CTRL_PIN, HIGH);
+        gpio_hold_dis((gpio_num_t)SENSOR_POWER_CTRL_PIN);
+        g_rail_on = true;
+        g_rail_held = true;
+        if (Serial) {
+            Serial.println("PowerManager: Sensor power control initialized. Sensors kept ON (ULP).");
+        }
+        return;
+    }
+#endif
     // Garante que os sensores comecem desligados
     // Para MOSFET Canal N (low-side), NÍVEL BAIXO desliga
     digitalWrite(SENSOR_POWER_CTRL_PIN, LOW); 
@@ -21,15 +46,24 @@ void power_sensors_on() {
     }
     // Para MOSFET Canal N (low-side), NÍVEL ALTO liga
     digitalWrite(SENSOR_POWER_CTRL_PIN, HIGH);
-    
-    if (Serial) {
-        Serial.printf("PowerManager: Waiting %dms for sensor stabilization...\n", SENSOR_STABILIZATION_DELAY_MS);
+    if (!g_rail_on) {
+        g_rail_on = true;
+        g_rail_on_ms = millis();
     }
-    delay(SENSOR_STABILIZATION_DELAY_MS); // Delay para estabilização dos sensores
-    
+    if (!g_rail_held) {
+        delay(SENSOR_RAIL_SETTLE_MS); // Só o trilho assentar; o aquecimento é por sensor
+    }
+
     if (Serial) {
-        Serial.println("PowerManager: Sensors presumed ON and stabilized.");
+        Serial.println("PowerManager: Sensors ON (aquecimento controlado por sensor).");
+    }
+}
+
+uint32_t sensor_power_elapsed_ms() {
+    if (!g_rail_on) {
+        return 0;
     }
+    return g_rail_held ? UINT32_MAX : millis() - g_rail_on_ms;
 }
 
 void power_sensors_off() {
@@ -38,6 +72,8 @@ void power_sensors_off() {
     }
     // Para MOSFET Canal N (low-side), NÍVEL BAIXO desliga
     digitalWrite(SENSOR_POWER_CTRL_PIN, LOW);
+    g_rail_on = false;
+    g_rail_held = false;
     delay(100); // Pequeno delay para garantir o corte total
     if (Serial) {
         Serial.println("PowerManager: Sensors OFF.");
@@ -47,6 +83,8 @@ void power_sensors_off() {
 void enter_deep_sleep() {
     uint64_t sleep_time_us = TIME_TO_SLEEP_INTERVAL_MINUTES * MINUTES_TO_uS_FACTOR;
 
+    diag_wake_end(); // Tempo acordado deste despertar (vai no próximo upload)
+
     if (Serial) {
         Serial.printf("PowerManager: Entering Deep Sleep for %llu seconds (%d minutes)...\n", sleep_time_us / uS_TO_S_FACTOR, TIME_TO_SLEEP_INTERVAL_MINUTES);
         Serial.flush(); // Garante que a mensagem serial seja enviada antes de dormir
@@ -54,6 +92,12 @@ void enter_deep_sleep() {
     
     // Configura a fonte de despertar (Timer)
     esp_sleep_enable_timer_wakeup(sleep_time_us);
+    wake_prepare_sleep();
+
+#if ULP_SAMPLER_ENABLED
+    // O ULP continua amostrando o DSM501A (trilho dos sensores retido ligado)
+    ulp_sampler_start();
+#endif
     
     // Opcional: Adicionar mais configurações de sleep se necessário, como desligar domínios RTC
     // esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_OFF);
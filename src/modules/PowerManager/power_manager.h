@@ -10,13 +10,26 @@
  */
 void setup_sensor_power();
 
+// Espera após ligar o trilho, até os sensores responderem no I2C (o SCD40
+// leva até 1000 ms do power-up ao idle). O aquecimento de cada sensor é
+// tratado à parte (ver sensor_warmup.h).
+#ifndef SENSOR_RAIL_SETTLE_MS
+#define SENSOR_RAIL_SETTLE_MS 1000
+#endif
+
 /**
  * @brief Liga a alimentação dos sensores através do MOSFET.
- * Inclui um delay para a estabilização dos sensores.
- * O tempo de delay deve ser ajustado conforme o sensor mais lento para estabilizar.
+ * Só espera o trilho assentar (SENSOR_RAIL_SETTLE_MS); não espera aquecimento.
  */
 void power_sensors_on();
 
+/**
+ * @brief Tempo desde que o trilho dos sensores foi ligado, em ms.
+ * @return 0 com o trilho desligado; UINT32_MAX se ele ficou ligado durante
+ * o deep sleep anterior (sensores já aquecidos).
+ */
+uint32_t sensor_power_elapsed_ms();
+
 /**
  * @brief Desliga a alimentação dos sensores através do MOSFET.
  */
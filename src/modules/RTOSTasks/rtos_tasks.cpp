@@ -0,0 +1,71 @@
+#include "rtos_tasks.h"
+#include "modules/ConnectivityHandler/comm_manager.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/event_groups.h>
+
+// Bits do grupo de eventos usado no "join" das tarefas
+#define RTOS_BIT_NETWORK_DONE (1 << 0)
+
+static EventGroupHandle_t g_cycle_events = NULL;
+static volatile bool g_network_ok = false;
+
+/**
+ * @brief (Tarefa) Levanta a rede celular e sinaliza o término.
+ */
+static void network_task(void* pvParameters) {
+    (void)pvParameters;
+
+    Serial.println(F("RTOSTasks: [rede] Iniciando modem e registro em paralelo..."));
+    g_network_ok = comm_bring_up_network();
+    Serial.printf("RTOSTasks: [rede] Concluída (ok: %d).\n", g_network_ok);
+
+    xEventGroupSetBits(g_cycle_events, RTOS_BIT_NETWORK_DONE);
+    vTaskDelete(NULL);
+}
+
+bool rtos_run_acquisition_stage(rtos_sensor_stage_fn sensor_stage) {
+    g_network_ok = false;
+
+    g_cycle_events = xEventGroupCreate();
+    if (g_cycle_events == NULL) {
+        Serial.println(F("RTOSTasks: AVISO - Falha ao criar o grupo de eventos. Executando em sequência."));
+        sensor_stage();
+        return comm_bring_up_network();
+    }
+
+    BaseType_t created = xTaskCreatePinnedToCore(
+        network_task,
+        "network_task",
+        RTOS_NETWORK_TASK_STACK_SIZE,
+        NULL,
+        RTOS_NETWORK_TASK_PRIORITY,
+        NULL,
+        RTOS_NETWORK_TASK_CORE
+    );
+
+    if (created != pdPASS) {
+        Serial.println(F("RTOSTasks: AVISO - Falha ao criar a tarefa de rede. Executando em sequência."));
+        vEventGroupDelete(g_cycle_events);
+        g_cycle_events = NULL;
+        sensor_stage();
+        return comm_bring_up_network();
+    }
+
+    // Ramo dos sensores roda na tarefa atual (loopTask), sem custo extra de pilha.
+    sensor_stage();
+
+    Serial.println(F("RTOSTasks: [sensores] Concluída. Aguardando a tarefa de rede..."));
+    unsigned long join_start = millis();
+
+    // comm_bring_up_network() tem seus próprios timeouts, então a espera é limitada.
+    xEventGroupWaitBits(g_cycle_events, RTOS_BIT_NETWORK_DONE, pdTRUE, pdTRUE, portMAX_DELAY);
+
+    Serial.printf("RTOSTasks: Join concluído (espera pela rede: %lu ms).\n", millis() - join_start);
+
+    vEventGroupDelete(g_cycle_events);
+    g_cycle_events = NULL;
+
+    return g_network_ok;
+}
@@ -0,0 +1,47 @@
+#ifndef RTOS_TASKS_H
+#define RTOS_TASKS_H
+
+#include <Arduino.h>
+
+// Parâmetros da tarefa de rede (modem + registro + GPRS).
+// Podem ser sobrescritos no config.h.
+#ifndef RTOS_NETWORK_TASK_STACK_SIZE
+#define RTOS_NETWORK_TASK_STACK_SIZE 8192
+#endif
+
+#ifndef RTOS_NETWORK_TASK_PRIORITY
+#define RTOS_NETWORK_TASK_PRIORITY 1
+#endif
+
+// O loop() do Arduino roda no core 1; a rede vai para o core 0.
+#ifndef RTOS_NETWORK_TASK_CORE
+#define RTOS_NETWORK_TASK_CORE 0
+#endif
+
+/**
+ * @brief Função que executa a etapa de sensores (ligar, aquecer, ler, desligar).
+ */
+typedef void (*rtos_sensor_stage_fn)(void);
+
+/**
+ * @brief Executa a etapa de aquisição do ciclo de despertar de forma concorrente.
+ *
+ * Grafo de tarefas:
+ *
+ *            +--> [network_task] comm_bring_up_network() --+
+ *   fork ----+                                             +--> join
+ *            +--> [tarefa atual] sensor_stage()  ----------+
+ *
+ * A tarefa de rede liga o modem, aguarda o registro e conecta o GPRS enquanto
+ * a tarefa que chamou esta função executa o aquecimento e a leitura dos
+ * sensores. A função só retorna quando ambos os ramos terminaram, de modo que
+ * o perform_communication_cycle() encontra a rede já pronta.
+ *
+ * @note Se a tarefa de rede não puder ser criada, executa tudo em sequência.
+ *
+ * @param sensor_stage Função da etapa de sensores (executada na tarefa atual).
+ * @return true se a rede foi levantada com sucesso, false caso contrário.
+ */
+bool rtos_run_acquisition_stage(rtos_sensor_stage_fn sensor_stage);
+
+#endif // RTOS_TASKS_H
@@ -40,6 +40,11 @@ bool scd40_init() {
     return true;
 }
 
+bool scd40_data_ready() {
+    bool dataReady = false;
+    return scd4x.getDataReadyStatus(dataReady) == 0 && dataReady;
+}
+
 bool scd40_read_measurements(SCD40_Data &data) {
 
     uint16_t error;
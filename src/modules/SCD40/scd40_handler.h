@@ -20,6 +20,14 @@ struct SCD40_Data {
  */
 bool scd40_init();
 
+/**
+ * @brief Consulta (sem esperar) o flag "Data Ready" do sensor.
+ * Usada pelo escalonador de aquecimento para ler o SCD40 assim que a
+ * primeira medição periódica termina (~5 s após o scd40_init()).
+ * @return true se há medição nova disponível.
+ */
+bool scd40_data_ready();
+
 /**
  * @brief Realiza a leitura dos dados do sensor SCD40.
  * * Verifica se novos dados estão disponíveis e, em caso afirmativo, lê os valores
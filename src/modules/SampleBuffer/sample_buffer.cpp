@@ -0,0 +1,114 @@
+#include "sample_buffer.h"
+#include <time.h>
+
+// ===================================================================
+// --- Variáveis na memória RTC ---
+// RTC_DATA_ATTR mantém os valores durante o deep sleep. Elas só são
+// zeradas em um boot "frio" (energização ou reset).
+// ===================================================================
+
+RTC_DATA_ATTR static StoredSample g_samples[SAMPLE_BUFFER_CAPACITY];
+RTC_DATA_ATTR static uint16_t g_head = 0;  // Posição da amostra mais antiga
+RTC_DATA_ATTR static uint16_t g_count = 0; // Amostras pendentes
+RTC_DATA_ATTR static uint16_t g_wakes_since_upload = 0;
+RTC_DATA_ATTR static bool g_clock_synced = false; // Relógio acertado desde o boot frio
+
+void sample_buffer_register_wake() {
+    if (g_wakes_since_upload < UINT16_MAX) {
+        g_wakes_since_upload++;
+    }
+    Serial.printf("SampleBuffer: Despertar %u desde o último upload (%u amostras pendentes).\n",
+                  g_wakes_since_upload, g_count);
+}
+
+bool sample_buffer_upload_due() {
+    // Sem hora da rede, as amostras seriam publicadas com carimbos de 1970
+    if (!g_clock_synced || g_wakes_since_upload >= UPLOAD_EVERY_N_WAKES) {
+        return true;
+    }
+    // A amostra deste despertar vai encher o buffer
+    return (g_count + 1) >= SAMPLE_BUFFER_CAPACITY;
+}
+
+void sample_buffer_push(const SCD40_Data& scd_data,
+                        const MICS6814_Data& mics_data,
+                        const DSM501A_Data& dsm_data) {
+    uint16_t slot;
+
+    if (g_count < SAMPLE_BUFFER_CAPACITY) {
+        slot = (g_head + g_count) % SAMPLE_BUFFER_CAPACITY;
+        g_count++;
+    } else {
+        // Buffer cheio: sobrescreve a amostra mais antiga
+        slot = g_head;
+        g_head = (g_head + 1) % SAMPLE_BUFFER_CAPACITY;
+        Serial.println("SampleBuffer: AVISO - Buffer cheio. Amostra mais antiga descartada.");
+    }
+
+    time_t now_epoch_utc;
+    time(&now_epoch_utc);
+
+    StoredSample& sample = g_samples[slot];
+    sample.timestamp_utc_sec = (uint32_t)now_epoch_utc;
+    sample.scd40 = scd_data;
+    sample.mics6814 = mics_data;
+    sample.dsm501a = dsm_data;
+
+    Serial.printf("SampleBuffer: Amostra armazenada (%u/%d).\n", g_count, SAMPLE_BUFFER_CAPACITY);
+}
+
+void sample_buffer_clock_synced(int64_t step_s) {
+    if (g_clock_synced) {
+        return;
+    }
+    g_clock_synced = true;
+    for (uint16_t i = 0; i < g_count; i++) {
+        StoredSample& sample = g_samples[(g_head + i) % SAMPLE_BUFFER_CAPACITY];
+        sample.timestamp_utc_sec = (uint32_t)((int64_t)sample.timestamp_utc_sec + step_s);
+    }
+    if (g_count > 0) {
+        Serial.printf("SampleBuffer: %u amostra(s) reposicionadas no horário da rede (%+lld s).\n", g_count,
+                      (long long)step_s);
+    }
+}
+
+size_t sample_buffer_reconvert_mics6814() {
+    // O buffer é circular: as pendentes formam no máximo dois trechos contíguos
+    size_t first_run = g_count;
+    if (g_head + first_run > SAMPLE_BUFFER_CAPACITY) {
+        first_run = SAMPLE_BUFFER_CAPACITY - g_head;
+    }
+    size_t converted = mics6814_convert_batch(&g_samples[g_head].mics6814, first_run, sizeof(StoredSample));
+    converted += mics6814_convert_batch(&g_samples[0].mics6814, g_count - first_run, sizeof(StoredSample));
+
+    if (converted > 0) {
+        Serial.printf("SampleBuffer: %u amostra(s) do MICS6814 reconvertidas com a nova calibração.\n",
+                      (unsigned)converted);
+    }
+    return converted;
+}
+
+size_t sample_buffer_count() {
+    return g_count;
+}
+
+bool sample_buffer_peek(size_t index, StoredSample& out) {
+    if (index >= g_count) {
+        return false;
+    }
+    out = g_samples[(g_head + index) % SAMPLE_BUFFER_CAPACITY];
+    return true;
+}
+
+void sample_buffer_discard(size_t n) {
+    if (n > g_count) {
+        n = g_count;
+    }
+    g_head = (g_head + n) % SAMPLE_BUFFER_CAPACITY;
+    g_count -= n;
+
+    if (g_count == 0) {
+        g_head = 0;
+        g_wakes_since_upload = 0;
+    }
+}
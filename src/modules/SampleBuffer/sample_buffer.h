@@ -0,0 +1,96 @@
+#ifndef SAMPLE_BUFFER_H
+#define SAMPLE_BUFFER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "modules/SCD40/scd40_handler.h"
+#include "modules/MICS6814/mics6814_handler.h"
+#include "modules/DSM501A/dsm501a_handler.h"
+
+// Quantidade máxima de leituras guardadas na memória RTC entre uploads.
+// A RTC slow memory do ESP32 tem 8 KB no total; cada amostra ocupa 52 bytes
+// (StoredSample), ~830 bytes com a capacidade padrão.
+#ifndef SAMPLE_BUFFER_CAPACITY
+#define SAMPLE_BUFFER_CAPACITY 16
+#endif
+
+// O ciclo de comunicação roda apenas a cada N despertares (ou com o buffer cheio).
+#ifndef UPLOAD_EVERY_N_WAKES
+#define UPLOAD_EVERY_N_WAKES 4
+#endif
+
+// Uma leitura completa guardada no buffer circular (sobrevive ao deep sleep)
+struct StoredSample {
+    uint32_t timestamp_utc_sec; // Momento da leitura (relógio interno do ESP32)
+    SCD40_Data scd40;
+    MICS6814_Data mics6814;
+    DSM501A_Data dsm501a;
+};
+
+/**
+ * @brief Registra um novo despertar. Deve ser chamada uma vez no início do setup().
+ */
+void sample_buffer_register_wake();
+
+/**
+ * @brief Indica se este despertar deve executar o ciclo de comunicação.
+ *
+ * O upload é devido quando UPLOAD_EVERY_N_WAKES despertares se passaram desde
+ * o último upload bem-sucedido, quando a amostra deste despertar vai
+ * encher o buffer, ou enquanto o relógio nunca foi sincronizado (boot frio).
+ *
+ * @return true se o ciclo de comunicação deve ser executado.
+ */
+bool sample_buffer_upload_due();
+
+/**
+ * @brief Adiciona as leituras atuais ao buffer, com o timestamp do relógio interno.
+ * Se o buffer estiver cheio, a amostra mais antiga é sobrescrita.
+ */
+void sample_buffer_push(const SCD40_Data& scd_data,
+                        const MICS6814_Data& mics_data,
+                        const DSM501A_Data& dsm_data);
+
+/**
+ * @brief Informa que o relógio interno foi acertado pela rede.
+ *
+ * Na primeira sincronização depois de um boot frio, as amostras pendentes
+ * (carimbadas com o relógio ainda em ~1970) são deslocadas pelo mesmo salto.
+ * O relógio conta durante o deep sleep, então os intervalos entre elas
+ * continuam certos.
+ *
+ * @param step_s Hora acertada menos a hora do relógio interno antes do acerto.
+ */
+void sample_buffer_clock_synced(int64_t step_s);
+
+/**
+ * @brief Recalcula os PPM do MICS6814 das amostras pendentes com os R0 atuais.
+ *
+ * Chamada quando a calibração muda (ver mics6814_baseline.h): as leituras
+ * ainda não publicadas saem convertidas pela calibração nova.
+ *
+ * @return Quantas amostras foram reconvertidas.
+ */
+size_t sample_buffer_reconvert_mics6814();
+
+/**
+ * @brief Número de amostras pendentes de envio.
+ */
+size_t sample_buffer_count();
+
+/**
+ * @brief Lê uma amostra pendente sem removê-la.
+ *
+ * @param index Posição a partir da mais antiga (0 = mais antiga).
+ * @param out Referência onde a amostra será copiada.
+ * @return true se o índice for válido, false caso contrário.
+ */
+bool sample_buffer_peek(size_t index, StoredSample& out);
+
+/**
+ * @brief Remove as 'n' amostras mais antigas (já publicadas).
+ * Se o buffer ficar vazio, zera também o contador de despertares.
+ */
+void sample_buffer_discard(size_t n);
+
+#endif // SAMPLE_BUFFER_H
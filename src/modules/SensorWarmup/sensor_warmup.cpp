@@ -0,0 +1,109 @@
+#include "sensor_warmup.h"
+#include "modules/PowerManager/power_manager.h"
+#include "modules/SCD40/scd40_handler.h"
+#include "modules/MICS6814/mics6814_handler.h"
+
+// Prazos e sonda de um sensor
+struct WarmupSpec {
+    const char* name;
+    bool from_rail;     // Prazos contados do trilho ligado (senão, de warmup_begin())
+    uint32_t min_ms;
+    uint32_t max_ms;
+    uint32_t probe_ms;  // Intervalo entre sondas
+    bool (*probe)();    // nullptr: pronto ao cumprir min_ms
+};
+
+static const WarmupSpec SPECS[WARMUP_SENSOR_COUNT] = {
+    {"SCD40", false, 0, WARMUP_SCD40_MAX_MS, WARMUP_SCD40_PROBE_MS, scd40_data_ready},
+    {"MICS6814", true, WARMUP_MICS6814_MIN_MS, WARMUP_MICS6814_MAX_MS, WARMUP_MICS6814_PROBE_MS,
+     mics6814_warmup_settled},
+    {"DSM501A", true, WARMUP_DSM501A_MS, WARMUP_DSM501A_MS, 0, nullptr},
+};
+
+static uint32_t g_begin_ms = 0;
+static bool g_ready[WARMUP_SENSOR_COUNT] = {};
+static bool g_done[WARMUP_SENSOR_COUNT] = {};
+static bool g_probed[WARMUP_SENSOR_COUNT] = {};
+static uint32_t g_last_probe_ms[WARMUP_SENSOR_COUNT] = {};
+
+/**
+ * @brief (Função Privada) Tempo de aquecimento do sensor, na referência dele.
+ */
+static uint32_t elapsed_ms(warmup_sensor_t sensor) {
+    return SPECS[sensor].from_rail ? sensor_power_elapsed_ms() : millis() - g_begin_ms;
+}
+
+/**
+ * @brief (Função Privada) Marca o sensor como pronto e registra o motivo.
+ */
+static void set_ready(warmup_sensor_t sensor, uint32_t elapsed, const char* reason) {
+    g_ready[sensor] = true;
+    if (elapsed == UINT32_MAX) {
+        Serial.printf("SensorWarmup: %s pronto (trilho ligado desde o sono anterior).\n", SPECS[sensor].name);
+        return;
+    }
+    Serial.printf("SensorWarmup: %s pronto em %.1f s (%s).\n", SPECS[sensor].name, elapsed / 1000.0f, reason);
+}
+
+void warmup_begin() {
+    g_begin_ms = millis();
+    memset(g_ready, 0, sizeof(g_ready));
+    memset(g_done, 0, sizeof(g_done));
+    memset(g_probed, 0, sizeof(g_probed));
+}
+
+bool warmup_ready(warmup_sensor_t sensor) {
+    if (sensor >= WARMUP_SENSOR_COUNT) {
+        return false;
+    }
+    if (g_ready[sensor]) {
+        return true;
+    }
+
+    const WarmupSpec& spec = SPECS[sensor];
+    uint32_t elapsed = elapsed_ms(sensor);
+    if (elapsed >= spec.max_ms) {
+        set_ready(sensor, elapsed, spec.probe != nullptr ? "prazo máximo, sem sinal da sonda" : "prazo");
+        return true;
+    }
+    if (spec.probe == nullptr) {
+        return false;
+    }
+
+    // A sonda começa um intervalo antes do mínimo: sondas que comparam com a
+    // anterior (MICS6814) já têm referência quando o mínimo chega
+    if (elapsed + spec.probe_ms < spec.min_ms) {
+        return false;
+    }
+    uint32_t now = millis();
+    if (g_probed[sensor] && now - g_last_probe_ms[sensor] < spec.probe_ms) {
+        return false;
+    }
+    g_probed[sensor] = true;
+    g_last_probe_ms[sensor] = now;
+
+    if (spec.probe() && elapsed >= spec.min_ms) {
+        set_ready(sensor, elapsed, "sonda");
+        return true;
+    }
+    return false;
+}
+
+void warmup_mark_done(warmup_sensor_t sensor) {
+    if (sensor < WARMUP_SENSOR_COUNT) {
+        g_done[sensor] = true;
+    }
+}
+
+bool warmup_done(warmup_sensor_t sensor) {
+    return sensor < WARMUP_SENSOR_COUNT && g_done[sensor];
+}
+
+bool warmup_all_done() {
+    for (int i = 0; i < WARMUP_SENSOR_COUNT; i++) {
+        if (!g_done[i]) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,93 @@
+#ifndef SENSOR_WARMUP_H
+#define SENSOR_WARMUP_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/*
+ * Escalonador de aquecimento dos sensores.
+ *
+ * Em vez de uma espera única dimensionada pelo sensor mais lento, cada
+ * sensor tem um prazo próprio (mínimo e máximo) e, quando possível, uma
+ * sonda que detecta que ele já está pronto antes do máximo:
+ *
+ *     SCD40     sonda "Data Ready" (primeira medição periódica, ~5 s)
+ *     MICS6814  sonda de inclinação das saídas (aquecedor, 1 a 3 min)
+ *     DSM501A   prazo fixo (~1 min); depois corre a janela de amostragem
+ *
+ * O main.cpp consulta warmup_ready() em laço, lê cada sensor assim que ele
+ * fica pronto, marca-o com warmup_mark_done() e desliga o trilho quando
+ * warmup_all_done(). Os prazos do MICS6814 e do DSM501A contam a partir do
+ * instante em que o trilho foi ligado (sensor_power_elapsed_ms()); os do
+ * SCD40, a partir de warmup_begin() (início da medição periódica).
+ */
+
+// SCD40: prazo máximo para o "Data Ready" (após ele, lê mesmo assim)
+#ifndef WARMUP_SCD40_MAX_MS
+#define WARMUP_SCD40_MAX_MS 10000
+#endif
+
+// Intervalo entre consultas do "Data Ready"
+#ifndef WARMUP_SCD40_PROBE_MS
+#define WARMUP_SCD40_PROBE_MS 500
+#endif
+
+// MICS6814: aquecimento mínimo e máximo do aquecedor
+#ifndef WARMUP_MICS6814_MIN_MS
+#define WARMUP_MICS6814_MIN_MS 60000
+#endif
+
+#ifndef WARMUP_MICS6814_MAX_MS
+#define WARMUP_MICS6814_MAX_MS 180000
+#endif
+
+// Intervalo entre sondas de inclinação (base de MICS_WARMUP_SETTLED_PERMILLE)
+#ifndef WARMUP_MICS6814_PROBE_MS
+#define WARMUP_MICS6814_PROBE_MS 5000
+#endif
+
+// DSM501A: aquecimento do resistor de convecção (sem indicador de prontidão)
+#ifndef WARMUP_DSM501A_MS
+#define WARMUP_DSM501A_MS 60000
+#endif
+
+// Período do laço de espera no main.cpp
+#ifndef WARMUP_POLL_MS
+#define WARMUP_POLL_MS 100
+#endif
+
+typedef enum {
+    WARMUP_SENSOR_SCD40 = 0,
+    WARMUP_SENSOR_MICS6814,
+    WARMUP_SENSOR_DSM501A,
+    WARMUP_SENSOR_COUNT
+} warmup_sensor_t;
+
+/**
+ * @brief Zera o estado de todos os sensores. Chamar com o trilho já ligado,
+ * logo após a inicialização dos sensores.
+ */
+void warmup_begin();
+
+/**
+ * @brief Indica se o sensor já pode ser lido: prazo mínimo cumprido e sonda
+ * positiva (ou prazo máximo estourado). Executa a sonda quando é a hora.
+ */
+bool warmup_ready(warmup_sensor_t sensor);
+
+/**
+ * @brief Marca o sensor como lido (ou descartado, ex: falha na inicialização).
+ */
+void warmup_mark_done(warmup_sensor_t sensor);
+
+/**
+ * @brief Indica se o sensor já foi marcado com warmup_mark_done().
+ */
+bool warmup_done(warmup_sensor_t sensor);
+
+/**
+ * @brief true quando todos os sensores foram marcados: o trilho pode desligar.
+ */
+bool warmup_all_done();
+
+#endif // SENSOR_WARMUP_H
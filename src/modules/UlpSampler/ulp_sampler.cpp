@@ -0,0 +1,167 @@
+#include "ulp_sampler.h"
+
+#if ULP_SAMPLER_ENABLED
+
+#include "esp32/ulp.h"
+#include "driver/gpio.h"
+#include "driver/rtc_io.h"
+#include "soc/rtc_io_reg.h"
+#include "esp_sleep.h"
+
+// Memória reservada ao ULP no início da RTC slow memory
+// (CONFIG_ESP32_ULP_COPROC_RESERVE_MEM = 512 bytes no core Arduino)
+#define ULP_RESERVED_WORDS 128
+
+// Dados nas primeiras palavras, programa logo depois
+#define ULP_DATA_OFFSET 0
+#define ULP_PROGRAM_OFFSET 8
+
+// Marca de que os contadores foram zerados por ulp_sampler_start()
+#define ULP_DATA_MAGIC 0xD501
+
+// Palavras de dados (o ULP usa os 16 bits baixos; contadores em pares baixo/alto)
+enum {
+    WORD_MAGIC = 0,
+    WORD_SAMPLES_LO,
+    WORD_SAMPLES_HI,
+    WORD_PM25_LO,
+    WORD_PM25_HI,
+    WORD_PM10_LO,
+    WORD_PM10_HI,
+    DATA_WORDS
+};
+
+// Rótulos do programa do ULP
+enum {
+    LABEL_PM25 = 0,
+    LABEL_PM10,
+    LABEL_DONE,
+    LABEL_SAMPLES_CARRY,
+    LABEL_PM25_CARRY,
+    LABEL_PM10_CARRY,
+};
+
+/**
+ * @brief (Função Privada) Contador de 32 bits a partir do par de palavras.
+ */
+static uint32_t read_counter(int lo_word) {
+    return (RTC_SLOW_MEM[ULP_DATA_OFFSET + lo_word] & 0xffff) |
+           ((RTC_SLOW_MEM[ULP_DATA_OFFSET + lo_word + 1] & 0xffff) << 16);
+}
+
+bool ulp_sampler_start() {
+    int rtc_pm25 = rtc_io_number_get((gpio_num_t)DSM501A_PM25_PIN);
+    int rtc_pm10 = rtc_io_number_get((gpio_num_t)DSM501A_PM10_PIN);
+    if (rtc_pm25 < 0 || rtc_pm10 < 0) {
+        Serial.println("UlpSampler: ERRO - Pinos do DSM501A não são RTC GPIOs.");
+        return false;
+    }
+    const uint32_t bit_pm25 = RTC_GPIO_IN_NEXT_S + rtc_pm25;
+    const uint32_t bit_pm10 = RTC_GPIO_IN_NEXT_S + rtc_pm10;
+
+    // Incrementa 'lo'; se der a volta, incrementa 'hi' (carry) e segue para 'next'
+    const ulp_insn_t program[] = {
+        I_MOVI(R3, ULP_DATA_OFFSET),
+
+        I_LD(R0, R3, WORD_SAMPLES_LO),
+        I_ADDI(R0, R0, 1),
+        I_ST(R0, R3, WORD_SAMPLES_LO),
+        M_BXZ(LABEL_SAMPLES_CARRY),
+
+        M_LABEL(LABEL_PM25),
+        I_RD_REG(RTC_GPIO_IN_REG, bit_pm25, bit_pm25),
+        M_BGE(LABEL_PM10, 1),                // Nível alto: nada a contar
+        I_LD(R0, R3, WORD_PM25_LO),
+        I_ADDI(R0, R0, 1),
+        I_ST(R0, R3, WORD_PM25_LO),
+        M_BXZ(LABEL_PM25_CARRY),
+
+        M_LABEL(LABEL_PM10),
+        I_RD_REG(RTC_GPIO_IN_REG, bit_pm10, bit_pm10),
+        M_BGE(LABEL_DONE, 1),
+        I_LD(R0, R3, WORD_PM10_LO),
+        I_ADDI(R0, R0, 1),
+        I_ST(R0, R3, WORD_PM10_LO),
+        M_BXZ(LABEL_PM10_CARRY),
+
+        M_LABEL(LABEL_DONE),
+        I_HALT(),
+
+        M_LABEL(LABEL_SAMPLES_CARRY),
+        I_LD(R0, R3, WORD_SAMPLES_HI),
+        I_ADDI(R0, R0, 1),
+        I_ST(R0, R3, WORD_SAMPLES_HI),
+        M_BX(LABEL_PM25),
+
+        M_LABEL(LABEL_PM25_CARRY),
+        I_LD(R0, R3, WORD_PM25_HI),
+        I_ADDI(R0, R0, 1),
+        I_ST(R0, R3, WORD_PM25_HI),
+        M_BX(LABEL_PM10),
+
+        M_LABEL(LABEL_PM10_CARRY),
+        I_LD(R0, R3, WORD_PM10_HI),
+        I_ADDI(R0, R0, 1),
+        I_ST(R0, R3, WORD_PM10_HI),
+        M_BX(LABEL_DONE),
+    };
+
+    for (int word = WORD_SAMPLES_LO; word < DATA_WORDS; word++) {
+        RTC_SLOW_MEM[ULP_DATA_OFFSET + word] = 0;
+    }
+    size_t size = sizeof(program) / sizeof(program[0]);
+    if (ulp_process_macros_and_load(ULP_PROGRAM_OFFSET, program, &size) != ESP_OK ||
+        ULP_PROGRAM_OFFSET + size > ULP_RESERVED_WORDS) {
+        Serial.println("UlpSampler: ERRO - Falha ao carregar o programa do ULP.");
+        return false;
+    }
+
+    rtc_gpio_init((gpio_num_t)DSM501A_PM25_PIN);
+    rtc_gpio_set_direction((gpio_num_t)DSM501A_PM25_PIN, RTC_GPIO_MODE_INPUT_ONLY);
+    rtc_gpio_init((gpio_num_t)DSM501A_PM10_PIN);
+    rtc_gpio_set_direction((gpio_num_t)DSM501A_PM10_PIN, RTC_GPIO_MODE_INPUT_ONLY);
+
+    // O DSM501A precisa continuar alimentado durante o sono
+    digitalWrite(SENSOR_POWER_CTRL_PIN, HIGH);
+    gpio_hold_en((gpio_num_t)SENSOR_POWER_CTRL_PIN);
+    gpio_deep_sleep_hold_en();
+    esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON);
+
+    ulp_set_wakeup_period(0, ULP_SAMPLE_PERIOD_US);
+    RTC_SLOW_MEM[ULP_DATA_OFFSET + WORD_MAGIC] = ULP_DATA_MAGIC;
+    if (ulp_run(ULP_PROGRAM_OFFSET) != ESP_OK) {
+        Serial.println("UlpSampler: ERRO - Falha ao iniciar o ULP.");
+        return false;
+    }
+    Serial.printf("UlpSampler: ULP amostrando o DSM501A a cada %lu us durante o sono (%u palavras).\n",
+                  (unsigned long)ULP_SAMPLE_PERIOD_US, (unsigned)size);
+    return true;
+}
+
+bool ulp_sampler_collect(UlpSampler_Stats& stats) {
+    memset(&stats, 0, sizeof(stats));
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_UNDEFINED ||
+        (RTC_SLOW_MEM[ULP_DATA_OFFSET + WORD_MAGIC] & 0xffff) != ULP_DATA_MAGIC) {
+        return false; // Boot a frio: a RTC slow memory não tem contagens válidas
+    }
+    stats.samples = read_counter(WORD_SAMPLES_LO);
+    stats.low_pm25 = read_counter(WORD_PM25_LO);
+    stats.low_pm10 = read_counter(WORD_PM10_LO);
+    stats.duration_ms = (uint32_t)((uint64_t)stats.samples * ULP_SAMPLE_PERIOD_US / 1000ULL);
+    RTC_SLOW_MEM[ULP_DATA_OFFSET + WORD_MAGIC] = 0;
+
+    // Devolve os pinos à matriz de GPIO (captura MCPWM / ISR da janela)
+    rtc_gpio_deinit((gpio_num_t)DSM501A_PM25_PIN);
+    rtc_gpio_deinit((gpio_num_t)DSM501A_PM10_PIN);
+
+    if (stats.samples == 0) {
+        Serial.println("UlpSampler: AVISO - ULP sem amostras neste sono.");
+        return false;
+    }
+    Serial.printf("UlpSampler: %lu amostras em %lu s de sono - LOP PM2.5: %.2f %%, PM10: %.2f %%\n",
+                  (unsigned long)stats.samples, (unsigned long)(stats.duration_ms / 1000),
+                  100.0f * stats.low_pm25 / stats.samples, 100.0f * stats.low_pm10 / stats.samples);
+    return true;
+}
+
+#endif // ULP_SAMPLER_ENABLED
@@ -0,0 +1,56 @@
+#ifndef ULP_SAMPLER_H
+#define ULP_SAMPLER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+/*
+ * Amostragem do DSM501A pelo coprocessador ULP durante o deep sleep.
+ *
+ * A cada ULP_SAMPLE_PERIOD_US o ULP lê o nível das duas saídas do DSM501A
+ * (RTC GPIOs) e conta, na RTC slow memory, as amostras e quantas estavam em
+ * nível baixo. A fração em nível baixo estima a LOP ratio do intervalo de
+ * sono inteiro; no despertar ela é combinada com a janela medida pelos
+ * núcleos principais.
+ *
+ * O ULP em si custa microampères, mas o trilho dos sensores fica retido
+ * ligado durante o sono e o consumo dele (aquecedores do MICS6814 e do
+ * DSM501A) passa a dominar: opção para alimentação externa/solar ou placas
+ * com trilho próprio para o DSM501A.
+ *
+ * O ADS1115 não é lido pelo ULP: o I2C do ULP só sai nos pads RTC
+ * (GPIO 0/2/4/15) e o ADS1115 está no barramento Wire principal.
+ */
+
+#ifndef ULP_SAMPLER_ENABLED
+#define ULP_SAMPLER_ENABLED 0
+#endif
+
+// Período do timer do ULP (uma amostra de cada saída por período)
+#ifndef ULP_SAMPLE_PERIOD_US
+#define ULP_SAMPLE_PERIOD_US 10000
+#endif
+
+// Amostras acumuladas pelo ULP desde ulp_sampler_start()
+struct UlpSampler_Stats {
+    uint32_t samples;
+    uint32_t low_pm25;     // Amostras com a saída PM2.5 em nível baixo
+    uint32_t low_pm10;
+    uint32_t duration_ms;  // samples x ULP_SAMPLE_PERIOD_US
+};
+
+/**
+ * @brief Carrega e inicia o programa do ULP e retém o trilho dos sensores
+ * ligado. Chamada logo antes do deep sleep (ver enter_deep_sleep()).
+ * @return false se os pinos do DSM501A não são RTC GPIOs ou o ULP não iniciou.
+ */
+bool ulp_sampler_start();
+
+/**
+ * @brief Lê as contagens do último sono e devolve os pinos ao GPIO digital
+ * (captura do DSM501A). Chamada no despertar, antes de dsm501a_init().
+ * @return false no boot a frio ou se o ULP não estava rodando.
+ */
+bool ulp_sampler_collect(UlpSampler_Stats& stats);
+
+#endif // ULP_SAMPLER_H
@@ -0,0 +1,69 @@
+#include "wake_manager.h"
+#include "esp_sleep.h"
+#include "esp_system.h"
+#include "modules/ConnectivityHandler/gps_cache.h"
+#include "modules/Diagnostics/diagnostics.h"
+
+// Deep sleeps iniciados por enter_deep_sleep() e despertares vistos pelo stub.
+// Iguais no setup() = o ciclo anterior dormiu normalmente e a memória RTC
+// chegou intacta até aqui.
+RTC_DATA_ATTR static uint32_t g_sleeps_started = 0;
+RTC_DATA_ATTR static uint32_t g_stub_wakes = 0;
+
+static const char* const WAKE_TYPE_NAMES[] = {
+    "store_only", "upload", "gnss_refresh", "recovery",
+};
+
+/**
+ * Stub de despertar: roda da RTC fast memory logo ao sair do deep sleep,
+ * antes do bootloader e de a flash estar disponível. Só pode tocar em
+ * variáveis RTC_DATA_ATTR; por isso apenas marca a passagem, e a decisão
+ * fica para wake_classify().
+ */
+void RTC_IRAM_ATTR esp_wake_deep_sleep(void) {
+    esp_default_wake_deep_sleep();
+    g_stub_wakes++;
+}
+
+wake_type_t wake_classify(bool upload_due) {
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    bool clean_sleep = (cause == ESP_SLEEP_WAKEUP_TIMER || cause == ESP_SLEEP_WAKEUP_ULP) &&
+                       g_stub_wakes == g_sleeps_started;
+    // Ressincroniza para o próximo ciclo, qualquer que seja o resultado
+    g_stub_wakes = g_sleeps_started;
+
+    wake_type_t type;
+    if (!clean_sleep) {
+        type = WAKE_TYPE_RECOVERY;
+        diag_count(DIAG_COUNTER_RECOVERY_BOOTS);
+    } else if (!upload_due) {
+        type = WAKE_TYPE_STORE_ONLY;
+    } else if (gps_cache_refresh_due()) {
+        type = WAKE_TYPE_GNSS_REFRESH;
+    } else {
+        type = WAKE_TYPE_UPLOAD;
+    }
+    return type;
+}
+
+bool wake_gnss_refresh_expected(wake_type_t type) {
+    // A classificação não consulta o cache nos boots de recuperação
+    return type == WAKE_TYPE_GNSS_REFRESH || (type == WAKE_TYPE_RECOVERY && gps_cache_refresh_due());
+}
+
+void wake_log(wake_type_t type) {
+    if (type == WAKE_TYPE_RECOVERY) {
+        Serial.printf("WakeManager: Despertar %s (causa %d, reset %d).\n", wake_type_name(type),
+                      (int)esp_sleep_get_wakeup_cause(), (int)esp_reset_reason());
+    } else {
+        Serial.printf("WakeManager: Despertar %s.\n", wake_type_name(type));
+    }
+}
+
+void wake_prepare_sleep() {
+    g_sleeps_started++;
+}
+
+const char* wake_type_name(wake_type_t type) {
+    return type <= WAKE_TYPE_RECOVERY ? WAKE_TYPE_NAMES[type] : "?";
+}
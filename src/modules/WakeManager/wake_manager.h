@@ -0,0 +1,63 @@
+#ifndef WAKE_MANAGER_H
+#define WAKE_MANAGER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Espera após o Serial.begin() para o monitor serial (USB) conectar. Só é
+// feita em boots de recuperação: nos despertares de deep sleep ninguém está
+// olhando a Serial e a espera era puro consumo.
+#ifndef WAKE_RECOVERY_SERIAL_DELAY_MS
+#define WAKE_RECOVERY_SERIAL_DELAY_MS 2000
+#endif
+
+/*
+ * Tipo do despertar, decidido no início do setup() a partir da causa do
+ * despertar (esp_sleep_get_wakeup_cause()), do motivo do reset e do estado
+ * guardado na memória RTC. Define quanto do boot é necessário.
+ */
+typedef enum {
+    WAKE_TYPE_STORE_ONLY = 0, // Só lê os sensores e guarda a amostra (sem modem)
+    WAKE_TYPE_UPLOAD,         // Upload do backlog, reaproveitando o fix em cache
+    WAKE_TYPE_GNSS_REFRESH,   // Upload com novo fix provável (cache ausente, velho ou movimento)
+    WAKE_TYPE_RECOVERY,       // Boot fora de um deep sleep limpo (energização, reset, pânico, WDT)
+} wake_type_t;
+
+/**
+ * @brief Classifica o despertar atual. Chamar uma vez, depois de
+ * sample_buffer_register_wake().
+ *
+ * É de recuperação todo boot que não veio do timer do deep sleep passando
+ * pelo stub de despertar (ver wake_manager.cpp): nesse caso o estado na
+ * memória RTC não é confiável ou o ciclo anterior não terminou.
+ *
+ * Não escreve na Serial: a espera pelo monitor depende do resultado.
+ *
+ * @param upload_due Resultado de sample_buffer_upload_due().
+ */
+wake_type_t wake_classify(bool upload_due);
+
+/**
+ * @brief Se este despertar deve tentar um novo fix: WAKE_TYPE_GNSS_REFRESH ou
+ * um boot de recuperação em que o cache também pede um (memória RTC zerada).
+ */
+bool wake_gnss_refresh_expected(wake_type_t type);
+
+/**
+ * @brief Registra o tipo do despertar na Serial (com causa e motivo do reset
+ * nos boots de recuperação).
+ */
+void wake_log(wake_type_t type);
+
+/**
+ * @brief Registra que o ESP32 vai entrar em deep sleep (chamada por
+ * enter_deep_sleep()). O próximo despertar só é "limpo" se o stub o confirmar.
+ */
+void wake_prepare_sleep();
+
+/**
+ * @brief Nome curto do tipo de despertar (para logs).
+ */
+const char* wake_type_name(wake_type_t type);
+
+#endif // WAKE_MANAGER_H
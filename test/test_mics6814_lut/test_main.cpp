@@ -0,0 +1,162 @@
+/**
+ * Conversão do MICS6814 pelas tabelas (mics6814_lut.h) contra as fórmulas
+ * originais com pow(), pelo mesmo caminho do firmware:
+ * mics6814_init() + mics6814_convert_batch().
+ *
+ * Executar: pio test -e native
+ */
+
+#include <unity.h>
+#include <math.h>
+
+#include "modules/MICS6814/mics6814_handler.h"
+#include "modules/MICS6814/mics6814_lut.h"
+
+// Erro relativo máximo prometido por tools/gen_mics6814_lut.py
+#define MAX_REL_ERROR 0.005
+
+#define ADC_MAX 32767
+
+// R0 diferentes por canal, no meio da faixa do ADC
+#define R0_CO 12000
+#define R0_NO2 16000
+#define R0_NH3 20000
+
+// Passo da varredura de valores brutos
+#define RAW_STEP 7
+
+// Curvas do driver ESP-IDF (as mesmas do gerador da tabela)
+static double curve_co(double r) { return pow(r, -1.179) * 4.385; }
+static double curve_no2(double r) { return pow(r, 1.007) / 6.855; }
+static double curve_nh3(double r) { return pow(r, -1.67) / 1.47; }
+
+/**
+ * @brief Rs/R0 corrigido pela faixa do ADC, como no handler.
+ */
+static double ratio(int32_t rs, int32_t r0) {
+    return ((double)rs / r0) * (double)(ADC_MAX - r0) / (double)(ADC_MAX - rs);
+}
+
+static bool ratio_in_table(double r) {
+    return r >= ldexp(1.0, MICS_LUT_RATIO_MIN_EXP) && r < ldexp(1.0, MICS_LUT_RATIO_MAX_EXP);
+}
+
+/**
+ * @brief Converte um valor bruto (o mesmo nos três canais) e confere cada PPM com pow().
+ * @return Quantos canais estavam dentro da faixa da tabela.
+ */
+static int check_raw(int16_t raw) {
+    MICS6814_Data data = {};
+    data.raw_co = raw;
+    data.raw_no2 = raw;
+    data.raw_nh3 = raw;
+    data.isValid = true;
+    TEST_ASSERT_EQUAL_UINT32(1, mics6814_convert_batch(&data, 1));
+
+    struct {
+        const char* name;
+        int32_t r0;
+        double (*curve)(double);
+        float ppm;
+    } channels[] = {
+        {"CO", R0_CO, curve_co, data.ppm_co},
+        {"NO2", R0_NO2, curve_no2, data.ppm_no2},
+        {"NH3", R0_NH3, curve_nh3, data.ppm_nh3},
+    };
+
+    int checked = 0;
+    for (const auto& channel : channels) {
+        double r = ratio(raw, channel.r0);
+        if (!ratio_in_table(r)) {
+            continue;
+        }
+        double expected = channel.curve(r);
+        double error = fabs(channel.ppm - expected) / expected;
+        if (error > MAX_REL_ERROR) {
+            char message[96];
+            snprintf(message, sizeof(message), "%s raw=%d Rs/R0=%.5f: %.6f ppm (esperado %.6f)", channel.name,
+                     raw, r, channel.ppm, expected);
+            TEST_FAIL_MESSAGE(message);
+        }
+        checked++;
+    }
+    return checked;
+}
+
+void setUp() {
+    mics6814_init(R0_CO, R0_NO2, R0_NH3);
+}
+
+void tearDown() {}
+
+void test_convert_batch_matches_pow_across_table_range() {
+    int checked = 0;
+    for (int32_t raw = 1; raw < ADC_MAX; raw += RAW_STEP) {
+        checked += check_raw((int16_t)raw);
+    }
+    // A varredura precisa cobrir boa parte da faixa nos três canais
+    TEST_ASSERT_GREATER_THAN(3 * 1000, checked);
+}
+
+void test_convert_batch_matches_pow_at_table_knots() {
+    // Valores brutos cuja razão cai exatamente em cada oitava (pior caso do Q16.16 nas pontas)
+    for (int exp = MICS_LUT_RATIO_MIN_EXP; exp < MICS_LUT_RATIO_MAX_EXP; exp++) {
+        double r = ldexp(1.0, exp);
+        // Inverte ratio() para o canal de NO2
+        double k = r * R0_NO2 / (double)(ADC_MAX - R0_NO2);
+        int32_t raw = (int32_t)lround(k * ADC_MAX / (1.0 + k));
+        if (raw > 0 && raw < ADC_MAX) {
+            check_raw((int16_t)raw);
+        }
+    }
+}
+
+void test_convert_batch_skips_invalid_readings() {
+    MICS6814_Data readings[2] = {};
+    readings[0].raw_co = readings[0].raw_no2 = readings[0].raw_nh3 = R0_NO2;
+    readings[0].isValid = true;
+    readings[1].raw_co = readings[1].raw_no2 = readings[1].raw_nh3 = R0_NO2;
+    readings[1].isValid = false;
+
+    TEST_ASSERT_EQUAL_UINT32(1, mics6814_convert_batch(readings, 2));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, readings[1].ppm_co);
+    TEST_ASSERT_FLOAT_WITHIN(curve_no2(1.0) * MAX_REL_ERROR, curve_no2(1.0), readings[0].ppm_no2);
+}
+
+void test_convert_batch_with_stride() {
+    // Leituras embutidas em registros maiores, como no StoredSample do buffer
+    struct Record {
+        uint32_t timestamp;
+        MICS6814_Data mics;
+        uint8_t tail[5];
+    } records[3] = {};
+    for (auto& record : records) {
+        record.mics.raw_co = record.mics.raw_no2 = record.mics.raw_nh3 = R0_NO2;
+        record.mics.isValid = true;
+        record.timestamp = 0xA5A5A5A5;
+    }
+    records[1].mics.isValid = false;
+
+    TEST_ASSERT_EQUAL_UINT32(2, mics6814_convert_batch(&records[0].mics, 3, sizeof(Record)));
+    TEST_ASSERT_FLOAT_WITHIN(curve_no2(1.0) * MAX_REL_ERROR, curve_no2(1.0), records[2].mics.ppm_no2);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, records[1].mics.ppm_no2);
+    TEST_ASSERT_EQUAL_UINT32(0xA5A5A5A5, records[2].timestamp);
+}
+
+void test_convert_batch_needs_r0() {
+    mics6814_init(0, R0_NO2, R0_NH3);
+    MICS6814_Data data = {};
+    data.raw_co = data.raw_no2 = data.raw_nh3 = R0_NO2;
+    data.isValid = true;
+    TEST_ASSERT_EQUAL_UINT32(0, mics6814_convert_batch(&data, 1));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_convert_batch_matches_pow_across_table_range);
+    RUN_TEST(test_convert_batch_matches_pow_at_table_knots);
+    RUN_TEST(test_convert_batch_skips_invalid_readings);
+    RUN_TEST(test_convert_batch_with_stride);
+    RUN_TEST(test_convert_batch_needs_r0);
+    return UNITY_END();
+}
@@ -0,0 +1,196 @@
+/**
+ * Benchmark (host) dos codificadores de payload: JSON (json_payload) e
+ * binário (binary_payload).
+ *
+ * Roda como o "firmware" do build nativo, sobre a NativeHAL:
+ *     pio run -e native_bench && .pio/build/native_bench/program
+ *
+ * Para cada formato mede, com um lote cheio (SAMPLE_BUFFER_CAPACITY amostras,
+ * localização e bloco de diagnóstico):
+ *   - bytes por mensagem e amostras que couberam no buffer MQTT;
+ *   - tempo por mensagem (relógio real do host) e vazão em bytes/ns;
+ *   - alocações no heap por mensagem (malloc/new interceptados);
+ * e verifica que nenhum codificador escreve além da capacidade informada,
+ * para todas as capacidades de 0 até o payload máximo do pacote MQTT.
+ */
+
+#include <Arduino.h>
+#include <esp_sleep.h>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "modules/PayloadCodec/binary_payload.h"
+#include "modules/PayloadCodec/json_payload.h"
+
+#ifndef BENCH_PAYLOAD_ITERATIONS
+#define BENCH_PAYLOAD_ITERATIONS 20000
+#endif
+
+// ===================================================================
+// --- Contagem de alocações (glibc) ---
+// ===================================================================
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t n, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void __libc_free(void* ptr);
+
+static volatile bool g_counting = false;
+static volatile unsigned long g_allocations = 0;
+
+extern "C" void* malloc(size_t size) {
+    if (g_counting) g_allocations++;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t n, size_t size) {
+    if (g_counting) g_allocations++;
+    return __libc_calloc(n, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    if (g_counting) g_allocations++;
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void* ptr) {
+    __libc_free(ptr);
+}
+
+void* operator new(size_t size) {
+    void* ptr = malloc(size);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+
+// ===================================================================
+// --- Lote de referência ---
+// ===================================================================
+
+typedef size_t (*encode_fn)(uint8_t* out, size_t capacity, const char* device_id,
+                            const StoredSample* samples, size_t count,
+                            const GPS_Data& gps_data, const Diag_Report* diag,
+                            size_t& out_encoded);
+
+static StoredSample g_samples[SAMPLE_BUFFER_CAPACITY];
+static GPS_Data g_gps;
+static Diag_Report g_diag;
+
+static void build_reference_batch() {
+    for (size_t i = 0; i < SAMPLE_BUFFER_CAPACITY; i++) {
+        StoredSample& s = g_samples[i];
+        s.timestamp_utc_sec = 1760000000UL + i * 900;
+        s.scd40 = {612.0f + i, 24.37f - 0.11f * i, 55.2f + 0.3f * i, true};
+        s.mics6814.ppm_co = 1.234f + 0.01f * i;
+        s.mics6814.ppm_no2 = 0.052f;
+        s.mics6814.ppm_nh3 = 0.91f;
+        s.mics6814.raw_co = (int16_t)(10450 + i);
+        s.mics6814.raw_no2 = 6120;
+        s.mics6814.raw_nh3 = (int16_t)(9800 - i);
+        s.mics6814.isValid = (i % 5) != 4; // Algumas leituras inválidas (null)
+        s.dsm501a = {0.0f, 0.0f, false};
+    }
+
+    g_gps.latitude = -23.550520f;
+    g_gps.longitude = -46.633308f;
+    g_gps.altitude = 760.0f;
+    g_gps.accuracy = 1.1f;
+    g_gps.satellites_used = 7;
+    g_gps.satellites_visible = 11;
+    g_gps.fix_epoch_utc = 1760000000UL;
+    g_gps.from_cache = true;
+    g_gps.isValid = true;
+
+    g_diag.wakes = 4;
+    for (int i = 0; i < DIAG_PHASE_COUNT; i++) {
+        g_diag.phases[i] = {1, 1500000, 1500000, 1500000, 262144};
+    }
+    g_diag.counters[DIAG_COUNTER_GNSS_POLLS] = 9;
+}
+
+static size_t max_mqtt_payload() {
+    // Mesma conta do publish_backlog(): cabeçalho fixo + tamanho do tópico + tópico
+    return MQTT_PACKET_BUFFER_SIZE - 5 - 2 - strlen(AWS_IOT_PUBLISH_TOPIC);
+}
+
+// ===================================================================
+// --- Medições ---
+// ===================================================================
+
+static void bench(const char* name, encode_fn encode, size_t capacity) {
+    static uint8_t buffer[MQTT_PACKET_BUFFER_SIZE];
+    size_t encoded = 0;
+    size_t bytes = encode(buffer, capacity, AWS_IOT_CLIENT_ID, g_samples, SAMPLE_BUFFER_CAPACITY,
+                          g_gps, &g_diag, encoded);
+
+    g_allocations = 0;
+    g_counting = true;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_PAYLOAD_ITERATIONS; i++) {
+        encode(buffer, capacity, AWS_IOT_CLIENT_ID, g_samples, SAMPLE_BUFFER_CAPACITY, g_gps, &g_diag, encoded);
+    }
+    auto end = std::chrono::steady_clock::now();
+    g_counting = false;
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / BENCH_PAYLOAD_ITERATIONS;
+    printf("Bench: %-6s %4u bytes, %2u/%u amostras | %8.0f ns/msg | %.3f bytes/ns | %.2f alocações/msg\n",
+           name, (unsigned)bytes, (unsigned)encoded, (unsigned)SAMPLE_BUFFER_CAPACITY, ns,
+           ns > 0.0 ? bytes / ns : 0.0, (double)g_allocations / BENCH_PAYLOAD_ITERATIONS);
+}
+
+/**
+ * @brief Codifica com todas as capacidades até 'max_capacity' e confere os
+ * bytes de guarda logo após a capacidade informada.
+ * @return true se nenhuma escrita passou do limite.
+ */
+static bool check_bounds(const char* name, encode_fn encode, size_t max_capacity) {
+    static uint8_t buffer[MQTT_PACKET_BUFFER_SIZE + 16];
+    const uint8_t GUARD = 0xA5;
+
+    for (size_t capacity = 0; capacity <= max_capacity; capacity++) {
+        memset(buffer, GUARD, sizeof(buffer));
+        size_t encoded = 0;
+        size_t bytes = encode(buffer, capacity, AWS_IOT_CLIENT_ID, g_samples, SAMPLE_BUFFER_CAPACITY,
+                              g_gps, &g_diag, encoded);
+        bool overrun = bytes > capacity;
+        for (size_t i = capacity; i < capacity + 16 && !overrun; i++) {
+            overrun = buffer[i] != GUARD;
+        }
+        if (overrun) {
+            printf("Bench: ERRO - %s escreveu além de %u bytes.\n", name, (unsigned)capacity);
+            return false;
+        }
+    }
+    printf("Bench: %-6s limites OK (capacidades 0..%u).\n", name, (unsigned)max_capacity);
+    return true;
+}
+
+void setup() {
+    build_reference_batch();
+    size_t capacity = max_mqtt_payload();
+    printf("Bench: payload máximo do pacote MQTT: %u bytes (MQTT_PACKET_BUFFER_SIZE %u).\n",
+           (unsigned)capacity, (unsigned)MQTT_PACKET_BUFFER_SIZE);
+
+    // JSON: +1 para o terminador nulo, como em serialize_batch()
+    bench("json", json_payload_encode, capacity + 1);
+    bench("binary", binary_payload_encode, capacity);
+    check_bounds("json", json_payload_encode, capacity + 1);
+    check_bounds("binary", binary_payload_encode, capacity);
+
+    esp_sleep_enable_timer_wakeup(1000000ULL);
+    esp_deep_sleep_start();
+}
+
+void loop() {
+}
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+"""Decodifica um lote binário (PAYLOAD_FORMAT_BINARY) publicado pelo firmware.
+
+Saída: o mesmo documento JSON "colunar" (batch v1) que o firmware publica
+quando compilado com PAYLOAD_FORMAT_JSON, para que o ingest trate os dois
+formatos da mesma forma. A versão do formato binário (BINARY_PAYLOAD_VERSION)
+só é conferida, não vai para o documento.
+
+Uso:
+    decode_payload.py arquivo.bin
+    decode_payload.py --hex b50101...
+    cat arquivo.bin | decode_payload.py
+"""
+
+import argparse
+import json
+import math
+import struct
+import sys
+from datetime import datetime, timezone
+
+MAGIC = 0xB5
+WIRE_VERSION = 1  # BINARY_PAYLOAD_VERSION
+DOC_VERSION = 1   # Campo "v" do documento JSON (json_payload.cpp)
+
+FLAG_LOCATION = 0x01
+FLAG_LOCATION_CACHED = 0x02
+FLAG_DIAG = 0x04
+HAS_SCD40 = 0x01
+HAS_MICS6814 = 0x02
+HAS_DSM501A = 0x04
+NULL_U16 = 0xFFFF  # BINARY_NULL_U16/_I16/_I32: sem valor (null no JSON)
+NULL_I16 = -0x8000
+NULL_I32 = -0x80000000
+
+# Mesma ordem de diag_phase_t / diag_counter_t (src/modules/Diagnostics)
+DIAG_PHASES = ("awake", "sens_on", "scd40", "mics", "modem_resume", "modem_restart",
+               "reg", "gprs", "ntp", "gnss", "tls", "mqtt", "pub", "dsm_wait", "rail")
+DIAG_COUNTERS = ("net_fail", "ntp_retry", "gnss_poll", "tls_fallback", "mqtt_retry",
+                 "pub_fail", "sensor_fail", "tls_heap_fallback", "recovery")
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def take(self, fmt):
+        values = struct.unpack_from("<" + fmt, self.data, self.pos)
+        self.pos += struct.calcsize("<" + fmt)
+        return values if len(values) > 1 else values[0]
+
+    def raw(self, n):
+        chunk = self.data[self.pos:self.pos + n]
+        if len(chunk) != n:
+            raise ValueError("payload truncado")
+        self.pos += n
+        return chunk
+
+
+def name_of(names, index):
+    return names[index] if index < len(names) else "id%d" % index
+
+
+def scaled(value, null, divisor=1):
+    if value == null:
+        return None
+    return value / divisor if divisor != 1 else value
+
+
+def finite(value, digits):
+    return round(value, digits) if math.isfinite(value) else None
+
+
+def decode_diag(r):
+    wakes, phase_count = r.take("HB")
+    phases = {}
+    for _ in range(phase_count):
+        phase, count, total_ms, max_ms, min_heap = r.take("BHIII")
+        phases[name_of(DIAG_PHASES, phase)] = [count, total_ms, max_ms, min_heap]
+    counters = {}
+    for _ in range(r.take("B")):
+        counter, value = r.take("BH")
+        counters[name_of(DIAG_COUNTERS, counter)] = value
+    return {"wakes": wakes, "ph": phases, "cnt": counters}
+
+
+def decode(data):
+    r = Reader(data)
+    magic, version, flags, count = r.take("BBBB")
+    if magic != MAGIC:
+        raise ValueError("magic inválido: 0x%02X" % magic)
+    if version != WIRE_VERSION:
+        raise ValueError("versão não suportada: %d" % version)
+
+    base_ts = r.take("I")
+    device_id = r.raw(r.take("B")).decode("utf-8", errors="replace")
+
+    doc = {
+        "deviceId": device_id,
+        "v": DOC_VERSION,
+        "base_ts": base_ts,
+        "datetime_utc_str": datetime.fromtimestamp(base_ts, timezone.utc)
+        .strftime("%Y-%m-%dT%H:%M:%SZ"),
+        "dt": [],
+    }
+
+    if flags & FLAG_LOCATION:
+        lat, lon, alt, acc, used, visible = r.take("iihHBB")
+        doc["location"] = {
+            "latitude": None if lat == NULL_I32 else round(lat / 1e6, 6),
+            "longitude": None if lon == NULL_I32 else round(lon / 1e6, 6),
+            "accuracy_m": scaled(acc, NULL_U16, 100.0),
+            "satellites_used": used,
+            "satellites_visible": visible,
+            "altitude_m": scaled(alt, NULL_I16),
+        }
+        doc["location"]["age_s"] = r.take("I")
+        doc["location"]["cached"] = bool(flags & FLAG_LOCATION_CACHED)
+        ttff_ms = r.take("I")
+        if not doc["location"]["cached"]:
+            doc["location"]["ttff_ms"] = ttff_ms
+
+    diag = decode_diag(r) if flags & FLAG_DIAG else None
+
+    scd = {"co2": [], "temperature": [], "humidity": []}
+    mics = {k: [] for k in ("ppm_co", "ppm_no2", "ppm_nh3", "raw_co", "raw_no2", "raw_nh3")}
+    dsm = {"lop_ratio_pm25": [], "lop_ratio_pm10": []}
+    seen = 0
+
+    for _ in range(count):
+        dt, valid = r.take("iB")
+        doc["dt"].append(dt)
+        seen |= valid
+
+        if valid & HAS_SCD40:
+            co2, temp, hum = r.take("HhH")
+            values = (scaled(co2, NULL_U16), scaled(temp, NULL_I16, 100.0), scaled(hum, NULL_U16, 100.0))
+        else:
+            values = (None, None, None)
+        for key, value in zip(scd, values):
+            scd[key].append(value)
+
+        if valid & HAS_MICS6814:
+            co, no2, nh3, raw_co, raw_no2, raw_nh3 = r.take("fffhhh")
+            values = (finite(co, 2), finite(no2, 2), finite(nh3, 2), raw_co, raw_no2, raw_nh3)
+        else:
+            values = (None,) * 6
+        for key, value in zip(mics, values):
+            mics[key].append(value)
+
+        if valid & HAS_DSM501A:
+            pm25, pm10 = r.take("HH")
+            values = (scaled(pm25, NULL_U16, 100.0), scaled(pm10, NULL_U16, 100.0))
+        else:
+            values = (None, None)
+        for key, value in zip(dsm, values):
+            dsm[key].append(value)
+
+    if seen & HAS_SCD40:
+        doc["scd40"] = scd
+    if seen & HAS_MICS6814:
+        doc["mics6814"] = mics
+    if seen & HAS_DSM501A:
+        doc["dsm501a"] = dsm
+    if diag is not None:
+        doc["diag"] = diag
+
+    if r.pos != len(data):
+        raise ValueError("%d byte(s) sobrando no payload" % (len(data) - r.pos))
+    return doc
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("file", nargs="?", help="arquivo binário (padrão: stdin)")
+    parser.add_argument("--hex", help="payload em hexadecimal")
+    args = parser.parse_args()
+
+    if args.hex:
+        data = bytes.fromhex(args.hex)
+    elif args.file:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    print(json.dumps(decode(data), indent=2))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Gera src/modules/MICS6814/mics6814_lut.h: as curvas PPM x (Rs/R0) do
+MICS6814 tabeladas para interpolação em ponto fixo no firmware.
+
+A razão Rs/R0 entra em Q16.16. Cada oitava de [2^RATIO_MIN_EXP, 2^RATIO_MAX_EXP)
+é dividida em SEGMENTS_PER_OCTAVE segmentos lineares iguais, de modo que o
+índice sai do bit mais significativo da razão e a interpolação só usa
+deslocamentos (ver mics6814_handler.cpp). Os valores são PPM x 10^6.
+
+Antes de gravar, o script reproduz a interpolação inteira do firmware sobre
+todas as razões representáveis (passo de 1/256 de segmento) e falha se o
+erro relativo contra as fórmulas originais (pow) passar de MAX_REL_ERROR.
+
+Uso:
+    gen_mics6814_lut.py            # verifica e regrava o header
+    gen_mics6814_lut.py --check    # só verifica (não grava)
+"""
+
+import argparse
+import math
+import os
+import sys
+
+RATIO_MIN_EXP = -7
+RATIO_MAX_EXP = 6
+SEGMENTS_PER_OCTAVE = 16
+SEGMENT_BITS = 4  # log2(SEGMENTS_PER_OCTAVE)
+Q = 16            # bits fracionários da razão
+SCALE = 1_000_000 # PPM -> micro-PPM
+MAX_REL_ERROR = 0.005
+
+# Mesmas fórmulas do driver ESP-IDF usadas até aqui em mics6814_read_data()
+CURVES = (
+    ("CO", lambda r: math.pow(r, -1.179) * 4.385),
+    ("NO2", lambda r: math.pow(r, 1.007) / 6.855),
+    ("NH3", lambda r: math.pow(r, -1.67) / 1.47),
+)
+
+OCTAVES = RATIO_MAX_EXP - RATIO_MIN_EXP
+ENTRIES = OCTAVES * SEGMENTS_PER_OCTAVE + 1
+RATIO_MIN_Q16 = 1 << (Q + RATIO_MIN_EXP)
+RATIO_MAX_Q16 = 1 << (Q + RATIO_MAX_EXP)
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "modules",
+                      "MICS6814", "mics6814_lut.h")
+
+
+def knot_ratio(index):
+    octave, segment = divmod(index, SEGMENTS_PER_OCTAVE)
+    return math.ldexp(1.0 + segment / SEGMENTS_PER_OCTAVE, RATIO_MIN_EXP + octave)
+
+
+def build_table(curve):
+    return [int(round(curve(knot_ratio(i)) * SCALE)) for i in range(ENTRIES)]
+
+
+def interpolate(table, ratio_q16):
+    """Cópia exata de lut_interpolate() (mics6814_handler.cpp)."""
+    if ratio_q16 < RATIO_MIN_Q16:
+        ratio_q16 = RATIO_MIN_Q16
+    if ratio_q16 >= RATIO_MAX_Q16:
+        return table[ENTRIES - 1]
+    msb = ratio_q16.bit_length() - 1
+    shift = msb - SEGMENT_BITS
+    offset = ratio_q16 - (1 << msb)
+    index = (msb - Q - RATIO_MIN_EXP) * SEGMENTS_PER_OCTAVE + (offset >> shift)
+    rest = offset & ((1 << shift) - 1)
+    y0, y1 = table[index], table[index + 1]
+    delta = (y1 - y0) * rest
+    # Deslocamento aritmético (arredonda para -inf), como no int64_t do C++
+    return y0 + (delta >> shift)
+
+
+def check(name, curve, table):
+    worst = 0.0
+    worst_ratio = 0.0
+    for msb in range(Q + RATIO_MIN_EXP, Q + RATIO_MAX_EXP):
+        step = max(1, (1 << (msb - SEGMENT_BITS)) >> 8)
+        for ratio_q16 in range(1 << msb, 1 << (msb + 1), step):
+            expected = curve(ratio_q16 / (1 << Q))
+            got = interpolate(table, ratio_q16) / SCALE
+            err = abs(got - expected) / expected
+            if err > worst:
+                worst, worst_ratio = err, ratio_q16 / (1 << Q)
+    print(f"{name}: erro relativo máximo {worst * 100:.3f}% (Rs/R0 = {worst_ratio:.5f})")
+    return worst
+
+
+def render(tables):
+    lines = [
+        "#ifndef MICS6814_LUT_H",
+        "#define MICS6814_LUT_H",
+        "",
+        "// GERADO por tools/gen_mics6814_lut.py - não editar à mão.",
+        "//",
+        "// Curvas PPM x (Rs/R0) do MICS6814 (fórmulas do driver ESP-IDF) em",
+        f"// {SEGMENTS_PER_OCTAVE} segmentos lineares por oitava de Rs/R0, de 2^{RATIO_MIN_EXP} a 2^{RATIO_MAX_EXP}.",
+        f"// Valores em PPM x {SCALE}. Erro de interpolação < {MAX_REL_ERROR * 100:g}% na faixa.",
+        "",
+        "#include <stdint.h>",
+        "",
+        f"#define MICS_LUT_RATIO_MIN_EXP ({RATIO_MIN_EXP})",
+        f"#define MICS_LUT_RATIO_MAX_EXP ({RATIO_MAX_EXP})",
+        f"#define MICS_LUT_SEGMENT_BITS {SEGMENT_BITS}",
+        f"#define MICS_LUT_ENTRIES {ENTRIES}",
+        f"#define MICS_LUT_SCALE {SCALE}",
+        "",
+    ]
+    for name, table in tables:
+        lines.append(f"static constexpr uint32_t MICS_LUT_{name}[MICS_LUT_ENTRIES] = {{")
+        for i in range(0, len(table), 6):
+            lines.append("    " + ", ".join(f"{v}u" for v in table[i:i + 6]) + ",")
+        lines.append("};")
+        lines.append("")
+    lines.append("#endif // MICS6814_LUT_H")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--check", action="store_true", help="só verifica o erro, sem gravar o header")
+    args = parser.parse_args()
+
+    tables = []
+    ok = True
+    for name, curve in CURVES:
+        table = build_table(curve)
+        if max(table) >= 1 << 32:
+            sys.exit(f"{name}: valor fora de uint32_t")
+        ok &= check(name, curve, table) <= MAX_REL_ERROR
+        tables.append((name, table))
+    if not ok:
+        sys.exit(f"ERRO: erro de interpolação acima de {MAX_REL_ERROR * 100:g}%")
+
+    if not args.check:
+        with open(HEADER, "w", encoding="utf-8") as f:
+            f.write(render(tables))
+        print(f"Gravado {os.path.normpath(HEADER)}")
+
+
+if __name__ == "__main__":
+    main()